@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+#ifndef __BENCH_COMMON_HPP__
+#define __BENCH_COMMON_HPP__
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+import pragma.math;
+
+namespace bench {
+	// All input sets are generated from a fixed seed, so that results are comparable between runs
+	constexpr uint32_t SEED = 0x6d617468;
+	constexpr size_t NUM_INPUTS = 1024; // Must be a power of two
+
+	inline std::mt19937 &get_random_generator()
+	{
+		static std::mt19937 gen {SEED};
+		return gen;
+	}
+	inline void reset_random_generator() { get_random_generator().seed(SEED); }
+	inline float random_float(float min, float max) { return std::uniform_real_distribution<float> {min, max}(get_random_generator()); }
+	inline Vector3 random_vector(float min, float max) { return {random_float(min, max), random_float(min, max), random_float(min, max)}; }
+	inline Vector3 random_direction()
+	{
+		auto v = random_vector(-1.f, 1.f);
+		if(uvec::length_sqr(v) < 0.0001f)
+			v = uvec::PRM_FORWARD;
+		return uvec::get_normal(v);
+	}
+	inline Quat random_rotation()
+	{
+		Quat q {random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f), random_float(-1.f, 1.f)};
+		if(uquat::length(q) < 0.0001f)
+			return uquat::identity();
+		uquat::normalize(q);
+		return q;
+	}
+	inline std::pair<Vector3, Vector3> random_aabb(float range, float maxExtent)
+	{
+		auto center = random_vector(-range, range);
+		auto extents = random_vector(0.1f, maxExtent);
+		return {center - extents, center + extents};
+	}
+	inline pragma::math::ScaledTransform random_transform(float range) { return {random_vector(-range, range), random_rotation(), random_vector(0.5f, 2.f)}; }
+
+	template<typename T>
+	const T &next_input(const std::vector<T> &inputs, size_t &i)
+	{
+		return inputs[i++ & (inputs.size() - 1)];
+	}
+};
+
+#endif
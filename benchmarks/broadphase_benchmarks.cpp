@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "bench_common.hpp"
+
+namespace {
+	struct MovingBox {
+		bounding_volume::AABB aabb;
+		Vector3 velocity;
+	};
+	// Boxes are distributed so that the density stays constant regardless of the count
+	std::vector<MovingBox> generate_moving_boxes(size_t count)
+	{
+		bench::reset_random_generator();
+		auto range = std::cbrt(static_cast<float>(count)) * 4.f;
+		std::vector<MovingBox> boxes;
+		boxes.reserve(count);
+		for(size_t i = 0; i < count; ++i) {
+			auto [min, max] = bench::random_aabb(range, 1.f);
+			boxes.push_back({{min, max}, bench::random_vector(-0.05f, 0.05f)});
+		}
+		return boxes;
+	}
+	void step(std::vector<MovingBox> &boxes, float dir)
+	{
+		for(auto &box : boxes) {
+			box.aabb.min += box.velocity * dir;
+			box.aabb.max += box.velocity * dir;
+		}
+	}
+};
+
+// One simulation step for all boxes, followed by the pair update. Boxes move back and forth so that the state doesn't drift between iterations.
+static void BM_broadphase_dynamic_aabb_tree(benchmark::State &state)
+{
+	auto boxes = generate_moving_boxes(state.range(0));
+	pragma::math::DynamicAabbTree tree {};
+	tree.Reserve(boxes.size());
+	std::vector<pragma::math::DynamicAabbTree::ProxyId> proxies;
+	proxies.reserve(boxes.size());
+	for(auto &box : boxes)
+		proxies.push_back(tree.Insert(box.aabb));
+	tree.UpdatePairs([](uint32_t, uint32_t) {});
+	size_t numPairs = 0;
+	size_t frame = 0;
+	for(auto _ : state) {
+		auto dir = ((frame++ / 32) % 2 == 0) ? 1.f : -1.f;
+		step(boxes, dir);
+		for(size_t i = 0; i < boxes.size(); ++i)
+			tree.Move(proxies[i], boxes[i].aabb, boxes[i].velocity * dir);
+		tree.UpdatePairs([&numPairs](uint32_t, uint32_t) { ++numPairs; });
+	}
+	benchmark::DoNotOptimize(numPairs);
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_broadphase_dynamic_aabb_tree)->Arg(1'024)->Arg(8'192)->Arg(50'000)->Unit(benchmark::kMicrosecond);
+
+static void BM_broadphase_sweep_and_prune(benchmark::State &state)
+{
+	auto boxes = generate_moving_boxes(state.range(0));
+	pragma::math::SweepAndPrune sap {};
+	sap.Reserve(boxes.size());
+	std::vector<pragma::math::SweepAndPrune::ProxyId> proxies;
+	proxies.reserve(boxes.size());
+	for(auto &box : boxes)
+		proxies.push_back(sap.Add(box.aabb));
+	sap.Update();
+	size_t numEvents = 0;
+	uint64_t numSwaps = 0;
+	size_t frame = 0;
+	for(auto _ : state) {
+		auto dir = ((frame++ / 32) % 2 == 0) ? 1.f : -1.f;
+		step(boxes, dir);
+		for(size_t i = 0; i < boxes.size(); ++i)
+			sap.SetAabb(proxies[i], boxes[i].aabb);
+		sap.Update();
+		numEvents += sap.GetPairEvents().size();
+		for(auto swapCount : sap.GetFrameStats().swapCount)
+			numSwaps += swapCount;
+	}
+	benchmark::DoNotOptimize(numEvents);
+	state.counters["swaps_per_frame"] = benchmark::Counter(static_cast<double>(numSwaps) / std::max<size_t>(frame, 1));
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_broadphase_sweep_and_prune)->Arg(1'024)->Arg(8'192)->Arg(50'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+
+// Adds all boxes at once and runs the first update, which sorts the endpoints and finds the initial pairs
+static void BM_broadphase_sweep_and_prune_bulk_insert(benchmark::State &state)
+{
+	auto boxes = generate_moving_boxes(state.range(0));
+	pragma::math::SweepAndPrune sap {};
+	sap.Reserve(boxes.size());
+	size_t numPairs = 0;
+	for(auto _ : state) {
+		sap.Clear();
+		for(auto &box : boxes)
+			sap.Add(box.aabb);
+		sap.Update();
+		numPairs += sap.GetPairCount();
+	}
+	benchmark::DoNotOptimize(numPairs);
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_broadphase_sweep_and_prune_bulk_insert)->Arg(1'024)->Arg(8'192)->Arg(50'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+
+// Replaces a quarter of the boxes between frames, which merges the added proxies into the sorted endpoints of the remaining ones
+static void BM_broadphase_sweep_and_prune_churn(benchmark::State &state)
+{
+	auto boxes = generate_moving_boxes(state.range(0));
+	pragma::math::SweepAndPrune sap {};
+	sap.Reserve(boxes.size());
+	std::vector<pragma::math::SweepAndPrune::ProxyId> proxies;
+	proxies.reserve(boxes.size());
+	for(auto &box : boxes)
+		proxies.push_back(sap.Add(box.aabb));
+	sap.Update();
+	size_t numEvents = 0;
+	size_t frame = 0;
+	for(auto _ : state) {
+		for(size_t i = frame++ % 4; i < boxes.size(); i += 4) {
+			sap.Remove(proxies[i]);
+			proxies[i] = sap.Add(boxes[i].aabb);
+		}
+		sap.Update();
+		numEvents += sap.GetPairEvents().size();
+	}
+	benchmark::DoNotOptimize(numEvents);
+	state.SetItemsProcessed(state.iterations() * (boxes.size() / 4));
+}
+BENCHMARK(BM_broadphase_sweep_and_prune_churn)->Arg(8'192)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+
+// Reference implementation, testing every pair with AABB::Intersects
+static void BM_broadphase_brute_force(benchmark::State &state)
+{
+	auto boxes = generate_moving_boxes(state.range(0));
+	size_t numPairs = 0;
+	size_t frame = 0;
+	for(auto _ : state) {
+		auto dir = ((frame++ / 32) % 2 == 0) ? 1.f : -1.f;
+		step(boxes, dir);
+		for(size_t i = 0; i < boxes.size(); ++i) {
+			for(size_t j = i + 1; j < boxes.size(); ++j) {
+				if(boxes[i].aabb.Intersects(boxes[j].aabb))
+					++numPairs;
+			}
+		}
+	}
+	benchmark::DoNotOptimize(numPairs);
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_broadphase_brute_force)->Arg(1'024)->Arg(8'192)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "bench_common.hpp"
+
+namespace {
+	// Displaced grid of size x size quads, which resembles a terrain mesh
+	void generate_grid_mesh(uint32_t size, std::vector<Vector3> &outVerts, std::vector<uint32_t> &outTris)
+	{
+		bench::reset_random_generator();
+		outVerts.clear();
+		outTris.clear();
+		outVerts.reserve((size + 1) * (size + 1));
+		outTris.reserve(size * size * 6);
+		for(uint32_t y = 0; y <= size; ++y) {
+			for(uint32_t x = 0; x <= size; ++x)
+				outVerts.push_back({static_cast<float>(x), bench::random_float(-0.5f, 0.5f), static_cast<float>(y)});
+		}
+		for(uint32_t y = 0; y < size; ++y) {
+			for(uint32_t x = 0; x < size; ++x) {
+				auto i = y * (size + 1) + x;
+				for(auto idx : {i, i + size + 1, i + 1, i + 1, i + size + 1, i + size + 2})
+					outTris.push_back(idx);
+			}
+		}
+	}
+
+	std::vector<std::pair<Vector3, Vector3>> generate_grid_rays(uint32_t size)
+	{
+		std::vector<std::pair<Vector3, Vector3>> rays;
+		rays.reserve(bench::NUM_INPUTS);
+		for(size_t i = 0; i < bench::NUM_INPUTS; ++i) {
+			Vector3 origin {bench::random_float(0.f, static_cast<float>(size)), 10.f, bench::random_float(0.f, static_cast<float>(size))};
+			auto dir = uvec::get_normal(Vector3 {bench::random_float(-0.5f, 0.5f), -1.f, bench::random_float(-0.5f, 0.5f)});
+			rays.push_back({origin, dir});
+		}
+		return rays;
+	}
+};
+
+static void BM_bvh_build(benchmark::State &state)
+{
+	std::vector<Vector3> verts;
+	std::vector<uint32_t> tris;
+	generate_grid_mesh(state.range(0), verts, tris);
+	pragma::math::Bvh::BuildInfo buildInfo {};
+	buildInfo.threadCount = state.range(1);
+	for(auto _ : state) {
+		pragma::math::Bvh bvh {verts, tris, buildInfo};
+		benchmark::DoNotOptimize(bvh.GetNodes().data());
+	}
+	state.SetItemsProcessed(state.iterations() * (tris.size() / 3));
+}
+// Second argument is the thread count, where 1 is the serial builder and 0 uses all hardware threads
+BENCHMARK(BM_bvh_build)->Args({32, 1})->Args({256, 1})->Args({1'024, 1})->Args({1'024, 4})->Args({1'024, 0})->Unit(benchmark::kMillisecond);
+
+// Compare with BM_bvh_build for the same mesh size. Alternates between two deformed vertex sets, the second argument is the thread count.
+static void BM_bvh_refit(benchmark::State &state)
+{
+	std::vector<Vector3> verts;
+	std::vector<uint32_t> tris;
+	generate_grid_mesh(state.range(0), verts, tris);
+	pragma::math::Bvh bvh {verts, tris};
+	std::array<std::vector<Vector3>, 2> frames {verts, verts};
+	for(auto &v : frames[1])
+		v.y += bench::random_float(-0.25f, 0.25f);
+	auto threadCount = static_cast<uint32_t>(state.range(1));
+	size_t i = 0;
+	for(auto _ : state)
+		benchmark::DoNotOptimize(bvh.Refit(frames[i++ % frames.size()], threadCount));
+	state.SetItemsProcessed(state.iterations() * (tris.size() / 3));
+}
+BENCHMARK(BM_bvh_refit)->Args({256, 1})->Args({1'024, 1})->Args({1'024, 0})->Unit(benchmark::kMillisecond);
+
+static void BM_bvh_raycast(benchmark::State &state)
+{
+	std::vector<Vector3> verts;
+	std::vector<uint32_t> tris;
+	generate_grid_mesh(state.range(0), verts, tris);
+	pragma::math::Bvh bvh {verts, tris};
+	auto rays = generate_grid_rays(state.range(0));
+	size_t i = 0;
+	for(auto _ : state) {
+		auto &ray = bench::next_input(rays, i);
+		benchmark::DoNotOptimize(bvh.Raycast(ray.first, ray.second));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_bvh_raycast)->Arg(32)->Arg(256);
+
+// Reference for BM_bvh_raycast, testing every triangle of the mesh
+static void BM_bvh_raycast_brute_force(benchmark::State &state)
+{
+	std::vector<Vector3> verts;
+	std::vector<uint32_t> tris;
+	generate_grid_mesh(state.range(0), verts, tris);
+	auto rays = generate_grid_rays(state.range(0));
+	size_t i = 0;
+	for(auto _ : state) {
+		auto &ray = bench::next_input(rays, i);
+		auto tBest = std::numeric_limits<double>::max();
+		for(auto j = decltype(tris.size()) {0u}; j < tris.size(); j += 3) {
+			double t, u, v;
+			if(pragma::math::intersection::line_triangle(ray.first, ray.second, verts[tris[j]], verts[tris[j + 1]], verts[tris[j + 2]], t, u, v) && t >= 0.0 && t < tBest)
+				tBest = t;
+		}
+		benchmark::DoNotOptimize(tBest);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_bvh_raycast_brute_force)->Arg(32);
+
+static void BM_bvh_closest_point(benchmark::State &state)
+{
+	std::vector<Vector3> verts;
+	std::vector<uint32_t> tris;
+	generate_grid_mesh(state.range(0), verts, tris);
+	pragma::math::Bvh bvh {verts, tris};
+	auto size = static_cast<float>(state.range(0));
+	std::vector<Vector3> points;
+	points.reserve(bench::NUM_INPUTS);
+	for(size_t j = 0; j < bench::NUM_INPUTS; ++j)
+		points.push_back({bench::random_float(0.f, size), bench::random_float(-4.f, 4.f), bench::random_float(0.f, size)});
+	size_t i = 0;
+	for(auto _ : state)
+		benchmark::DoNotOptimize(bvh.FindClosestPoint(bench::next_input(points, i)));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_bvh_closest_point)->Arg(32)->Arg(256);
+
+static void BM_bvh_triangles_in_sphere(benchmark::State &state)
+{
+	std::vector<Vector3> verts;
+	std::vector<uint32_t> tris;
+	generate_grid_mesh(state.range(0), verts, tris);
+	pragma::math::Bvh bvh {verts, tris};
+	auto size = static_cast<float>(state.range(0));
+	std::vector<Vector3> points;
+	points.reserve(bench::NUM_INPUTS);
+	for(size_t j = 0; j < bench::NUM_INPUTS; ++j)
+		points.push_back({bench::random_float(0.f, size), 0.f, bench::random_float(0.f, size)});
+	std::vector<uint32_t> result;
+	size_t i = 0;
+	for(auto _ : state) {
+		result.clear();
+		bvh.FindTrianglesInSphere(bench::next_input(points, i), 2.f, result);
+		benchmark::DoNotOptimize(result.data());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_bvh_triangles_in_sphere)->Arg(256);
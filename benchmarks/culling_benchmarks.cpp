@@ -0,0 +1,301 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "bench_common.hpp"
+
+namespace {
+	constexpr float SCENE_RANGE = 500.f;
+	std::vector<bounding_volume::AABB> generate_scene(size_t count)
+	{
+		bench::reset_random_generator();
+		std::vector<bounding_volume::AABB> boxes;
+		boxes.reserve(count);
+		for(size_t i = 0; i < count; ++i) {
+			auto [min, max] = bench::random_aabb(SCENE_RANGE, 4.f);
+			boxes.push_back({min, max});
+		}
+		return boxes;
+	}
+	// Six planes of a view-frustum-like volume, covering a small part of the scene
+	auto generate_view_planes() { return pragma::math::geometry::get_obb_planes(Vector3 {}, bench::random_rotation(), Vector3 {-100.f, -60.f, -160.f}, Vector3 {100.f, 60.f, 160.f}); }
+	pragma::math::Frustum generate_view_frustum() { return pragma::math::Frustum {glm::perspective(1.2f, 16.f / 9.f, 0.5f, 400.f) * glm::lookAt(Vector3 {}, Vector3 {0.f, 0.f, 1.f}, Vector3 {0.f, 1.f, 0.f})}; }
+};
+
+static void BM_culling_octree(benchmark::State &state)
+{
+	auto boxes = generate_scene(state.range(0));
+	auto planes = generate_view_planes();
+	pragma::math::LooseOctree octree {Vector3 {}, SCENE_RANGE};
+	octree.Reserve(boxes.size(), boxes.size() / 4);
+	for(auto &box : boxes)
+		octree.Insert(box);
+	size_t numVisible = 0;
+	for(auto _ : state)
+		octree.QueryPlaneMesh(planes.begin(), planes.end(), [&numVisible](pragma::math::LooseOctree::ItemId) { ++numVisible; });
+	benchmark::DoNotOptimize(numVisible);
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_culling_octree)->Arg(8'192)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+
+// Moves a fraction of the items every iteration, which mostly stay within their nodes
+static void BM_culling_octree_update(benchmark::State &state)
+{
+	auto boxes = generate_scene(state.range(0));
+	pragma::math::LooseOctree octree {Vector3 {}, SCENE_RANGE};
+	std::vector<pragma::math::LooseOctree::ItemId> items;
+	items.reserve(boxes.size());
+	for(auto &box : boxes)
+		items.push_back(octree.Insert(box));
+	std::vector<Vector3> offsets;
+	offsets.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i)
+		offsets.push_back(bench::random_vector(-0.5f, 0.5f));
+	size_t idx = 0;
+	for(auto _ : state) {
+		for(size_t i = 0; i < boxes.size(); i += 8) {
+			auto &offset = bench::next_input(offsets, idx);
+			boxes[i].min += offset;
+			boxes[i].max += offset;
+			octree.Update(items[i], boxes[i]);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * (boxes.size() / 8));
+}
+BENCHMARK(BM_culling_octree_update)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+
+static void BM_culling_brute_force(benchmark::State &state)
+{
+	auto boxes = generate_scene(state.range(0));
+	auto planes = generate_view_planes();
+	size_t numVisible = 0;
+	for(auto _ : state) {
+		for(auto &box : boxes) {
+			if(pragma::math::intersection::aabb_in_plane_mesh(box.min, box.max, planes.begin(), planes.end()) != pragma::math::intersection::Intersect::Outside)
+				++numVisible;
+		}
+	}
+	benchmark::DoNotOptimize(numVisible);
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_culling_brute_force)->Arg(8'192)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+
+// Arg 1 enables the last-plane cache, which is warmed up before the measurement
+static void BM_culling_frustum_aabbs(benchmark::State &state)
+{
+	auto boxes = generate_scene(state.range(0));
+	auto frustum = generate_view_frustum();
+	pragma::math::AabbSoaBuffer soa {boxes};
+	std::vector<uint32_t> visibleMask(pragma::math::intersection::get_hit_mask_size(boxes.size()));
+	std::vector<uint8_t> lastPlanes;
+	if(state.range(1) != 0) {
+		lastPlanes.resize(boxes.size(), pragma::math::Frustum::INVALID_PLANE);
+		frustum.CullAabbs(soa.GetView(), visibleMask.data(), lastPlanes.data());
+	}
+	for(auto _ : state)
+		benchmark::DoNotOptimize(frustum.CullAabbs(soa.GetView(), visibleMask.data(), lastPlanes.empty() ? nullptr : lastPlanes.data()));
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_culling_frustum_aabbs)->Args({200'000, 0})->Args({200'000, 1})->Unit(benchmark::kMicrosecond);
+
+static void BM_culling_frustum_spheres(benchmark::State &state)
+{
+	auto boxes = generate_scene(state.range(0));
+	auto frustum = generate_view_frustum();
+	pragma::math::SphereSoaBuffer soa {};
+	soa.Reserve(boxes.size());
+	for(auto &box : boxes)
+		soa.Add((box.min + box.max) * 0.5f, uvec::length(box.max - box.min) * 0.5f);
+	std::vector<uint32_t> visibleMask(pragma::math::intersection::get_hit_mask_size(boxes.size()));
+	for(auto _ : state)
+		benchmark::DoNotOptimize(frustum.CullSpheres(soa.GetView(), visibleMask.data()));
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_culling_frustum_spheres)->Arg(200'000)->Unit(benchmark::kMicrosecond);
+
+// Per-box classification without plane caching, for comparison with the batched variants
+static void BM_culling_frustum_scalar(benchmark::State &state)
+{
+	auto boxes = generate_scene(state.range(0));
+	auto frustum = generate_view_frustum();
+	size_t numVisible = 0;
+	for(auto _ : state) {
+		for(auto &box : boxes) {
+			if(frustum.ClassifyAabb(box.min, box.max) != pragma::math::intersection::Intersect::Outside)
+				++numVisible;
+		}
+	}
+	benchmark::DoNotOptimize(numVisible);
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_culling_frustum_scalar)->Arg(200'000)->Unit(benchmark::kMicrosecond);
+
+// Main camera, 4 shadow cascades and 6 cubemap faces. Arg 1 culls all views in a single pass, Arg 0 culls each view separately.
+static void BM_culling_multi_view(benchmark::State &state)
+{
+	auto boxes = generate_scene(state.range(0));
+	std::vector<pragma::math::Frustum> frusta;
+	frusta.push_back(generate_view_frustum());
+	for(auto i = 0u; i < 4u; ++i) {
+		auto extent = 50.f * static_cast<float>(1u << i);
+		frusta.push_back(pragma::math::Frustum {pragma::math::geometry::get_obb_planes(Vector3 {}, bench::random_rotation(), Vector3 {-extent, -extent, -SCENE_RANGE}, Vector3 {extent, extent, SCENE_RANGE})});
+	}
+	for(auto &dir : {Vector3 {1.f, 0.f, 0.f}, Vector3 {-1.f, 0.f, 0.f}, Vector3 {0.f, 1.f, 0.f}, Vector3 {0.f, -1.f, 0.f}, Vector3 {0.f, 0.f, 1.f}, Vector3 {0.f, 0.f, -1.f}}) {
+		auto up = (std::abs(dir.y) > 0.5f) ? Vector3 {0.f, 0.f, 1.f} : Vector3 {0.f, 1.f, 0.f};
+		frusta.push_back(pragma::math::Frustum {glm::perspective(glm::half_pi<float>(), 1.f, 0.1f, 100.f) * glm::lookAt(Vector3 {10.f, 0.f, 0.f}, Vector3 {10.f, 0.f, 0.f} + dir, up)});
+	}
+	pragma::math::AabbSoaBuffer soa {boxes};
+	auto maskSize = pragma::math::intersection::get_hit_mask_size(boxes.size());
+	std::vector<uint32_t> visibleMasks(maskSize * frusta.size());
+	std::vector<size_t> visibleCounts(frusta.size());
+	auto singlePass = state.range(1) != 0;
+	for(auto _ : state) {
+		if(singlePass)
+			pragma::math::Frustum::CullAabbs(frusta.data(), static_cast<uint32_t>(frusta.size()), soa.GetView(), visibleMasks.data(), visibleCounts.data());
+		else {
+			for(size_t i = 0; i < frusta.size(); ++i)
+				visibleCounts[i] = frusta[i].CullAabbs(soa.GetView(), visibleMasks.data() + i * maskSize);
+		}
+		benchmark::DoNotOptimize(visibleCounts.data());
+	}
+	state.SetItemsProcessed(state.iterations() * boxes.size() * frusta.size());
+}
+BENCHMARK(BM_culling_multi_view)->Args({200'000, 0})->Args({200'000, 1})->Unit(benchmark::kMicrosecond);
+
+// Parallel culling into a compacted index list, Arg 1 is the thread count
+static void BM_culling_frustum_parallel(benchmark::State &state)
+{
+	auto boxes = generate_scene(state.range(0));
+	auto frustum = generate_view_frustum();
+	pragma::math::AabbSoaBuffer soa {boxes};
+	std::vector<uint32_t> visibleIndices;
+	auto threadCount = static_cast<uint32_t>(state.range(1));
+	for(auto _ : state)
+		benchmark::DoNotOptimize(frustum.CullAabbs(soa.GetView(), visibleIndices, threadCount));
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_culling_frustum_parallel)->Args({200'000, 1})->Args({200'000, 4})->Args({1'000'000, 1})->Args({1'000'000, 4})->Unit(benchmark::kMicrosecond);
+
+namespace {
+	constexpr uint32_t CLUSTER_GRID_X = 16;
+	constexpr uint32_t CLUSTER_GRID_Y = 9;
+	constexpr uint32_t CLUSTER_GRID_Z = 24;
+	pragma::math::LightClusterGrid generate_cluster_grid()
+	{
+		pragma::math::LightClusterGrid grid;
+		grid.Build(Vector3 {}, Vector3 {0.f, 0.f, 1.f}, Vector3 {0.f, 1.f, 0.f}, 1.2f, 16.f / 9.f, 0.5f, 400.f, CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z);
+		return grid;
+	}
+	// Half of the lights are point lights, the other half spotlights
+	void generate_lights(size_t count, pragma::math::SphereSoaBuffer &outPointLights, std::vector<pragma::math::LightClusterGrid::SpotLight> &outSpotLights)
+	{
+		bench::reset_random_generator();
+		for(size_t i = 0; i < count / 2; ++i)
+			outPointLights.Add(bench::random_vector(-200.f, 200.f) + Vector3 {0.f, 0.f, 200.f}, bench::random_float(1.f, 20.f));
+		for(size_t i = count / 2; i < count; ++i)
+			outSpotLights.push_back({bench::random_vector(-200.f, 200.f) + Vector3 {0.f, 0.f, 200.f}, bench::random_direction(), bench::random_float(0.1f, 1.f), bench::random_float(5.f, 40.f)});
+	}
+};
+
+// Arg 1 is the thread count
+static void BM_clustered_lighting_assign(benchmark::State &state)
+{
+	auto grid = generate_cluster_grid();
+	pragma::math::SphereSoaBuffer pointLights;
+	std::vector<pragma::math::LightClusterGrid::SpotLight> spotLights;
+	generate_lights(state.range(0), pointLights, spotLights);
+	auto threadCount = static_cast<uint32_t>(state.range(1));
+	for(auto _ : state) {
+		grid.AssignLights(pointLights.GetView(), spotLights.data(), spotLights.size(), threadCount);
+		benchmark::DoNotOptimize(grid.GetLightIndices().data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_clustered_lighting_assign)->Args({1'024, 1})->Args({8'192, 1})->Args({8'192, 4})->Unit(benchmark::kMicrosecond);
+
+// Tests every light against the bounding sphere of every cluster
+static void BM_clustered_lighting_brute_force(benchmark::State &state)
+{
+	auto grid = generate_cluster_grid();
+	pragma::math::SphereSoaBuffer pointLights;
+	std::vector<pragma::math::LightClusterGrid::SpotLight> spotLights;
+	generate_lights(state.range(0), pointLights, spotLights);
+	std::vector<std::vector<uint32_t>> clusterLights(grid.GetClusterCount());
+	for(auto _ : state) {
+		for(uint32_t c = 0; c < grid.GetClusterCount(); ++c) {
+			auto &lights = clusterLights[c];
+			lights.clear();
+			auto cluster = grid.GetClusterSphere(c);
+			for(size_t i = 0; i < pointLights.Size(); ++i) {
+				auto light = pointLights.Get(i);
+				if(uvec::length_sqr(light.origin - cluster.origin) <= (light.radius + cluster.radius) * (light.radius + cluster.radius))
+					lights.push_back(static_cast<uint32_t>(i));
+			}
+			for(size_t i = 0; i < spotLights.size(); ++i) {
+				auto &light = spotLights[i];
+				if(pragma::math::intersection::sphere_cone(cluster.origin, cluster.radius, light.origin, light.direction, light.coneAngle, light.range))
+					lights.push_back(static_cast<uint32_t>(pointLights.Size() + i));
+			}
+		}
+		benchmark::DoNotOptimize(clusterLights.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_clustered_lighting_brute_force)->Arg(1'024)->Unit(benchmark::kMicrosecond);
+
+namespace {
+	constexpr uint32_t OCCLUSION_BUFFER_WIDTH = 320;
+	constexpr uint32_t OCCLUSION_BUFFER_HEIGHT = 180;
+	// Randomly placed and oriented wall quads in front of the camera of generate_view_frustum
+	void generate_occluders(size_t count, std::vector<Vector3> &outVerts, std::vector<uint32_t> &outTris)
+	{
+		bench::reset_random_generator();
+		for(size_t i = 0; i < count; ++i) {
+			auto center = bench::random_vector(-150.f, 150.f) + Vector3 {0.f, 0.f, 200.f};
+			auto rot = bench::random_rotation();
+			auto halfWidth = bench::random_float(5.f, 30.f);
+			auto halfHeight = bench::random_float(5.f, 30.f);
+			auto offset = static_cast<uint32_t>(outVerts.size());
+			for(auto [x, y] : {std::pair {-1.f, -1.f}, std::pair {1.f, -1.f}, std::pair {1.f, 1.f}, std::pair {-1.f, 1.f}})
+				outVerts.push_back(center + rot * Vector3 {x * halfWidth, y * halfHeight, 0.f});
+			outTris.insert(outTris.end(), {offset, offset + 1, offset + 2, offset, offset + 2, offset + 3});
+		}
+	}
+	Mat4 get_view_projection() { return glm::perspective(1.2f, 16.f / 9.f, 0.5f, 400.f) * glm::lookAt(Vector3 {}, Vector3 {0.f, 0.f, 1.f}, Vector3 {0.f, 1.f, 0.f}); }
+};
+
+// Arg 0 is the number of occluder quads, Arg 1 the thread count
+static void BM_occlusion_rasterize(benchmark::State &state)
+{
+	std::vector<Vector3> verts;
+	std::vector<uint32_t> tris;
+	generate_occluders(state.range(0), verts, tris);
+	pragma::math::OcclusionBuffer buffer {OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT};
+	auto threadCount = static_cast<uint32_t>(state.range(1));
+	for(auto _ : state) {
+		buffer.Begin(get_view_projection());
+		buffer.AddOccluder(verts, tris);
+		buffer.Rasterize(threadCount);
+		benchmark::DoNotOptimize(buffer.GetDepths(0));
+	}
+	state.SetItemsProcessed(state.iterations() * tris.size() / 3);
+}
+BENCHMARK(BM_occlusion_rasterize)->Args({256, 1})->Args({256, 4})->Args({2'048, 1})->Args({2'048, 4})->Unit(benchmark::kMicrosecond);
+
+static void BM_occlusion_cull_aabbs(benchmark::State &state)
+{
+	std::vector<Vector3> verts;
+	std::vector<uint32_t> tris;
+	generate_occluders(256, verts, tris);
+	pragma::math::OcclusionBuffer buffer {OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT};
+	buffer.Begin(get_view_projection());
+	buffer.AddOccluder(verts, tris);
+	buffer.Rasterize();
+	auto boxes = generate_scene(state.range(0));
+	pragma::math::AabbSoaBuffer soa {boxes};
+	std::vector<uint32_t> visibleMask(pragma::math::intersection::get_hit_mask_size(boxes.size()));
+	for(auto _ : state)
+		benchmark::DoNotOptimize(buffer.CullAabbs(soa.GetView(), visibleMask.data()));
+	state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_occlusion_cull_aabbs)->Arg(200'000)->Unit(benchmark::kMicrosecond);
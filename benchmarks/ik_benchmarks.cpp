@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "bench_common.hpp"
+
+template<class TSolver>
+static void run_ik_benchmark(benchmark::State &state)
+{
+	auto numJoints = static_cast<uint32_t>(state.range(0));
+	bench::reset_random_generator();
+	std::vector<pragma::math::ScaledTransform> targets;
+	targets.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i)
+		targets.push_back(pragma::math::ScaledTransform {bench::random_vector(-static_cast<float>(numJoints), static_cast<float>(numJoints))});
+
+	TSolver solver {};
+	solver.Resize(numJoints);
+	auto resetChain = [&solver, numJoints]() {
+		for(auto i = decltype(numJoints) {0u}; i < numJoints; ++i)
+			solver.SetLocalTransform(i, pragma::math::ScaledTransform {Vector3 {0.f, (i > 0) ? 1.f : 0.f, 0.f}});
+	};
+	size_t idx = 0;
+	for(auto _ : state) {
+		state.PauseTiming();
+		resetChain();
+		state.ResumeTiming();
+		benchmark::DoNotOptimize(solver.Solve(bench::next_input(targets, idx)));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_ik_ccd_solve(benchmark::State &state) { run_ik_benchmark<uvec::ik::CCDSolver>(state); }
+BENCHMARK(BM_ik_ccd_solve)->Arg(4)->Arg(16);
+
+static void BM_ik_fabrik_solve(benchmark::State &state) { run_ik_benchmark<uvec::ik::FABRIKSolver>(state); }
+BENCHMARK(BM_ik_fabrik_solve)->Arg(4)->Arg(16);
@@ -0,0 +1,399 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "bench_common.hpp"
+
+namespace {
+	struct RayAabbInput {
+		Vector3 origin;
+		Vector3 dir;
+		Vector3 min;
+		Vector3 max;
+	};
+	struct TriangleInput {
+		Vector3 v0;
+		Vector3 v1;
+		Vector3 v2;
+	};
+	struct RayTriangleInput {
+		Vector3 origin;
+		Vector3 dir;
+		TriangleInput tri;
+	};
+	struct AabbTriangleInput {
+		Vector3 min;
+		Vector3 max;
+		TriangleInput tri;
+	};
+	struct ObbPairInput {
+		pragma::math::ScaledTransform poseA;
+		pragma::math::ScaledTransform poseB;
+		Vector3 minA;
+		Vector3 maxA;
+		Vector3 minB;
+		Vector3 maxB;
+	};
+
+	TriangleInput random_triangle(float range, float size)
+	{
+		auto center = bench::random_vector(-range, range);
+		return {center + bench::random_vector(-size, size), center + bench::random_vector(-size, size), center + bench::random_vector(-size, size)};
+	}
+};
+
+static void BM_line_aabb(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	std::vector<RayAabbInput> inputs;
+	inputs.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i) {
+		auto [min, max] = bench::random_aabb(50.f, 10.f);
+		inputs.push_back({bench::random_vector(-100.f, 100.f), bench::random_direction() * 200.f, min, max});
+	}
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto &in = bench::next_input(inputs, idx);
+		float tMin, tMax;
+		benchmark::DoNotOptimize(pragma::math::intersection::line_aabb(in.origin, in.dir, in.min, in.max, &tMin, &tMax));
+		benchmark::DoNotOptimize(tMin);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_line_aabb);
+
+static void BM_aabb_triangle(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	std::vector<AabbTriangleInput> inputs;
+	inputs.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i) {
+		auto [min, max] = bench::random_aabb(10.f, 5.f);
+		inputs.push_back({min, max, random_triangle(10.f, 5.f)});
+	}
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto &in = bench::next_input(inputs, idx);
+		benchmark::DoNotOptimize(pragma::math::intersection::aabb_triangle(in.min, in.max, in.tri.v0, in.tri.v1, in.tri.v2));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_aabb_triangle);
+
+static void BM_line_triangle(benchmark::State &state)
+{
+	auto cull = state.range(0) != 0;
+	bench::reset_random_generator();
+	std::vector<RayTriangleInput> inputs;
+	inputs.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i) {
+		auto tri = random_triangle(10.f, 5.f);
+		auto origin = bench::random_vector(-20.f, 20.f);
+		// Aim roughly at the triangle, so that both hits and misses are measured
+		auto target = (tri.v0 + tri.v1 + tri.v2) / 3.f + bench::random_vector(-3.f, 3.f);
+		inputs.push_back({origin, uvec::get_normal(target - origin), tri});
+	}
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto &in = bench::next_input(inputs, idx);
+		double t, u, v;
+		benchmark::DoNotOptimize(pragma::math::intersection::line_triangle(in.origin, in.dir, in.tri.v0, in.tri.v1, in.tri.v2, t, u, v, cull));
+		benchmark::DoNotOptimize(t);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_line_triangle)->Arg(0)->Arg(1);
+
+static void BM_aabb_in_plane_mesh(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	// Six planes of a view-frustum-like volume
+	auto planes = pragma::math::geometry::get_obb_planes(Vector3 {}, bench::random_rotation(), Vector3 {-50.f, -30.f, -80.f}, Vector3 {50.f, 30.f, 80.f});
+	std::vector<std::pair<Vector3, Vector3>> inputs;
+	inputs.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i)
+		inputs.push_back(bench::random_aabb(150.f, 10.f));
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto &in = bench::next_input(inputs, idx);
+		benchmark::DoNotOptimize(pragma::math::intersection::aabb_in_plane_mesh(in.first, in.second, planes.begin(), planes.end()));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_aabb_in_plane_mesh);
+
+static void BM_aabb_in_plane_mesh_plane_set(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	auto planes = pragma::math::geometry::get_obb_planes(Vector3 {}, bench::random_rotation(), Vector3 {-50.f, -30.f, -80.f}, Vector3 {50.f, 30.f, 80.f});
+	pragma::math::PlaneSet planeSet {planes.begin(), planes.end()};
+	std::vector<std::pair<Vector3, Vector3>> inputs;
+	inputs.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i)
+		inputs.push_back(bench::random_aabb(150.f, 10.f));
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto &in = bench::next_input(inputs, idx);
+		benchmark::DoNotOptimize(pragma::math::intersection::aabb_in_plane_mesh(in.first, in.second, planeSet));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_aabb_in_plane_mesh_plane_set);
+
+static void generate_triangle_mesh(size_t numTris, std::vector<Vector3> &outVerts, std::vector<uint32_t> &outTris)
+{
+	outVerts.clear();
+	outTris.clear();
+	for(auto i = decltype(numTris) {0u}; i < numTris; ++i) {
+		auto tri = random_triangle(150.f, 10.f);
+		for(auto &v : {tri.v0, tri.v1, tri.v2}) {
+			outTris.push_back(static_cast<uint32_t>(outVerts.size()));
+			outVerts.push_back(v);
+		}
+	}
+}
+
+static void BM_triangle_in_plane_mesh_scalar_loop(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	auto planes = pragma::math::geometry::get_obb_planes(Vector3 {}, bench::random_rotation(), Vector3 {-50.f, -30.f, -80.f}, Vector3 {50.f, 30.f, 80.f});
+	std::vector<Vector3> verts;
+	std::vector<uint32_t> tris;
+	generate_triangle_mesh(state.range(0), verts, tris);
+	std::vector<pragma::math::intersection::Intersect> results(tris.size() / 3);
+	for(auto _ : state) {
+		for(size_t i = 0; i < results.size(); ++i)
+			results[i] = pragma::math::intersection::triangle_in_plane_mesh(verts[tris[i * 3]], verts[tris[i * 3 + 1]], verts[tris[i * 3 + 2]], planes.begin(), planes.end());
+		benchmark::DoNotOptimize(results.data());
+	}
+	state.SetItemsProcessed(state.iterations() * results.size());
+}
+BENCHMARK(BM_triangle_in_plane_mesh_scalar_loop)->Arg(1'024)->Arg(32'768);
+
+static void BM_triangle_in_plane_mesh_batch(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	auto planes = pragma::math::geometry::get_obb_planes(Vector3 {}, bench::random_rotation(), Vector3 {-50.f, -30.f, -80.f}, Vector3 {50.f, 30.f, 80.f});
+	pragma::math::PlaneSet planeSet {planes.begin(), planes.end()};
+	std::vector<Vector3> verts;
+	std::vector<uint32_t> tris;
+	generate_triangle_mesh(state.range(0), verts, tris);
+	std::vector<pragma::math::intersection::Intersect> results(tris.size() / 3);
+	pragma::math::intersection::ClippedTriangleMesh clipped;
+	auto clip = state.range(1) != 0;
+	for(auto _ : state)
+		benchmark::DoNotOptimize(pragma::math::intersection::triangle_in_plane_mesh(verts, tris, planeSet, results.data(), clip ? &clipped : nullptr));
+	state.SetItemsProcessed(state.iterations() * results.size());
+}
+BENCHMARK(BM_triangle_in_plane_mesh_batch)->Args({1'024, 0})->Args({32'768, 0})->Args({32'768, 1});
+
+static pragma::math::SphereSoaBuffer generate_sphere_soa_buffer(size_t count)
+{
+	pragma::math::SphereSoaBuffer spheres;
+	spheres.Reserve(count);
+	for(auto i = decltype(count) {0u}; i < count; ++i)
+		spheres.Add(bench::random_vector(-150.f, 150.f), bench::random_float(0.1f, 10.f));
+	return spheres;
+}
+
+static void BM_sphere_in_plane_mesh_scalar_loop(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	auto count = static_cast<size_t>(state.range(0));
+	auto planes = pragma::math::geometry::get_obb_planes(Vector3 {}, bench::random_rotation(), Vector3 {-50.f, -30.f, -80.f}, Vector3 {50.f, 30.f, 80.f});
+	auto buffer = generate_sphere_soa_buffer(count);
+	std::vector<bounding_volume::Sphere> spheres;
+	spheres.reserve(count);
+	for(auto i = decltype(count) {0u}; i < count; ++i)
+		spheres.push_back(buffer.Get(i));
+	for(auto _ : state) {
+		size_t numVisible = 0;
+		for(auto &sphere : spheres) {
+			if(pragma::math::intersection::sphere_in_plane_mesh(sphere.origin, sphere.radius, planes.begin(), planes.end()) != pragma::math::intersection::Intersect::Outside)
+				++numVisible;
+		}
+		benchmark::DoNotOptimize(numVisible);
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_sphere_in_plane_mesh_scalar_loop)->Arg(1'024)->Arg(32'768);
+
+static void BM_sphere_in_plane_mesh_batch(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	auto count = static_cast<size_t>(state.range(0));
+	auto planes = pragma::math::geometry::get_obb_planes(Vector3 {}, bench::random_rotation(), Vector3 {-50.f, -30.f, -80.f}, Vector3 {50.f, 30.f, 80.f});
+	auto spheres = generate_sphere_soa_buffer(count);
+	std::vector<pragma::math::intersection::Intersect> results(count);
+	auto view = spheres.GetView();
+	for(auto _ : state)
+		benchmark::DoNotOptimize(pragma::math::intersection::sphere_in_plane_mesh(view, planes.data(), planes.size(), results.data()));
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_sphere_in_plane_mesh_batch)->Arg(1'024)->Arg(32'768);
+
+static void BM_obb_obb(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	std::vector<ObbPairInput> inputs;
+	inputs.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i) {
+		auto [minA, maxA] = bench::random_aabb(2.f, 5.f);
+		auto [minB, maxB] = bench::random_aabb(2.f, 5.f);
+		inputs.push_back({bench::random_transform(10.f), bench::random_transform(10.f), minA, maxA, minB, maxB});
+	}
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto &in = bench::next_input(inputs, idx);
+		benchmark::DoNotOptimize(pragma::math::intersection::obb_obb(in.poseA, in.minA, in.maxA, in.poseB, in.minB, in.maxB));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_obb_obb);
+
+static std::vector<pragma::math::intersection::OrientedBox> generate_oriented_boxes(size_t count)
+{
+	std::vector<pragma::math::intersection::OrientedBox> boxes;
+	boxes.reserve(count);
+	for(auto i = decltype(count) {0u}; i < count; ++i) {
+		auto [min, max] = bench::random_aabb(2.f, 5.f);
+		boxes.push_back(pragma::math::intersection::get_oriented_box(bench::random_transform(10.f), min, max));
+	}
+	return boxes;
+}
+
+static void BM_obb_obb_oriented_box(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	auto boxes = generate_oriented_boxes(bench::NUM_INPUTS * 2);
+	size_t idx = 0;
+	for(auto _ : state) {
+		idx = (idx + 2) % boxes.size();
+		benchmark::DoNotOptimize(pragma::math::intersection::obb_obb(boxes[idx], boxes[idx + 1]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_obb_obb_oriented_box);
+
+static void BM_obb_obb_batch(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	auto count = static_cast<size_t>(state.range(0));
+	pragma::math::ObbSoaBuffer boxes {generate_oriented_boxes(count)};
+	auto [min, max] = bench::random_aabb(2.f, 5.f);
+	auto obb = pragma::math::intersection::get_oriented_box(bench::random_transform(10.f), min, max);
+	std::vector<pragma::math::intersection::Intersect> results(count);
+	auto view = boxes.GetView();
+	for(auto _ : state)
+		benchmark::DoNotOptimize(pragma::math::intersection::obb_obb(view, obb, results.data()));
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_obb_obb_batch)->Arg(1'024)->Arg(32'768);
+
+static pragma::math::AabbSoaBuffer generate_aabb_soa_buffer(size_t count)
+{
+	pragma::math::AabbSoaBuffer boxes;
+	boxes.Reserve(count);
+	for(auto i = decltype(count) {0u}; i < count; ++i) {
+		auto [min, max] = bench::random_aabb(100.f, 5.f);
+		boxes.Add(min, max);
+	}
+	return boxes;
+}
+
+static void BM_line_aabb_scalar_loop(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	auto count = static_cast<size_t>(state.range(0));
+	auto boxes = generate_aabb_soa_buffer(count);
+	std::vector<bounding_volume::AABB> aabbs;
+	aabbs.reserve(count);
+	for(auto i = decltype(count) {0u}; i < count; ++i)
+		aabbs.push_back(boxes.Get(i));
+	auto origin = bench::random_vector(-100.f, 100.f);
+	auto dir = bench::random_direction() * 200.f;
+	for(auto _ : state) {
+		size_t numHits = 0;
+		for(auto &aabb : aabbs) {
+			float tMin, tMax;
+			if(pragma::math::intersection::line_aabb(origin, dir, aabb.min, aabb.max, &tMin, &tMax) == pragma::math::intersection::Result::Intersect)
+				++numHits;
+		}
+		benchmark::DoNotOptimize(numHits);
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_line_aabb_scalar_loop)->Arg(1'024)->Arg(32'768);
+
+static void BM_line_aabb_batch(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	auto count = static_cast<size_t>(state.range(0));
+	auto boxes = generate_aabb_soa_buffer(count);
+	pragma::math::intersection::Ray ray {bench::random_vector(-100.f, 100.f), bench::random_direction() * 200.f};
+	std::vector<uint32_t> hitMask(pragma::math::intersection::get_hit_mask_size(count));
+	std::vector<float> tMin(count);
+	std::vector<float> tMax(count);
+	auto view = boxes.GetView();
+	for(auto _ : state)
+		benchmark::DoNotOptimize(pragma::math::intersection::line_aabb(ray, view, hitMask.data(), tMin.data(), tMax.data()));
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_line_aabb_batch)->Arg(1'024)->Arg(32'768);
+
+static void generate_ray_packet_scene(size_t numTris, size_t numRays, std::vector<Vector3> &outVerts, std::vector<uint32_t> &outTris, std::vector<Vector3> &outOrigins, std::vector<Vector3> &outDirs)
+{
+	bench::reset_random_generator();
+	outVerts.reserve(numTris * 3);
+	outTris.reserve(numTris * 3);
+	for(auto i = decltype(numTris) {0u}; i < numTris; ++i) {
+		auto tri = random_triangle(20.f, 2.f);
+		for(auto &v : {tri.v0, tri.v1, tri.v2}) {
+			outTris.push_back(static_cast<uint32_t>(outVerts.size()));
+			outVerts.push_back(v);
+		}
+	}
+	// Coherent rays, as they would be produced by a lightmap texel or a line-of-sight fan
+	auto origin = bench::random_vector(-30.f, -25.f);
+	auto baseDir = uvec::get_normal(-origin);
+	outOrigins.reserve(numRays);
+	outDirs.reserve(numRays);
+	for(auto i = decltype(numRays) {0u}; i < numRays; ++i) {
+		outOrigins.push_back(origin + bench::random_vector(-0.5f, 0.5f));
+		outDirs.push_back(uvec::get_normal(baseDir + bench::random_vector(-0.2f, 0.2f)));
+	}
+}
+
+static void BM_line_triangle_scalar_loop(benchmark::State &state)
+{
+	std::vector<Vector3> verts, origins, dirs;
+	std::vector<uint32_t> tris;
+	generate_ray_packet_scene(state.range(0), 64, verts, tris, origins, dirs);
+	for(auto _ : state) {
+		for(auto r = decltype(origins.size()) {0u}; r < origins.size(); ++r) {
+			auto tBest = std::numeric_limits<double>::max();
+			for(auto i = decltype(tris.size()) {0u}; i < tris.size(); i += 3) {
+				double t, u, v;
+				if(pragma::math::intersection::line_triangle(origins[r], dirs[r], verts[tris[i]], verts[tris[i + 1]], verts[tris[i + 2]], t, u, v) && t >= 0.0 && t < tBest)
+					tBest = t;
+			}
+			benchmark::DoNotOptimize(tBest);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * origins.size() * (tris.size() / 3));
+}
+BENCHMARK(BM_line_triangle_scalar_loop)->Arg(256)->Arg(4'096);
+
+static void BM_line_triangle_packet(benchmark::State &state)
+{
+	std::vector<Vector3> verts, origins, dirs;
+	std::vector<uint32_t> tris;
+	generate_ray_packet_scene(state.range(0), 64, verts, tris, origins, dirs);
+	pragma::math::TriangleSoaBuffer triBuffer {verts, tris};
+	std::vector<pragma::math::intersection::RayPacketHit> hits(origins.size());
+	auto view = triBuffer.GetView();
+	for(auto _ : state)
+		benchmark::DoNotOptimize(pragma::math::intersection::line_triangle(origins.data(), dirs.data(), origins.size(), view, hits.data()));
+	state.SetItemsProcessed(state.iterations() * origins.size() * (tris.size() / 3));
+}
+BENCHMARK(BM_line_triangle_packet)->Arg(256)->Arg(4'096);
@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "benchmark/benchmark.h"
+
+int main(int argc, char **argv)
+{
+	// Write the results as JSON by default, so that runs can be diffed across commits
+	std::string outArg = "--benchmark_out=mathutil_bench.json";
+	std::string outFormatArg = "--benchmark_out_format=json";
+	std::vector<char *> args {argv, argv + argc};
+	auto hasOutArg = false;
+	for(auto i = 1; i < argc; ++i) {
+		if(strncmp(argv[i], "--benchmark_out=", 16) == 0)
+			hasOutArg = true;
+	}
+	if(!hasOutArg) {
+		args.push_back(outArg.data());
+		args.push_back(outFormatArg.data());
+	}
+	auto numArgs = static_cast<int>(args.size());
+	::benchmark::Initialize(&numArgs, args.data());
+	if(::benchmark::ReportUnrecognizedArguments(numArgs, args.data()))
+		return 1;
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+	return 0;
+}
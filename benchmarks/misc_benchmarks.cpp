@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "bench_common.hpp"
+
+static void BM_float16_compress(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	std::vector<float> values;
+	values.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i)
+		values.push_back(bench::random_float(-70000.f, 70000.f));
+	size_t idx = 0;
+	for(auto _ : state)
+		benchmark::DoNotOptimize(Float16Compressor::compress(bench::next_input(values, idx)));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_float16_compress);
+
+static void BM_float16_decompress(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	std::vector<uint16_t> values;
+	values.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i)
+		values.push_back(Float16Compressor::compress(bench::random_float(-70000.f, 70000.f)));
+	size_t idx = 0;
+	for(auto _ : state)
+		benchmark::DoNotOptimize(Float16Compressor::decompress(bench::next_input(values, idx)));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_float16_decompress);
+
+static void BM_perlin_noise(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	pragma::math::PerlinNoise noise {bench::SEED};
+	std::vector<Vector3> points;
+	points.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i)
+		points.push_back(bench::random_vector(-256.f, 256.f));
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto &p = bench::next_input(points, idx);
+		benchmark::DoNotOptimize(noise.GetNoise(p.x, p.y, p.z));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_perlin_noise);
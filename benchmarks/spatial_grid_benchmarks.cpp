@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "bench_common.hpp"
+
+namespace {
+	// Particle-like distribution with an average of ~2 points per unit cube
+	std::vector<Vector3> generate_points(size_t count)
+	{
+		bench::reset_random_generator();
+		auto range = std::cbrt(static_cast<float>(count) / 2.f) * 0.5f;
+		std::vector<Vector3> points;
+		points.reserve(count);
+		for(size_t i = 0; i < count; ++i)
+			points.push_back(bench::random_vector(-range, range));
+		return points;
+	}
+};
+
+// Second argument is the thread count, where 0 uses all hardware threads
+static void BM_spatial_grid_build(benchmark::State &state)
+{
+	auto points = generate_points(state.range(0));
+	pragma::math::SpatialHashGrid grid {1.f};
+	auto threadCount = static_cast<uint32_t>(state.range(1));
+	for(auto _ : state) {
+		grid.Build(points, threadCount);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_spatial_grid_build)->Args({16'384, 1})->Args({262'144, 1})->Args({262'144, 0})->Args({4'194'304, 1})->Args({4'194'304, 0})->Unit(benchmark::kMicrosecond);
+
+static void BM_spatial_grid_radius(benchmark::State &state)
+{
+	auto points = generate_points(state.range(0));
+	pragma::math::SpatialHashGrid grid {1.f};
+	grid.Build(points);
+	std::vector<uint32_t> result;
+	size_t i = 0;
+	for(auto _ : state) {
+		result.clear();
+		grid.FindPointsInRadius(bench::next_input(points, i), 1.f, result);
+		benchmark::DoNotOptimize(result.data());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_spatial_grid_radius)->Arg(16'384)->Arg(262'144);
+
+// Reference for BM_spatial_grid_radius, testing every point
+static void BM_spatial_grid_radius_brute_force(benchmark::State &state)
+{
+	auto points = generate_points(state.range(0));
+	std::vector<uint32_t> result;
+	size_t i = 0;
+	for(auto _ : state) {
+		result.clear();
+		auto &origin = bench::next_input(points, i);
+		for(uint32_t j = 0; j < points.size(); ++j) {
+			if(uvec::length_sqr(points[j] - origin) <= 1.f)
+				result.push_back(j);
+		}
+		benchmark::DoNotOptimize(result.data());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_spatial_grid_radius_brute_force)->Arg(16'384);
+
+static void BM_spatial_grid_k_nearest(benchmark::State &state)
+{
+	auto points = generate_points(262'144);
+	pragma::math::SpatialHashGrid grid {1.f};
+	grid.Build(points);
+	std::vector<uint32_t> result;
+	auto k = static_cast<uint32_t>(state.range(0));
+	size_t i = 0;
+	for(auto _ : state) {
+		grid.FindKNearest(bench::next_input(points, i), k, result);
+		benchmark::DoNotOptimize(result.data());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_spatial_grid_k_nearest)->Arg(1)->Arg(8)->Arg(32);
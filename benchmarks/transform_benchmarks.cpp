@@ -0,0 +1,322 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "bench_common.hpp"
+
+static std::vector<pragma::math::ScaledTransform> generate_transforms()
+{
+	bench::reset_random_generator();
+	std::vector<pragma::math::ScaledTransform> transforms;
+	transforms.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i)
+		transforms.push_back(bench::random_transform(100.f));
+	return transforms;
+}
+
+static void BM_scaled_transform_multiply(benchmark::State &state)
+{
+	auto transforms = generate_transforms();
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto &a = bench::next_input(transforms, idx);
+		auto &b = bench::next_input(transforms, idx);
+		benchmark::DoNotOptimize(a * b);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_scaled_transform_multiply);
+
+static void BM_scaled_transform_inverse(benchmark::State &state)
+{
+	auto transforms = generate_transforms();
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto &t = bench::next_input(transforms, idx);
+		benchmark::DoNotOptimize(t.GetInverse());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_scaled_transform_inverse);
+
+static void BM_scaled_transform_point(benchmark::State &state)
+{
+	auto transforms = generate_transforms();
+	bench::reset_random_generator();
+	std::vector<Vector3> points;
+	points.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i)
+		points.push_back(bench::random_vector(-10.f, 10.f));
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto &t = transforms[idx & (bench::NUM_INPUTS - 1)];
+		auto &p = bench::next_input(points, idx);
+		benchmark::DoNotOptimize(t * p);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_scaled_transform_point);
+
+static void BM_quat_slerp(benchmark::State &state)
+{
+	bench::reset_random_generator();
+	std::vector<Quat> rotations;
+	std::vector<float> factors;
+	rotations.reserve(bench::NUM_INPUTS);
+	factors.reserve(bench::NUM_INPUTS);
+	for(auto i = decltype(bench::NUM_INPUTS) {0u}; i < bench::NUM_INPUTS; ++i) {
+		rotations.push_back(bench::random_rotation());
+		factors.push_back(bench::random_float(0.f, 1.f));
+	}
+	size_t idx = 0;
+	for(auto _ : state) {
+		auto f = factors[idx & (bench::NUM_INPUTS - 1)];
+		auto &q0 = bench::next_input(rotations, idx);
+		auto &q1 = bench::next_input(rotations, idx);
+		benchmark::DoNotOptimize(uquat::slerp(q0, q1, f));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_quat_slerp);
+
+static std::vector<pragma::math::ScaledTransform> generate_transforms(size_t count)
+{
+	bench::reset_random_generator();
+	std::vector<pragma::math::ScaledTransform> transforms;
+	transforms.reserve(count);
+	for(size_t i = 0; i < count; ++i)
+		transforms.push_back(bench::random_transform(100.f));
+	return transforms;
+}
+
+static void BM_scaled_transform_multiply_scalar_loop(benchmark::State &state)
+{
+	auto a = generate_transforms(state.range(0));
+	auto b = a;
+	std::reverse(b.begin(), b.end());
+	std::vector<pragma::math::ScaledTransform> out(a.size());
+	for(auto _ : state) {
+		for(size_t i = 0; i < a.size(); ++i)
+			out[i] = a[i] * b[i];
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_scaled_transform_multiply_scalar_loop)->Arg(1'024)->Arg(131'072);
+
+static void BM_scaled_transform_buffer_multiply(benchmark::State &state)
+{
+	auto transforms = generate_transforms(state.range(0));
+	pragma::math::ScaledTransformBuffer a {transforms};
+	std::reverse(transforms.begin(), transforms.end());
+	pragma::math::ScaledTransformBuffer b {transforms};
+	pragma::math::ScaledTransformBuffer out;
+	for(auto _ : state) {
+		pragma::math::ScaledTransformBuffer::Multiply(a, b, out);
+		benchmark::DoNotOptimize(out.GetTranslation(0));
+	}
+	state.SetItemsProcessed(state.iterations() * a.Size());
+}
+BENCHMARK(BM_scaled_transform_buffer_multiply)->Arg(1'024)->Arg(131'072);
+
+static void BM_scaled_transform_buffer_inverse(benchmark::State &state)
+{
+	pragma::math::ScaledTransformBuffer transforms {generate_transforms(state.range(0))};
+	pragma::math::ScaledTransformBuffer out;
+	for(auto _ : state) {
+		pragma::math::ScaledTransformBuffer::Invert(transforms, out);
+		benchmark::DoNotOptimize(out.GetTranslation(0));
+	}
+	state.SetItemsProcessed(state.iterations() * transforms.Size());
+}
+BENCHMARK(BM_scaled_transform_buffer_inverse)->Arg(131'072);
+
+static void BM_scaled_transform_buffer_to_matrices(benchmark::State &state)
+{
+	pragma::math::ScaledTransformBuffer transforms {generate_transforms(state.range(0))};
+	std::vector<Mat4> matrices(transforms.Size());
+	for(auto _ : state) {
+		transforms.ToMatrices(matrices.data());
+		benchmark::DoNotOptimize(matrices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * transforms.Size());
+}
+BENCHMARK(BM_scaled_transform_buffer_to_matrices)->Arg(131'072);
+
+static void BM_scaled_transform_buffer_to_affine_matrices(benchmark::State &state)
+{
+	pragma::math::ScaledTransformBuffer transforms {generate_transforms(state.range(0))};
+	std::vector<pragma::math::AffineMatrix> matrices(transforms.Size());
+	for(auto _ : state) {
+		transforms.ToAffineMatrices(matrices.data());
+		benchmark::DoNotOptimize(matrices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * transforms.Size());
+}
+BENCHMARK(BM_scaled_transform_buffer_to_affine_matrices)->Arg(131'072);
+
+static void BM_mat4_multiply_loop(benchmark::State &state)
+{
+	auto transforms = generate_transforms(state.range(0));
+	std::vector<Mat4> a;
+	a.reserve(transforms.size());
+	for(auto &t : transforms)
+		a.push_back(t.ToMatrix());
+	auto b = a;
+	std::reverse(b.begin(), b.end());
+	std::vector<Mat4> out(a.size());
+	for(auto _ : state) {
+		for(size_t i = 0; i < a.size(); ++i)
+			out[i] = a[i] * b[i];
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_mat4_multiply_loop)->Arg(1'024)->Arg(131'072);
+
+static void BM_affine_matrix_multiply(benchmark::State &state)
+{
+	auto transforms = generate_transforms(state.range(0));
+	std::vector<pragma::math::AffineMatrix> a;
+	a.reserve(transforms.size());
+	for(auto &t : transforms)
+		a.push_back(pragma::math::AffineMatrix {t});
+	auto b = a;
+	std::reverse(b.begin(), b.end());
+	std::vector<pragma::math::AffineMatrix> out(a.size());
+	for(auto _ : state) {
+		pragma::math::AffineMatrix::Multiply(a.data(), b.data(), out.data(), a.size());
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_affine_matrix_multiply)->Arg(1'024)->Arg(131'072);
+
+static void BM_affine_matrix_transform_points(benchmark::State &state)
+{
+	pragma::math::AffineMatrix m {bench::random_transform(100.f)};
+	bench::reset_random_generator();
+	std::vector<Vector3> points;
+	points.reserve(state.range(0));
+	for(auto i = decltype(state.range(0)) {0}; i < state.range(0); ++i)
+		points.push_back(bench::random_vector(-10.f, 10.f));
+	std::vector<Vector3> out(points.size());
+	for(auto _ : state) {
+		m.TransformPoints(points.data(), out.data(), points.size());
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_affine_matrix_transform_points)->Arg(131'072);
+
+// Arg 0 is the number of skeletons with 64 bones each, Arg 1 the thread count (0 for the serial update)
+static void BM_transform_hierarchy_update(benchmark::State &state)
+{
+	constexpr uint32_t numBones = 64;
+	auto numSkeletons = static_cast<uint32_t>(state.range(0));
+	auto threadCount = static_cast<uint32_t>(state.range(1));
+	auto locals = generate_transforms(numSkeletons * numBones);
+	pragma::math::TransformHierarchy hierarchy;
+	for(uint32_t i = 0; i < numSkeletons; ++i) {
+		auto root = hierarchy.AddNode(pragma::math::TransformHierarchy::INVALID_INDEX);
+		// Chains of up to four bones
+		for(uint32_t j = 1; j < numBones; ++j)
+			hierarchy.AddNode((j % 4 == 1) ? root : hierarchy.GetNodeCount() - 1);
+	}
+	for(auto _ : state) {
+		hierarchy.SetLocalTransforms(locals);
+		benchmark::DoNotOptimize((threadCount == 0) ? hierarchy.Update() : hierarchy.UpdateParallel(threadCount));
+	}
+	state.SetItemsProcessed(state.iterations() * hierarchy.GetNodeCount());
+}
+BENCHMARK(BM_transform_hierarchy_update)->Args({2'048, 0})->Args({2'048, 1})->Args({2'048, 4})->Unit(benchmark::kMicrosecond);
+
+// Only one bone per skeleton changes per update
+static void BM_transform_hierarchy_update_sparse(benchmark::State &state)
+{
+	constexpr uint32_t numBones = 64;
+	auto numSkeletons = static_cast<uint32_t>(state.range(0));
+	auto locals = generate_transforms(numSkeletons * numBones);
+	pragma::math::TransformHierarchy hierarchy;
+	for(uint32_t i = 0; i < numSkeletons; ++i) {
+		auto root = hierarchy.AddNode(pragma::math::TransformHierarchy::INVALID_INDEX);
+		for(uint32_t j = 1; j < numBones; ++j)
+			hierarchy.AddNode((j % 4 == 1) ? root : hierarchy.GetNodeCount() - 1);
+	}
+	hierarchy.SetLocalTransforms(locals);
+	hierarchy.Update();
+	uint32_t frame = 0;
+	for(auto _ : state) {
+		auto bone = ++frame % numBones;
+		for(uint32_t i = 0; i < numSkeletons; ++i)
+			hierarchy.SetLocalTransform(i * numBones + bone, locals[i * numBones + bone]);
+		benchmark::DoNotOptimize(hierarchy.Update());
+	}
+	state.SetItemsProcessed(state.iterations() * numSkeletons);
+}
+BENCHMARK(BM_transform_hierarchy_update_sparse)->Arg(2'048)->Unit(benchmark::kMicrosecond);
+
+// Four influences per vertex
+static void generate_skinned_vertices(size_t numVerts, uint32_t numBones, std::vector<pragma::math::Vertex> &outVerts, std::vector<pragma::math::VertexWeight> &outWeights)
+{
+	bench::reset_random_generator();
+	outVerts.clear();
+	outWeights.clear();
+	outVerts.reserve(numVerts);
+	outWeights.reserve(numVerts);
+	auto bone = [numBones] { return static_cast<int32_t>(bench::random_float(0.f, static_cast<float>(numBones))) % static_cast<int32_t>(numBones); };
+	for(size_t i = 0; i < numVerts; ++i) {
+		auto tangent = bench::random_direction();
+		outVerts.push_back({bench::random_vector(-10.f, 10.f), Vector2 {}, bench::random_direction(), Vector4 {tangent, 1.f}});
+		outWeights.push_back({Vector4i {bone(), bone(), bone(), bone()}, Vector4 {0.4f, 0.3f, 0.2f, 0.1f}});
+	}
+}
+
+// Arg 0 is the number of vertices, skinned to 64 bones, Arg 1 the thread count
+static void BM_skinning_dual_quaternion(benchmark::State &state)
+{
+	constexpr uint32_t numBones = 64;
+	auto numVerts = static_cast<size_t>(state.range(0));
+	auto threadCount = static_cast<uint32_t>(state.range(1));
+	std::vector<pragma::math::DualQuat> bones;
+	bones.reserve(numBones);
+	for(auto &t : generate_transforms(numBones))
+		bones.push_back(pragma::math::DualQuat {t});
+	std::vector<pragma::math::Vertex> verts;
+	std::vector<pragma::math::VertexWeight> weights;
+	generate_skinned_vertices(numVerts, numBones, verts, weights);
+	std::vector<Vector3> positions(numVerts);
+	std::vector<Vector3> normals(numVerts);
+	for(auto _ : state) {
+		pragma::math::skinning::dual_quaternion(bones.data(), numBones, verts.data(), weights.data(), numVerts, positions.data(), normals.data(), nullptr, threadCount);
+		benchmark::DoNotOptimize(positions.data());
+		benchmark::DoNotOptimize(normals.data());
+	}
+	state.SetItemsProcessed(state.iterations() * numVerts);
+}
+BENCHMARK(BM_skinning_dual_quaternion)->Args({65'536, 1})->Args({65'536, 4})->Unit(benchmark::kMicrosecond);
+
+static void BM_skinning_linear_blend(benchmark::State &state)
+{
+	constexpr uint32_t numBones = 64;
+	auto numVerts = static_cast<size_t>(state.range(0));
+	auto threadCount = static_cast<uint32_t>(state.range(1));
+	std::vector<Mat4> bones;
+	bones.reserve(numBones);
+	for(auto &t : generate_transforms(numBones))
+		bones.push_back(t.ToMatrix());
+	std::vector<pragma::math::Vertex> verts;
+	std::vector<pragma::math::VertexWeight> weights;
+	generate_skinned_vertices(numVerts, numBones, verts, weights);
+	std::vector<Vector3> positions(numVerts);
+	std::vector<Vector3> normals(numVerts);
+	std::vector<Vector4> tangents(numVerts);
+	for(auto _ : state) {
+		pragma::math::skinning::linear_blend(bones.data(), numBones, verts.data(), weights.data(), numVerts, positions.data(), normals.data(), tangents.data(), threadCount);
+		benchmark::DoNotOptimize(positions.data());
+		benchmark::DoNotOptimize(normals.data());
+		benchmark::DoNotOptimize(tangents.data());
+	}
+	state.SetItemsProcessed(state.iterations() * numVerts);
+}
+BENCHMARK(BM_skinning_linear_blend)->Args({65'536, 1})->Args({65'536, 4})->Unit(benchmark::kMicrosecond);
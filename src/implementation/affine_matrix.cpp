@@ -0,0 +1,235 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+#include "simd.hpp"
+
+module pragma.math;
+
+import :affine_matrix;
+
+namespace {
+	using vfloat = pragma::math::simd::vfloat;
+	using Vec3Lanes = std::array<vfloat, 3>;
+	// Row-major elements of the three rows
+	using AffineLanes = std::array<vfloat, 12>;
+	constexpr uint32_t BATCH_SIZE = pragma::math::simd::width;
+
+	// Rows of translation * rotation * scale, same as ScaledTransform::ToMatrix
+	Mat3x4 to_rows(const Vector3 &translation, const Quat &q, const Vector3 &scale)
+	{
+		auto xx = q.x * q.x;
+		auto yy = q.y * q.y;
+		auto zz = q.z * q.z;
+		auto xz = q.x * q.z;
+		auto xy = q.x * q.y;
+		auto yz = q.y * q.z;
+		auto wx = q.w * q.x;
+		auto wy = q.w * q.y;
+		auto wz = q.w * q.z;
+		return {
+		  Vector4 {(1.f - 2.f * (yy + zz)) * scale.x, 2.f * (xy - wz) * scale.y, 2.f * (xz + wy) * scale.z, translation.x},
+		  Vector4 {2.f * (xy + wz) * scale.x, (1.f - 2.f * (xx + zz)) * scale.y, 2.f * (yz - wx) * scale.z, translation.y},
+		  Vector4 {2.f * (xz - wy) * scale.x, 2.f * (yz + wx) * scale.y, (1.f - 2.f * (xx + yy)) * scale.z, translation.z},
+		};
+	}
+
+	// Inverse of a matrix with orthogonal basis vectors b, whose squared lengths are lenSqr: B^-1 = S^-1 * R^T = S^-2 * B^T
+	Mat3x4 orthogonal_inverse(const Mat3x4 &rows, const Vector3 &lenSqr)
+	{
+		Mat3x4 inv;
+		for(uint8_t c = 0; c < 3; ++c) {
+			Vector3 row = Vector3 {rows[0][c], rows[1][c], rows[2][c]} / lenSqr[c];
+			inv[c] = Vector4 {row, -glm::dot(row, Vector3 {rows[0].w, rows[1].w, rows[2].w})};
+		}
+		return inv;
+	}
+
+	void load_matrices(const pragma::math::AffineMatrix *matrices, size_t offset, uint32_t n, float (&staging)[12][BATCH_SIZE], AffineLanes &outLanes)
+	{
+		using namespace pragma::math::simd;
+		for(uint32_t j = 0; j < n; ++j) {
+			auto &rows = matrices[offset + j].GetRows();
+			for(uint8_t k = 0; k < 12; ++k)
+				staging[k][j] = rows[k / 4][k % 4];
+		}
+		for(uint8_t k = 0; k < 12; ++k)
+			outLanes[k] = load(staging[k]);
+	}
+	void store_matrices(pragma::math::AffineMatrix *matrices, size_t offset, uint32_t n, float (&staging)[12][BATCH_SIZE], const AffineLanes &lanes)
+	{
+		using namespace pragma::math::simd;
+		for(uint8_t k = 0; k < 12; ++k)
+			store(staging[k], lanes[k]);
+		for(uint32_t j = 0; j < n; ++j) {
+			Mat3x4 rows;
+			for(uint8_t k = 0; k < 12; ++k)
+				rows[k / 4][k % 4] = staging[k][j];
+			matrices[offset + j] = rows;
+		}
+	}
+	AffineLanes broadcast(const pragma::math::AffineMatrix &m)
+	{
+		using namespace pragma::math::simd;
+		AffineLanes lanes;
+		auto &rows = m.GetRows();
+		for(uint8_t k = 0; k < 12; ++k)
+			lanes[k] = set1(rows[k / 4][k % 4]);
+		return lanes;
+	}
+	// Lanes that were not loaded contain undefined values, the results of those lanes are never stored
+	AffineLanes multiply(const AffineLanes &a, const AffineLanes &b)
+	{
+		using namespace pragma::math::simd;
+		AffineLanes result;
+		for(uint8_t r = 0; r < 3; ++r) {
+			auto *ra = &a[r * 4];
+			for(uint8_t c = 0; c < 4; ++c) {
+				auto v = fmadd(ra[0], b[c], fmadd(ra[1], b[4 + c], ra[2] * b[8 + c]));
+				result[r * 4 + c] = (c == 3) ? (v + ra[3]) : v;
+			}
+		}
+		return result;
+	}
+
+	template<bool POINTS>
+	void transform_vectors(const pragma::math::AffineMatrix &m, const Vector3 *in, Vector3 *out, size_t count)
+	{
+		using namespace pragma::math::simd;
+		alignas(64) float coords[3][BATCH_SIZE] = {};
+		auto lanes = broadcast(m);
+		for(size_t i = 0; i < count; i += BATCH_SIZE) {
+			auto n = static_cast<uint32_t>(std::min<size_t>(BATCH_SIZE, count - i));
+			for(uint32_t j = 0; j < n; ++j) {
+				for(uint8_t c = 0; c < 3; ++c)
+					coords[c][j] = in[i + j][c];
+			}
+			Vec3Lanes v {load(coords[0]), load(coords[1]), load(coords[2])};
+			for(uint8_t r = 0; r < 3; ++r) {
+				auto *row = &lanes[r * 4];
+				auto res = fmadd(row[0], v[0], fmadd(row[1], v[1], row[2] * v[2]));
+				if constexpr(POINTS)
+					res = res + row[3];
+				store(coords[r], res);
+			}
+			for(uint32_t j = 0; j < n; ++j)
+				out[i + j] = {coords[0][j], coords[1][j], coords[2][j]};
+		}
+	}
+};
+
+pragma::math::AffineMatrix::AffineMatrix(const Mat3 &basis, const Vector3 &translation)
+{
+	for(uint8_t r = 0; r < 3; ++r)
+		m_rows[r] = {basis[0][r], basis[1][r], basis[2][r], translation[r]};
+}
+
+pragma::math::AffineMatrix::AffineMatrix(const Mat4 &m)
+{
+	for(uint8_t r = 0; r < 3; ++r)
+		m_rows[r] = {m[0][r], m[1][r], m[2][r], m[3][r]};
+}
+
+pragma::math::AffineMatrix::AffineMatrix(const Transform &t) : m_rows {to_rows(t.GetOrigin(), t.GetRotation(), Vector3 {1.f, 1.f, 1.f})} {}
+
+pragma::math::AffineMatrix::AffineMatrix(const ScaledTransform &t) : m_rows {to_rows(t.GetOrigin(), t.GetRotation(), t.GetScale())} {}
+
+Mat3 pragma::math::AffineMatrix::GetBasis() const
+{
+	Mat3 basis;
+	for(uint8_t c = 0; c < 3; ++c)
+		basis[c] = {m_rows[0][c], m_rows[1][c], m_rows[2][c]};
+	return basis;
+}
+
+void pragma::math::AffineMatrix::SetTranslation(const Vector3 &translation)
+{
+	for(uint8_t r = 0; r < 3; ++r)
+		m_rows[r].w = translation[r];
+}
+
+Mat4 pragma::math::AffineMatrix::ToMatrix() const
+{
+	Mat4 m {1.f};
+	for(uint8_t c = 0; c < 4; ++c) {
+		for(uint8_t r = 0; r < 3; ++r)
+			m[c][r] = m_rows[r][c];
+	}
+	return m;
+}
+
+pragma::math::AffineMatrix pragma::math::AffineMatrix::GetInverse() const
+{
+	auto invBasis = glm::inverse(GetBasis());
+	return {invBasis, -(invBasis * GetTranslation())};
+}
+
+pragma::math::AffineMatrix pragma::math::AffineMatrix::GetOrthogonalInverse() const
+{
+	Vector3 lenSqr;
+	for(uint8_t c = 0; c < 3; ++c)
+		lenSqr[c] = m_rows[0][c] * m_rows[0][c] + m_rows[1][c] * m_rows[1][c] + m_rows[2][c] * m_rows[2][c];
+	return orthogonal_inverse(m_rows, lenSqr);
+}
+
+pragma::math::AffineMatrix pragma::math::AffineMatrix::GetRigidInverse() const { return orthogonal_inverse(m_rows, Vector3 {1.f, 1.f, 1.f}); }
+
+Vector3 pragma::math::AffineMatrix::TransformPoint(const Vector3 &p) const
+{
+	Vector4 v {p, 1.f};
+	return {glm::dot(m_rows[0], v), glm::dot(m_rows[1], v), glm::dot(m_rows[2], v)};
+}
+
+Vector3 pragma::math::AffineMatrix::TransformDirection(const Vector3 &dir) const
+{
+	Vector4 v {dir, 0.f};
+	return {glm::dot(m_rows[0], v), glm::dot(m_rows[1], v), glm::dot(m_rows[2], v)};
+}
+
+pragma::math::AffineMatrix pragma::math::AffineMatrix::operator*(const AffineMatrix &other) const
+{
+	auto res = *this;
+	res *= other;
+	return res;
+}
+
+pragma::math::AffineMatrix &pragma::math::AffineMatrix::operator*=(const AffineMatrix &other)
+{
+	auto &b = other.m_rows;
+	Mat3x4 rows;
+	for(uint8_t r = 0; r < 3; ++r) {
+		auto &a = m_rows[r];
+		rows[r] = a.x * b[0] + a.y * b[1] + a.z * b[2] + Vector4 {0.f, 0.f, 0.f, a.w};
+	}
+	m_rows = rows;
+	return *this;
+}
+
+void pragma::math::AffineMatrix::TransformPoints(const Vector3 *points, Vector3 *outPoints, size_t count) const { transform_vectors<true>(*this, points, outPoints, count); }
+
+void pragma::math::AffineMatrix::TransformDirections(const Vector3 *dirs, Vector3 *outDirs, size_t count) const { transform_vectors<false>(*this, dirs, outDirs, count); }
+
+void pragma::math::AffineMatrix::Multiply(const AffineMatrix *a, const AffineMatrix *b, AffineMatrix *out, size_t count)
+{
+	alignas(64) float staging[12][BATCH_SIZE] = {};
+	AffineLanes la, lb;
+	for(size_t i = 0; i < count; i += BATCH_SIZE) {
+		auto n = static_cast<uint32_t>(std::min<size_t>(BATCH_SIZE, count - i));
+		load_matrices(a, i, n, staging, la);
+		load_matrices(b, i, n, staging, lb);
+		store_matrices(out, i, n, staging, multiply(la, lb));
+	}
+}
+
+void pragma::math::AffineMatrix::Multiply(const AffineMatrix &parent, const AffineMatrix *b, AffineMatrix *out, size_t count)
+{
+	alignas(64) float staging[12][BATCH_SIZE] = {};
+	auto la = broadcast(parent);
+	AffineLanes lb;
+	for(size_t i = 0; i < count; i += BATCH_SIZE) {
+		auto n = static_cast<uint32_t>(std::min<size_t>(BATCH_SIZE, count - i));
+		load_matrices(b, i, n, staging, lb);
+		store_matrices(out, i, n, staging, multiply(la, lb));
+	}
+}
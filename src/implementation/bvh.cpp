@@ -0,0 +1,667 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+module pragma.math;
+
+import :bvh;
+import :parallel;
+
+namespace {
+	// Subtrees with at most this many triangles are built as a single task by the parallel builder
+	constexpr uint32_t PARALLEL_SUBTREE_SIZE = 4'096;
+	// Nodes with at least this many triangles are binned across all threads
+	constexpr uint32_t PARALLEL_BINNING_SIZE = 65'536;
+	// Trees with fewer nodes are always refitted on the calling thread
+	constexpr uint32_t PARALLEL_REFIT_SIZE = 16'384;
+
+	struct Bounds {
+		Vector3 min {std::numeric_limits<float>::max()};
+		Vector3 max {std::numeric_limits<float>::lowest()};
+		void Grow(const Vector3 &p)
+		{
+			min = glm::min(min, p);
+			max = glm::max(max, p);
+		}
+		void Grow(const Bounds &b)
+		{
+			min = glm::min(min, b.min);
+			max = glm::max(max, b.max);
+		}
+		// Half of the surface area, which is sufficient for the surface area heuristic
+		float GetArea() const
+		{
+			auto e = max - min;
+			if(e.x < 0.f || e.y < 0.f || e.z < 0.f)
+				return 0.f;
+			return e.x * e.y + e.y * e.z + e.z * e.x;
+		}
+	};
+
+	struct BuildContext {
+		std::vector<Bounds> triangleBounds;
+		std::vector<Vector3> centroids;
+		uint32_t maxLeafSize = 4;
+		uint32_t binCount = 16;
+		uint32_t threadCount = 1;
+	};
+
+	enum class SplitType : uint8_t { Leaf = 0, Sah, Median };
+	struct Split {
+		uint32_t axis = 0;
+		uint32_t bin = 0;
+		float centroidMin = 0.f;
+		float scale = 0.f;
+	};
+
+	struct Bin {
+		Bounds bounds {};
+		uint32_t count = 0;
+	};
+	using AxisBins = std::array<std::array<Bin, pragma::math::Bvh::MAX_BIN_COUNT>, 3>;
+
+	uint32_t get_bin_index(const BuildContext &ctx, const Split &split, uint32_t prim) { return std::min(ctx.binCount - 1, static_cast<uint32_t>((ctx.centroids[prim][split.axis] - split.centroidMin) * split.scale)); }
+
+	// Splits the range [0, count) into chunks which are processed in parallel for large ranges, and merges the chunk results in order.
+	// All reductions used by the builder (min, max and integer sums) are exact, so the result does not depend on the number of chunks.
+	template<typename T, typename TProcess, typename TMerge>
+	T reduce_chunks(const BuildContext &ctx, uint32_t count, const TProcess &process, const TMerge &merge)
+	{
+		auto numChunks = (ctx.threadCount > 1 && count >= PARALLEL_BINNING_SIZE) ? ctx.threadCount : 1u;
+		if(numChunks == 1) {
+			T result {};
+			process(0u, count, result);
+			return result;
+		}
+		std::vector<T> chunkResults(numChunks);
+		auto chunkSize = (count + numChunks - 1) / numChunks;
+		pragma::math::parallel::parallel_for(
+		  numChunks,
+		  [&](size_t i) {
+			  auto first = std::min(static_cast<uint32_t>(i) * chunkSize, count);
+			  process(first, std::min(chunkSize, count - first), chunkResults[i]);
+		  },
+		  numChunks);
+		for(uint32_t i = 1; i < numChunks; ++i)
+			merge(chunkResults[0], chunkResults[i]);
+		return std::move(chunkResults[0]);
+	}
+
+	Bounds calc_bounds(const BuildContext &ctx, const uint32_t *prims, uint32_t count)
+	{
+		return reduce_chunks<Bounds>(
+		  ctx, count,
+		  [&ctx, prims](uint32_t first, uint32_t n, Bounds &bounds) {
+			  for(auto i = first; i < first + n; ++i)
+				  bounds.Grow(ctx.triangleBounds[prims[i]]);
+		  },
+		  [](Bounds &a, const Bounds &b) { a.Grow(b); });
+	}
+
+	Bounds calc_centroid_bounds(const BuildContext &ctx, const uint32_t *prims, uint32_t count)
+	{
+		return reduce_chunks<Bounds>(
+		  ctx, count,
+		  [&ctx, prims](uint32_t first, uint32_t n, Bounds &bounds) {
+			  for(auto i = first; i < first + n; ++i)
+				  bounds.Grow(ctx.centroids[prims[i]]);
+		  },
+		  [](Bounds &a, const Bounds &b) { a.Grow(b); });
+	}
+
+	// Finds the best split plane for the primitive range with a binned surface area heuristic
+	SplitType find_split(const BuildContext &ctx, const uint32_t *prims, uint32_t count, const Bounds &nodeBounds, uint32_t depth, Split &outSplit)
+	{
+		if(count <= 1 || depth >= pragma::math::Bvh::MAX_DEPTH - 1)
+			return SplitType::Leaf;
+		auto centroidBounds = calc_centroid_bounds(ctx, prims, count);
+		std::array<Split, 3> axisSplits;
+		for(uint32_t axis = 0; axis < 3; ++axis) {
+			auto extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+			axisSplits[axis] = {axis, 0, centroidBounds.min[axis], (extent > 0.f) ? (static_cast<float>(ctx.binCount) / extent) : 0.f};
+		}
+
+		auto bins = reduce_chunks<AxisBins>(
+		  ctx, count,
+		  [&ctx, prims, &axisSplits](uint32_t first, uint32_t n, AxisBins &bins) {
+			  for(auto i = first; i < first + n; ++i) {
+				  auto prim = prims[i];
+				  for(auto &split : axisSplits) {
+					  if(split.scale == 0.f)
+						  continue;
+					  auto &bin = bins[split.axis][get_bin_index(ctx, split, prim)];
+					  ++bin.count;
+					  bin.bounds.Grow(ctx.triangleBounds[prim]);
+				  }
+			  }
+		  },
+		  [&ctx](AxisBins &a, const AxisBins &b) {
+			  for(uint32_t axis = 0; axis < 3; ++axis) {
+				  for(uint32_t i = 0; i < ctx.binCount; ++i) {
+					  a[axis][i].count += b[axis][i].count;
+					  a[axis][i].bounds.Grow(b[axis][i].bounds);
+				  }
+			  }
+		  });
+
+		std::array<float, pragma::math::Bvh::MAX_BIN_COUNT> rightCost;
+		auto bestCost = std::numeric_limits<float>::max();
+		auto hasSplit = false;
+		for(auto &split : axisSplits) {
+			if(split.scale == 0.f)
+				continue;
+			auto &axisBins = bins[split.axis];
+			Bounds rightBounds {};
+			uint32_t rightCount = 0;
+			for(auto i = ctx.binCount - 1; i > 0; --i) {
+				rightBounds.Grow(axisBins[i].bounds);
+				rightCount += axisBins[i].count;
+				rightCost[i] = (rightCount > 0) ? (rightCount * rightBounds.GetArea()) : -1.f;
+			}
+			Bounds leftBounds {};
+			uint32_t leftCount = 0;
+			for(uint32_t i = 0; i < ctx.binCount - 1; ++i) {
+				leftBounds.Grow(axisBins[i].bounds);
+				leftCount += axisBins[i].count;
+				if(leftCount == 0 || rightCost[i + 1] < 0.f)
+					continue;
+				auto cost = leftCount * leftBounds.GetArea() + rightCost[i + 1];
+				if(cost < bestCost) {
+					bestCost = cost;
+					outSplit = split;
+					outSplit.bin = i + 1;
+					hasSplit = true;
+				}
+			}
+		}
+		if(!hasSplit) {
+			// All centroids coincide, we can only split by count
+			return (count > ctx.maxLeafSize) ? SplitType::Median : SplitType::Leaf;
+		}
+		auto nodeArea = nodeBounds.GetArea();
+		auto leafCost = count * nodeArea;
+		auto splitCost = nodeArea + bestCost;
+		if(splitCost >= leafCost && count <= ctx.maxLeafSize)
+			return SplitType::Leaf;
+		return SplitType::Sah;
+	}
+
+	// Reorders the primitive range according to the split and returns the number of primitives on the left side
+	uint32_t partition(const BuildContext &ctx, uint32_t *prims, uint32_t count, SplitType type, const Split &split)
+	{
+		if(type == SplitType::Median)
+			return count / 2;
+		auto *mid = std::partition(prims, prims + count, [&ctx, &split](uint32_t prim) { return get_bin_index(ctx, split, prim) < split.bin; });
+		return static_cast<uint32_t>(mid - prims);
+	}
+
+	struct BuildEntry {
+		uint32_t nodeIndex;
+		uint32_t depth;
+	};
+	// Splits nodes[rootIndex] recursively. Child pairs are appended to 'nodes' in depth-first order, with the left subtree being processed first.
+	// If 'outDeferred' is not null, nodes with at most PARALLEL_SUBTREE_SIZE triangles are not split and are added to it instead.
+	void build_subtree(const BuildContext &ctx, uint32_t *prims, std::vector<pragma::math::BvhNode> &nodes, uint32_t rootIndex, uint32_t rootDepth, std::vector<BuildEntry> *outDeferred = nullptr)
+	{
+		std::vector<BuildEntry> stack;
+		stack.push_back({rootIndex, rootDepth});
+		while(!stack.empty()) {
+			auto entry = stack.back();
+			stack.pop_back();
+			auto first = nodes[entry.nodeIndex].leftFirst;
+			auto count = nodes[entry.nodeIndex].count;
+			if(outDeferred && count <= PARALLEL_SUBTREE_SIZE) {
+				outDeferred->push_back(entry);
+				continue;
+			}
+			Bounds nodeBounds {nodes[entry.nodeIndex].min, nodes[entry.nodeIndex].max};
+			Split split {};
+			auto type = find_split(ctx, prims + first, count, nodeBounds, entry.depth, split);
+			if(type == SplitType::Leaf)
+				continue;
+			auto leftCount = partition(ctx, prims + first, count, type, split);
+
+			auto leftIdx = static_cast<uint32_t>(nodes.size());
+			for(auto [childFirst, childCount] : {std::pair<uint32_t, uint32_t> {first, leftCount}, std::pair<uint32_t, uint32_t> {first + leftCount, count - leftCount}}) {
+				auto bounds = calc_bounds(ctx, prims + childFirst, childCount);
+				auto &child = nodes.emplace_back();
+				child.min = bounds.min;
+				child.max = bounds.max;
+				child.leftFirst = childFirst;
+				child.count = childCount;
+			}
+			auto &node = nodes[entry.nodeIndex];
+			node.leftFirst = leftIdx;
+			node.count = 0;
+			stack.push_back({leftIdx + 1, entry.depth + 1});
+			stack.push_back({leftIdx, entry.depth + 1});
+		}
+	}
+
+	float calc_distance_sqr_to_aabb(const Vector3 &p, const Vector3 &min, const Vector3 &max)
+	{
+		auto d = glm::max(glm::max(min - p, Vector3 {}), p - max);
+		return uvec::dot(d, d);
+	}
+};
+
+pragma::math::Bvh::Bvh(const std::vector<Vector3> &verts, const std::vector<uint16_t> &triangles, const BuildInfo &buildInfo) { Build(verts, triangles, buildInfo); }
+pragma::math::Bvh::Bvh(const std::vector<Vector3> &verts, const std::vector<uint32_t> &triangles, const BuildInfo &buildInfo) { Build(verts, triangles, buildInfo); }
+void pragma::math::Bvh::Build(const std::vector<Vector3> &verts, const std::vector<uint16_t> &triangles, const BuildInfo &buildInfo) { Initialize(verts, triangles, buildInfo); }
+void pragma::math::Bvh::Build(const std::vector<Vector3> &verts, const std::vector<uint32_t> &triangles, const BuildInfo &buildInfo) { Initialize(verts, triangles, buildInfo); }
+void pragma::math::Bvh::Clear()
+{
+	m_nodes.clear();
+	m_primitives.clear();
+	m_vertices.clear();
+	m_indices.clear();
+	m_buildSahCost = 0.f;
+}
+
+template<typename TIndex>
+void pragma::math::Bvh::Initialize(const std::vector<Vector3> &verts, const std::vector<TIndex> &triangles, const BuildInfo &buildInfo)
+{
+	Clear();
+	auto numIndices = (triangles.size() / 3) * 3;
+	m_vertices = verts;
+	m_indices.reserve(numIndices);
+	for(auto i = decltype(numIndices) {0u}; i < numIndices; ++i)
+		m_indices.push_back(static_cast<uint32_t>(triangles[i]));
+	BuildNodes(buildInfo);
+	m_buildSahCost = CalcSahCost();
+}
+
+void pragma::math::Bvh::BuildNodes(const BuildInfo &buildInfo)
+{
+	auto numTris = static_cast<uint32_t>(m_indices.size() / 3);
+	m_nodes.clear();
+	m_primitives.resize(numTris);
+	std::iota(m_primitives.begin(), m_primitives.end(), 0u);
+	if(numTris == 0)
+		return;
+
+	BuildContext ctx {};
+	ctx.maxLeafSize = std::max(buildInfo.maxLeafSize, 1u);
+	ctx.binCount = std::clamp(buildInfo.binCount, 2u, MAX_BIN_COUNT);
+	ctx.threadCount = parallel::get_thread_count(buildInfo.threadCount);
+	ctx.triangleBounds.resize(numTris);
+	ctx.centroids.resize(numTris);
+	auto numChunks = (numTris + PARALLEL_SUBTREE_SIZE - 1) / PARALLEL_SUBTREE_SIZE;
+	parallel::parallel_for(
+	  numChunks,
+	  [this, &ctx, numTris](size_t chunk) {
+		  auto first = static_cast<uint32_t>(chunk) * PARALLEL_SUBTREE_SIZE;
+		  auto end = std::min(first + PARALLEL_SUBTREE_SIZE, numTris);
+		  for(auto i = first; i < end; ++i) {
+			  auto &bounds = ctx.triangleBounds[i];
+			  for(uint32_t j = 0; j < 3; ++j)
+				  bounds.Grow(m_vertices[m_indices[i * 3 + j]]);
+			  ctx.centroids[i] = (bounds.min + bounds.max) * 0.5f;
+		  }
+	  },
+	  ctx.threadCount);
+
+	auto rootBounds = calc_bounds(ctx, m_primitives.data(), numTris);
+	BvhNode root {};
+	root.min = rootBounds.min;
+	root.max = rootBounds.max;
+	root.leftFirst = 0;
+	root.count = numTris;
+	if(ctx.threadCount <= 1) {
+		m_nodes.reserve(numTris * 2 - 1);
+		m_nodes.push_back(root);
+		build_subtree(ctx, m_primitives.data(), m_nodes, 0, 0);
+		return;
+	}
+
+	// The top levels are split on the calling thread (with parallel binning for large nodes), the remaining
+	// subtrees are built as independent tasks. Split decisions only depend on the primitive range of a node, so
+	// the resulting tree is the same as the one produced by the serial builder, regardless of the thread count.
+	std::vector<BvhNode> topNodes {root};
+	std::vector<BuildEntry> deferred;
+	build_subtree(ctx, m_primitives.data(), topNodes, 0, 0, &deferred);
+
+	std::vector<std::vector<BvhNode>> subtrees(deferred.size());
+	parallel::parallel_for(
+	  deferred.size(),
+	  [this, &ctx, &topNodes, &deferred, &subtrees](size_t i) {
+		  auto &nodes = subtrees[i];
+		  nodes.push_back(topNodes[deferred[i].nodeIndex]);
+		  build_subtree(ctx, m_primitives.data(), nodes, 0, deferred[i].depth);
+	  },
+	  ctx.threadCount);
+
+	// Flatten the partial trees into the same depth-first layout as the serial builder
+	std::vector<const std::vector<BvhNode> *> deferredSubtrees(topNodes.size(), nullptr);
+	size_t numNodes = topNodes.size();
+	for(size_t i = 0; i < deferred.size(); ++i) {
+		deferredSubtrees[deferred[i].nodeIndex] = &subtrees[i];
+		numNodes += subtrees[i].size() - 1;
+	}
+	struct EmitEntry {
+		uint32_t dstIndex;
+		const std::vector<BvhNode> *srcNodes;
+		uint32_t srcIndex;
+	};
+	m_nodes.reserve(numNodes);
+	m_nodes.push_back({});
+	std::vector<EmitEntry> stack;
+	stack.push_back({0, &topNodes, 0});
+	while(!stack.empty()) {
+		auto entry = stack.back();
+		stack.pop_back();
+		if(entry.srcNodes == &topNodes && deferredSubtrees[entry.srcIndex]) {
+			entry.srcNodes = deferredSubtrees[entry.srcIndex];
+			entry.srcIndex = 0;
+		}
+		auto node = (*entry.srcNodes)[entry.srcIndex];
+		if(!node.IsLeaf()) {
+			auto srcLeft = node.leftFirst;
+			node.leftFirst = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.push_back({});
+			m_nodes.push_back({});
+			stack.push_back({node.leftFirst + 1, entry.srcNodes, srcLeft + 1});
+			stack.push_back({node.leftFirst, entry.srcNodes, srcLeft});
+		}
+		m_nodes[entry.dstIndex] = node;
+	}
+}
+
+bounding_volume::AABB pragma::math::Bvh::GetBounds() const
+{
+	if(m_nodes.empty())
+		return {};
+	return {m_nodes.front().min, m_nodes.front().max};
+}
+
+std::array<Vector3, 3> pragma::math::Bvh::GetTriangle(uint32_t triangleIndex) const
+{
+	auto *indices = m_indices.data() + triangleIndex * 3;
+	return {m_vertices[indices[0]], m_vertices[indices[1]], m_vertices[indices[2]]};
+}
+
+std::optional<pragma::math::Bvh::RaycastHit> pragma::math::Bvh::Raycast(const Vector3 &origin, const Vector3 &dir, float tMin, float tMax, bool bCull) const
+{
+	if(m_nodes.empty())
+		return {};
+	intersection::Ray ray {origin, dir};
+	std::optional<RaycastHit> result {};
+	auto tBest = tMax;
+	auto testNode = [this, &ray, tMin, &tBest](uint32_t nodeIdx, float &outTEntry) -> bool {
+		auto &node = m_nodes[nodeIdx];
+		float tEntry, tExit;
+		if(intersection::line_aabb(ray, node.min, node.max, &tEntry, &tExit) != intersection::Result::Intersect || tExit < tMin || tEntry > tBest)
+			return false;
+		outTEntry = tEntry;
+		return true;
+	};
+
+	struct StackEntry {
+		uint32_t nodeIndex;
+		float tEntry;
+	};
+	std::array<StackEntry, MAX_DEPTH + 1> stack;
+	uint32_t stackSize = 0;
+	float tRoot;
+	if(!testNode(0, tRoot))
+		return {};
+	stack[stackSize++] = {0, tRoot};
+	while(stackSize > 0) {
+		auto entry = stack[--stackSize];
+		if(entry.tEntry > tBest)
+			continue;
+		auto &node = m_nodes[entry.nodeIndex];
+		if(node.IsLeaf()) {
+			for(auto i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+				auto triIdx = m_primitives[i];
+				auto tri = GetTriangle(triIdx);
+				double t, u, v;
+				if(!intersection::line_triangle(origin, dir, tri[0], tri[1], tri[2], t, u, v, bCull) || t < tMin || t > tBest || (result && t == tBest))
+					continue;
+				tBest = static_cast<float>(t);
+				result = RaycastHit {triIdx, static_cast<float>(t), static_cast<float>(u), static_cast<float>(v)};
+			}
+			continue;
+		}
+		float tLeft, tRight;
+		auto hitLeft = testNode(node.leftFirst, tLeft);
+		auto hitRight = testNode(node.leftFirst + 1, tRight);
+		if(hitLeft && hitRight) {
+			// Push the far child first, so that the near child is visited first
+			if(tLeft <= tRight) {
+				stack[stackSize++] = {node.leftFirst + 1, tRight};
+				stack[stackSize++] = {node.leftFirst, tLeft};
+			}
+			else {
+				stack[stackSize++] = {node.leftFirst, tLeft};
+				stack[stackSize++] = {node.leftFirst + 1, tRight};
+			}
+		}
+		else if(hitLeft)
+			stack[stackSize++] = {node.leftFirst, tLeft};
+		else if(hitRight)
+			stack[stackSize++] = {node.leftFirst + 1, tRight};
+	}
+	return result;
+}
+
+std::optional<pragma::math::Bvh::ClosestPoint> pragma::math::Bvh::FindClosestPoint(const Vector3 &p, float maxDistance) const
+{
+	if(m_nodes.empty())
+		return {};
+	std::optional<ClosestPoint> result {};
+	auto bestDistSqr = maxDistance * maxDistance;
+
+	struct StackEntry {
+		uint32_t nodeIndex;
+		float distSqr;
+	};
+	std::array<StackEntry, MAX_DEPTH + 1> stack;
+	uint32_t stackSize = 0;
+	auto &root = m_nodes.front();
+	auto rootDistSqr = calc_distance_sqr_to_aabb(p, root.min, root.max);
+	if(rootDistSqr > bestDistSqr)
+		return {};
+	stack[stackSize++] = {0, rootDistSqr};
+	while(stackSize > 0) {
+		auto entry = stack[--stackSize];
+		if(entry.distSqr > bestDistSqr)
+			continue;
+		auto &node = m_nodes[entry.nodeIndex];
+		if(node.IsLeaf()) {
+			for(auto i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+				auto triIdx = m_primitives[i];
+				auto tri = GetTriangle(triIdx);
+				Vector3 pClosest;
+				geometry::closest_point_on_triangle_to_point(tri[0], tri[1], tri[2], p, &pClosest);
+				auto distSqr = uvec::length_sqr(pClosest - p);
+				if(distSqr > bestDistSqr || (result && distSqr == bestDistSqr))
+					continue;
+				bestDistSqr = distSqr;
+				result = ClosestPoint {triIdx, pClosest, distSqr};
+			}
+			continue;
+		}
+		auto &left = m_nodes[node.leftFirst];
+		auto &right = m_nodes[node.leftFirst + 1];
+		auto dLeft = calc_distance_sqr_to_aabb(p, left.min, left.max);
+		auto dRight = calc_distance_sqr_to_aabb(p, right.min, right.max);
+		// Visit the closer child first
+		if(dLeft <= dRight) {
+			if(dRight <= bestDistSqr)
+				stack[stackSize++] = {node.leftFirst + 1, dRight};
+			if(dLeft <= bestDistSqr)
+				stack[stackSize++] = {node.leftFirst, dLeft};
+		}
+		else {
+			if(dLeft <= bestDistSqr)
+				stack[stackSize++] = {node.leftFirst, dLeft};
+			if(dRight <= bestDistSqr)
+				stack[stackSize++] = {node.leftFirst + 1, dRight};
+		}
+	}
+	return result;
+}
+
+void pragma::math::Bvh::FindTrianglesInAabb(const Vector3 &min, const Vector3 &max, std::vector<uint32_t> &outTriangles) const
+{
+	if(m_nodes.empty())
+		return;
+	std::array<uint32_t, MAX_DEPTH + 1> stack;
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0) {
+		auto &node = m_nodes[stack[--stackSize]];
+		if(intersection::aabb_aabb(node.min, node.max, min, max) == intersection::Intersect::Outside)
+			continue;
+		if(node.IsLeaf()) {
+			for(auto i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+				auto triIdx = m_primitives[i];
+				auto tri = GetTriangle(triIdx);
+				if(intersection::aabb_triangle(min, max, tri[0], tri[1], tri[2]))
+					outTriangles.push_back(triIdx);
+			}
+			continue;
+		}
+		stack[stackSize++] = node.leftFirst + 1;
+		stack[stackSize++] = node.leftFirst;
+	}
+}
+
+void pragma::math::Bvh::FindTrianglesInSphere(const Vector3 &origin, float radius, std::vector<uint32_t> &outTriangles) const
+{
+	if(m_nodes.empty())
+		return;
+	auto radiusSqr = radius * radius;
+	std::array<uint32_t, MAX_DEPTH + 1> stack;
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0) {
+		auto &node = m_nodes[stack[--stackSize]];
+		if(!intersection::aabb_sphere(node.min, node.max, origin, radius))
+			continue;
+		if(node.IsLeaf()) {
+			for(auto i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+				auto triIdx = m_primitives[i];
+				auto tri = GetTriangle(triIdx);
+				Vector3 pClosest;
+				geometry::closest_point_on_triangle_to_point(tri[0], tri[1], tri[2], origin, &pClosest);
+				if(uvec::length_sqr(pClosest - origin) <= radiusSqr)
+					outTriangles.push_back(triIdx);
+			}
+			continue;
+		}
+		stack[stackSize++] = node.leftFirst + 1;
+		stack[stackSize++] = node.leftFirst;
+	}
+}
+
+void pragma::math::Bvh::RefitNode(uint32_t nodeIndex)
+{
+	auto &node = m_nodes[nodeIndex];
+	Bounds bounds {};
+	if(node.IsLeaf()) {
+		for(auto i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+			auto *indices = m_indices.data() + m_primitives[i] * 3;
+			for(uint32_t j = 0; j < 3; ++j)
+				bounds.Grow(m_vertices[indices[j]]);
+		}
+	}
+	else {
+		auto &left = m_nodes[node.leftFirst];
+		auto &right = m_nodes[node.leftFirst + 1];
+		bounds.Grow(Bounds {left.min, left.max});
+		bounds.Grow(Bounds {right.min, right.max});
+	}
+	node.min = bounds.min;
+	node.max = bounds.max;
+}
+
+bool pragma::math::Bvh::Refit(const std::vector<Vector3> &verts, uint32_t threadCount)
+{
+	if(verts.size() != m_vertices.size())
+		return false;
+	std::copy(verts.begin(), verts.end(), m_vertices.begin());
+	if(m_nodes.empty())
+		return true;
+	threadCount = parallel::get_thread_count(threadCount);
+	if(threadCount <= 1 || m_nodes.size() < PARALLEL_REFIT_SIZE) {
+		// Children are always stored after their parent, so iterating backwards visits them first
+		for(auto i = static_cast<uint32_t>(m_nodes.size()); i-- > 0;)
+			RefitNode(i);
+		return true;
+	}
+
+	// Expand the top levels until there are enough independent subtrees to keep all threads busy
+	std::vector<uint32_t> topNodes;
+	std::vector<uint32_t> subtreeRoots {0};
+	while(subtreeRoots.size() < threadCount * 4) {
+		std::vector<uint32_t> nextRoots;
+		nextRoots.reserve(subtreeRoots.size() * 2);
+		auto expanded = false;
+		for(auto idx : subtreeRoots) {
+			auto &node = m_nodes[idx];
+			if(node.IsLeaf()) {
+				nextRoots.push_back(idx);
+				continue;
+			}
+			topNodes.push_back(idx);
+			nextRoots.push_back(node.leftFirst);
+			nextRoots.push_back(node.leftFirst + 1);
+			expanded = true;
+		}
+		subtreeRoots = std::move(nextRoots);
+		if(!expanded)
+			break;
+	}
+
+	parallel::parallel_for(
+	  subtreeRoots.size(),
+	  [this, &subtreeRoots](size_t i) {
+		  // In pre-order every child comes after its parent, so the reverse order is bottom-up
+		  std::vector<uint32_t> order;
+		  std::vector<uint32_t> stack {subtreeRoots[i]};
+		  while(!stack.empty()) {
+			  auto idx = stack.back();
+			  stack.pop_back();
+			  order.push_back(idx);
+			  auto &node = m_nodes[idx];
+			  if(node.IsLeaf())
+				  continue;
+			  stack.push_back(node.leftFirst + 1);
+			  stack.push_back(node.leftFirst);
+		  }
+		  for(auto it = order.rbegin(); it != order.rend(); ++it)
+			  RefitNode(*it);
+	  },
+	  threadCount);
+
+	// Top nodes were collected level by level
+	for(auto it = topNodes.rbegin(); it != topNodes.rend(); ++it)
+		RefitNode(*it);
+	return true;
+}
+
+float pragma::math::Bvh::CalcSahCost() const
+{
+	if(m_nodes.empty())
+		return 0.f;
+	auto &root = m_nodes.front();
+	auto rootArea = Bounds {root.min, root.max}.GetArea();
+	if(rootArea <= 0.f)
+		return 0.f;
+	double cost = 0.0;
+	for(auto &node : m_nodes) {
+		auto area = static_cast<double>(Bounds {node.min, node.max}.GetArea());
+		cost += node.IsLeaf() ? (area * node.count) : area;
+	}
+	return static_cast<float>(cost / rootArea);
+}
+
+bool pragma::math::Bvh::IsRebuildRecommended(float maxCostRatio) const
+{
+	if(m_buildSahCost <= 0.f)
+		return false;
+	return CalcSahCost() > m_buildSahCost * maxCostRatio;
+}
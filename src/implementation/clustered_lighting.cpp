@@ -0,0 +1,266 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+#include "simd.hpp"
+
+module pragma.math;
+
+import :clustered_lighting;
+
+namespace {
+	// Number of lights per task when computing the cluster ranges of the lights
+	constexpr size_t LIGHT_RANGE_CHUNK_SIZE = 256;
+
+	float plane_distance(const Vector4 &plane, const Vector3 &p) { return plane.x * p.x + plane.y * p.y + plane.z * p.z - plane.w; }
+
+	// Plane through the camera position and two directions, oriented so that 'towards' is on the positive side
+	Vector4 get_boundary_plane(const Vector3 &pos, const Vector3 &a, const Vector3 &b, const Vector3 &towards)
+	{
+		auto n = uvec::get_normal(uvec::cross(a, b));
+		if(uvec::dot(n, towards) < 0.f)
+			n = -n;
+		return {n, uvec::dot(n, pos)};
+	}
+
+	// Cell i lies between planes[i] and planes[i +1]. A sphere touches the cell if it is not entirely behind
+	// the first plane and not entirely in front of the second one.
+	bool get_cell_range(const std::vector<Vector4> &planes, const Vector3 &origin, float radius, uint32_t &outMin, uint32_t &outMax)
+	{
+		auto found = false;
+		auto distPrev = plane_distance(planes.front(), origin);
+		for(auto i = decltype(planes.size()) {1u}; i < planes.size(); ++i) {
+			auto dist = plane_distance(planes[i], origin);
+			if(distPrev > -radius && dist < radius) {
+				if(!found)
+					outMin = static_cast<uint32_t>(i - 1);
+				outMax = static_cast<uint32_t>(i - 1);
+				found = true;
+			}
+			distPrev = dist;
+		}
+		return found;
+	}
+
+	// Bounding sphere of the intersection of the cone and the sphere with the light range, see https://bartwronski.com/2017/04/13/cull-that-cone/
+	bounding_volume::Sphere get_spot_light_bounds(const pragma::math::LightClusterGrid::SpotLight &light)
+	{
+		if(light.coneAngle > static_cast<float>(pragma::math::pi_2))
+			return {light.origin, light.range};
+		if(light.coneAngle > static_cast<float>(pragma::math::pi_4))
+			return {light.origin + light.direction * (std::cos(light.coneAngle) * light.range), std::sin(light.coneAngle) * light.range};
+		auto radius = light.range / (2.f * std::cos(light.coneAngle));
+		return {light.origin + light.direction * radius, radius};
+	}
+};
+
+void pragma::math::LightClusterGrid::Build(const Vector3 &pos, const Vector3 &forward, const Vector3 &up, float fovRad, float aspectRatio, float nearZ, float farZ, uint32_t numX, uint32_t numY, uint32_t numZ)
+{
+	m_numX = std::max(numX, 1u);
+	m_numY = std::max(numY, 1u);
+	m_numZ = std::max(numZ, 1u);
+	auto right = uvec::get_normal(uvec::cross(forward, up));
+	// Points at depth z are pos + dir * z, so all boundaries can be derived from the directions at depth 1
+	auto getDir = [&](float u, float v) { return frustum::get_plane_point(pos, forward, right, up, fovRad, 1.f, aspectRatio, Vector2 {u, v}) - pos; };
+	auto uDir = getDir(1.f, 0.5f) - getDir(0.f, 0.5f);
+	auto vDir = getDir(0.5f, 1.f) - getDir(0.5f, 0.f);
+
+	auto &columnPlanes = m_boundaryPlanes[0];
+	columnPlanes.resize(m_numX + 1);
+	for(uint32_t x = 0; x <= m_numX; ++x) {
+		auto u = static_cast<float>(x) / static_cast<float>(m_numX);
+		columnPlanes[x] = get_boundary_plane(pos, getDir(u, 0.f), getDir(u, 1.f), uDir);
+	}
+	auto &rowPlanes = m_boundaryPlanes[1];
+	rowPlanes.resize(m_numY + 1);
+	for(uint32_t y = 0; y <= m_numY; ++y) {
+		auto v = static_cast<float>(y) / static_cast<float>(m_numY);
+		rowPlanes[y] = get_boundary_plane(pos, getDir(0.f, v), getDir(1.f, v), vDir);
+	}
+	m_sliceDepths.resize(m_numZ + 1);
+	auto &slicePlanes = m_boundaryPlanes[2];
+	slicePlanes.resize(m_numZ + 1);
+	auto viewDir = uvec::get_normal(forward);
+	for(uint32_t z = 0; z <= m_numZ; ++z) {
+		auto depth = (z == m_numZ) ? farZ : nearZ * std::pow(farZ / nearZ, static_cast<float>(z) / static_cast<float>(m_numZ));
+		m_sliceDepths[z] = depth;
+		slicePlanes[z] = {viewDir, uvec::dot(viewDir, pos) + depth};
+	}
+
+	std::vector<Vector3> cornerDirs;
+	cornerDirs.reserve((m_numX + 1) * (m_numY + 1));
+	for(uint32_t y = 0; y <= m_numY; ++y) {
+		for(uint32_t x = 0; x <= m_numX; ++x)
+			cornerDirs.push_back(getDir(static_cast<float>(x) / static_cast<float>(m_numX), static_cast<float>(y) / static_cast<float>(m_numY)));
+	}
+	auto numClusters = GetClusterCount();
+	for(auto *v : {&m_clusterX, &m_clusterY, &m_clusterZ, &m_clusterRadius})
+		v->resize(numClusters);
+	for(uint32_t z = 0; z < m_numZ; ++z) {
+		for(uint32_t y = 0; y < m_numY; ++y) {
+			for(uint32_t x = 0; x < m_numX; ++x) {
+				std::array<Vector3, 8> corners;
+				for(uint32_t i = 0; i < 4; ++i) {
+					auto &dir = cornerDirs[(y + i / 2) * (m_numX + 1) + x + i % 2];
+					corners[i] = pos + dir * m_sliceDepths[z];
+					corners[i + 4] = pos + dir * m_sliceDepths[z + 1];
+				}
+				auto min = corners.front();
+				auto max = corners.front();
+				for(auto &c : corners) {
+					min = glm::min(min, c);
+					max = glm::max(max, c);
+				}
+				auto center = (min + max) * 0.5f;
+				auto radiusSqr = 0.f;
+				for(auto &c : corners)
+					radiusSqr = std::max(radiusSqr, uvec::length_sqr(c - center));
+				auto idx = GetClusterIndex(x, y, z);
+				m_clusterX[idx] = center.x;
+				m_clusterY[idx] = center.y;
+				m_clusterZ[idx] = center.z;
+				m_clusterRadius[idx] = std::sqrt(radiusSqr);
+			}
+		}
+	}
+	m_clusterCounts.assign(numClusters, 0);
+	m_clusterOffsets.assign(numClusters + 1, 0);
+	m_lightIndices.clear();
+}
+
+bool pragma::math::LightClusterGrid::FindCluster(const Vector3 &p, uint32_t &outClusterIndex) const
+{
+	LightRange range;
+	// With a radius of 0, points on a boundary would not be in any cell. Otherwise they are assigned to the lower cell.
+	if(!GetLightRange(p, std::numeric_limits<float>::min(), range))
+		return false;
+	outClusterIndex = GetClusterIndex(range.min[0], range.min[1], range.min[2]);
+	return true;
+}
+
+bounding_volume::Sphere pragma::math::LightClusterGrid::GetClusterSphere(uint32_t clusterIndex) const { return {Vector3 {m_clusterX[clusterIndex], m_clusterY[clusterIndex], m_clusterZ[clusterIndex]}, m_clusterRadius[clusterIndex]}; }
+
+bool pragma::math::LightClusterGrid::GetLightRange(const Vector3 &origin, float radius, LightRange &outRange) const
+{
+	outRange.valid = false;
+	if(m_numZ == 0)
+		return false;
+	for(auto i = decltype(m_boundaryPlanes.size()) {0u}; i < m_boundaryPlanes.size(); ++i) {
+		if(!get_cell_range(m_boundaryPlanes[i], origin, radius, outRange.min[i], outRange.max[i]))
+			return false;
+	}
+	outRange.valid = true;
+	return true;
+}
+
+void pragma::math::LightClusterGrid::AssignSlice(uint32_t z, const SphereSoaView &pointLights, const SpotLight *spotLights, size_t numSpotLights, std::vector<uint32_t> &outIndices)
+{
+	using namespace simd;
+	auto numTiles = m_numX * m_numY;
+	auto firstCluster = z * numTiles;
+	auto &entries = m_sliceEntries[z];
+	entries.clear();
+	// Entries are (tile << 32) | light, so that they can be sorted by tile while keeping the order of the lights
+	auto addEntry = [&entries](uint32_t tile, uint32_t light) { entries.push_back((static_cast<uint64_t>(tile) << 32) | light); };
+	for(size_t i = 0; i < pointLights.count; ++i) {
+		auto &range = m_lightRanges[i];
+		if(!range.valid || z < range.min[2] || z > range.max[2])
+			continue;
+		for(auto y = range.min[1]; y <= range.max[1]; ++y) {
+			for(auto x = range.min[0]; x <= range.max[0]; ++x)
+				addEntry(y * m_numX + x, static_cast<uint32_t>(i));
+		}
+	}
+	for(size_t i = 0; i < numSpotLights; ++i) {
+		auto lightIndex = static_cast<uint32_t>(pointLights.count + i);
+		auto &range = m_lightRanges[lightIndex];
+		if(!range.valid || z < range.min[2] || z > range.max[2])
+			continue;
+		// Same as intersection::sphere_cone with the light range as cone size, for a row of clusters at a time
+		auto &light = spotLights[i];
+		// Clusters behind the light can only be culled if the cone is narrower than a hemisphere
+		auto cullBehind = std::cos(light.coneAngle) >= 0.f;
+		auto ox = set1(light.origin.x);
+		auto oy = set1(light.origin.y);
+		auto oz = set1(light.origin.z);
+		auto dx = set1(light.direction.x);
+		auto dy = set1(light.direction.y);
+		auto dz = set1(light.direction.z);
+		auto cosAngle = set1(std::cos(light.coneAngle));
+		auto sinAngle = set1(std::sin(light.coneAngle));
+		auto coneSize = set1(light.range);
+		for(auto y = range.min[1]; y <= range.max[1]; ++y) {
+			auto rowStart = firstCluster + y * m_numX;
+			for(auto x = range.min[0]; x <= range.max[0]; x += width) {
+				auto n = std::min(width, range.max[0] + 1 - x);
+				auto idx = rowStart + x;
+				auto vx = load_partial(m_clusterX.data() + idx, n) - ox;
+				auto vy = load_partial(m_clusterY.data() + idx, n) - oy;
+				auto vz = load_partial(m_clusterZ.data() + idx, n) - oz;
+				auto r = load_partial(m_clusterRadius.data() + idx, n);
+				auto lenSqr = fmadd(vx, vx, fmadd(vy, vy, vz * vz));
+				auto v1Len = fmadd(vx, dx, fmadd(vy, dy, vz * dz));
+				// The difference can be slightly negative due to rounding
+				auto closestPointDist = cosAngle * sqrt(max(lenSqr - v1Len * v1Len, zero())) - v1Len * sinAngle;
+				auto culled = cmp_gt(closestPointDist, r) | cmp_gt(v1Len, r + coneSize);
+				if(cullBehind)
+					culled = culled | cmp_lt(v1Len, -r);
+				for(auto bits = to_bits(~culled) & lane_mask(n); bits != 0; bits &= bits - 1)
+					addEntry(y * m_numX + x + std::countr_zero(bits), lightIndex);
+			}
+		}
+	}
+
+	// Counting sort by tile. The offsets within the slice are stored in the part of m_clusterOffsets that belongs to the slice,
+	// which is overwritten with the final offsets once all slices have been assigned.
+	auto *counts = m_clusterCounts.data() + firstCluster;
+	std::fill(counts, counts + numTiles, 0u);
+	for(auto entry : entries)
+		++counts[entry >> 32];
+	auto *offsets = m_clusterOffsets.data() + firstCluster;
+	offsets[0] = 0;
+	for(uint32_t i = 1; i < numTiles; ++i)
+		offsets[i] = offsets[i - 1] + counts[i - 1];
+	outIndices.resize(entries.size());
+	for(auto entry : entries)
+		outIndices[offsets[entry >> 32]++] = static_cast<uint32_t>(entry);
+}
+
+void pragma::math::LightClusterGrid::AssignLights(const SphereSoaView &pointLights, const SpotLight *spotLights, size_t numSpotLights, uint32_t threadCount)
+{
+	auto numLights = pointLights.count + numSpotLights;
+	m_lightRanges.resize(numLights);
+	auto numChunks = (numLights + LIGHT_RANGE_CHUNK_SIZE - 1) / LIGHT_RANGE_CHUNK_SIZE;
+	parallel::parallel_for(
+	  numChunks,
+	  [this, &pointLights, spotLights, numLights](size_t chunk) {
+		  auto end = std::min((chunk + 1) * LIGHT_RANGE_CHUNK_SIZE, numLights);
+		  for(auto i = chunk * LIGHT_RANGE_CHUNK_SIZE; i < end; ++i) {
+			  if(i < pointLights.count) {
+				  GetLightRange(Vector3 {pointLights.x[i], pointLights.y[i], pointLights.z[i]}, pointLights.radius[i], m_lightRanges[i]);
+				  continue;
+			  }
+			  auto bounds = get_spot_light_bounds(spotLights[i - pointLights.count]);
+			  GetLightRange(bounds.origin, bounds.radius, m_lightRanges[i]);
+		  }
+	  },
+	  threadCount);
+
+	// Each slice is processed by a single task, the lists of all slices are concatenated in order
+	auto numClusters = GetClusterCount();
+	m_clusterOffsets.resize(numClusters + 1);
+	m_sliceEntries.resize(m_numZ);
+	parallel::parallel_compact(
+	  m_numZ, 1, [this, &pointLights, spotLights, numSpotLights](size_t begin, size_t, std::vector<uint32_t> &outIndices) { AssignSlice(static_cast<uint32_t>(begin), pointLights, spotLights, numSpotLights, outIndices); }, m_lightIndices, threadCount);
+
+	m_clusterOffsets[0] = 0;
+	for(uint32_t i = 0; i < numClusters; ++i)
+		m_clusterOffsets[i + 1] = m_clusterOffsets[i] + m_clusterCounts[i];
+}
+
+std::pair<const uint32_t *, uint32_t> pragma::math::LightClusterGrid::GetClusterLights(uint32_t clusterIndex) const
+{
+	auto offset = m_clusterOffsets[clusterIndex];
+	return {m_lightIndices.data() + offset, m_clusterOffsets[clusterIndex + 1] - offset};
+}
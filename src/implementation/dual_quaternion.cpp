@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+module pragma.math;
+
+import :dual_quaternion;
+
+pragma::math::DualQuat::DualQuat(const Vector3 &translation, const Quat &rotation) : real {rotation}, dual {Quat {0.f, translation.x, translation.y, translation.z} * rotation * 0.5f} {}
+
+pragma::math::DualQuat::DualQuat(const Transform &t) : DualQuat {t.GetOrigin(), t.GetRotation()} {}
+
+Vector3 pragma::math::DualQuat::GetTranslation() const
+{
+	// Vector part of 2 * dual * conjugate(real)
+	Vector3 r {real.x, real.y, real.z};
+	Vector3 d {dual.x, dual.y, dual.z};
+	return (d * real.w - r * dual.w + uvec::cross(r, d)) * 2.f;
+}
+
+pragma::math::Transform pragma::math::DualQuat::ToTransform() const { return {GetTranslation(), real}; }
+
+Mat4 pragma::math::DualQuat::ToMatrix() const { return ToTransform().ToMatrix(); }
+
+void pragma::math::DualQuat::Normalize()
+{
+	auto len = uquat::length(real);
+	if(len == 0.f) {
+		*this = {};
+		return;
+	}
+	auto invLen = 1.f / len;
+	real *= invLen;
+	dual *= invLen;
+	dual -= real * uquat::dot_product(real, dual);
+}
+
+pragma::math::DualQuat pragma::math::DualQuat::GetNormal() const
+{
+	auto dq = *this;
+	dq.Normalize();
+	return dq;
+}
+
+pragma::math::DualQuat pragma::math::DualQuat::GetInverse() const { return {glm::conjugate(real), glm::conjugate(dual)}; }
+
+Vector3 pragma::math::DualQuat::operator*(const Vector3 &p) const { return Rotate(p) + GetTranslation(); }
+
+Vector3 pragma::math::DualQuat::Rotate(const Vector3 &dir) const
+{
+	auto result = dir;
+	uvec::rotate(&result, real);
+	return result;
+}
+
+pragma::math::DualQuat pragma::math::DualQuat::operator*(const DualQuat &other) const
+{
+	auto res = *this;
+	res *= other;
+	return res;
+}
+
+pragma::math::DualQuat &pragma::math::DualQuat::operator*=(const DualQuat &other)
+{
+	dual = real * other.dual + dual * other.real;
+	real = real * other.real;
+	return *this;
+}
+
+pragma::math::DualQuat &pragma::math::DualQuat::operator+=(const DualQuat &other)
+{
+	real += other.real;
+	dual += other.dual;
+	return *this;
+}
+
+pragma::math::DualQuat pragma::math::DualQuat::Blend(const DualQuat *dqs, const float *weights, size_t count)
+{
+	if(count == 0)
+		return {};
+	size_t pivotIdx = 0;
+	for(size_t i = 1; i < count; ++i) {
+		if(weights[i] > weights[pivotIdx])
+			pivotIdx = i;
+	}
+	DualQuat result {Quat {0.f, 0.f, 0.f, 0.f}, Quat {0.f, 0.f, 0.f, 0.f}};
+	auto &pivot = dqs[pivotIdx].real;
+	for(size_t i = 0; i < count; ++i) {
+		auto w = weights[i];
+		if(uquat::dot_product(pivot, dqs[i].real) < 0.f)
+			w = -w;
+		result += dqs[i] * w;
+	}
+	result.Normalize();
+	return result;
+}
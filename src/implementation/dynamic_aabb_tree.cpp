@@ -0,0 +1,349 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+module pragma.math;
+
+import :dynamic_aabb_tree;
+
+namespace {
+	bounding_volume::AABB merge(const bounding_volume::AABB &a, const bounding_volume::AABB &b) { return {glm::min(a.min, b.min), glm::max(a.max, b.max)}; }
+	// Half of the surface area
+	float calc_area(const bounding_volume::AABB &aabb)
+	{
+		auto e = aabb.max - aabb.min;
+		return e.x * e.y + e.y * e.z + e.z * e.x;
+	}
+	bool contains(const bounding_volume::AABB &outer, const bounding_volume::AABB &inner)
+	{
+		return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+	}
+};
+
+pragma::math::DynamicAabbTree::DynamicAabbTree(float margin, float displacementMultiplier) : m_margin {margin}, m_displacementMultiplier {displacementMultiplier} {}
+
+void pragma::math::DynamicAabbTree::Reserve(uint32_t proxyCount)
+{
+	// A tree with n leaves has n -1 inner nodes
+	auto nodeCount = std::max(proxyCount * 2, 1u) - 1;
+	if(nodeCount > m_nodes.size()) {
+		auto oldSize = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.resize(nodeCount);
+		for(auto i = nodeCount; i-- > oldSize;) {
+			m_nodes[i].parent = m_freeList;
+			m_nodes[i].height = -1;
+			m_freeList = i;
+		}
+	}
+	m_moveBuffer.reserve(proxyCount);
+}
+
+void pragma::math::DynamicAabbTree::Clear()
+{
+	auto nodeCount = static_cast<uint32_t>(m_nodes.size());
+	m_freeList = INVALID_PROXY;
+	for(auto i = nodeCount; i-- > 0;) {
+		m_nodes[i] = {};
+		m_nodes[i].parent = m_freeList;
+		m_freeList = i;
+	}
+	m_root = INVALID_PROXY;
+	m_proxyCount = 0;
+	m_moveBuffer.clear();
+}
+
+uint32_t pragma::math::DynamicAabbTree::AllocateNode()
+{
+	if(m_freeList == INVALID_PROXY) {
+		// Only reached if the capacity is exhausted, grows the pool geometrically
+		auto oldSize = static_cast<uint32_t>(m_nodes.size());
+		auto newSize = std::max(oldSize * 2, 16u);
+		m_nodes.resize(newSize);
+		for(auto i = newSize; i-- > oldSize;) {
+			m_nodes[i].parent = m_freeList;
+			m_nodes[i].height = -1;
+			m_freeList = i;
+		}
+	}
+	auto nodeIndex = m_freeList;
+	auto &node = m_nodes[nodeIndex];
+	m_freeList = node.parent;
+	node = {};
+	node.height = 0;
+	return nodeIndex;
+}
+
+void pragma::math::DynamicAabbTree::FreeNode(uint32_t nodeIndex)
+{
+	auto &node = m_nodes[nodeIndex];
+	node.parent = m_freeList;
+	node.child1 = INVALID_PROXY;
+	node.child2 = INVALID_PROXY;
+	node.height = -1;
+	node.moved = false;
+	m_freeList = nodeIndex;
+}
+
+uint32_t pragma::math::DynamicAabbTree::GetHeight() const { return (m_root != INVALID_PROXY) ? static_cast<uint32_t>(m_nodes[m_root].height) : 0; }
+
+pragma::math::DynamicAabbTree::ProxyId pragma::math::DynamicAabbTree::Insert(const bounding_volume::AABB &aabb, uint64_t userData)
+{
+	auto proxyId = AllocateNode();
+	auto &node = m_nodes[proxyId];
+	Vector3 margin {m_margin, m_margin, m_margin};
+	node.aabb = {aabb.min - margin, aabb.max + margin};
+	node.userData = userData;
+	node.moved = true;
+	InsertLeaf(proxyId);
+	m_moveBuffer.push_back(proxyId);
+	++m_proxyCount;
+	return proxyId;
+}
+
+void pragma::math::DynamicAabbTree::Remove(ProxyId proxyId)
+{
+	// Stale entries in the move buffer are skipped by UpdatePairs
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	--m_proxyCount;
+}
+
+bool pragma::math::DynamicAabbTree::Move(ProxyId proxyId, const bounding_volume::AABB &aabb, const Vector3 &displacement)
+{
+	Vector3 margin {m_margin, m_margin, m_margin};
+	bounding_volume::AABB fatAabb {aabb.min - margin, aabb.max + margin};
+	// Predict the movement along the displacement
+	auto d = displacement * m_displacementMultiplier;
+	fatAabb.min += glm::min(d, Vector3 {});
+	fatAabb.max += glm::max(d, Vector3 {});
+
+	auto &treeAabb = m_nodes[proxyId].aabb;
+	if(contains(treeAabb, aabb)) {
+		// The tree box still contains the object, but it might be too large, e.g. if the object was moving quickly but has since stopped
+		auto hugeMargin = margin * 4.f;
+		bounding_volume::AABB hugeAabb {fatAabb.min - hugeMargin, fatAabb.max + hugeMargin};
+		if(contains(hugeAabb, treeAabb))
+			return false;
+	}
+
+	RemoveLeaf(proxyId);
+	m_nodes[proxyId].aabb = fatAabb;
+	InsertLeaf(proxyId);
+	if(!m_nodes[proxyId].moved) {
+		m_nodes[proxyId].moved = true;
+		m_moveBuffer.push_back(proxyId);
+	}
+	return true;
+}
+
+void pragma::math::DynamicAabbTree::InsertLeaf(uint32_t leaf)
+{
+	if(m_root == INVALID_PROXY) {
+		m_root = leaf;
+		m_nodes[leaf].parent = INVALID_PROXY;
+		return;
+	}
+
+	// Find the best sibling by descending the tree with the surface area heuristic
+	auto leafAabb = m_nodes[leaf].aabb;
+	auto index = m_root;
+	while(!m_nodes[index].IsLeaf()) {
+		auto &node = m_nodes[index];
+		auto area = calc_area(node.aabb);
+		auto combinedArea = calc_area(merge(node.aabb, leafAabb));
+		// Cost of creating a new parent for this node and the new leaf
+		auto cost = 2.f * combinedArea;
+		// Minimum cost of pushing the leaf further down the tree
+		auto inheritanceCost = 2.f * (combinedArea - area);
+		auto calcDescendCost = [this, &leafAabb, inheritanceCost](uint32_t child) {
+			auto &childNode = m_nodes[child];
+			auto mergedArea = calc_area(merge(leafAabb, childNode.aabb));
+			return childNode.IsLeaf() ? (mergedArea + inheritanceCost) : (mergedArea - calc_area(childNode.aabb) + inheritanceCost);
+		};
+		auto cost1 = calcDescendCost(node.child1);
+		auto cost2 = calcDescendCost(node.child2);
+		if(cost < cost1 && cost < cost2)
+			break;
+		index = (cost1 < cost2) ? node.child1 : node.child2;
+	}
+	auto sibling = index;
+
+	// Create a new parent for the sibling and the leaf
+	auto oldParent = m_nodes[sibling].parent;
+	auto newParent = AllocateNode();
+	auto &parentNode = m_nodes[newParent];
+	parentNode.parent = oldParent;
+	parentNode.aabb = merge(leafAabb, m_nodes[sibling].aabb);
+	parentNode.height = m_nodes[sibling].height + 1;
+	parentNode.child1 = sibling;
+	parentNode.child2 = leaf;
+	if(oldParent != INVALID_PROXY) {
+		auto &oldParentNode = m_nodes[oldParent];
+		if(oldParentNode.child1 == sibling)
+			oldParentNode.child1 = newParent;
+		else
+			oldParentNode.child2 = newParent;
+	}
+	else
+		m_root = newParent;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	UpdateAncestors(m_nodes[leaf].parent);
+}
+
+void pragma::math::DynamicAabbTree::RemoveLeaf(uint32_t leaf)
+{
+	if(leaf == m_root) {
+		m_root = INVALID_PROXY;
+		return;
+	}
+	auto parent = m_nodes[leaf].parent;
+	auto grandParent = m_nodes[parent].parent;
+	auto sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+	if(grandParent == INVALID_PROXY) {
+		m_root = sibling;
+		m_nodes[sibling].parent = INVALID_PROXY;
+		FreeNode(parent);
+		return;
+	}
+	// Replace the parent with the sibling
+	auto &grandParentNode = m_nodes[grandParent];
+	if(grandParentNode.child1 == parent)
+		grandParentNode.child1 = sibling;
+	else
+		grandParentNode.child2 = sibling;
+	m_nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+	UpdateAncestors(grandParent);
+}
+
+void pragma::math::DynamicAabbTree::UpdateAncestors(uint32_t nodeIndex)
+{
+	while(nodeIndex != INVALID_PROXY) {
+		nodeIndex = Balance(nodeIndex);
+		auto &node = m_nodes[nodeIndex];
+		auto &child1 = m_nodes[node.child1];
+		auto &child2 = m_nodes[node.child2];
+		node.height = 1 + std::max(child1.height, child2.height);
+		node.aabb = merge(child1.aabb, child2.aabb);
+		nodeIndex = node.parent;
+	}
+}
+
+uint32_t pragma::math::DynamicAabbTree::Balance(uint32_t iA)
+{
+	// Performs a left or right rotation if node A is imbalanced and returns the new root of the subtree
+	auto &a = m_nodes[iA];
+	if(a.IsLeaf() || a.height < 2)
+		return iA;
+	auto iB = a.child1;
+	auto iC = a.child2;
+	auto &b = m_nodes[iB];
+	auto &c = m_nodes[iC];
+	auto balance = c.height - b.height;
+	auto replaceChild = [this](uint32_t parent, uint32_t oldChild, uint32_t newChild) {
+		if(parent == INVALID_PROXY) {
+			m_root = newChild;
+			return;
+		}
+		auto &parentNode = m_nodes[parent];
+		if(parentNode.child1 == oldChild)
+			parentNode.child1 = newChild;
+		else
+			parentNode.child2 = newChild;
+	};
+
+	// Rotate C up
+	if(balance > 1) {
+		auto iF = c.child1;
+		auto iG = c.child2;
+		auto &f = m_nodes[iF];
+		auto &g = m_nodes[iG];
+		c.child1 = iA;
+		c.parent = a.parent;
+		a.parent = iC;
+		replaceChild(c.parent, iA, iC);
+		if(f.height > g.height) {
+			c.child2 = iF;
+			a.child2 = iG;
+			g.parent = iA;
+			a.aabb = merge(b.aabb, g.aabb);
+			c.aabb = merge(a.aabb, f.aabb);
+			a.height = 1 + std::max(b.height, g.height);
+			c.height = 1 + std::max(a.height, f.height);
+		}
+		else {
+			c.child2 = iG;
+			a.child2 = iF;
+			f.parent = iA;
+			a.aabb = merge(b.aabb, f.aabb);
+			c.aabb = merge(a.aabb, g.aabb);
+			a.height = 1 + std::max(b.height, f.height);
+			c.height = 1 + std::max(a.height, g.height);
+		}
+		return iC;
+	}
+
+	// Rotate B up
+	if(balance < -1) {
+		auto iD = b.child1;
+		auto iE = b.child2;
+		auto &d = m_nodes[iD];
+		auto &e = m_nodes[iE];
+		b.child1 = iA;
+		b.parent = a.parent;
+		a.parent = iB;
+		replaceChild(b.parent, iA, iB);
+		if(d.height > e.height) {
+			b.child2 = iD;
+			a.child1 = iE;
+			e.parent = iA;
+			a.aabb = merge(c.aabb, e.aabb);
+			b.aabb = merge(a.aabb, d.aabb);
+			a.height = 1 + std::max(c.height, e.height);
+			b.height = 1 + std::max(a.height, d.height);
+		}
+		else {
+			b.child2 = iE;
+			a.child1 = iD;
+			d.parent = iA;
+			a.aabb = merge(c.aabb, d.aabb);
+			b.aabb = merge(a.aabb, e.aabb);
+			a.height = 1 + std::max(c.height, d.height);
+			b.height = 1 + std::max(a.height, e.height);
+		}
+		return iB;
+	}
+	return iA;
+}
+
+void pragma::math::DynamicAabbTree::UpdatePairs(const std::function<void(ProxyId, ProxyId)> &callback)
+{
+	m_pairBuffer.clear();
+	for(auto proxyId : m_moveBuffer) {
+		auto &node = m_nodes[proxyId];
+		// Skip proxies that have been removed since they were added to the buffer
+		if(node.height != 0 || !node.moved)
+			continue;
+		Query(node.aabb, [this, proxyId](ProxyId other) {
+			if(other == proxyId)
+				return true;
+			// If both proxies have moved, the pair is only reported by the one with the lower id
+			if(m_nodes[other].moved && other < proxyId)
+				return true;
+			m_pairBuffer.push_back({std::min(proxyId, other), std::max(proxyId, other)});
+			return true;
+		});
+	}
+	for(auto proxyId : m_moveBuffer)
+		m_nodes[proxyId].moved = false;
+	m_moveBuffer.clear();
+
+	// A proxy may have been added to the move buffer more than once if it was removed and its id was re-used
+	std::sort(m_pairBuffer.begin(), m_pairBuffer.end());
+	m_pairBuffer.erase(std::unique(m_pairBuffer.begin(), m_pairBuffer.end()), m_pairBuffer.end());
+	for(auto &pair : m_pairBuffer)
+		callback(pair.first, pair.second);
+}
@@ -0,0 +1,379 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+#include "simd.hpp"
+
+module pragma.math;
+
+import :frustum_culling;
+import :parallel;
+
+namespace {
+	// Number of volumes per task of the parallel variants, must be a multiple of 32
+	constexpr size_t PARALLEL_CULL_CHUNK_SIZE = 4'096;
+
+	using Planes = std::array<Vector4, pragma::math::Frustum::PLANE_COUNT>;
+
+	// Planes that can never reject anything, e.g. the far plane of an infinite projection
+	Vector4 get_unbounded_plane() { return {0.f, 0.f, 0.f, std::numeric_limits<float>::max()}; }
+	bool is_unbounded_plane(const Vector4 &plane) { return plane.x == 0.f && plane.y == 0.f && plane.z == 0.f; }
+
+	Vector4 normalize_plane(const Vector3 &n, float d)
+	{
+		auto l = uvec::length(n);
+		return {n / l, d / l};
+	}
+
+	float plane_distance(const Vector4 &plane, const Vector3 &p) { return plane.x * p.x + plane.y * p.y + plane.z * p.z - plane.w; }
+
+	// Shared by boxes and spheres: A volume is outside of a plane if dist - radius > 0 and entirely inside of it if dist + radius <= 0,
+	// where the radius of a box is the projection of its half-extents onto the plane normal.
+	template<typename TGetDistance>
+	pragma::math::intersection::Intersect classify(const Planes &planes, uint8_t &inOutPlaneMask, uint8_t &inOutLastPlane, const TGetDistance &getDistance)
+	{
+		using pragma::math::intersection::Intersect;
+		auto mask = inOutPlaneMask;
+		auto lastPlane = inOutLastPlane;
+		if(lastPlane < planes.size() && (mask & (1u << lastPlane))) {
+			auto [dist, radius] = getDistance(planes[lastPlane]);
+			if(dist - radius > 0.f)
+				return Intersect::Outside;
+		}
+		auto result = Intersect::Inside;
+		for(auto i = decltype(planes.size()) {0u}; i < planes.size(); ++i) {
+			auto bit = static_cast<uint8_t>(1u << i);
+			if(!(mask & bit))
+				continue;
+			auto [dist, radius] = getDistance(planes[i]);
+			if(dist - radius > 0.f) {
+				inOutLastPlane = static_cast<uint8_t>(i);
+				return Intersect::Outside;
+			}
+			if(dist + radius > 0.f)
+				result = Intersect::Overlap;
+			else
+				mask &= ~bit;
+		}
+		inOutPlaneMask = mask;
+		return result;
+	}
+
+	// Avoids the copy of load_partial for full batches
+	pragma::math::simd::vfloat load_lanes(const float *p, uint32_t count) { return (count == pragma::math::simd::width) ? pragma::math::simd::load(p) : pragma::math::simd::load_partial(p, count); }
+
+	struct PlaneLanes {
+		pragma::math::simd::vfloat nx, ny, nz;
+		pragma::math::simd::vfloat ax, ay, az;
+		pragma::math::simd::vfloat d;
+	};
+	PlaneLanes broadcast_plane(const Vector4 &plane)
+	{
+		using namespace pragma::math::simd;
+		return {set1(plane.x), set1(plane.y), set1(plane.z), set1(std::abs(plane.x)), set1(std::abs(plane.y)), set1(std::abs(plane.z)), set1(plane.w)};
+	}
+	// Loads the cached plane of each lane. Lanes without a valid cached plane get a plane that never rejects anything.
+	PlaneLanes gather_planes(const Planes &planes, const uint8_t *planeIndices, uint32_t count)
+	{
+		using namespace pragma::math::simd;
+		alignas(64) float nx[width], ny[width], nz[width], d[width];
+		for(uint32_t i = 0; i < width; ++i) {
+			if(i >= count || planeIndices[i] >= planes.size()) {
+				nx[i] = ny[i] = nz[i] = 0.f;
+				d[i] = std::numeric_limits<float>::max();
+				continue;
+			}
+			auto &plane = planes[planeIndices[i]];
+			nx[i] = plane.x;
+			ny[i] = plane.y;
+			nz[i] = plane.z;
+			d[i] = plane.w;
+		}
+		auto vx = load(nx);
+		auto vy = load(ny);
+		auto vz = load(nz);
+		return {vx, vy, vz, abs(vx), abs(vy), abs(vz), load(d)};
+	}
+
+	struct AabbLanes {
+		pragma::math::simd::vfloat cx, cy, cz;
+		pragma::math::simd::vfloat ex, ey, ez;
+		pragma::math::simd::vmask IsOutside(const PlaneLanes &p) const
+		{
+			using namespace pragma::math::simd;
+			auto dist = fmadd(p.nx, cx, fmadd(p.ny, cy, p.nz * cz)) - p.d;
+			auto radius = fmadd(p.ax, ex, fmadd(p.ay, ey, p.az * ez));
+			return cmp_gt(dist - radius, zero());
+		}
+	};
+	AabbLanes load_aabb_lanes(const pragma::math::AabbSoaView &boxes, size_t i, uint32_t count)
+	{
+		using namespace pragma::math::simd;
+		auto half = set1(0.5f);
+		auto minX = load_lanes(boxes.minX + i, count);
+		auto minY = load_lanes(boxes.minY + i, count);
+		auto minZ = load_lanes(boxes.minZ + i, count);
+		auto maxX = load_lanes(boxes.maxX + i, count);
+		auto maxY = load_lanes(boxes.maxY + i, count);
+		auto maxZ = load_lanes(boxes.maxZ + i, count);
+		return {(minX + maxX) * half, (minY + maxY) * half, (minZ + maxZ) * half, (maxX - minX) * half, (maxY - minY) * half, (maxZ - minZ) * half};
+	}
+
+	struct SphereLanes {
+		pragma::math::simd::vfloat x, y, z, r;
+		pragma::math::simd::vmask IsOutside(const PlaneLanes &p) const
+		{
+			using namespace pragma::math::simd;
+			auto dist = fmadd(p.nx, x, fmadd(p.ny, y, p.nz * z)) - p.d;
+			return cmp_gt(dist - r, zero());
+		}
+	};
+	SphereLanes load_sphere_lanes(const pragma::math::SphereSoaView &spheres, size_t i, uint32_t count) { return {load_lanes(spheres.x + i, count), load_lanes(spheres.y + i, count), load_lanes(spheres.z + i, count), load_lanes(spheres.radius + i, count)}; }
+
+	// Returns the visibility bits of the lanes. Planes are tested in order until all lanes have been rejected.
+	template<typename TLanes>
+	uint32_t cull_lanes(const TLanes &lanes, const Planes &planes, const std::array<PlaneLanes, pragma::math::Frustum::PLANE_COUNT> &planeLanes, uint8_t *lastPlanes, uint32_t count)
+	{
+		using namespace pragma::math::simd;
+		auto laneBits = lane_mask(count);
+		uint32_t outside = 0;
+		if(lastPlanes) {
+			// Most volumes are rejected by the same plane as in the previous frame
+			outside = to_bits(lanes.IsOutside(gather_planes(planes, lastPlanes, count))) & laneBits;
+			if(outside == laneBits)
+				return 0;
+		}
+		for(uint32_t i = 0; i < planeLanes.size(); ++i) {
+			auto rejected = to_bits(lanes.IsOutside(planeLanes[i])) & laneBits & ~outside;
+			if(rejected == 0)
+				continue;
+			if(lastPlanes) {
+				for(auto bits = rejected; bits != 0; bits &= bits - 1)
+					lastPlanes[std::countr_zero(bits)] = static_cast<uint8_t>(i);
+			}
+			outside |= rejected;
+			if(outside == laneBits)
+				break;
+		}
+		return ~outside & laneBits;
+	}
+
+	// Culls against all frusta per batch of volumes, so that the bounds are only loaded once. The last-plane cache is only supported for a single frustum.
+	template<typename TLoadLanes>
+	void cull(const pragma::math::Frustum *frusta, uint32_t numFrusta, size_t count, uint32_t *outVisibleMasks, size_t *outVisibleCounts, uint8_t *inOutLastPlanes, const TLoadLanes &loadLanes)
+	{
+		using namespace pragma::math::simd;
+		std::vector<std::array<PlaneLanes, pragma::math::Frustum::PLANE_COUNT>> planeLanes;
+		planeLanes.resize(numFrusta);
+		for(uint32_t i = 0; i < numFrusta; ++i) {
+			auto &planes = frusta[i].GetPlaneVectors();
+			for(auto j = decltype(planes.size()) {0u}; j < planes.size(); ++j)
+				planeLanes[i][j] = broadcast_plane(planes[j]);
+		}
+		auto maskSize = pragma::math::intersection::get_hit_mask_size(count);
+		std::fill(outVisibleMasks, outVisibleMasks + maskSize * numFrusta, 0u);
+		if(outVisibleCounts)
+			std::fill(outVisibleCounts, outVisibleCounts + numFrusta, 0);
+		for(size_t i = 0; i < count; i += width) {
+			auto n = static_cast<uint32_t>(std::min<size_t>(width, count - i));
+			auto lanes = loadLanes(i, n);
+			for(uint32_t j = 0; j < numFrusta; ++j) {
+				auto bits = cull_lanes(lanes, frusta[j].GetPlaneVectors(), planeLanes[j], inOutLastPlanes ? (inOutLastPlanes + i) : nullptr, n);
+				// The simd width always divides 32, so the lanes never straddle two words
+				outVisibleMasks[j * maskSize + i / 32] |= bits << (i % 32);
+				if(outVisibleCounts)
+					outVisibleCounts[j] += std::popcount(bits);
+			}
+		}
+	}
+
+	// Culls each chunk into a local bit mask and appends the indices of the visible volumes
+	template<typename TLoadLanes>
+	size_t cull_parallel(const pragma::math::Frustum &frustum, size_t count, std::vector<uint32_t> &outVisibleIndices, uint32_t threadCount, const TLoadLanes &loadLanes)
+	{
+		pragma::math::parallel::parallel_compact(
+		  count, PARALLEL_CULL_CHUNK_SIZE,
+		  [&frustum, &loadLanes](size_t begin, size_t end, std::vector<uint32_t> &outIndices) {
+			  std::array<uint32_t, pragma::math::intersection::get_hit_mask_size(PARALLEL_CULL_CHUNK_SIZE)> mask;
+			  size_t numVisible;
+			  cull(&frustum, 1, end - begin, mask.data(), &numVisible, nullptr, [&loadLanes, begin](size_t i, uint32_t n) { return loadLanes(begin + i, n); });
+			  outIndices.reserve(numVisible);
+			  for(auto i = decltype(mask.size()) {0u}; i < pragma::math::intersection::get_hit_mask_size(end - begin); ++i) {
+				  for(auto bits = mask[i]; bits != 0; bits &= bits - 1)
+					  outIndices.push_back(static_cast<uint32_t>(begin + i * 32 + std::countr_zero(bits)));
+			  }
+		  },
+		  outVisibleIndices, threadCount);
+		return outVisibleIndices.size();
+	}
+};
+
+pragma::math::Frustum::Frustum()
+{
+	for(auto &plane : m_planes)
+		plane = {0.f, 0.f, 0.f, 0.f};
+}
+
+pragma::math::Frustum::Frustum(const Mat4 &viewProjection, bool reverseZ)
+{
+	// Gribb/Hartmann: A point is inside if dot(row, p) >= 0 for each of the clip space planes
+	auto row = [&viewProjection](uint32_t i) { return Vector4 {viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]}; };
+	auto r0 = row(0);
+	auto r1 = row(1);
+	auto r2 = row(2);
+	auto r3 = row(3);
+	// 0 <= z is the near plane and z <= w the far plane, or the other way around with reverse-Z
+	std::array<Vector4, PLANE_COUNT> clipPlanes {r3 + r0, r3 - r0, r3 + r1, r3 - r1, reverseZ ? (r3 - r2) : r2, reverseZ ? r2 : (r3 - r2)};
+	auto getNormal = [](const Vector4 &p) { return -Vector3 {p.x, p.y, p.z}; };
+
+	// The normal of the far plane of an infinite projection is zero, apart from rounding errors (e.g. glm::tweakedInfinitePerspective).
+	// The normals of the near and far plane are scaled by the same factor, whereas the plane distances grow with the distance of the camera
+	// from the origin, so only the normal lengths are compared. Their ratio is near / far for a finite perspective projection, and about 2.4e-7 for
+	// glm::tweakedInfinitePerspective. Far planes that are more than 1e6 times the near distance away are treated as infinite as well,
+	// which only makes the culling more conservative.
+	auto nearLength = uvec::length(getNormal(clipPlanes[static_cast<uint32_t>(PlaneIndex::Near)]));
+	auto farLength = uvec::length(getNormal(clipPlanes[static_cast<uint32_t>(PlaneIndex::Far)]));
+	auto isFarPlaneInfinite = farLength <= nearLength * 1e-6f;
+	for(auto i = decltype(clipPlanes.size()) {0u}; i < clipPlanes.size(); ++i) {
+		if(i == static_cast<uint32_t>(PlaneIndex::Far) && isFarPlaneInfinite) {
+			m_planes[i] = get_unbounded_plane();
+			continue;
+		}
+		m_planes[i] = normalize_plane(getNormal(clipPlanes[i]), clipPlanes[i].w);
+	}
+}
+
+pragma::math::Frustum::Frustum(const std::array<Vector3, 4> &nearCorners, const std::array<Vector3, 4> &farCorners)
+{
+	Vector3 nearCenter {};
+	Vector3 farCenter {};
+	for(auto i = decltype(nearCorners.size()) {0u}; i < nearCorners.size(); ++i) {
+		nearCenter += nearCorners[i];
+		farCenter += farCorners[i];
+	}
+	nearCenter /= 4.f;
+	farCenter /= 4.f;
+	auto center = (nearCenter + farCenter) * 0.5f;
+	// The orientation is derived from the frustum center, so the corners may be in either winding order
+	auto planeFromPoints = [&center](const Vector3 &a, const Vector3 &b, const Vector3 &c) {
+		auto n = uvec::get_normal(uvec::cross(b - a, c - a));
+		auto d = uvec::dot(n, a);
+		if(uvec::dot(n, center) - d > 0.f)
+			return Vector4 {-n, -d};
+		return Vector4 {n, d};
+	};
+	// Side planes in corner order: bottom-left -> top-left is the left plane, top-left -> top-right the top plane, etc.
+	constexpr std::array<PlaneIndex, 4> sidePlanes {PlaneIndex::Left, PlaneIndex::Top, PlaneIndex::Right, PlaneIndex::Bottom};
+	for(auto i = decltype(sidePlanes.size()) {0u}; i < sidePlanes.size(); ++i)
+		m_planes[static_cast<uint32_t>(sidePlanes[i])] = planeFromPoints(nearCorners[i], farCorners[i], farCorners[(i + 1) % 4]);
+	auto forward = uvec::get_normal(farCenter - nearCenter);
+	m_planes[static_cast<uint32_t>(PlaneIndex::Near)] = {-forward, -uvec::dot(forward, nearCenter)};
+	m_planes[static_cast<uint32_t>(PlaneIndex::Far)] = {forward, uvec::dot(forward, farCenter)};
+}
+
+pragma::math::Frustum::Frustum(const std::array<Plane, PLANE_COUNT> &planes)
+{
+	for(auto i = decltype(planes.size()) {0u}; i < planes.size(); ++i)
+		m_planes[i] = {planes[i].GetNormal(), static_cast<float>(planes[i].GetDistance())};
+}
+
+pragma::math::Frustum pragma::math::Frustum::CreatePerspective(const Vector3 &pos, const Vector3 &forward, const Vector3 &up, float fovRad, float aspectRatio, float nearZ, float farZ)
+{
+	return Frustum {frustum::get_plane_boundaries(pos, forward, up, fovRad, nearZ, aspectRatio, nullptr, nullptr), frustum::get_plane_boundaries(pos, forward, up, fovRad, farZ, aspectRatio, nullptr, nullptr)};
+}
+
+std::vector<pragma::math::Plane> pragma::math::Frustum::GetPlanes() const
+{
+	static_assert(static_cast<uint32_t>(PlaneIndex::Far) == PLANE_COUNT - 1);
+	auto numPlanes = HasFarPlane() ? m_planes.size() : (m_planes.size() - 1);
+	std::vector<Plane> planes;
+	planes.reserve(numPlanes);
+	for(auto i = decltype(m_planes.size()) {0u}; i < numPlanes; ++i)
+		planes.push_back(Plane {Vector3 {m_planes[i].x, m_planes[i].y, m_planes[i].z}, static_cast<double>(m_planes[i].w)});
+	return planes;
+}
+
+bool pragma::math::Frustum::HasFarPlane() const { return !is_unbounded_plane(m_planes[static_cast<uint32_t>(PlaneIndex::Far)]); }
+
+std::array<Vector3, 8> pragma::math::Frustum::GetCorners() const
+{
+	std::array<Vector3, 8> corners;
+	auto intersect = [this](PlaneIndex a, PlaneIndex b, PlaneIndex c) {
+		auto &pa = m_planes[static_cast<uint32_t>(a)];
+		auto &pb = m_planes[static_cast<uint32_t>(b)];
+		auto &pc = m_planes[static_cast<uint32_t>(c)];
+		Vector3 p {std::numeric_limits<float>::infinity()};
+		// GetPlaneIntersection expects planes of the form dot(n, p) + d = 0
+		Plane::GetPlaneIntersection(&p, Vector3 {pa.x, pa.y, pa.z}, Vector3 {pb.x, pb.y, pb.z}, Vector3 {pc.x, pc.y, pc.z}, -pa.w, -pb.w, -pc.w);
+		return p;
+	};
+	constexpr std::array<std::pair<PlaneIndex, PlaneIndex>, 4> sides {std::pair {PlaneIndex::Left, PlaneIndex::Bottom}, std::pair {PlaneIndex::Left, PlaneIndex::Top}, std::pair {PlaneIndex::Right, PlaneIndex::Top}, std::pair {PlaneIndex::Right, PlaneIndex::Bottom}};
+	for(auto i = decltype(sides.size()) {0u}; i < sides.size(); ++i) {
+		corners[i] = intersect(sides[i].first, sides[i].second, PlaneIndex::Near);
+		corners[i + 4] = intersect(sides[i].first, sides[i].second, PlaneIndex::Far);
+	}
+	return corners;
+}
+
+pragma::math::intersection::Intersect pragma::math::Frustum::ClassifyAabb(const Vector3 &min, const Vector3 &max) const
+{
+	auto mask = PLANE_MASK_ALL;
+	auto lastPlane = INVALID_PLANE;
+	return ClassifyAabb(min, max, mask, lastPlane);
+}
+
+pragma::math::intersection::Intersect pragma::math::Frustum::ClassifySphere(const Vector3 &origin, float radius) const
+{
+	auto mask = PLANE_MASK_ALL;
+	auto lastPlane = INVALID_PLANE;
+	return ClassifySphere(origin, radius, mask, lastPlane);
+}
+
+pragma::math::intersection::Intersect pragma::math::Frustum::ClassifyAabb(const Vector3 &min, const Vector3 &max, uint8_t &inOutPlaneMask, uint8_t &inOutLastPlane) const
+{
+	auto center = (min + max) * 0.5f;
+	auto extents = (max - min) * 0.5f;
+	return classify(m_planes, inOutPlaneMask, inOutLastPlane, [&center, &extents](const Vector4 &plane) -> std::pair<float, float> {
+		return {plane_distance(plane, center), std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z};
+	});
+}
+
+pragma::math::intersection::Intersect pragma::math::Frustum::ClassifySphere(const Vector3 &origin, float radius, uint8_t &inOutPlaneMask, uint8_t &inOutLastPlane) const
+{
+	return classify(m_planes, inOutPlaneMask, inOutLastPlane, [&origin, radius](const Vector4 &plane) -> std::pair<float, float> { return {plane_distance(plane, origin), radius}; });
+}
+
+size_t pragma::math::Frustum::CullAabbs(const AabbSoaView &boxes, uint32_t *outVisibleMask, uint8_t *inOutLastPlanes) const
+{
+	size_t numVisible;
+	cull(this, 1, boxes.count, outVisibleMask, &numVisible, inOutLastPlanes, [&boxes](size_t i, uint32_t n) { return load_aabb_lanes(boxes, i, n); });
+	return numVisible;
+}
+
+size_t pragma::math::Frustum::CullSpheres(const SphereSoaView &spheres, uint32_t *outVisibleMask, uint8_t *inOutLastPlanes) const
+{
+	size_t numVisible;
+	cull(this, 1, spheres.count, outVisibleMask, &numVisible, inOutLastPlanes, [&spheres](size_t i, uint32_t n) { return load_sphere_lanes(spheres, i, n); });
+	return numVisible;
+}
+
+size_t pragma::math::Frustum::CullAabbs(const AabbSoaView &boxes, std::vector<uint32_t> &outVisibleIndices, uint32_t threadCount) const
+{
+	return cull_parallel(*this, boxes.count, outVisibleIndices, threadCount, [&boxes](size_t i, uint32_t n) { return load_aabb_lanes(boxes, i, n); });
+}
+
+size_t pragma::math::Frustum::CullSpheres(const SphereSoaView &spheres, std::vector<uint32_t> &outVisibleIndices, uint32_t threadCount) const
+{
+	return cull_parallel(*this, spheres.count, outVisibleIndices, threadCount, [&spheres](size_t i, uint32_t n) { return load_sphere_lanes(spheres, i, n); });
+}
+
+void pragma::math::Frustum::CullAabbs(const Frustum *frusta, uint32_t numFrusta, const AabbSoaView &boxes, uint32_t *outVisibleMasks, size_t *outVisibleCounts)
+{
+	cull(frusta, numFrusta, boxes.count, outVisibleMasks, outVisibleCounts, nullptr, [&boxes](size_t i, uint32_t n) { return load_aabb_lanes(boxes, i, n); });
+}
+
+void pragma::math::Frustum::CullSpheres(const Frustum *frusta, uint32_t numFrusta, const SphereSoaView &spheres, uint32_t *outVisibleMasks, size_t *outVisibleCounts)
+{
+	cull(frusta, numFrusta, spheres.count, outVisibleMasks, outVisibleCounts, nullptr, [&spheres](size_t i, uint32_t n) { return load_sphere_lanes(spheres, i, n); });
+}
@@ -119,14 +119,75 @@ bool pragma::math::intersection::obb_plane(const Vector3 &min, const Vector3 &ma
 
 pragma::math::intersection::Intersect pragma::math::intersection::obb_obb(const ScaledTransform &obbPoseA, const Vector3 &obbMinA, const Vector3 &obbMaxA, const ScaledTransform &obbPoseB, const Vector3 &obbMinB, const Vector3 &obbMaxB)
 {
-	auto obbPoseBRelToA = obbPoseA.GetInverse() * obbPoseB;
-	return aabb_obb(obbMinA, obbMaxA, obbPoseBRelToA.GetOrigin(), obbPoseBRelToA.GetRotation(), obbMinB, obbMaxB);
+	return obb_obb(get_oriented_box(obbPoseA, obbMinA, obbMaxA), get_oriented_box(obbPoseB, obbMinB, obbMaxB));
 }
 
 pragma::math::intersection::Intersect pragma::math::intersection::aabb_obb(const Vector3 &aabbMin, const Vector3 &aabbMax, const Vector3 &obbOrigin, const Quat &obbRot, const Vector3 &obbMin, const Vector3 &obbMax)
 {
-	auto planes = geometry::get_obb_planes(obbOrigin, obbRot, obbMin, obbMax);
-	return aabb_in_plane_mesh(aabbMin, aabbMax, planes.begin(), planes.end());
+	return obb_obb(OrientedBox {(aabbMin + aabbMax) * 0.5f, (aabbMax - aabbMin) * 0.5f, Mat3 {1.f}}, get_oriented_box(obbOrigin, obbRot, obbMin, obbMax));
+}
+
+pragma::math::intersection::OrientedBox pragma::math::intersection::get_oriented_box(const Vector3 &origin, const Quat &rot, const Vector3 &min, const Vector3 &max)
+{
+	return {origin + rot * ((min + max) * 0.5f), (max - min) * 0.5f, glm::mat3_cast(rot)};
+}
+
+pragma::math::intersection::OrientedBox pragma::math::intersection::get_oriented_box(const ScaledTransform &pose, const Vector3 &min, const Vector3 &max)
+{
+	return {pose * ((min + max) * 0.5f), glm::abs((max - min) * 0.5f * pose.GetScale()), glm::mat3_cast(pose.GetRotation())};
+}
+
+pragma::math::intersection::Intersect pragma::math::intersection::obb_obb(const OrientedBox &a, const OrientedBox &b)
+{
+	// Source: Christer Ericson, "Real-Time Collision Detection", 4.4.1
+	// r[i][j] is the cosine between axis i of a and axis j of b. The epsilon prevents false separations on the
+	// edge-edge axes if two edges are (nearly) parallel, in which case their cross product is close to zero.
+	// The containment test subtracts it instead, so that equal boxes are inside of each other despite rounding in the cosines.
+	constexpr auto parallelEpsilon = 1e-6f;
+	float r[3][3];
+	float absR[3][3];
+	float containR[3][3];
+	for(uint8_t i = 0; i < 3; ++i) {
+		for(uint8_t j = 0; j < 3; ++j) {
+			r[i][j] = uvec::dot(a.axes[i], b.axes[j]);
+			absR[i][j] = std::abs(r[i][j]) + parallelEpsilon;
+			containR[i][j] = std::max(std::abs(r[i][j]) - parallelEpsilon, 0.f);
+		}
+	}
+	auto d = b.center - a.center;
+	// Offset between the centers in the frame of a
+	Vector3 t {uvec::dot(d, a.axes[0]), uvec::dot(d, a.axes[1]), uvec::dot(d, a.axes[2])};
+	auto &ea = a.halfExtents;
+	auto &eb = b.halfExtents;
+
+	for(uint8_t i = 0; i < 3; ++i) {
+		auto rb = eb[0] * absR[i][0] + eb[1] * absR[i][1] + eb[2] * absR[i][2];
+		if(std::abs(t[i]) > ea[i] + rb)
+			return Intersect::Outside;
+	}
+	// The face axes of b also decide whether a is inside of b
+	auto inside = true;
+	for(uint8_t j = 0; j < 3; ++j) {
+		auto dist = std::abs(uvec::dot(d, b.axes[j]));
+		auto ra = ea[0] * absR[0][j] + ea[1] * absR[1][j] + ea[2] * absR[2][j];
+		if(dist > ra + eb[j])
+			return Intersect::Outside;
+		if(inside && dist + ea[0] * containR[0][j] + ea[1] * containR[1][j] + ea[2] * containR[2][j] > eb[j])
+			inside = false;
+	}
+	for(uint8_t i = 0; i < 3; ++i) {
+		auto i1 = (i + 1) % 3;
+		auto i2 = (i + 2) % 3;
+		for(uint8_t j = 0; j < 3; ++j) {
+			auto j1 = (j + 1) % 3;
+			auto j2 = (j + 2) % 3;
+			auto ra = ea[i1] * absR[i2][j] + ea[i2] * absR[i1][j];
+			auto rb = eb[j1] * absR[i][j2] + eb[j2] * absR[i][j1];
+			if(std::abs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb)
+				return Intersect::Outside;
+		}
+	}
+	return inside ? Intersect::Inside : Intersect::Overlap;
 }
 
 bool pragma::math::intersection::aabb_plane(const Vector3 &min, const Vector3 &max, const Vector3 &n, double d) { return obb_plane(min, max, {}, {}, n, d); }
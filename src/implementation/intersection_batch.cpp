@@ -0,0 +1,419 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+#include "simd.hpp"
+
+module pragma.math;
+
+import :intersection_batch;
+
+pragma::math::AabbSoaBuffer::AabbSoaBuffer(const std::vector<bounding_volume::AABB> &aabbs)
+{
+	Reserve(aabbs.size());
+	for(auto &aabb : aabbs)
+		Add(aabb.min, aabb.max);
+}
+void pragma::math::AabbSoaBuffer::Reserve(size_t count)
+{
+	for(auto *v : {&m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ})
+		v->reserve(count);
+}
+void pragma::math::AabbSoaBuffer::Resize(size_t count)
+{
+	for(auto *v : {&m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ})
+		v->resize(count);
+}
+void pragma::math::AabbSoaBuffer::Clear()
+{
+	for(auto *v : {&m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ})
+		v->clear();
+}
+void pragma::math::AabbSoaBuffer::Add(const Vector3 &min, const Vector3 &max)
+{
+	m_minX.push_back(min.x);
+	m_minY.push_back(min.y);
+	m_minZ.push_back(min.z);
+	m_maxX.push_back(max.x);
+	m_maxY.push_back(max.y);
+	m_maxZ.push_back(max.z);
+}
+void pragma::math::AabbSoaBuffer::Set(size_t idx, const Vector3 &min, const Vector3 &max)
+{
+	m_minX[idx] = min.x;
+	m_minY[idx] = min.y;
+	m_minZ[idx] = min.z;
+	m_maxX[idx] = max.x;
+	m_maxY[idx] = max.y;
+	m_maxZ[idx] = max.z;
+}
+bounding_volume::AABB pragma::math::AabbSoaBuffer::Get(size_t idx) const { return {{m_minX[idx], m_minY[idx], m_minZ[idx]}, {m_maxX[idx], m_maxY[idx], m_maxZ[idx]}}; }
+pragma::math::AabbSoaView pragma::math::AabbSoaBuffer::GetView() const { return GetView(0, Size()); }
+pragma::math::AabbSoaView pragma::math::AabbSoaBuffer::GetView(size_t offset, size_t count) const
+{
+	AabbSoaView view {};
+	view.minX = m_minX.data() + offset;
+	view.minY = m_minY.data() + offset;
+	view.minZ = m_minZ.data() + offset;
+	view.maxX = m_maxX.data() + offset;
+	view.maxY = m_maxY.data() + offset;
+	view.maxZ = m_maxZ.data() + offset;
+	view.count = count;
+	return view;
+}
+
+pragma::math::SphereSoaBuffer::SphereSoaBuffer(const std::vector<bounding_volume::Sphere> &spheres)
+{
+	Reserve(spheres.size());
+	for(auto &sphere : spheres)
+		Add(sphere.origin, sphere.radius);
+}
+void pragma::math::SphereSoaBuffer::Reserve(size_t count)
+{
+	for(auto *v : {&m_x, &m_y, &m_z, &m_radius})
+		v->reserve(count);
+}
+void pragma::math::SphereSoaBuffer::Resize(size_t count)
+{
+	for(auto *v : {&m_x, &m_y, &m_z, &m_radius})
+		v->resize(count);
+}
+void pragma::math::SphereSoaBuffer::Clear()
+{
+	for(auto *v : {&m_x, &m_y, &m_z, &m_radius})
+		v->clear();
+}
+void pragma::math::SphereSoaBuffer::Add(const Vector3 &origin, float radius)
+{
+	m_x.push_back(origin.x);
+	m_y.push_back(origin.y);
+	m_z.push_back(origin.z);
+	m_radius.push_back(radius);
+}
+void pragma::math::SphereSoaBuffer::Set(size_t idx, const Vector3 &origin, float radius)
+{
+	m_x[idx] = origin.x;
+	m_y[idx] = origin.y;
+	m_z[idx] = origin.z;
+	m_radius[idx] = radius;
+}
+bounding_volume::Sphere pragma::math::SphereSoaBuffer::Get(size_t idx) const { return {{m_x[idx], m_y[idx], m_z[idx]}, m_radius[idx]}; }
+pragma::math::SphereSoaView pragma::math::SphereSoaBuffer::GetView() const { return GetView(0, Size()); }
+pragma::math::SphereSoaView pragma::math::SphereSoaBuffer::GetView(size_t offset, size_t count) const
+{
+	SphereSoaView view {};
+	view.x = m_x.data() + offset;
+	view.y = m_y.data() + offset;
+	view.z = m_z.data() + offset;
+	view.radius = m_radius.data() + offset;
+	view.count = count;
+	return view;
+}
+
+pragma::math::ObbSoaBuffer::ObbSoaBuffer(const std::vector<intersection::OrientedBox> &boxes)
+{
+	Reserve(boxes.size());
+	for(auto &box : boxes)
+		Add(box);
+}
+std::array<std::vector<float> *, 15> pragma::math::ObbSoaBuffer::GetArrays()
+{
+	return {&m_centerX, &m_centerY, &m_centerZ, &m_halfExtentX, &m_halfExtentY, &m_halfExtentZ, &m_axis0X, &m_axis0Y, &m_axis0Z, &m_axis1X, &m_axis1Y, &m_axis1Z, &m_axis2X, &m_axis2Y, &m_axis2Z};
+}
+void pragma::math::ObbSoaBuffer::Reserve(size_t count)
+{
+	for(auto *v : GetArrays())
+		v->reserve(count);
+}
+void pragma::math::ObbSoaBuffer::Resize(size_t count)
+{
+	for(auto *v : GetArrays())
+		v->resize(count);
+}
+void pragma::math::ObbSoaBuffer::Clear()
+{
+	for(auto *v : GetArrays())
+		v->clear();
+}
+void pragma::math::ObbSoaBuffer::Add(const intersection::OrientedBox &box)
+{
+	Resize(Size() + 1);
+	Set(Size() - 1, box);
+}
+void pragma::math::ObbSoaBuffer::Set(size_t idx, const intersection::OrientedBox &box)
+{
+	m_centerX[idx] = box.center.x;
+	m_centerY[idx] = box.center.y;
+	m_centerZ[idx] = box.center.z;
+	m_halfExtentX[idx] = box.halfExtents.x;
+	m_halfExtentY[idx] = box.halfExtents.y;
+	m_halfExtentZ[idx] = box.halfExtents.z;
+	m_axis0X[idx] = box.axes[0].x;
+	m_axis0Y[idx] = box.axes[0].y;
+	m_axis0Z[idx] = box.axes[0].z;
+	m_axis1X[idx] = box.axes[1].x;
+	m_axis1Y[idx] = box.axes[1].y;
+	m_axis1Z[idx] = box.axes[1].z;
+	m_axis2X[idx] = box.axes[2].x;
+	m_axis2Y[idx] = box.axes[2].y;
+	m_axis2Z[idx] = box.axes[2].z;
+}
+pragma::math::intersection::OrientedBox pragma::math::ObbSoaBuffer::Get(size_t idx) const
+{
+	intersection::OrientedBox box;
+	box.center = {m_centerX[idx], m_centerY[idx], m_centerZ[idx]};
+	box.halfExtents = {m_halfExtentX[idx], m_halfExtentY[idx], m_halfExtentZ[idx]};
+	box.axes[0] = {m_axis0X[idx], m_axis0Y[idx], m_axis0Z[idx]};
+	box.axes[1] = {m_axis1X[idx], m_axis1Y[idx], m_axis1Z[idx]};
+	box.axes[2] = {m_axis2X[idx], m_axis2Y[idx], m_axis2Z[idx]};
+	return box;
+}
+pragma::math::ObbSoaView pragma::math::ObbSoaBuffer::GetView() const { return GetView(0, Size()); }
+pragma::math::ObbSoaView pragma::math::ObbSoaBuffer::GetView(size_t offset, size_t count) const
+{
+	ObbSoaView view {};
+	view.centerX = m_centerX.data() + offset;
+	view.centerY = m_centerY.data() + offset;
+	view.centerZ = m_centerZ.data() + offset;
+	view.halfExtentX = m_halfExtentX.data() + offset;
+	view.halfExtentY = m_halfExtentY.data() + offset;
+	view.halfExtentZ = m_halfExtentZ.data() + offset;
+	view.axis0X = m_axis0X.data() + offset;
+	view.axis0Y = m_axis0Y.data() + offset;
+	view.axis0Z = m_axis0Z.data() + offset;
+	view.axis1X = m_axis1X.data() + offset;
+	view.axis1Y = m_axis1Y.data() + offset;
+	view.axis1Z = m_axis1Z.data() + offset;
+	view.axis2X = m_axis2X.data() + offset;
+	view.axis2Y = m_axis2Y.data() + offset;
+	view.axis2Z = m_axis2Z.data() + offset;
+	view.count = count;
+	return view;
+}
+
+////////////////////////////////////
+
+pragma::math::intersection::Ray::Ray(const Vector3 &origin, const Vector3 &dir) : origin {origin}, dir {dir}, dirInv {1 / dir.x, 1 / dir.y, 1 / dir.z}
+{
+	sign = {static_cast<uint8_t>(dirInv.x < 0), static_cast<uint8_t>(dirInv.y < 0), static_cast<uint8_t>(dirInv.z < 0)};
+}
+
+pragma::math::intersection::Result pragma::math::intersection::line_aabb(const Ray &ray, const Vector3 &min, const Vector3 &max, float *tMinRes, float *tMaxRes)
+{
+	auto &o = ray.origin;
+	auto &dirInv = ray.dirInv;
+	auto &sign = ray.sign;
+	const Vector3 *bounds[] = {&min, &max};
+	float tMin = (bounds[sign[0]]->x - o.x) * dirInv.x;
+	float tMax = (bounds[1 - sign[0]]->x - o.x) * dirInv.x;
+	float tyMin = (bounds[sign[1]]->y - o.y) * dirInv.y;
+	float tyMax = (bounds[1 - sign[1]]->y - o.y) * dirInv.y;
+	if((tMin > tyMax) || (tyMin > tMax))
+		return Result::NoIntersection;
+	if(tyMin > tMin)
+		tMin = tyMin;
+	if(tyMax < tMax)
+		tMax = tyMax;
+	float tzMin = (bounds[sign[2]]->z - o.z) * dirInv.z;
+	float tzMax = (bounds[1 - sign[2]]->z - o.z) * dirInv.z;
+	if((tMin > tzMax) || (tzMin > tMax))
+		return Result::NoIntersection;
+	if(tzMin > tMin)
+		tMin = tzMin;
+	if(tzMax < tMax)
+		tMax = tzMax;
+	if(tMinRes != nullptr)
+		*tMinRes = tMin;
+	if(tMaxRes != nullptr)
+		*tMaxRes = tMax;
+	return Result::Intersect;
+}
+
+namespace {
+	struct SlabPointers {
+		const float *nearX;
+		const float *nearY;
+		const float *nearZ;
+		const float *farX;
+		const float *farY;
+		const float *farZ;
+	};
+	struct RayLanes {
+		pragma::math::simd::vfloat ox, oy, oz;
+		pragma::math::simd::vfloat ix, iy, iz;
+	};
+
+	// Mirrors the scalar line_aabb, including its comparison order, so that NaN and edge cases resolve identically.
+	// Note that simd::min/max have the semantics (a < b) ? a : b and (a > b) ? a : b.
+	uint32_t line_aabb_lanes(const RayLanes &ray, pragma::math::simd::vfloat nearX, pragma::math::simd::vfloat nearY, pragma::math::simd::vfloat nearZ, pragma::math::simd::vfloat farX, pragma::math::simd::vfloat farY, pragma::math::simd::vfloat farZ,
+	  pragma::math::simd::vfloat &outTMin, pragma::math::simd::vfloat &outTMax)
+	{
+		using namespace pragma::math::simd;
+		auto tMin = (nearX - ray.ox) * ray.ix;
+		auto tMax = (farX - ray.ox) * ray.ix;
+		auto tyMin = (nearY - ray.oy) * ray.iy;
+		auto tyMax = (farY - ray.oy) * ray.iy;
+		auto miss = cmp_gt(tMin, tyMax) | cmp_gt(tyMin, tMax);
+		tMin = max(tyMin, tMin);
+		tMax = min(tyMax, tMax);
+		auto tzMin = (nearZ - ray.oz) * ray.iz;
+		auto tzMax = (farZ - ray.oz) * ray.iz;
+		miss |= cmp_gt(tMin, tzMax) | cmp_gt(tzMin, tMax);
+		outTMin = max(tzMin, tMin);
+		outTMax = min(tzMax, tMax);
+		return to_bits(~miss);
+	}
+};
+
+size_t pragma::math::intersection::line_aabb(const Ray &ray, const AabbSoaView &boxes, uint32_t *outHitMask, float *outTMin, float *outTMax)
+{
+	using namespace simd;
+	// The near and far slab only depend on the ray direction, so we can select them once for all boxes
+	SlabPointers slabs {ray.sign[0] ? boxes.maxX : boxes.minX, ray.sign[1] ? boxes.maxY : boxes.minY, ray.sign[2] ? boxes.maxZ : boxes.minZ, ray.sign[0] ? boxes.minX : boxes.maxX, ray.sign[1] ? boxes.minY : boxes.maxY, ray.sign[2] ? boxes.minZ : boxes.maxZ};
+	RayLanes lanes {set1(ray.origin.x), set1(ray.origin.y), set1(ray.origin.z), set1(ray.dirInv.x), set1(ray.dirInv.y), set1(ray.dirInv.z)};
+
+	std::fill(outHitMask, outHitMask + get_hit_mask_size(boxes.count), 0u);
+	size_t numHits = 0;
+	auto writeHits = [outHitMask, &numHits](size_t i, uint32_t bits) {
+		// The simd width always divides 32, so the lanes never straddle two words
+		outHitMask[i / 32] |= bits << (i % 32);
+		numHits += std::popcount(bits);
+	};
+
+	size_t i = 0;
+	auto numFull = boxes.count - (boxes.count % width);
+	for(; i < numFull; i += width) {
+		vfloat tMin, tMax;
+		auto bits = line_aabb_lanes(lanes, load(slabs.nearX + i), load(slabs.nearY + i), load(slabs.nearZ + i), load(slabs.farX + i), load(slabs.farY + i), load(slabs.farZ + i), tMin, tMax);
+		writeHits(i, bits);
+		if(outTMin)
+			store(outTMin + i, tMin);
+		if(outTMax)
+			store(outTMax + i, tMax);
+	}
+	if(i < boxes.count) {
+		auto n = static_cast<uint32_t>(boxes.count - i);
+		vfloat tMin, tMax;
+		auto bits = line_aabb_lanes(lanes, load_partial(slabs.nearX + i, n), load_partial(slabs.nearY + i, n), load_partial(slabs.nearZ + i, n), load_partial(slabs.farX + i, n), load_partial(slabs.farY + i, n), load_partial(slabs.farZ + i, n), tMin, tMax);
+		writeHits(i, bits & lane_mask(n));
+		if(outTMin)
+			store_partial(outTMin + i, tMin, n);
+		if(outTMax)
+			store_partial(outTMax + i, tMax, n);
+	}
+	return numHits;
+}
+
+size_t pragma::math::intersection::sphere_in_plane_mesh(const SphereSoaView &spheres, const Plane *planes, size_t numPlanes, Intersect *outResults, bool skipInsideTest)
+{
+	using namespace simd;
+	// Plane::GetDistance(p) is dot(n, p - center), the dot product with the center is hoisted out of the loop
+	struct PlaneLanes {
+		vfloat nx, ny, nz, d;
+	};
+	std::vector<PlaneLanes> planeLanes;
+	planeLanes.reserve(numPlanes);
+	for(size_t i = 0; i < numPlanes; ++i) {
+		auto &n = planes[i].GetNormal();
+		planeLanes.push_back({set1(n.x), set1(n.y), set1(n.z), set1(uvec::dot(n, planes[i].GetCenterPos()))});
+	}
+	size_t numNotOutside = 0;
+	for(size_t i = 0; i < spheres.count; i += width) {
+		auto n = static_cast<uint32_t>(std::min<size_t>(width, spheres.count - i));
+		auto laneBits = lane_mask(n);
+		auto x = load_partial(spheres.x + i, n);
+		auto y = load_partial(spheres.y + i, n);
+		auto z = load_partial(spheres.z + i, n);
+		auto r = load_partial(spheres.radius + i, n);
+		auto negR = -r;
+		uint32_t outside = 0;
+		uint32_t overlap = 0;
+		for(auto &plane : planeLanes) {
+			auto dist = fmadd(plane.nx, x, fmadd(plane.ny, y, plane.nz * z)) - plane.d;
+			outside |= to_bits(cmp_gt(dist, r));
+			overlap |= to_bits(cmp_gt(dist, negR));
+			if((outside & laneBits) == laneBits)
+				break;
+		}
+		if(skipInsideTest)
+			overlap = laneBits;
+		for(uint32_t j = 0; j < n; ++j) {
+			auto bit = 1u << j;
+			outResults[i + j] = (outside & bit) ? Intersect::Outside : ((overlap & bit) ? Intersect::Overlap : Intersect::Inside);
+		}
+		numNotOutside += std::popcount(~outside & laneBits);
+	}
+	return numNotOutside;
+}
+
+size_t pragma::math::intersection::obb_obb(const ObbSoaView &boxes, const OrientedBox &obb, Intersect *outResults)
+{
+	using namespace simd;
+	// Mirrors the scalar obb_obb with a = boxes[i] and b = obb
+	constexpr auto parallelEpsilon = 1e-6f;
+	std::array<std::array<vfloat, 3>, 3> bAxes;
+	for(uint8_t j = 0; j < 3; ++j)
+		bAxes[j] = {set1(obb.axes[j].x), set1(obb.axes[j].y), set1(obb.axes[j].z)};
+	std::array<vfloat, 3> bCenter {set1(obb.center.x), set1(obb.center.y), set1(obb.center.z)};
+	std::array<vfloat, 3> eb {set1(obb.halfExtents.x), set1(obb.halfExtents.y), set1(obb.halfExtents.z)};
+	auto epsilon = set1(parallelEpsilon);
+	auto dot = [](const std::array<vfloat, 3> &u, const std::array<vfloat, 3> &v) { return fmadd(u[0], v[0], fmadd(u[1], v[1], u[2] * v[2])); };
+
+	size_t numNotOutside = 0;
+	for(size_t i = 0; i < boxes.count; i += width) {
+		auto n = static_cast<uint32_t>(std::min<size_t>(width, boxes.count - i));
+		auto laneBits = lane_mask(n);
+		std::array<std::array<vfloat, 3>, 3> aAxes {{
+		  {load_partial(boxes.axis0X + i, n), load_partial(boxes.axis0Y + i, n), load_partial(boxes.axis0Z + i, n)},
+		  {load_partial(boxes.axis1X + i, n), load_partial(boxes.axis1Y + i, n), load_partial(boxes.axis1Z + i, n)},
+		  {load_partial(boxes.axis2X + i, n), load_partial(boxes.axis2Y + i, n), load_partial(boxes.axis2Z + i, n)},
+		}};
+		std::array<vfloat, 3> ea {load_partial(boxes.halfExtentX + i, n), load_partial(boxes.halfExtentY + i, n), load_partial(boxes.halfExtentZ + i, n)};
+		std::array<vfloat, 3> d {bCenter[0] - load_partial(boxes.centerX + i, n), bCenter[1] - load_partial(boxes.centerY + i, n), bCenter[2] - load_partial(boxes.centerZ + i, n)};
+		vfloat r[3][3];
+		vfloat absR[3][3];
+		vfloat containR[3][3];
+		for(uint8_t a = 0; a < 3; ++a) {
+			for(uint8_t b = 0; b < 3; ++b) {
+				r[a][b] = dot(aAxes[a], bAxes[b]);
+				absR[a][b] = abs(r[a][b]) + epsilon;
+				containR[a][b] = max(abs(r[a][b]) - epsilon, zero());
+			}
+		}
+		std::array<vfloat, 3> t {dot(d, aAxes[0]), dot(d, aAxes[1]), dot(d, aAxes[2])};
+
+		uint32_t outside = 0;
+		for(uint8_t a = 0; a < 3; ++a) {
+			auto rb = fmadd(eb[0], absR[a][0], fmadd(eb[1], absR[a][1], eb[2] * absR[a][2]));
+			outside |= to_bits(cmp_gt(abs(t[a]), ea[a] + rb));
+		}
+		uint32_t notInside = 0;
+		for(uint8_t b = 0; b < 3; ++b) {
+			auto dist = abs(dot(d, bAxes[b]));
+			auto ra = fmadd(ea[0], absR[0][b], fmadd(ea[1], absR[1][b], ea[2] * absR[2][b]));
+			outside |= to_bits(cmp_gt(dist, ra + eb[b]));
+			auto raContained = fmadd(ea[0], containR[0][b], fmadd(ea[1], containR[1][b], ea[2] * containR[2][b]));
+			notInside |= to_bits(cmp_gt(dist + raContained, eb[b]));
+		}
+		if((outside & laneBits) != laneBits) {
+			for(uint8_t a = 0; a < 3; ++a) {
+				auto a1 = (a + 1) % 3;
+				auto a2 = (a + 2) % 3;
+				for(uint8_t b = 0; b < 3; ++b) {
+					auto b1 = (b + 1) % 3;
+					auto b2 = (b + 2) % 3;
+					auto ra = fmadd(ea[a1], absR[a2][b], ea[a2] * absR[a1][b]);
+					auto rb = fmadd(eb[b1], absR[a][b2], eb[b2] * absR[a][b1]);
+					outside |= to_bits(cmp_gt(abs(t[a2] * r[a1][b] - t[a1] * r[a2][b]), ra + rb));
+				}
+			}
+		}
+		for(uint32_t j = 0; j < n; ++j) {
+			auto bit = 1u << j;
+			outResults[i + j] = (outside & bit) ? Intersect::Outside : ((notInside & bit) ? Intersect::Overlap : Intersect::Inside);
+		}
+		numNotOutside += std::popcount(~outside & laneBits);
+	}
+	return numNotOutside;
+}
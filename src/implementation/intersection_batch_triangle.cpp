@@ -0,0 +1,203 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+#include "simd.hpp"
+
+module pragma.math;
+
+import :intersection_batch;
+
+pragma::math::TriangleSoaBuffer::TriangleSoaBuffer(const std::vector<Vector3> &verts, const std::vector<uint16_t> &triangles) { Initialize(verts, triangles); }
+pragma::math::TriangleSoaBuffer::TriangleSoaBuffer(const std::vector<Vector3> &verts, const std::vector<uint32_t> &triangles) { Initialize(verts, triangles); }
+template<typename TIndex>
+void pragma::math::TriangleSoaBuffer::Initialize(const std::vector<Vector3> &verts, const std::vector<TIndex> &triangles)
+{
+	auto numTris = triangles.size() / 3;
+	Reserve(numTris);
+	for(auto i = decltype(numTris) {0u}; i < numTris; ++i)
+		Add(verts[triangles[i * 3]], verts[triangles[i * 3 + 1]], verts[triangles[i * 3 + 2]]);
+}
+void pragma::math::TriangleSoaBuffer::Reserve(size_t count)
+{
+	for(auto *v : {&m_v0x, &m_v0y, &m_v0z, &m_e1x, &m_e1y, &m_e1z, &m_e2x, &m_e2y, &m_e2z})
+		v->reserve(count);
+}
+void pragma::math::TriangleSoaBuffer::Clear()
+{
+	for(auto *v : {&m_v0x, &m_v0y, &m_v0z, &m_e1x, &m_e1y, &m_e1z, &m_e2x, &m_e2y, &m_e2z})
+		v->clear();
+}
+void pragma::math::TriangleSoaBuffer::Add(const Vector3 &v0, const Vector3 &v1, const Vector3 &v2)
+{
+	auto e1 = v1 - v0;
+	auto e2 = v2 - v0;
+	m_v0x.push_back(v0.x);
+	m_v0y.push_back(v0.y);
+	m_v0z.push_back(v0.z);
+	m_e1x.push_back(e1.x);
+	m_e1y.push_back(e1.y);
+	m_e1z.push_back(e1.z);
+	m_e2x.push_back(e2.x);
+	m_e2y.push_back(e2.y);
+	m_e2z.push_back(e2.z);
+}
+void pragma::math::TriangleSoaBuffer::Set(size_t idx, const Vector3 &v0, const Vector3 &v1, const Vector3 &v2)
+{
+	auto e1 = v1 - v0;
+	auto e2 = v2 - v0;
+	m_v0x[idx] = v0.x;
+	m_v0y[idx] = v0.y;
+	m_v0z[idx] = v0.z;
+	m_e1x[idx] = e1.x;
+	m_e1y[idx] = e1.y;
+	m_e1z[idx] = e1.z;
+	m_e2x[idx] = e2.x;
+	m_e2y[idx] = e2.y;
+	m_e2z[idx] = e2.z;
+}
+std::array<Vector3, 3> pragma::math::TriangleSoaBuffer::Get(size_t idx) const
+{
+	Vector3 v0 {m_v0x[idx], m_v0y[idx], m_v0z[idx]};
+	return {v0, v0 + Vector3 {m_e1x[idx], m_e1y[idx], m_e1z[idx]}, v0 + Vector3 {m_e2x[idx], m_e2y[idx], m_e2z[idx]}};
+}
+pragma::math::TriangleSoaView pragma::math::TriangleSoaBuffer::GetView() const
+{
+	TriangleSoaView view {};
+	view.v0x = m_v0x.data();
+	view.v0y = m_v0y.data();
+	view.v0z = m_v0z.data();
+	view.e1x = m_e1x.data();
+	view.e1y = m_e1y.data();
+	view.e1z = m_e1z.data();
+	view.e2x = m_e2x.data();
+	view.e2y = m_e2y.data();
+	view.e2z = m_e2z.data();
+	view.count = Size();
+	return view;
+}
+
+////////////////////////////////////
+
+namespace {
+	struct RayPacket {
+		pragma::math::simd::vfloat ox, oy, oz;
+		pragma::math::simd::vfloat dx, dy, dz;
+	};
+	struct PacketResult {
+		pragma::math::simd::vfloat t, u, v;
+		pragma::math::simd::vint triangleIndex;
+	};
+
+	// Vectorized version of the Moeller-Trumbore test in line_triangle, with one ray per lane and the triangle broadcast to all lanes
+	template<bool CULL>
+	void line_triangle_packet(const RayPacket &ray, const pragma::math::TriangleSoaView &tris, float tMin, PacketResult &inOutResult)
+	{
+		using namespace pragma::math::simd;
+		const auto eps = set1(0.000001f);
+		const auto negEps = set1(-0.000001f);
+		const auto vZero = zero();
+		const auto vOne = set1(1.f);
+		const auto vTMin = set1(tMin);
+		for(size_t i = 0; i < tris.count; ++i) {
+			auto v0x = set1(tris.v0x[i]);
+			auto v0y = set1(tris.v0y[i]);
+			auto v0z = set1(tris.v0z[i]);
+			auto e1x = set1(tris.e1x[i]);
+			auto e1y = set1(tris.e1y[i]);
+			auto e1z = set1(tris.e1z[i]);
+			auto e2x = set1(tris.e2x[i]);
+			auto e2y = set1(tris.e2y[i]);
+			auto e2z = set1(tris.e2z[i]);
+
+			// pvec = cross(dir, edge2)
+			auto px = ray.dy * e2z - ray.dz * e2y;
+			auto py = ray.dz * e2x - ray.dx * e2z;
+			auto pz = ray.dx * e2y - ray.dy * e2x;
+			auto det = e1x * px + e1y * py + e1z * pz;
+			auto valid = CULL ? cmp_ge(det, eps) : (cmp_ge(det, eps) | cmp_le(det, negEps));
+			if(!any(valid))
+				continue;
+			auto invDet = vOne / det;
+
+			auto tx = ray.ox - v0x;
+			auto ty = ray.oy - v0y;
+			auto tz = ray.oz - v0z;
+			auto u = tx * px + ty * py + tz * pz;
+
+			// qvec = cross(tvec, edge1)
+			auto qx = ty * e1z - tz * e1y;
+			auto qy = tz * e1x - tx * e1z;
+			auto qz = tx * e1y - ty * e1x;
+			auto v = ray.dx * qx + ray.dy * qy + ray.dz * qz;
+			if constexpr(CULL) {
+				// Compare before scaling by the determinant, same as line_triangle
+				valid &= cmp_ge(u, vZero) & cmp_le(u, det) & cmp_ge(v, vZero) & cmp_le(u + v, det);
+				u = u * invDet;
+				v = v * invDet;
+			}
+			else {
+				u = u * invDet;
+				v = v * invDet;
+				valid &= cmp_ge(u, vZero) & cmp_le(u, vOne) & cmp_ge(v, vZero) & cmp_le(u + v, vOne);
+			}
+			auto t = (e2x * qx + e2y * qy + e2z * qz) * invDet;
+			valid &= cmp_ge(t, vTMin) & cmp_lt(t, inOutResult.t);
+			if(!any(valid))
+				continue;
+			inOutResult.t = select(valid, t, inOutResult.t);
+			inOutResult.u = select(valid, u, inOutResult.u);
+			inOutResult.v = select(valid, v, inOutResult.v);
+			inOutResult.triangleIndex = select(valid, set1_int(static_cast<int32_t>(i)), inOutResult.triangleIndex);
+		}
+	}
+};
+
+size_t pragma::math::intersection::line_triangle(const Vector3 *origins, const Vector3 *dirs, size_t numRays, const TriangleSoaView &triangles, RayPacketHit *outHits, bool bCull, float tMin, float tMax)
+{
+	using namespace simd;
+	size_t numHits = 0;
+	for(size_t i = 0; i < numRays; i += width) {
+		auto n = static_cast<uint32_t>(std::min<size_t>(width, numRays - i));
+		alignas(64) std::array<std::array<float, width>, 6> rayData;
+		for(uint32_t j = 0; j < width; ++j) {
+			// Unused lanes duplicate the last ray of the packet
+			auto idx = i + std::min(j, n - 1);
+			rayData[0][j] = origins[idx].x;
+			rayData[1][j] = origins[idx].y;
+			rayData[2][j] = origins[idx].z;
+			rayData[3][j] = dirs[idx].x;
+			rayData[4][j] = dirs[idx].y;
+			rayData[5][j] = dirs[idx].z;
+		}
+		RayPacket packet {load(rayData[0].data()), load(rayData[1].data()), load(rayData[2].data()), load(rayData[3].data()), load(rayData[4].data()), load(rayData[5].data())};
+		PacketResult result {set1(tMax), zero(), zero(), set1_int(static_cast<int32_t>(RayPacketHit::INVALID_TRIANGLE))};
+		if(bCull)
+			line_triangle_packet<true>(packet, triangles, tMin, result);
+		else
+			line_triangle_packet<false>(packet, triangles, tMin, result);
+
+		alignas(64) std::array<float, width> t, u, v;
+		alignas(64) std::array<int32_t, width> triangleIndex;
+		store(t.data(), result.t);
+		store(u.data(), result.u);
+		store(v.data(), result.v);
+		store_int(triangleIndex.data(), result.triangleIndex);
+		for(uint32_t j = 0; j < n; ++j) {
+			auto &hit = outHits[i + j];
+			hit.triangleIndex = static_cast<uint32_t>(triangleIndex[j]);
+			if(!hit.IsHit()) {
+				hit.t = 0.f;
+				hit.u = 0.f;
+				hit.v = 0.f;
+				continue;
+			}
+			hit.t = t[j];
+			hit.u = u[j];
+			hit.v = v[j];
+			++numHits;
+		}
+	}
+	return numHits;
+}
@@ -0,0 +1,326 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+#include "simd.hpp"
+
+module pragma.math;
+
+import :occlusion;
+import :parallel;
+
+namespace {
+	static_assert(pragma::math::OcclusionBuffer::TILE_SIZE % pragma::math::simd::width == 0 && std::has_single_bit(pragma::math::OcclusionBuffer::TILE_SIZE));
+	// Number of mip levels below level 0 that can be built independently for each tile
+	constexpr uint32_t TILE_MIP_COUNT = std::countr_zero(pragma::math::OcclusionBuffer::TILE_SIZE);
+	// Number of boxes per task of the parallel culling
+	constexpr size_t PARALLEL_CULL_CHUNK_SIZE = 1'024;
+
+	// Offsets of the pixel centers of a SIMD batch relative to its first pixel
+	pragma::math::simd::vfloat get_lane_pixel_centers()
+	{
+		alignas(64) std::array<float, pragma::math::simd::width> offsets;
+		for(uint32_t i = 0; i < offsets.size(); ++i)
+			offsets[i] = static_cast<float>(i) + 0.5f;
+		return pragma::math::simd::load(offsets.data());
+	}
+
+	// Signed distance to the near plane in clip space, which is z >= 0 for a depth range of [0, 1] and z <= w with reverse-Z
+	float get_near_plane_distance(const Vector4 &clipPos, bool reverseZ) { return reverseZ ? (clipPos.w - clipPos.z) : clipPos.z; }
+};
+
+pragma::math::OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height) : m_width {std::max(width, 1u)}, m_height {std::max(height, 1u)}
+{
+	m_tilesX = (m_width + TILE_SIZE - 1) / TILE_SIZE;
+	m_tilesY = (m_height + TILE_SIZE - 1) / TILE_SIZE;
+	m_tileBins.resize(m_tilesX * m_tilesY);
+	auto w = m_tilesX * TILE_SIZE;
+	auto h = m_tilesY * TILE_SIZE;
+	for(;;) {
+		m_mips.push_back({w, h, std::vector<float>(w * h, 1.f)});
+		if(w == 1 && h == 1)
+			break;
+		w = (w + 1) / 2;
+		h = (h + 1) / 2;
+	}
+}
+
+void pragma::math::OcclusionBuffer::Begin(const Mat4 &viewProjection, bool reverseZ)
+{
+	m_viewProjection = viewProjection;
+	m_reverseZ = reverseZ;
+	m_triangles.clear();
+	for(auto &bin : m_tileBins)
+		bin.clear();
+	for(auto &mip : m_mips)
+		std::fill(mip.depths.begin(), mip.depths.end(), 1.f);
+}
+
+void pragma::math::OcclusionBuffer::AddOccluder(const std::vector<Vector3> &verts, const std::vector<uint16_t> &triangles, const Mat4 &transform) { AddTriangles(verts, triangles, transform); }
+void pragma::math::OcclusionBuffer::AddOccluder(const std::vector<Vector3> &verts, const std::vector<uint32_t> &triangles, const Mat4 &transform) { AddTriangles(verts, triangles, transform); }
+
+template<typename TIndex>
+void pragma::math::OcclusionBuffer::AddTriangles(const std::vector<Vector3> &verts, const std::vector<TIndex> &triangles, const Mat4 &transform)
+{
+	auto m = m_viewProjection * transform;
+	std::vector<Vector4> clipVerts;
+	clipVerts.reserve(verts.size());
+	for(auto &v : verts)
+		clipVerts.push_back(m * Vector4 {v, 1.f});
+	for(size_t i = 0; i + 2 < triangles.size(); i += 3)
+		AddTriangle({clipVerts[triangles[i]], clipVerts[triangles[i + 1]], clipVerts[triangles[i + 2]]});
+}
+
+void pragma::math::OcclusionBuffer::AddTriangle(const std::array<Vector4, 3> &clipVerts)
+{
+	auto toScreen = [this](const Vector4 &v) -> Vector3 {
+		auto wInv = 1.f / v.w;
+		return {(v.x * wInv + 1.f) * 0.5f * static_cast<float>(m_width), (v.y * wInv + 1.f) * 0.5f * static_cast<float>(m_height), ToDepth(v.z * wInv)};
+	};
+	std::array<float, 3> nearDist;
+	uint32_t numBehind = 0;
+	for(uint8_t i = 0; i < 3; ++i) {
+		nearDist[i] = get_near_plane_distance(clipVerts[i], m_reverseZ);
+		if(nearDist[i] < 0.f)
+			++numBehind;
+	}
+	if(numBehind == 3)
+		return;
+	if(numBehind == 0) {
+		AddScreenTriangle({toScreen(clipVerts[0]), toScreen(clipVerts[1]), toScreen(clipVerts[2])});
+		return;
+	}
+	// Clip against the near plane, which results in a triangle or a quad
+	std::array<Vector3, 4> polygon;
+	uint32_t count = 0;
+	for(uint8_t i = 0; i < 3; ++i) {
+		auto j = (i + 1) % 3;
+		if(nearDist[i] >= 0.f)
+			polygon[count++] = toScreen(clipVerts[i]);
+		if((nearDist[i] >= 0.f) != (nearDist[j] >= 0.f)) {
+			auto t = nearDist[i] / (nearDist[i] - nearDist[j]);
+			polygon[count++] = toScreen(clipVerts[i] + (clipVerts[j] - clipVerts[i]) * t);
+		}
+	}
+	for(uint32_t i = 1; i + 1 < count; ++i)
+		AddScreenTriangle({polygon[0], polygon[i], polygon[i + 1]});
+}
+
+void pragma::math::OcclusionBuffer::AddScreenTriangle(const std::array<Vector3, 3> &verts)
+{
+	std::array<std::array<double, 3>, 3> v;
+	for(uint8_t i = 0; i < 3; ++i)
+		v[i] = {verts[i].x, verts[i].y, verts[i].z};
+	auto d1 = std::array<double, 3> {v[1][0] - v[0][0], v[1][1] - v[0][1], v[1][2] - v[0][2]};
+	auto d2 = std::array<double, 3> {v[2][0] - v[0][0], v[2][1] - v[0][1], v[2][2] - v[0][2]};
+	auto area = d1[0] * d2[1] - d1[1] * d2[0];
+	if(area == 0.0 || !std::isfinite(area))
+		return;
+	// Triangles beyond the far plane can't lower any depths
+	if(std::min({v[0][2], v[1][2], v[2][2]}) >= 1.0)
+		return;
+
+	// Bounds of the pixels whose center lies inside of the triangle, which includes all pixels that are entirely covered by it
+	auto &mip0 = m_mips.front();
+	auto minX = std::max(std::ceil(std::min({v[0][0], v[1][0], v[2][0]}) - 0.5), 0.0);
+	auto minY = std::max(std::ceil(std::min({v[0][1], v[1][1], v[2][1]}) - 0.5), 0.0);
+	auto maxX = std::min(std::floor(std::max({v[0][0], v[1][0], v[2][0]}) - 0.5), static_cast<double>(mip0.width - 1));
+	auto maxY = std::min(std::floor(std::max({v[0][1], v[1][1], v[2][1]}) - 0.5), static_cast<double>(mip0.height - 1));
+	if(minX > maxX || minY > maxY)
+		return;
+
+	Triangle tri;
+	tri.min = {static_cast<int32_t>(minX), static_cast<int32_t>(minY)};
+	tri.max = {static_cast<int32_t>(maxX), static_cast<int32_t>(maxY)};
+	// Edge i goes from vertex i to vertex i + 1, the signs are flipped for clockwise triangles so that the inside is always positive.
+	// Only pixels that are entirely covered by the triangle are rasterized, so that boxes behind partially covered pixels are never culled.
+	// Each edge function is offset by its value at the pixel corner where it is smallest, so that testing it at the pixel center tests that corner.
+	auto sign = (area > 0.0) ? 1.0 : -1.0;
+	for(uint8_t i = 0; i < 3; ++i) {
+		auto &a = v[i];
+		auto &b = v[(i + 1) % 3];
+		auto ea = -(b[1] - a[1]) * sign;
+		auto eb = (b[0] - a[0]) * sign;
+		tri.edges[i] = {ea, eb, -(ea * a[0] + eb * a[1]) - 0.5 * (std::abs(ea) + std::abs(eb))};
+	}
+	// Depth is linear in screen space: The plane through the three vertices in (x, y, depth).
+	// It is offset to the farthest depth within the pixel in the same way, so that the stored depths are never in front of the triangle.
+	auto nx = d1[1] * d2[2] - d1[2] * d2[1];
+	auto ny = d1[2] * d2[0] - d1[0] * d2[2];
+	auto za = -nx / area;
+	auto zb = -ny / area;
+	tri.depthPlane = {za, zb, v[0][2] - za * v[0][0] - zb * v[0][1] + 0.5 * (std::abs(za) + std::abs(zb))};
+
+	auto triIdx = static_cast<uint32_t>(m_triangles.size());
+	m_triangles.push_back(tri);
+	for(auto y = tri.min[1] / TILE_SIZE; y <= tri.max[1] / TILE_SIZE; ++y) {
+		for(auto x = tri.min[0] / TILE_SIZE; x <= tri.max[0] / TILE_SIZE; ++x)
+			m_tileBins[y * m_tilesX + x].push_back(triIdx);
+	}
+}
+
+void pragma::math::OcclusionBuffer::Rasterize(uint32_t threadCount)
+{
+	parallel::parallel_for(
+	  m_tileBins.size(),
+	  [this](size_t i) {
+		  auto tileX = static_cast<uint32_t>(i % m_tilesX);
+		  auto tileY = static_cast<uint32_t>(i / m_tilesX);
+		  RasterizeTile(tileX, tileY);
+		  BuildTileMips(tileX, tileY);
+	  },
+	  threadCount);
+
+	// The remaining levels are smaller than the tile count
+	for(auto level = TILE_MIP_COUNT + 1; level < m_mips.size(); ++level) {
+		auto &src = m_mips[level - 1];
+		auto &dst = m_mips[level];
+		for(uint32_t y = 0; y < dst.height; ++y) {
+			auto y0 = y * 2;
+			auto y1 = std::min(y0 + 1, src.height - 1);
+			for(uint32_t x = 0; x < dst.width; ++x) {
+				auto x0 = x * 2;
+				auto x1 = std::min(x0 + 1, src.width - 1);
+				dst.depths[y * dst.width + x] = std::max({src.depths[y0 * src.width + x0], src.depths[y0 * src.width + x1], src.depths[y1 * src.width + x0], src.depths[y1 * src.width + x1]});
+			}
+		}
+	}
+}
+
+void pragma::math::OcclusionBuffer::RasterizeTile(uint32_t tileX, uint32_t tileY)
+{
+	using namespace simd;
+	auto &mip0 = m_mips.front();
+	auto tileMinX = static_cast<int32_t>(tileX * TILE_SIZE);
+	auto tileMinY = static_cast<int32_t>(tileY * TILE_SIZE);
+	auto laneCenters = get_lane_pixel_centers();
+	for(auto triIdx : m_tileBins[tileY * m_tilesX + tileX]) {
+		auto &tri = m_triangles[triIdx];
+		auto x0 = std::max(tri.min[0], tileMinX);
+		auto y0 = std::max(tri.min[1], tileMinY);
+		auto x1 = std::min(tri.max[0], tileMinX + static_cast<int32_t>(TILE_SIZE) - 1);
+		auto y1 = std::min(tri.max[1], tileMinY + static_cast<int32_t>(TILE_SIZE) - 1);
+
+		// Move the origin to the tile corner, so that the remaining values fit into single precision
+		std::array<float, 3> ea, eb, ec;
+		for(uint8_t i = 0; i < 3; ++i) {
+			auto &e = tri.edges[i];
+			ea[i] = static_cast<float>(e[0]);
+			eb[i] = static_cast<float>(e[1]);
+			ec[i] = static_cast<float>(e[0] * tileMinX + e[1] * tileMinY + e[2]);
+		}
+		auto &dp = tri.depthPlane;
+		auto za = static_cast<float>(dp[0]);
+		auto zb = static_cast<float>(dp[1]);
+		auto zc = static_cast<float>(dp[0] * tileMinX + dp[1] * tileMinY + dp[2]);
+		std::array<vfloat, 3> edgeA {set1(ea[0]), set1(ea[1]), set1(ea[2])};
+		auto depthA = set1(za);
+
+		// Batches are aligned to the SIMD width within the tile, pixels outside of the bounds of the triangle always fail the edge tests
+		auto batchMinX = tileMinX + ((x0 - tileMinX) / static_cast<int32_t>(width)) * static_cast<int32_t>(width);
+		for(auto y = y0; y <= y1; ++y) {
+			auto py = static_cast<float>(y - tileMinY) + 0.5f;
+			std::array<vfloat, 3> edgeRow {set1(eb[0] * py + ec[0]), set1(eb[1] * py + ec[1]), set1(eb[2] * py + ec[2])};
+			auto depthRow = set1(zb * py + zc);
+			auto *row = mip0.depths.data() + static_cast<size_t>(y) * mip0.width;
+			for(auto x = batchMinX; x <= x1; x += width) {
+				auto px = set1(static_cast<float>(x - tileMinX)) + laneCenters;
+				auto inside = cmp_ge(fmadd(edgeA[0], px, edgeRow[0]), zero()) & cmp_ge(fmadd(edgeA[1], px, edgeRow[1]), zero()) & cmp_ge(fmadd(edgeA[2], px, edgeRow[2]), zero());
+				if(to_bits(inside) == 0)
+					continue;
+				auto depth = fmadd(depthA, px, depthRow);
+				auto old = load(row + x);
+				store(row + x, select(inside, min(old, depth), old));
+			}
+		}
+	}
+}
+
+void pragma::math::OcclusionBuffer::BuildTileMips(uint32_t tileX, uint32_t tileY)
+{
+	for(uint32_t level = 1; level <= TILE_MIP_COUNT && level < m_mips.size(); ++level) {
+		auto &src = m_mips[level - 1];
+		auto &dst = m_mips[level];
+		auto size = TILE_SIZE >> level;
+		for(auto y = tileY * size; y < (tileY + 1) * size; ++y) {
+			auto *row0 = src.depths.data() + static_cast<size_t>(y * 2) * src.width;
+			auto *row1 = row0 + src.width;
+			for(auto x = tileX * size; x < (tileX + 1) * size; ++x)
+				dst.depths[y * dst.width + x] = std::max({row0[x * 2], row0[x * 2 + 1], row1[x * 2], row1[x * 2 + 1]});
+		}
+	}
+}
+
+bool pragma::math::OcclusionBuffer::IsAabbVisible(const Vector3 &min, const Vector3 &max) const
+{
+	auto screenMin = Vector2 {std::numeric_limits<float>::max()};
+	auto screenMax = Vector2 {std::numeric_limits<float>::lowest()};
+	auto depthMin = std::numeric_limits<float>::max();
+	uint32_t numBehind = 0;
+	for(uint8_t i = 0; i < 8; ++i) {
+		Vector3 corner {(i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z};
+		auto clipPos = m_viewProjection * Vector4 {corner, 1.f};
+		if(get_near_plane_distance(clipPos, m_reverseZ) < 0.f) {
+			++numBehind;
+			continue;
+		}
+		auto wInv = 1.f / clipPos.w;
+		Vector2 p {(clipPos.x * wInv + 1.f) * 0.5f * static_cast<float>(m_width), (clipPos.y * wInv + 1.f) * 0.5f * static_cast<float>(m_height)};
+		screenMin = glm::min(screenMin, p);
+		screenMax = glm::max(screenMax, p);
+		depthMin = std::min(depthMin, ToDepth(clipPos.z * wInv));
+	}
+	if(numBehind == 8)
+		return false;
+	// The projection of the box is unbounded
+	if(numBehind > 0)
+		return true;
+	if(screenMax.x < 0.f || screenMax.y < 0.f || screenMin.x >= static_cast<float>(m_width) || screenMin.y >= static_cast<float>(m_height))
+		return false;
+
+	// All pixels the screen-space bounds touch
+	auto x0 = static_cast<uint32_t>(std::max(screenMin.x, 0.f));
+	auto y0 = static_cast<uint32_t>(std::max(screenMin.y, 0.f));
+	auto x1 = static_cast<uint32_t>(std::min(screenMax.x, static_cast<float>(m_width - 1)));
+	auto y1 = static_cast<uint32_t>(std::min(screenMax.y, static_cast<float>(m_height - 1)));
+	// Coarsest level at which the bounds cover at most 4x4 texels
+	uint32_t level = 0;
+	while(level + 1 < m_mips.size() && ((x1 >> level) - (x0 >> level) >= 4 || (y1 >> level) - (y0 >> level) >= 4))
+		++level;
+	auto &mip = m_mips[level];
+	for(auto y = y0 >> level; y <= (y1 >> level); ++y) {
+		for(auto x = x0 >> level; x <= (x1 >> level); ++x) {
+			if(mip.depths[y * mip.width + x] >= depthMin)
+				return true;
+		}
+	}
+	return false;
+}
+
+size_t pragma::math::OcclusionBuffer::CullAabbs(const AabbSoaView &boxes, uint32_t *outVisibleMask) const
+{
+	std::fill(outVisibleMask, outVisibleMask + intersection::get_hit_mask_size(boxes.count), 0u);
+	size_t numVisible = 0;
+	for(size_t i = 0; i < boxes.count; ++i) {
+		if(!IsAabbVisible({boxes.minX[i], boxes.minY[i], boxes.minZ[i]}, {boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]}))
+			continue;
+		outVisibleMask[i / 32] |= 1u << (i % 32);
+		++numVisible;
+	}
+	return numVisible;
+}
+
+size_t pragma::math::OcclusionBuffer::CullAabbs(const AabbSoaView &boxes, std::vector<uint32_t> &outVisibleIndices, uint32_t threadCount) const
+{
+	parallel::parallel_compact(
+	  boxes.count, PARALLEL_CULL_CHUNK_SIZE,
+	  [this, &boxes](size_t begin, size_t end, std::vector<uint32_t> &outIndices) {
+		  for(auto i = begin; i < end; ++i) {
+			  if(IsAabbVisible({boxes.minX[i], boxes.minY[i], boxes.minZ[i]}, {boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]}))
+				  outIndices.push_back(static_cast<uint32_t>(i));
+		  }
+	  },
+	  outVisibleIndices, threadCount);
+	return outVisibleIndices.size();
+}
@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+module pragma.math;
+
+import :octree;
+
+namespace {
+	float get_max_extent(const bounding_volume::AABB &aabb)
+	{
+		auto e = (aabb.max - aabb.min) * 0.5f;
+		return std::max({e.x, e.y, e.z});
+	}
+};
+
+pragma::math::LooseOctree::LooseOctree(const Vector3 &center, float halfSize, uint32_t maxDepth, float looseness)
+    : m_center {center}, m_halfSize {halfSize}, m_maxDepth {std::min(maxDepth, MAX_DEPTH)}, m_looseness {std::max(looseness, 1.f)}
+{
+	Clear();
+}
+
+void pragma::math::LooseOctree::Reserve(uint32_t itemCount, uint32_t nodeCount)
+{
+	m_items.reserve(itemCount);
+	m_nodes.reserve(nodeCount);
+}
+
+void pragma::math::LooseOctree::Clear()
+{
+	m_nodes.clear();
+	m_items.clear();
+	m_freeNodes = INVALID_INDEX;
+	m_freeItems = INVALID_INDEX;
+	m_outsideItems = INVALID_INDEX;
+	m_itemCount = 0;
+	m_nodeCount = 0;
+	// The root node always exists
+	AllocateNode(INVALID_INDEX, m_center, m_halfSize, 0);
+}
+
+std::pair<Vector3, Vector3> pragma::math::LooseOctree::GetLooseBounds(const Node &node) const
+{
+	auto extent = node.halfSize * m_looseness;
+	Vector3 vExtent {extent, extent, extent};
+	return {node.center - vExtent, node.center + vExtent};
+}
+
+bool pragma::math::LooseOctree::ContainsCenter(const Node &node, const Vector3 &p) const
+{
+	auto d = p - node.center;
+	return std::abs(d.x) <= node.halfSize && std::abs(d.y) <= node.halfSize && std::abs(d.z) <= node.halfSize;
+}
+
+uint32_t pragma::math::LooseOctree::GetChildIndex(const Node &node, const Vector3 &p) const { return ((p.x >= node.center.x) ? 1u : 0u) | ((p.y >= node.center.y) ? 2u : 0u) | ((p.z >= node.center.z) ? 4u : 0u); }
+
+uint32_t pragma::math::LooseOctree::AllocateNode(uint32_t parent, const Vector3 &center, float halfSize, uint32_t depth)
+{
+	uint32_t nodeIndex;
+	if(m_freeNodes != INVALID_INDEX) {
+		nodeIndex = m_freeNodes;
+		m_freeNodes = m_nodes[nodeIndex].parent;
+	}
+	else {
+		nodeIndex = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.push_back({});
+	}
+	auto &node = m_nodes[nodeIndex];
+	node = {};
+	node.parent = parent;
+	node.center = center;
+	node.halfSize = halfSize;
+	node.depth = depth;
+	++m_nodeCount;
+	return nodeIndex;
+}
+
+void pragma::math::LooseOctree::FreeNode(uint32_t nodeIndex)
+{
+	auto &node = m_nodes[nodeIndex];
+	auto &parent = m_nodes[node.parent];
+	for(auto &child : parent.children) {
+		if(child == nodeIndex)
+			child = INVALID_INDEX;
+	}
+	node.parent = m_freeNodes;
+	m_freeNodes = nodeIndex;
+	--m_nodeCount;
+}
+
+void pragma::math::LooseOctree::LinkItem(uint32_t nodeIndex, ItemId itemId)
+{
+	auto &item = m_items[itemId];
+	item.node = nodeIndex;
+	item.prev = INVALID_INDEX;
+	auto &head = (nodeIndex != INVALID_INDEX) ? m_nodes[nodeIndex].firstItem : m_outsideItems;
+	item.next = head;
+	if(head != INVALID_INDEX)
+		m_items[head].prev = itemId;
+	head = itemId;
+	if(nodeIndex == INVALID_INDEX)
+		return;
+	++m_nodes[nodeIndex].itemCount;
+	for(auto i = nodeIndex; i != INVALID_INDEX; i = m_nodes[i].parent)
+		++m_nodes[i].subtreeItemCount;
+}
+
+void pragma::math::LooseOctree::UnlinkItem(ItemId itemId)
+{
+	auto &item = m_items[itemId];
+	auto nodeIndex = item.node;
+	if(item.prev != INVALID_INDEX)
+		m_items[item.prev].next = item.next;
+	else if(nodeIndex != INVALID_INDEX)
+		m_nodes[nodeIndex].firstItem = item.next;
+	else
+		m_outsideItems = item.next;
+	if(item.next != INVALID_INDEX)
+		m_items[item.next].prev = item.prev;
+	item.prev = INVALID_INDEX;
+	item.next = INVALID_INDEX;
+	item.node = INVALID_INDEX;
+	if(nodeIndex == INVALID_INDEX)
+		return;
+	--m_nodes[nodeIndex].itemCount;
+	for(auto i = nodeIndex; i != INVALID_INDEX; i = m_nodes[i].parent)
+		--m_nodes[i].subtreeItemCount;
+	// Return empty nodes to the pool. Descendants of an empty node are always empty (and therefore already freed) as well.
+	while(nodeIndex != 0 && m_nodes[nodeIndex].subtreeItemCount == 0) {
+		auto parent = m_nodes[nodeIndex].parent;
+		FreeNode(nodeIndex);
+		nodeIndex = parent;
+	}
+}
+
+pragma::math::LooseOctree::ItemId pragma::math::LooseOctree::Insert(const bounding_volume::AABB &aabb, uint64_t userData)
+{
+	ItemId itemId;
+	if(m_freeItems != INVALID_INDEX) {
+		itemId = m_freeItems;
+		m_freeItems = m_items[itemId].next;
+	}
+	else {
+		itemId = static_cast<ItemId>(m_items.size());
+		m_items.push_back({});
+	}
+	auto &item = m_items[itemId];
+	item = {};
+	item.aabb = aabb;
+	item.userData = userData;
+	item.valid = true;
+	++m_itemCount;
+
+	auto center = (aabb.min + aabb.max) * 0.5f;
+	auto maxExtent = get_max_extent(aabb);
+	if(!ContainsCenter(m_nodes.front(), center) || !FitsNode(m_nodes.front(), maxExtent)) {
+		LinkItem(INVALID_INDEX, itemId);
+		return itemId;
+	}
+	// Descend as long as the item fits into the loose bounds of the child
+	uint32_t nodeIndex = 0;
+	while(m_nodes[nodeIndex].depth < m_maxDepth) {
+		auto &node = m_nodes[nodeIndex];
+		auto childHalfSize = node.halfSize * 0.5f;
+		if(maxExtent > (m_looseness - 1.f) * childHalfSize)
+			break;
+		auto childIdx = GetChildIndex(node, center);
+		auto child = node.children[childIdx];
+		if(child == INVALID_INDEX) {
+			Vector3 offset {(childIdx & 1) ? childHalfSize : -childHalfSize, (childIdx & 2) ? childHalfSize : -childHalfSize, (childIdx & 4) ? childHalfSize : -childHalfSize};
+			child = AllocateNode(nodeIndex, node.center + offset, childHalfSize, node.depth + 1);
+			m_nodes[nodeIndex].children[childIdx] = child;
+		}
+		nodeIndex = child;
+	}
+	LinkItem(nodeIndex, itemId);
+	return itemId;
+}
+
+void pragma::math::LooseOctree::Remove(ItemId itemId)
+{
+	UnlinkItem(itemId);
+	auto &item = m_items[itemId];
+	item.valid = false;
+	item.next = m_freeItems;
+	m_freeItems = itemId;
+	--m_itemCount;
+}
+
+void pragma::math::LooseOctree::Update(ItemId itemId, const bounding_volume::AABB &aabb)
+{
+	auto &item = m_items[itemId];
+	if(item.node != INVALID_INDEX) {
+		// The target node only depends on the center and size of the item, so if the center is still within the
+		// cell of the current node and the item is too large for the next level, the node doesn't change
+		auto &node = m_nodes[item.node];
+		auto center = (aabb.min + aabb.max) * 0.5f;
+		auto maxExtent = get_max_extent(aabb);
+		auto fitsChild = node.depth < m_maxDepth && maxExtent <= (m_looseness - 1.f) * node.halfSize * 0.5f;
+		if(ContainsCenter(node, center) && FitsNode(node, maxExtent) && !fitsChild) {
+			item.aabb = aabb;
+			return;
+		}
+	}
+	auto userData = item.userData;
+	// Re-inserting re-uses the same item id, since it is at the front of the free list
+	Remove(itemId);
+	Insert(aabb, userData);
+}
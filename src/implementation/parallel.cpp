@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+module pragma.math;
+
+import :parallel;
+
+namespace {
+	pragma::math::parallel::Executor &get_executor()
+	{
+		static pragma::math::parallel::Executor executor {};
+		return executor;
+	}
+
+	// Ranges are packed into a single 64-bit value ([begin << 32] | end), so that they can be updated with a single compare-exchange
+	constexpr size_t MAX_JOB_SIZE = std::numeric_limits<uint32_t>::max();
+	constexpr uint64_t pack_range(uint64_t begin, uint64_t end) { return (begin << 32) | end; }
+	constexpr uint64_t get_range_begin(uint64_t range) { return range >> 32; }
+	constexpr uint64_t get_range_end(uint64_t range) { return range & std::numeric_limits<uint32_t>::max(); }
+};
+
+struct pragma::math::parallel::ThreadPool::Job {
+	// Each participant has its own range, aligned to a cache line to avoid false sharing
+	struct alignas(64) Range {
+		std::atomic<uint64_t> value {0};
+	};
+	Job(size_t count, const std::function<void(size_t)> &task, uint32_t numParticipants) : task {task}, ranges {std::make_unique<Range[]>(numParticipants)}, numRanges {numParticipants}, remaining {count}
+	{
+		for(uint32_t i = 0; i < numParticipants; ++i)
+			ranges[i].value.store(pack_range(count * i / numParticipants, count * (i + 1) / numParticipants), std::memory_order_relaxed);
+	}
+	bool HasFreeSlot() const { return nextSlot.load(std::memory_order_relaxed) < numRanges; }
+	bool IsComplete() const { return remaining.load(std::memory_order_acquire) == 0; }
+	void Participate(uint32_t slot)
+	{
+		auto &own = ranges[slot].value;
+		do {
+			auto range = own.load(std::memory_order_acquire);
+			for(;;) {
+				auto begin = get_range_begin(range);
+				auto end = get_range_end(range);
+				if(begin >= end)
+					break;
+				if(!own.compare_exchange_weak(range, pack_range(begin + 1, end), std::memory_order_acq_rel, std::memory_order_acquire))
+					continue;
+				task(begin);
+				remaining.fetch_sub(1, std::memory_order_acq_rel);
+				range = own.load(std::memory_order_acquire);
+			}
+		} while(Steal(slot));
+	}
+	// Moves the upper half of the largest remaining range to the range of 'slot'. Returns false if there is nothing left to steal.
+	bool Steal(uint32_t slot)
+	{
+		for(;;) {
+			uint32_t victim = 0;
+			uint64_t victimRange = 0;
+			uint64_t victimSize = 0;
+			for(uint32_t i = 0; i < numRanges; ++i) {
+				if(i == slot)
+					continue;
+				auto range = ranges[i].value.load(std::memory_order_acquire);
+				auto begin = get_range_begin(range);
+				auto end = get_range_end(range);
+				if(begin < end && end - begin > victimSize) {
+					victim = i;
+					victimRange = range;
+					victimSize = end - begin;
+				}
+			}
+			if(victimSize == 0)
+				return false;
+			auto begin = get_range_begin(victimRange);
+			auto end = get_range_end(victimRange);
+			auto mid = begin + victimSize / 2;
+			if(ranges[victim].value.compare_exchange_strong(victimRange, pack_range(begin, mid), std::memory_order_acq_rel, std::memory_order_acquire)) {
+				ranges[slot].value.store(pack_range(mid, end), std::memory_order_release);
+				return true;
+			}
+		}
+	}
+
+	const std::function<void(size_t)> &task;
+	std::unique_ptr<Range[]> ranges;
+	uint32_t numRanges;
+	// Slot 0 belongs to the thread that started the job
+	std::atomic<uint32_t> nextSlot {1};
+	std::atomic<size_t> remaining;
+};
+
+pragma::math::parallel::ThreadPool::ThreadPool(uint32_t workerCount)
+{
+	if(workerCount == 0)
+		workerCount = get_thread_count(0) - 1;
+	m_workers.reserve(workerCount);
+	for(uint32_t i = 0; i < workerCount; ++i)
+		m_workers.emplace_back([this]() { RunWorker(); });
+}
+
+pragma::math::parallel::ThreadPool::~ThreadPool()
+{
+	{
+		std::scoped_lock lock {m_mutex};
+		m_stop = true;
+	}
+	m_condition.notify_all();
+	for(auto &t : m_workers)
+		t.join();
+}
+
+void pragma::math::parallel::ThreadPool::RunWorker()
+{
+	for(;;) {
+		std::shared_ptr<Job> job;
+		uint32_t slot;
+		{
+			std::unique_lock lock {m_mutex};
+			m_condition.wait(lock, [this]() { return m_stop || std::any_of(m_jobs.begin(), m_jobs.end(), [](const std::shared_ptr<Job> &job) { return job->HasFreeSlot(); }); });
+			if(m_stop)
+				return;
+			auto it = std::find_if(m_jobs.begin(), m_jobs.end(), [](const std::shared_ptr<Job> &job) { return job->HasFreeSlot(); });
+			job = *it;
+			slot = job->nextSlot.fetch_add(1, std::memory_order_relaxed);
+		}
+		if(slot < job->numRanges)
+			job->Participate(slot);
+	}
+}
+
+void pragma::math::parallel::ThreadPool::Run(size_t count, const std::function<void(size_t)> &task, uint32_t threadCount)
+{
+	auto numThreads = static_cast<uint32_t>(std::min<size_t>({get_thread_count(threadCount), m_workers.size() + 1, count}));
+	if(numThreads <= 1) {
+		for(size_t i = 0; i < count; ++i)
+			task(i);
+		return;
+	}
+	if(count > MAX_JOB_SIZE) {
+		for(size_t offset = 0; offset < count; offset += MAX_JOB_SIZE) {
+			std::function<void(size_t)> offsetTask = [&task, offset](size_t i) { task(offset + i); };
+			Run(std::min(MAX_JOB_SIZE, count - offset), offsetTask, numThreads);
+		}
+		return;
+	}
+	auto job = std::make_shared<Job>(count, task, numThreads);
+	{
+		std::scoped_lock lock {m_mutex};
+		m_jobs.push_back(job);
+	}
+	for(uint32_t i = 1; i < numThreads; ++i)
+		m_condition.notify_one();
+	job->Participate(0);
+	// Wait for the ranges that were stolen by other threads
+	while(!job->IsComplete())
+		std::this_thread::yield();
+	std::scoped_lock lock {m_mutex};
+	m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), job));
+}
+
+pragma::math::parallel::ThreadPool &pragma::math::parallel::get_thread_pool()
+{
+	static ThreadPool pool {};
+	return pool;
+}
+
+void pragma::math::parallel::set_executor(const Executor &executor) { get_executor() = executor; }
+
+uint32_t pragma::math::parallel::get_thread_count(uint32_t threadCount)
+{
+	if(threadCount > 0)
+		return threadCount;
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void pragma::math::parallel::parallel_for(size_t count, const std::function<void(size_t)> &f, uint32_t threadCount)
+{
+	auto numThreads = static_cast<uint32_t>(std::min<size_t>(get_thread_count(threadCount), count));
+	if(numThreads <= 1) {
+		for(size_t i = 0; i < count; ++i)
+			f(i);
+		return;
+	}
+	auto &executor = get_executor();
+	if(executor) {
+		executor(count, f, threadCount);
+		return;
+	}
+	get_thread_pool().Run(count, f, numThreads);
+}
+
+void pragma::math::parallel::parallel_compact(size_t count, size_t chunkSize, const std::function<void(size_t, size_t, std::vector<uint32_t> &)> &f, std::vector<uint32_t> &outIndices, uint32_t threadCount)
+{
+	chunkSize = std::max<size_t>(chunkSize, 1);
+	auto numChunks = (count + chunkSize - 1) / chunkSize;
+	std::vector<std::vector<uint32_t>> chunkIndices(numChunks);
+	parallel_for(
+	  numChunks,
+	  [&f, &chunkIndices, chunkSize, count](size_t i) {
+		  auto begin = i * chunkSize;
+		  f(begin, std::min(begin + chunkSize, count), chunkIndices[i]);
+	  },
+	  threadCount);
+
+	std::vector<size_t> offsets(numChunks + 1, 0);
+	for(size_t i = 0; i < numChunks; ++i)
+		offsets[i + 1] = offsets[i] + chunkIndices[i].size();
+	outIndices.resize(offsets.back());
+	parallel_for(numChunks, [&chunkIndices, &offsets, &outIndices](size_t i) { std::copy(chunkIndices[i].begin(), chunkIndices[i].end(), outIndices.begin() + offsets[i]); }, threadCount);
+}
@@ -0,0 +1,279 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+#include "simd.hpp"
+
+module pragma.math;
+
+import :plane_set;
+
+namespace {
+	static_assert(pragma::math::PlaneSet::MAX_PLANES % pragma::math::simd::width == 0);
+
+	// Number of SIMD batches that cover all planes of the set
+	uint32_t get_batch_count(const pragma::math::PlaneSet &planes) { return (planes.GetCount() + pragma::math::simd::width - 1) / pragma::math::simd::width; }
+
+	struct PlaneLanes {
+		pragma::math::simd::vfloat nx, ny, nz, d;
+		// Same operation order as PackedPlane::GetDistance
+		pragma::math::simd::vfloat GetDistance(pragma::math::simd::vfloat x, pragma::math::simd::vfloat y, pragma::math::simd::vfloat z) const { return nx * x + ny * y + nz * z - d; }
+	};
+	PlaneLanes load_planes(const pragma::math::PlaneSet &planes, uint32_t batch)
+	{
+		using namespace pragma::math::simd;
+		auto offset = batch * width;
+		return {load(planes.GetNormalsX() + offset), load(planes.GetNormalsY() + offset), load(planes.GetNormalsZ() + offset), load(planes.GetDistances() + offset)};
+	}
+
+	// Each plane adds at most one vertex to a convex polygon. Rounding can make the clipped polygon slightly non-convex though,
+	// so clip_polygon still checks the bounds.
+	constexpr uint32_t MAX_CLIPPED_VERTICES = 3 + pragma::math::PlaneSet::MAX_PLANES;
+	using ClipPolygon = std::array<Vector3, MAX_CLIPPED_VERTICES>;
+	// Same as geometry::clip_polygon_to_plane_mesh with the planes of the set, without allocations. Returns the number of remaining vertices,
+	// or std::nullopt if they don't fit into the array, in which case the contents of inOutPolygon are undefined.
+	std::optional<uint32_t> clip_polygon(ClipPolygon &inOutPolygon, uint32_t count, const pragma::math::PlaneSet &planes)
+	{
+		ClipPolygon tmp;
+		auto *src = &inOutPolygon;
+		auto *dst = &tmp;
+		for(uint32_t i = 0; i < planes.GetCount() && count >= 3; ++i) {
+			auto plane = planes.Get(i);
+			uint32_t numClipped = 0;
+			auto *prev = &(*src)[count - 1];
+			auto distPrev = plane.GetDistance(*prev);
+			for(uint32_t j = 0; j < count; ++j) {
+				auto &v = (*src)[j];
+				auto dist = plane.GetDistance(v);
+				if((distPrev <= 0.f) != (dist <= 0.f)) {
+					if(numClipped == MAX_CLIPPED_VERTICES)
+						return std::nullopt;
+					(*dst)[numClipped++] = *prev + (v - *prev) * (distPrev / (distPrev - dist));
+				}
+				if(dist <= 0.f) {
+					if(numClipped == MAX_CLIPPED_VERTICES)
+						return std::nullopt;
+					(*dst)[numClipped++] = v;
+				}
+				prev = &v;
+				distPrev = dist;
+			}
+			std::swap(src, dst);
+			count = numClipped;
+		}
+		if(src != &inOutPolygon)
+			std::copy_n(src->begin(), count, inOutPolygon.begin());
+		return count;
+	}
+	// Fallback for polygons which don't fit into a ClipPolygon
+	void clip_polygon(std::vector<Vector3> &inOutPolygon, const pragma::math::PlaneSet &planes)
+	{
+		std::vector<pragma::math::PackedPlane> planeList;
+		planeList.reserve(planes.GetCount());
+		for(uint32_t i = 0; i < planes.GetCount(); ++i)
+			planeList.push_back(planes.Get(i));
+		pragma::math::geometry::clip_polygon_to_plane_mesh(inOutPolygon, planeList.begin(), planeList.end());
+	}
+
+	void add_polygon(pragma::math::intersection::ClippedTriangleMesh &mesh, const Vector3 *polygon, uint32_t count, uint32_t sourceTriangle)
+	{
+		auto offset = static_cast<uint32_t>(mesh.vertices.size());
+		mesh.vertices.insert(mesh.vertices.end(), polygon, polygon + count);
+		for(uint32_t i = 1; i + 1 < count; ++i) {
+			mesh.indices.insert(mesh.indices.end(), {offset, offset + i, offset + i + 1});
+			mesh.sourceTriangles.push_back(sourceTriangle);
+		}
+	}
+
+	template<typename TIndex>
+	size_t triangle_in_plane_mesh(const std::vector<Vector3> &verts, const std::vector<TIndex> &triangles, const pragma::math::PlaneSet &planes, pragma::math::intersection::Intersect *outResults,
+	  pragma::math::intersection::ClippedTriangleMesh *outClipped)
+	{
+		using namespace pragma::math::simd;
+		using pragma::math::intersection::Intersect;
+		if(outClipped)
+			outClipped->Clear();
+		auto numTriangles = triangles.size() / 3;
+		size_t numNotOutside = 0;
+		// Vertex coordinates of the current batch, v0x, v0y, v0z, v1x, ...
+		alignas(64) std::array<std::array<float, width>, 9> coords;
+		for(size_t i = 0; i < numTriangles; i += width) {
+			auto n = static_cast<uint32_t>(std::min<size_t>(width, numTriangles - i));
+			auto laneBits = lane_mask(n);
+			for(uint32_t j = 0; j < width; ++j) {
+				// Unused lanes repeat the last triangle of the batch
+				auto idx = (i + std::min(j, n - 1)) * 3;
+				for(uint8_t k = 0; k < 3; ++k) {
+					auto &v = verts[triangles[idx + k]];
+					coords[k * 3][j] = v.x;
+					coords[k * 3 + 1][j] = v.y;
+					coords[k * 3 + 2][j] = v.z;
+				}
+			}
+			std::array<vfloat, 9> v;
+			for(uint8_t k = 0; k < v.size(); ++k)
+				v[k] = load(coords[k].data());
+
+			uint32_t outside = 0;
+			uint32_t straddles = 0;
+			for(uint32_t p = 0; p < planes.GetCount(); ++p) {
+				PlaneLanes plane {set1(planes.GetNormalsX()[p]), set1(planes.GetNormalsY()[p]), set1(planes.GetNormalsZ()[p]), set1(planes.GetDistances()[p])};
+				auto out0 = to_bits(cmp_gt(plane.GetDistance(v[0], v[1], v[2]), zero()));
+				auto out1 = to_bits(cmp_gt(plane.GetDistance(v[3], v[4], v[5]), zero()));
+				auto out2 = to_bits(cmp_gt(plane.GetDistance(v[6], v[7], v[8]), zero()));
+				outside |= out0 & out1 & out2;
+				straddles |= out0 | out1 | out2;
+				if((outside & laneBits) == laneBits)
+					break;
+			}
+
+			for(uint32_t j = 0; j < n; ++j) {
+				auto bit = 1u << j;
+				auto &result = outResults[i + j];
+				if(outside & bit) {
+					result = Intersect::Outside;
+					continue;
+				}
+				ClipPolygon polygon;
+				auto idx = (i + j) * 3;
+				polygon[0] = verts[triangles[idx]];
+				polygon[1] = verts[triangles[idx + 1]];
+				polygon[2] = verts[triangles[idx + 2]];
+				const Vector3 *clippedVerts = polygon.data();
+				uint32_t count = 3;
+				std::vector<Vector3> fallbackPolygon;
+				if(straddles & bit) {
+					auto numClipped = clip_polygon(polygon, count, planes);
+					if(numClipped)
+						count = *numClipped;
+					else {
+						fallbackPolygon = {verts[triangles[idx]], verts[triangles[idx + 1]], verts[triangles[idx + 2]]};
+						clip_polygon(fallbackPolygon, planes);
+						clippedVerts = fallbackPolygon.data();
+						count = static_cast<uint32_t>(fallbackPolygon.size());
+					}
+					if(count < 3) {
+						result = Intersect::Outside;
+						continue;
+					}
+					result = Intersect::Overlap;
+				}
+				else
+					result = Intersect::Inside;
+				++numNotOutside;
+				if(outClipped)
+					add_polygon(*outClipped, clippedVerts, count, static_cast<uint32_t>(i + j));
+			}
+		}
+		return numNotOutside;
+	}
+};
+
+pragma::math::PackedPlane::PackedPlane(const Plane &plane) : normal {plane.GetNormal()}
+{
+	// Plane::GetDistance measures the distance relative to the center position, which may differ from the stored distance
+	distance = uvec::dot(normal, plane.GetCenterPos());
+}
+
+pragma::math::Plane pragma::math::PackedPlane::ToPlane() const { return Plane {normal, static_cast<double>(distance)}; }
+
+pragma::math::PlaneSet::PlaneSet() { Clear(); }
+
+bool pragma::math::PlaneSet::Add(const PackedPlane &plane)
+{
+	if(m_count >= MAX_PLANES)
+		return false;
+	m_normalX[m_count] = plane.normal.x;
+	m_normalY[m_count] = plane.normal.y;
+	m_normalZ[m_count] = plane.normal.z;
+	m_distance[m_count] = plane.distance;
+	++m_count;
+	return true;
+}
+
+void pragma::math::PlaneSet::Clear()
+{
+	// A zero normal with the largest distance results in a distance of -FLT_MAX for all points
+	m_normalX.fill(0.f);
+	m_normalY.fill(0.f);
+	m_normalZ.fill(0.f);
+	m_distance.fill(std::numeric_limits<float>::max());
+	m_count = 0;
+}
+
+pragma::math::PackedPlane pragma::math::PlaneSet::Get(uint32_t idx) const { return {Vector3 {m_normalX[idx], m_normalY[idx], m_normalZ[idx]}, m_distance[idx]}; }
+
+bool pragma::math::intersection::point_in_plane_mesh(const Vector3 &vec, const PlaneSet &planes)
+{
+	using namespace simd;
+	auto x = set1(vec.x);
+	auto y = set1(vec.y);
+	auto z = set1(vec.z);
+	for(uint32_t i = 0; i < get_batch_count(planes); ++i) {
+		if(to_bits(cmp_gt(load_planes(planes, i).GetDistance(x, y, z), zero())) != 0)
+			return false;
+	}
+	return true;
+}
+
+pragma::math::intersection::Intersect pragma::math::intersection::sphere_in_plane_mesh(const Vector3 &vec, float radius, const PlaneSet &planes, bool skipInsideTest)
+{
+	using namespace simd;
+	auto x = set1(vec.x);
+	auto y = set1(vec.y);
+	auto z = set1(vec.z);
+	auto r = set1(radius);
+	auto negR = set1(-radius);
+	auto overlap = false;
+	for(uint32_t i = 0; i < get_batch_count(planes); ++i) {
+		auto dist = load_planes(planes, i).GetDistance(x, y, z);
+		if(to_bits(cmp_gt(dist, r)) != 0)
+			return Intersect::Outside;
+		overlap = overlap || to_bits(cmp_gt(dist, negR)) != 0;
+	}
+	return (overlap || skipInsideTest) ? Intersect::Overlap : Intersect::Inside;
+}
+
+pragma::math::intersection::Intersect pragma::math::intersection::aabb_in_plane_mesh(const Vector3 &min, const Vector3 &max, const PlaneSet &planes)
+{
+	using namespace simd;
+	auto minX = set1(min.x);
+	auto minY = set1(min.y);
+	auto minZ = set1(min.z);
+	auto maxX = set1(max.x);
+	auto maxY = set1(max.y);
+	auto maxZ = set1(max.z);
+	auto overlap = false;
+	for(uint32_t i = 0; i < get_batch_count(planes); ++i) {
+		auto p = load_planes(planes, i);
+		// Like the iterator overload, the corner closest to the front of each plane decides whether the box is outside,
+		// the one furthest away whether it is inside
+		auto negX = cmp_lt(p.nx, zero());
+		auto negY = cmp_lt(p.ny, zero());
+		auto negZ = cmp_lt(p.nz, zero());
+		auto distNear = p.GetDistance(select(negX, maxX, minX), select(negY, maxY, minY), select(negZ, maxZ, minZ));
+		if(to_bits(cmp_gt(distNear, zero())) != 0)
+			return Intersect::Outside;
+		auto distFar = p.GetDistance(select(negX, minX, maxX), select(negY, minY, maxY), select(negZ, minZ, maxZ));
+		overlap = overlap || to_bits(cmp_gt(distFar, zero())) != 0;
+	}
+	return overlap ? Intersect::Overlap : Intersect::Inside;
+}
+
+void pragma::math::intersection::ClippedTriangleMesh::Clear()
+{
+	vertices.clear();
+	indices.clear();
+	sourceTriangles.clear();
+}
+
+size_t pragma::math::intersection::triangle_in_plane_mesh(const std::vector<Vector3> &verts, const std::vector<uint16_t> &triangles, const PlaneSet &planes, Intersect *outResults, ClippedTriangleMesh *outClipped)
+{
+	return ::triangle_in_plane_mesh(verts, triangles, planes, outResults, outClipped);
+}
+
+size_t pragma::math::intersection::triangle_in_plane_mesh(const std::vector<Vector3> &verts, const std::vector<uint32_t> &triangles, const PlaneSet &planes, Intersect *outResults, ClippedTriangleMesh *outClipped)
+{
+	return ::triangle_in_plane_mesh(verts, triangles, planes, outResults, outClipped);
+}
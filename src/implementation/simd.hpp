@@ -0,0 +1,243 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+// Thin wrapper around the widest SIMD instruction set enabled at compile time (see MATHUTIL_SIMD_INSTRUCTION_SET),
+// so that batched kernels only have to be written once. Falls back to scalar code on other architectures.
+// Must only be included in the global module fragment of implementation units.
+
+#pragma once
+#ifndef __MATHUTIL_SIMD_HPP__
+#define __MATHUTIL_SIMD_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+#if defined(__AVX512F__)
+#define MATHUTIL_SIMD_AVX512
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define MATHUTIL_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATHUTIL_SIMD_SSE
+#include <emmintrin.h>
+#else
+#define MATHUTIL_SIMD_SCALAR
+#endif
+
+namespace pragma::math::simd {
+#if defined(MATHUTIL_SIMD_AVX512)
+	constexpr uint32_t width = 16;
+	struct vfloat {
+		__m512 v;
+	};
+	struct vint {
+		__m512i v;
+	};
+	struct vmask {
+		__mmask16 v;
+	};
+
+	inline vfloat set1(float f) { return {_mm512_set1_ps(f)}; }
+	inline vfloat zero() { return {_mm512_setzero_ps()}; }
+	inline vfloat load(const float *p) { return {_mm512_loadu_ps(p)}; }
+	inline void store(float *p, vfloat a) { _mm512_storeu_ps(p, a.v); }
+	inline vfloat operator+(vfloat a, vfloat b) { return {_mm512_add_ps(a.v, b.v)}; }
+	inline vfloat operator-(vfloat a, vfloat b) { return {_mm512_sub_ps(a.v, b.v)}; }
+	inline vfloat operator*(vfloat a, vfloat b) { return {_mm512_mul_ps(a.v, b.v)}; }
+	inline vfloat operator/(vfloat a, vfloat b) { return {_mm512_div_ps(a.v, b.v)}; }
+	inline vfloat operator-(vfloat a) { return {_mm512_sub_ps(_mm512_setzero_ps(), a.v)}; }
+	inline vfloat fmadd(vfloat a, vfloat b, vfloat c) { return {_mm512_fmadd_ps(a.v, b.v, c.v)}; }
+	// Same semantics as x86 minps/maxps: (a < b) ? a : b and (a > b) ? a : b
+	inline vfloat min(vfloat a, vfloat b) { return {_mm512_min_ps(a.v, b.v)}; }
+	inline vfloat max(vfloat a, vfloat b) { return {_mm512_max_ps(a.v, b.v)}; }
+	inline vfloat sqrt(vfloat a) { return {_mm512_sqrt_ps(a.v)}; }
+	inline vfloat abs(vfloat a) { return {_mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(0x7FFFFFFF)))}; }
+	inline vmask cmp_lt(vfloat a, vfloat b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ)}; }
+	inline vmask cmp_le(vfloat a, vfloat b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ)}; }
+	inline vmask cmp_gt(vfloat a, vfloat b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ)}; }
+	inline vmask cmp_ge(vfloat a, vfloat b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ)}; }
+	inline vmask operator&(vmask a, vmask b) { return {static_cast<__mmask16>(a.v & b.v)}; }
+	inline vmask operator|(vmask a, vmask b) { return {static_cast<__mmask16>(a.v | b.v)}; }
+	inline vmask operator~(vmask a) { return {static_cast<__mmask16>(~a.v)}; }
+	inline uint32_t to_bits(vmask m) { return static_cast<uint32_t>(m.v); }
+	inline vfloat select(vmask m, vfloat a, vfloat b) { return {_mm512_mask_blend_ps(m.v, b.v, a.v)}; }
+
+	inline vint set1_int(int32_t i) { return {_mm512_set1_epi32(i)}; }
+	inline vint load_int(const int32_t *p) { return {_mm512_loadu_si512(p)}; }
+	inline void store_int(int32_t *p, vint a) { _mm512_storeu_si512(p, a.v); }
+	inline vint select(vmask m, vint a, vint b) { return {_mm512_mask_blend_epi32(m.v, b.v, a.v)}; }
+#elif defined(MATHUTIL_SIMD_AVX2)
+	constexpr uint32_t width = 8;
+	struct vfloat {
+		__m256 v;
+	};
+	struct vint {
+		__m256i v;
+	};
+	struct vmask {
+		__m256 v;
+	};
+
+	inline vfloat set1(float f) { return {_mm256_set1_ps(f)}; }
+	inline vfloat zero() { return {_mm256_setzero_ps()}; }
+	inline vfloat load(const float *p) { return {_mm256_loadu_ps(p)}; }
+	inline void store(float *p, vfloat a) { _mm256_storeu_ps(p, a.v); }
+	inline vfloat operator+(vfloat a, vfloat b) { return {_mm256_add_ps(a.v, b.v)}; }
+	inline vfloat operator-(vfloat a, vfloat b) { return {_mm256_sub_ps(a.v, b.v)}; }
+	inline vfloat operator*(vfloat a, vfloat b) { return {_mm256_mul_ps(a.v, b.v)}; }
+	inline vfloat operator/(vfloat a, vfloat b) { return {_mm256_div_ps(a.v, b.v)}; }
+	inline vfloat operator-(vfloat a) { return {_mm256_sub_ps(_mm256_setzero_ps(), a.v)}; }
+#ifdef __FMA__
+	inline vfloat fmadd(vfloat a, vfloat b, vfloat c) { return {_mm256_fmadd_ps(a.v, b.v, c.v)}; }
+#else
+	inline vfloat fmadd(vfloat a, vfloat b, vfloat c) { return {_mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v)}; }
+#endif
+	inline vfloat min(vfloat a, vfloat b) { return {_mm256_min_ps(a.v, b.v)}; }
+	inline vfloat max(vfloat a, vfloat b) { return {_mm256_max_ps(a.v, b.v)}; }
+	inline vfloat sqrt(vfloat a) { return {_mm256_sqrt_ps(a.v)}; }
+	inline vfloat abs(vfloat a) { return {_mm256_and_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)))}; }
+	inline vmask cmp_lt(vfloat a, vfloat b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+	inline vmask cmp_le(vfloat a, vfloat b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+	inline vmask cmp_gt(vfloat a, vfloat b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+	inline vmask cmp_ge(vfloat a, vfloat b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+	inline vmask operator&(vmask a, vmask b) { return {_mm256_and_ps(a.v, b.v)}; }
+	inline vmask operator|(vmask a, vmask b) { return {_mm256_or_ps(a.v, b.v)}; }
+	inline vmask operator~(vmask a) { return {_mm256_xor_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))}; }
+	inline uint32_t to_bits(vmask m) { return static_cast<uint32_t>(_mm256_movemask_ps(m.v)); }
+	inline vfloat select(vmask m, vfloat a, vfloat b) { return {_mm256_blendv_ps(b.v, a.v, m.v)}; }
+
+	inline vint set1_int(int32_t i) { return {_mm256_set1_epi32(i)}; }
+	inline vint load_int(const int32_t *p) { return {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p))}; }
+	inline void store_int(int32_t *p, vint a) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), a.v); }
+	inline vint select(vmask m, vint a, vint b) { return {_mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b.v), _mm256_castsi256_ps(a.v), m.v))}; }
+#elif defined(MATHUTIL_SIMD_SSE)
+	constexpr uint32_t width = 4;
+	struct vfloat {
+		__m128 v;
+	};
+	struct vint {
+		__m128i v;
+	};
+	struct vmask {
+		__m128 v;
+	};
+
+	inline vfloat set1(float f) { return {_mm_set1_ps(f)}; }
+	inline vfloat zero() { return {_mm_setzero_ps()}; }
+	inline vfloat load(const float *p) { return {_mm_loadu_ps(p)}; }
+	inline void store(float *p, vfloat a) { _mm_storeu_ps(p, a.v); }
+	inline vfloat operator+(vfloat a, vfloat b) { return {_mm_add_ps(a.v, b.v)}; }
+	inline vfloat operator-(vfloat a, vfloat b) { return {_mm_sub_ps(a.v, b.v)}; }
+	inline vfloat operator*(vfloat a, vfloat b) { return {_mm_mul_ps(a.v, b.v)}; }
+	inline vfloat operator/(vfloat a, vfloat b) { return {_mm_div_ps(a.v, b.v)}; }
+	inline vfloat operator-(vfloat a) { return {_mm_sub_ps(_mm_setzero_ps(), a.v)}; }
+	inline vfloat fmadd(vfloat a, vfloat b, vfloat c) { return {_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)}; }
+	inline vfloat min(vfloat a, vfloat b) { return {_mm_min_ps(a.v, b.v)}; }
+	inline vfloat max(vfloat a, vfloat b) { return {_mm_max_ps(a.v, b.v)}; }
+	inline vfloat sqrt(vfloat a) { return {_mm_sqrt_ps(a.v)}; }
+	inline vfloat abs(vfloat a) { return {_mm_and_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)))}; }
+	inline vmask cmp_lt(vfloat a, vfloat b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+	inline vmask cmp_le(vfloat a, vfloat b) { return {_mm_cmple_ps(a.v, b.v)}; }
+	inline vmask cmp_gt(vfloat a, vfloat b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+	inline vmask cmp_ge(vfloat a, vfloat b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+	inline vmask operator&(vmask a, vmask b) { return {_mm_and_ps(a.v, b.v)}; }
+	inline vmask operator|(vmask a, vmask b) { return {_mm_or_ps(a.v, b.v)}; }
+	inline vmask operator~(vmask a) { return {_mm_xor_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(-1)))}; }
+	inline uint32_t to_bits(vmask m) { return static_cast<uint32_t>(_mm_movemask_ps(m.v)); }
+	inline vfloat select(vmask m, vfloat a, vfloat b) { return {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))}; }
+
+	inline vint set1_int(int32_t i) { return {_mm_set1_epi32(i)}; }
+	inline vint load_int(const int32_t *p) { return {_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))}; }
+	inline void store_int(int32_t *p, vint a) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), a.v); }
+	inline vint select(vmask m, vint a, vint b)
+	{
+		auto mi = _mm_castps_si128(m.v);
+		return {_mm_or_si128(_mm_and_si128(mi, a.v), _mm_andnot_si128(mi, b.v))};
+	}
+#else
+	constexpr uint32_t width = 1;
+	struct vfloat {
+		float v;
+	};
+	struct vint {
+		int32_t v;
+	};
+	struct vmask {
+		bool v;
+	};
+
+	inline vfloat set1(float f) { return {f}; }
+	inline vfloat zero() { return {0.f}; }
+	inline vfloat load(const float *p) { return {*p}; }
+	inline void store(float *p, vfloat a) { *p = a.v; }
+	inline vfloat operator+(vfloat a, vfloat b) { return {a.v + b.v}; }
+	inline vfloat operator-(vfloat a, vfloat b) { return {a.v - b.v}; }
+	inline vfloat operator*(vfloat a, vfloat b) { return {a.v * b.v}; }
+	inline vfloat operator/(vfloat a, vfloat b) { return {a.v / b.v}; }
+	inline vfloat operator-(vfloat a) { return {-a.v}; }
+	inline vfloat fmadd(vfloat a, vfloat b, vfloat c) { return {a.v * b.v + c.v}; }
+	inline vfloat min(vfloat a, vfloat b) { return {(a.v < b.v) ? a.v : b.v}; }
+	inline vfloat max(vfloat a, vfloat b) { return {(a.v > b.v) ? a.v : b.v}; }
+	inline vfloat sqrt(vfloat a) { return {std::sqrt(a.v)}; }
+	inline vfloat abs(vfloat a) { return {std::fabs(a.v)}; }
+	inline vmask cmp_lt(vfloat a, vfloat b) { return {a.v < b.v}; }
+	inline vmask cmp_le(vfloat a, vfloat b) { return {a.v <= b.v}; }
+	inline vmask cmp_gt(vfloat a, vfloat b) { return {a.v > b.v}; }
+	inline vmask cmp_ge(vfloat a, vfloat b) { return {a.v >= b.v}; }
+	inline vmask operator&(vmask a, vmask b) { return {a.v && b.v}; }
+	inline vmask operator|(vmask a, vmask b) { return {a.v || b.v}; }
+	inline vmask operator~(vmask a) { return {!a.v}; }
+	inline uint32_t to_bits(vmask m) { return m.v ? 1u : 0u; }
+	inline vfloat select(vmask m, vfloat a, vfloat b) { return {m.v ? a.v : b.v}; }
+
+	inline vint set1_int(int32_t i) { return {i}; }
+	inline vint load_int(const int32_t *p) { return {*p}; }
+	inline void store_int(int32_t *p, vint a) { *p = a.v; }
+	inline vint select(vmask m, vint a, vint b) { return {m.v ? a.v : b.v}; }
+#endif
+
+	inline vfloat operator+=(vfloat &a, vfloat b) { return a = a + b; }
+	inline vfloat operator-=(vfloat &a, vfloat b) { return a = a - b; }
+	inline vfloat operator*=(vfloat &a, vfloat b) { return a = a * b; }
+	inline vmask operator&=(vmask &a, vmask b) { return a = a & b; }
+	inline vmask operator|=(vmask &a, vmask b) { return a = a | b; }
+	inline bool any(vmask m) { return to_bits(m) != 0; }
+	inline bool all(vmask m) { return to_bits(m) == ((width == 32) ? ~0u : ((1u << width) - 1u)); }
+
+	// Returns a bit mask with the lowest 'count' lanes set
+	constexpr uint32_t lane_mask(uint32_t count) { return (count >= 32) ? ~0u : ((1u << count) - 1u); }
+
+	// Loads 'count' (<= width) values and fills the remaining lanes with 'fill'
+	inline vfloat load_partial(const float *p, uint32_t count, float fill = 0.f)
+	{
+		alignas(64) float tmp[width];
+		for(uint32_t i = 0; i < width; ++i)
+			tmp[i] = (i < count) ? p[i] : fill;
+		return load(tmp);
+	}
+	inline void store_partial(float *p, vfloat a, uint32_t count)
+	{
+		alignas(64) float tmp[width];
+		store(tmp, a);
+		for(uint32_t i = 0; i < count; ++i)
+			p[i] = tmp[i];
+	}
+	inline vint load_partial_int(const int32_t *p, uint32_t count, int32_t fill = 0)
+	{
+		alignas(64) int32_t tmp[width];
+		for(uint32_t i = 0; i < width; ++i)
+			tmp[i] = (i < count) ? p[i] : fill;
+		return load_int(tmp);
+	}
+	inline void store_partial_int(int32_t *p, vint a, uint32_t count)
+	{
+		alignas(64) int32_t tmp[width];
+		store_int(tmp, a);
+		for(uint32_t i = 0; i < count; ++i)
+			p[i] = tmp[i];
+	}
+};
+
+#endif
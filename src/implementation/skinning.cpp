@@ -0,0 +1,308 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+#include "simd.hpp"
+
+module pragma.math;
+
+import :parallel;
+import :skinning;
+
+namespace {
+	using vfloat = pragma::math::simd::vfloat;
+	using Vec3Lanes = std::array<vfloat, 3>;
+	// x, y, z, w
+	using QuatLanes = std::array<vfloat, 4>;
+
+	constexpr uint32_t MAX_INFLUENCES = 4;
+	constexpr uint32_t BATCH_SIZE = pragma::math::simd::width;
+	// Number of vertices per task if the skinning is parallelized, multiple of BATCH_SIZE
+	constexpr size_t CHUNK_SIZE = 4'096;
+
+	// real xyzw, dual xyzw
+	constexpr uint32_t DUAL_QUAT_COMPONENTS = 8;
+	// Three rows of the affine transform, (r0, r1, r2, translation) each
+	constexpr uint32_t AFFINE_COMPONENTS = 12;
+
+	// Structure-of-arrays staging buffers for one batch of vertices
+	template<uint32_t NUM_COMPONENTS>
+	struct InfluenceBatch {
+		// Components of the bone of each influence, zero for ignored influences
+		alignas(64) float components[MAX_INFLUENCES][NUM_COMPONENTS][BATCH_SIZE];
+		alignas(64) float weights[MAX_INFLUENCES][BATCH_SIZE];
+	};
+	struct VertexBatch {
+		alignas(64) float positions[3][BATCH_SIZE];
+		alignas(64) float normals[3][BATCH_SIZE];
+		alignas(64) float tangents[3][BATCH_SIZE];
+	};
+	struct SkinningOutput {
+		Vector3 *positions;
+		Vector3 *normals;
+		Vector4 *tangents;
+	};
+
+	void get_components(const pragma::math::DualQuat &dq, float *out)
+	{
+		auto &r = dq.real;
+		auto &d = dq.dual;
+		float comps[DUAL_QUAT_COMPONENTS] = {r.x, r.y, r.z, r.w, d.x, d.y, d.z, d.w};
+		std::copy(std::begin(comps), std::end(comps), out);
+	}
+	void get_components(const Mat4 &m, float *out)
+	{
+		for(uint8_t r = 0; r < 3; ++r) {
+			for(uint8_t c = 0; c < 4; ++c)
+				out[r * 4 + c] = m[c][r];
+		}
+	}
+	void get_components(const Mat3x4 &m, float *out)
+	{
+		for(uint8_t r = 0; r < 3; ++r) {
+			for(uint8_t c = 0; c < 4; ++c)
+				out[r * 4 + c] = m[r][c];
+		}
+	}
+	void get_components(const pragma::math::AffineMatrix &m, float *out) { get_components(m.GetRows(), out); }
+
+	template<uint32_t NUM_COMPONENTS, typename TBone>
+	void gather_influences(const TBone *bones, uint32_t numBones, const pragma::math::VertexWeight *weights, size_t offset, uint32_t n, InfluenceBatch<NUM_COMPONENTS> &batch)
+	{
+		float comps[NUM_COMPONENTS];
+		for(uint32_t j = 0; j < BATCH_SIZE; ++j) {
+			for(uint32_t k = 0; k < MAX_INFLUENCES; ++k) {
+				auto w = 0.f;
+				if(j < n) {
+					auto &vw = weights[offset + j];
+					auto id = vw.boneIds[k];
+					if(id >= 0 && static_cast<uint32_t>(id) < numBones && vw.weights[k] != 0.f) {
+						get_components(bones[id], comps);
+						w = vw.weights[k];
+					}
+				}
+				batch.weights[k][j] = w;
+				for(uint32_t c = 0; c < NUM_COMPONENTS; ++c)
+					batch.components[k][c][j] = (w != 0.f) ? comps[c] : 0.f;
+			}
+		}
+	}
+
+	void gather_vertices(const pragma::math::Vertex *verts, size_t offset, uint32_t n, const SkinningOutput &output, VertexBatch &batch)
+	{
+		for(uint32_t j = 0; j < BATCH_SIZE; ++j) {
+			auto *v = (j < n) ? &verts[offset + j] : nullptr;
+			for(uint8_t c = 0; c < 3; ++c) {
+				batch.positions[c][j] = v ? v->position[c] : 0.f;
+				if(output.normals)
+					batch.normals[c][j] = v ? v->normal[c] : 0.f;
+				if(output.tangents)
+					batch.tangents[c][j] = v ? v->tangent[c] : 0.f;
+			}
+		}
+	}
+	// The handedness of the tangents is copied from the source vertices
+	void scatter_vertices(const VertexBatch &batch, const pragma::math::Vertex *verts, size_t offset, uint32_t n, const SkinningOutput &output)
+	{
+		for(uint32_t j = 0; j < n; ++j) {
+			output.positions[offset + j] = {batch.positions[0][j], batch.positions[1][j], batch.positions[2][j]};
+			if(output.normals)
+				output.normals[offset + j] = {batch.normals[0][j], batch.normals[1][j], batch.normals[2][j]};
+			if(output.tangents)
+				output.tangents[offset + j] = {batch.tangents[0][j], batch.tangents[1][j], batch.tangents[2][j], verts[offset + j].tangent.w};
+		}
+	}
+
+	Vec3Lanes load_vec3(const float (&v)[3][BATCH_SIZE])
+	{
+		using namespace pragma::math::simd;
+		return {load(v[0]), load(v[1]), load(v[2])};
+	}
+	void store_vec3(float (&v)[3][BATCH_SIZE], const Vec3Lanes &lanes)
+	{
+		using namespace pragma::math::simd;
+		for(uint8_t c = 0; c < 3; ++c)
+			store(v[c], lanes[c]);
+	}
+
+	Vec3Lanes cross(const Vec3Lanes &a, const Vec3Lanes &b) { return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]}; }
+	vfloat dot(const QuatLanes &a, const QuatLanes &b)
+	{
+		using namespace pragma::math::simd;
+		return fmadd(a[0], b[0], fmadd(a[1], b[1], fmadd(a[2], b[2], a[3] * b[3])));
+	}
+	// Zero vectors are left unchanged
+	Vec3Lanes normalize(const Vec3Lanes &v)
+	{
+		using namespace pragma::math::simd;
+		auto lenSqr = fmadd(v[0], v[0], fmadd(v[1], v[1], v[2] * v[2]));
+		auto valid = cmp_gt(lenSqr, zero());
+		auto invLen = select(valid, set1(1.f) / sqrt(select(valid, lenSqr, set1(1.f))), set1(1.f));
+		return {v[0] * invLen, v[1] * invLen, v[2] * invLen};
+	}
+	// Same as uvec::rotate
+	Vec3Lanes rotate(const QuatLanes &q, const Vec3Lanes &v)
+	{
+		using namespace pragma::math::simd;
+		Vec3Lanes qv {q[0], q[1], q[2]};
+		auto uv = cross(qv, v);
+		auto uuv = cross(qv, uv);
+		auto two = set1(2.f);
+		return {v[0] + (uv[0] * q[3] + uuv[0]) * two, v[1] + (uv[1] * q[3] + uuv[1]) * two, v[2] + (uv[2] * q[3] + uuv[2]) * two};
+	}
+	// m are the rows of an affine transform, w is 1 for points and 0 for directions
+	Vec3Lanes transform(const std::array<vfloat, AFFINE_COMPONENTS> &m, const Vec3Lanes &v, bool point)
+	{
+		using namespace pragma::math::simd;
+		Vec3Lanes result;
+		for(uint8_t r = 0; r < 3; ++r) {
+			auto *row = &m[r * 4];
+			auto res = fmadd(row[0], v[0], fmadd(row[1], v[1], row[2] * v[2]));
+			result[r] = point ? (res + row[3]) : res;
+		}
+		return result;
+	}
+
+	void skin_dual_quaternion(const pragma::math::DualQuat *bones, uint32_t numBones, const pragma::math::Vertex *verts, const pragma::math::VertexWeight *weights, size_t begin, size_t end, const SkinningOutput &output)
+	{
+		using namespace pragma::math::simd;
+		InfluenceBatch<DUAL_QUAT_COMPONENTS> influences;
+		VertexBatch vertices;
+		for(auto i = begin; i < end; i += BATCH_SIZE) {
+			auto n = static_cast<uint32_t>(std::min<size_t>(BATCH_SIZE, end - i));
+			gather_influences(bones, numBones, weights, i, n, influences);
+			gather_vertices(verts, i, n, output, vertices);
+
+			// The rotation of the influence with the largest weight determines the hemisphere of the blend, see DualQuat::Blend
+			QuatLanes pivot {zero(), zero(), zero(), set1(1.f)};
+			auto pivotWeight = zero();
+			for(uint32_t k = 0; k < MAX_INFLUENCES; ++k) {
+				auto w = load(influences.weights[k]);
+				auto mask = cmp_gt(w, pivotWeight);
+				pivotWeight = select(mask, w, pivotWeight);
+				for(uint8_t c = 0; c < 4; ++c)
+					pivot[c] = select(mask, load(influences.components[k][c]), pivot[c]);
+			}
+
+			QuatLanes real {zero(), zero(), zero(), zero()};
+			QuatLanes dual {zero(), zero(), zero(), zero()};
+			for(uint32_t k = 0; k < MAX_INFLUENCES; ++k) {
+				auto &comps = influences.components[k];
+				QuatLanes r {load(comps[0]), load(comps[1]), load(comps[2]), load(comps[3])};
+				auto w = load(influences.weights[k]);
+				w = select(cmp_lt(dot(pivot, r), zero()), -w, w);
+				for(uint8_t c = 0; c < 4; ++c) {
+					real[c] = fmadd(r[c], w, real[c]);
+					dual[c] = fmadd(load(comps[4 + c]), w, dual[c]);
+				}
+			}
+
+			// Same as DualQuat::Normalize, vertices without influences use the identity
+			auto lenSqr = dot(real, real);
+			auto valid = cmp_gt(lenSqr, zero());
+			auto invLen = set1(1.f) / sqrt(select(valid, lenSqr, set1(1.f)));
+			for(uint8_t c = 0; c < 4; ++c) {
+				real[c] = select(valid, real[c] * invLen, set1((c == 3) ? 1.f : 0.f));
+				dual[c] = select(valid, dual[c] * invLen, zero());
+			}
+			auto rd = dot(real, dual);
+			for(uint8_t c = 0; c < 4; ++c)
+				dual[c] = dual[c] - real[c] * rd;
+
+			// Same as DualQuat::GetTranslation
+			Vec3Lanes rv {real[0], real[1], real[2]};
+			Vec3Lanes dv {dual[0], dual[1], dual[2]};
+			auto rxd = cross(rv, dv);
+			auto two = set1(2.f);
+			auto pos = rotate(real, load_vec3(vertices.positions));
+			for(uint8_t c = 0; c < 3; ++c)
+				pos[c] = pos[c] + (dv[c] * real[3] - rv[c] * dual[3] + rxd[c]) * two;
+			store_vec3(vertices.positions, pos);
+			// Rotations preserve the length, so no renormalization is required
+			if(output.normals)
+				store_vec3(vertices.normals, rotate(real, load_vec3(vertices.normals)));
+			if(output.tangents)
+				store_vec3(vertices.tangents, rotate(real, load_vec3(vertices.tangents)));
+			scatter_vertices(vertices, verts, i, n, output);
+		}
+	}
+
+	template<typename TMatrix>
+	void skin_linear_blend(const TMatrix *bones, uint32_t numBones, const pragma::math::Vertex *verts, const pragma::math::VertexWeight *weights, size_t begin, size_t end, const SkinningOutput &output)
+	{
+		using namespace pragma::math::simd;
+		InfluenceBatch<AFFINE_COMPONENTS> influences;
+		VertexBatch vertices;
+		for(auto i = begin; i < end; i += BATCH_SIZE) {
+			auto n = static_cast<uint32_t>(std::min<size_t>(BATCH_SIZE, end - i));
+			gather_influences(bones, numBones, weights, i, n, influences);
+			gather_vertices(verts, i, n, output, vertices);
+
+			std::array<vfloat, AFFINE_COMPONENTS> m;
+			m.fill(zero());
+			auto weightSum = zero();
+			for(uint32_t k = 0; k < MAX_INFLUENCES; ++k) {
+				auto w = load(influences.weights[k]);
+				weightSum = weightSum + w;
+				for(uint32_t c = 0; c < AFFINE_COMPONENTS; ++c)
+					m[c] = fmadd(load(influences.components[k][c]), w, m[c]);
+			}
+			// The weights are normalized, vertices without influences use the identity
+			auto valid = cmp_gt(abs(weightSum), zero());
+			auto invSum = select(valid, set1(1.f) / select(valid, weightSum, set1(1.f)), zero());
+			for(uint32_t c = 0; c < AFFINE_COMPONENTS; ++c)
+				m[c] = m[c] * invSum;
+			for(uint8_t r = 0; r < 3; ++r)
+				m[r * 4 + r] = m[r * 4 + r] + select(valid, zero(), set1(1.f));
+
+			store_vec3(vertices.positions, transform(m, load_vec3(vertices.positions), true));
+			if(output.normals)
+				store_vec3(vertices.normals, normalize(transform(m, load_vec3(vertices.normals), false)));
+			if(output.tangents)
+				store_vec3(vertices.tangents, normalize(transform(m, load_vec3(vertices.tangents), false)));
+			scatter_vertices(vertices, verts, i, n, output);
+		}
+	}
+
+	// Calls f(begin, end) for chunks of CHUNK_SIZE vertices, in parallel unless threadCount is 1
+	void run_chunked(size_t numVerts, uint32_t threadCount, const std::function<void(size_t, size_t)> &f)
+	{
+		if(threadCount == 1 || numVerts <= CHUNK_SIZE) {
+			f(0, numVerts);
+			return;
+		}
+		auto numChunks = (numVerts + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		pragma::math::parallel::parallel_for(
+		  numChunks,
+		  [numVerts, &f](size_t chunk) {
+			  auto begin = chunk * CHUNK_SIZE;
+			  f(begin, std::min(begin + CHUNK_SIZE, numVerts));
+		  },
+		  threadCount);
+	}
+};
+
+void pragma::math::skinning::dual_quaternion(const DualQuat *bones, uint32_t numBones, const Vertex *verts, const VertexWeight *weights, size_t numVerts, Vector3 *outPositions, Vector3 *outNormals, Vector4 *outTangents, uint32_t threadCount)
+{
+	SkinningOutput output {outPositions, outNormals, outTangents};
+	run_chunked(numVerts, threadCount, [&](size_t begin, size_t end) { skin_dual_quaternion(bones, numBones, verts, weights, begin, end, output); });
+}
+
+void pragma::math::skinning::linear_blend(const Mat4 *bones, uint32_t numBones, const Vertex *verts, const VertexWeight *weights, size_t numVerts, Vector3 *outPositions, Vector3 *outNormals, Vector4 *outTangents, uint32_t threadCount)
+{
+	SkinningOutput output {outPositions, outNormals, outTangents};
+	run_chunked(numVerts, threadCount, [&](size_t begin, size_t end) { skin_linear_blend(bones, numBones, verts, weights, begin, end, output); });
+}
+
+void pragma::math::skinning::linear_blend(const Mat3x4 *bones, uint32_t numBones, const Vertex *verts, const VertexWeight *weights, size_t numVerts, Vector3 *outPositions, Vector3 *outNormals, Vector4 *outTangents, uint32_t threadCount)
+{
+	SkinningOutput output {outPositions, outNormals, outTangents};
+	run_chunked(numVerts, threadCount, [&](size_t begin, size_t end) { skin_linear_blend(bones, numBones, verts, weights, begin, end, output); });
+}
+
+void pragma::math::skinning::linear_blend(const AffineMatrix *bones, uint32_t numBones, const Vertex *verts, const VertexWeight *weights, size_t numVerts, Vector3 *outPositions, Vector3 *outNormals, Vector4 *outTangents, uint32_t threadCount)
+{
+	SkinningOutput output {outPositions, outNormals, outTangents};
+	run_chunked(numVerts, threadCount, [&](size_t begin, size_t end) { skin_linear_blend(bones, numBones, verts, weights, begin, end, output); });
+}
@@ -0,0 +1,312 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+module pragma.math;
+
+import :spatial_grid;
+import :parallel;
+
+namespace {
+	// Minimum number of points per thread for the parallel build
+	constexpr uint32_t PARALLEL_CHUNK_SIZE = 16'384;
+	// The points are partitioned by the upper bits of their bucket before they are sorted by bucket, see Build
+	constexpr uint32_t MAX_PARTITION_COUNT = 1'024;
+
+	uint32_t next_power_of_two(uint32_t v)
+	{
+		uint32_t r = 1;
+		while(r < v)
+			r <<= 1;
+		return r;
+	}
+};
+
+pragma::math::SpatialHashGrid::SpatialHashGrid(float cellSize, uint32_t tableSize) : m_requestedTableSize {tableSize} { SetCellSize(cellSize); }
+
+void pragma::math::SpatialHashGrid::SetCellSize(float cellSize) { m_cellSize = cellSize; }
+
+void pragma::math::SpatialHashGrid::Clear()
+{
+	m_points.clear();
+	m_pointIndices.clear();
+	m_bucketStart.clear();
+	m_tableMask = 0;
+}
+
+Vector3i pragma::math::SpatialHashGrid::GetCell(const Vector3 &p) const
+{
+	return {static_cast<int32_t>(std::floor(p.x * m_invCellSize)), static_cast<int32_t>(std::floor(p.y * m_invCellSize)), static_cast<int32_t>(std::floor(p.z * m_invCellSize))};
+}
+
+uint32_t pragma::math::SpatialHashGrid::GetBucket(const Vector3i &cell) const
+{
+	auto h = (static_cast<uint32_t>(cell.x) * 73'856'093u) ^ (static_cast<uint32_t>(cell.y) * 19'349'663u) ^ (static_cast<uint32_t>(cell.z) * 83'492'791u);
+	return h & m_tableMask;
+}
+
+void pragma::math::SpatialHashGrid::Build(const std::vector<Vector3> &points, uint32_t threadCount)
+{
+	m_buildCellSize = m_cellSize;
+	m_invCellSize = 1.f / m_cellSize;
+	auto numPoints = static_cast<uint32_t>(points.size());
+	auto tableSize = next_power_of_two(std::max((m_requestedTableSize > 0) ? m_requestedTableSize : numPoints, 16u));
+	m_tableMask = tableSize - 1;
+	m_points.resize(numPoints);
+	m_pointIndices.resize(numPoints);
+	m_pointBuckets.resize(numPoints);
+	m_partitionedPoints.resize(numPoints);
+	m_bucketStart.resize(tableSize + 1);
+
+	// Two-pass radix sort by bucket: The points are first partitioned by the upper bits of their bucket, and each partition is then
+	// sorted by bucket with a counting sort. Every chunk has its own histogram in the first pass, which keeps the scatter stable and the
+	// result independent of the thread count. There are only few partitions, so these histograms are small, and the bucket range
+	// of a single partition is small enough for its histogram to stay in the cache.
+	auto numPartitions = std::min(tableSize, MAX_PARTITION_COUNT);
+	auto partitionShift = static_cast<uint32_t>(std::countr_zero(tableSize / numPartitions));
+	threadCount = parallel::get_thread_count(threadCount);
+	auto numChunks = std::max(std::min(threadCount, numPoints / PARALLEL_CHUNK_SIZE), 1u);
+	auto chunkSize = (numPoints + numChunks - 1) / numChunks;
+	m_chunkCounts.assign(static_cast<size_t>(numChunks) * numPartitions, 0);
+	m_partitionStart.resize(numPartitions + 1);
+	m_chunkCellBounds.assign(numChunks, {Vector3i {std::numeric_limits<int32_t>::max()}, Vector3i {std::numeric_limits<int32_t>::lowest()}});
+	auto getChunkRange = [](size_t chunk, uint32_t size, uint32_t count) -> std::pair<uint32_t, uint32_t> {
+		auto first = std::min(static_cast<uint32_t>(chunk) * size, count);
+		return {first, std::min(first + size, count)};
+	};
+
+	parallel::parallel_for(
+	  numChunks,
+	  [this, &points, numPoints, chunkSize, numPartitions, partitionShift, &getChunkRange](size_t chunk) {
+		  auto [first, end] = getChunkRange(chunk, chunkSize, numPoints);
+		  auto *counts = m_chunkCounts.data() + chunk * numPartitions;
+		  auto &bounds = m_chunkCellBounds[chunk];
+		  for(auto i = first; i < end; ++i) {
+			  auto cell = GetCell(points[i]);
+			  auto bucket = GetBucket(cell);
+			  m_pointBuckets[i] = bucket;
+			  ++counts[bucket >> partitionShift];
+			  bounds.first = glm::min(bounds.first, cell);
+			  bounds.second = glm::max(bounds.second, cell);
+		  }
+	  },
+	  numChunks);
+
+	// Exclusive prefix sum over all partitions, with the chunks of a partition in order
+	uint32_t offset = 0;
+	for(uint32_t partition = 0; partition < numPartitions; ++partition) {
+		m_partitionStart[partition] = offset;
+		for(uint32_t chunk = 0; chunk < numChunks; ++chunk) {
+			auto &count = m_chunkCounts[static_cast<size_t>(chunk) * numPartitions + partition];
+			auto n = count;
+			count = offset;
+			offset += n;
+		}
+	}
+	m_partitionStart[numPartitions] = offset;
+
+	parallel::parallel_for(
+	  numChunks,
+	  [this, numPoints, chunkSize, numPartitions, partitionShift, &getChunkRange](size_t chunk) {
+		  auto [first, end] = getChunkRange(chunk, chunkSize, numPoints);
+		  auto *offsets = m_chunkCounts.data() + chunk * numPartitions;
+		  for(auto i = first; i < end; ++i) {
+			  auto bucket = m_pointBuckets[i];
+			  m_partitionedPoints[offsets[bucket >> partitionShift]++] = {bucket, i};
+		  }
+	  },
+	  numChunks);
+
+	// The partitions cover disjoint bucket ranges, so they can be sorted independently
+	auto partitionsPerChunk = (numPartitions + numChunks - 1) / numChunks;
+	parallel::parallel_for(
+	  numChunks,
+	  [this, &points, numPartitions, partitionShift, partitionsPerChunk, &getChunkRange](size_t chunk) {
+		  auto [firstPartition, endPartition] = getChunkRange(chunk, partitionsPerChunk, numPartitions);
+		  for(auto partition = firstPartition; partition < endPartition; ++partition) {
+			  auto first = m_partitionStart[partition];
+			  auto end = m_partitionStart[partition + 1];
+			  auto firstBucket = partition << partitionShift;
+			  auto endBucket = (partition + 1) << partitionShift;
+			  std::fill(m_bucketStart.begin() + firstBucket, m_bucketStart.begin() + endBucket, 0);
+			  for(auto i = first; i < end; ++i)
+				  ++m_bucketStart[m_partitionedPoints[i].first];
+			  auto bucketOffset = first;
+			  for(auto bucket = firstBucket; bucket < endBucket; ++bucket) {
+				  auto n = m_bucketStart[bucket];
+				  m_bucketStart[bucket] = bucketOffset;
+				  bucketOffset += n;
+			  }
+			  for(auto i = first; i < end; ++i) {
+				  auto [bucket, pointIndex] = m_partitionedPoints[i];
+				  auto dst = m_bucketStart[bucket]++;
+				  m_points[dst] = points[pointIndex];
+				  m_pointIndices[dst] = pointIndex;
+			  }
+			  // The scatter has moved the start of every bucket to its end, which is the start of the next bucket
+			  for(auto bucket = endBucket - 1; bucket > firstBucket; --bucket)
+				  m_bucketStart[bucket] = m_bucketStart[bucket - 1];
+			  m_bucketStart[firstBucket] = first;
+		  }
+	  },
+	  numChunks);
+	m_bucketStart[tableSize] = numPoints;
+
+	m_minCell = m_chunkCellBounds.front().first;
+	m_maxCell = m_chunkCellBounds.front().second;
+	for(auto &bounds : m_chunkCellBounds) {
+		m_minCell = glm::min(m_minCell, bounds.first);
+		m_maxCell = glm::max(m_maxCell, bounds.second);
+	}
+}
+
+template<typename TFunc>
+bool pragma::math::SpatialHashGrid::ForEachPointInCell(const Vector3i &cell, const TFunc &f) const
+{
+	auto bucket = GetBucket(cell);
+	for(auto i = m_bucketStart[bucket]; i < m_bucketStart[bucket + 1]; ++i) {
+		auto &p = m_points[i];
+		// Other cells may map to the same bucket
+		if(GetCell(p) != cell)
+			continue;
+		if(!f(m_pointIndices[i], p))
+			return false;
+	}
+	return true;
+}
+
+void pragma::math::SpatialHashGrid::FindPointsInAabb(const Vector3 &min, const Vector3 &max, std::vector<uint32_t> &outIndices) const
+{
+	if(m_points.empty())
+		return;
+	auto cellMin = glm::max(GetCell(min), m_minCell);
+	auto cellMax = glm::min(GetCell(max), m_maxCell);
+	if(cellMin.x > cellMax.x || cellMin.y > cellMax.y || cellMin.z > cellMax.z)
+		return;
+	auto isInAabb = [&min, &max](const Vector3 &p) { return p.x >= min.x && p.y >= min.y && p.z >= min.z && p.x <= max.x && p.y <= max.y && p.z <= max.z; };
+	auto numCells = static_cast<uint64_t>(cellMax.x - cellMin.x + 1) * static_cast<uint64_t>(cellMax.y - cellMin.y + 1) * static_cast<uint64_t>(cellMax.z - cellMin.z + 1);
+	if(numCells >= m_points.size()) {
+		// Testing all points is cheaper than visiting all cells
+		for(size_t i = 0; i < m_points.size(); ++i) {
+			if(isInAabb(m_points[i]))
+				outIndices.push_back(m_pointIndices[i]);
+		}
+		return;
+	}
+	for(auto z = cellMin.z; z <= cellMax.z; ++z) {
+		for(auto y = cellMin.y; y <= cellMax.y; ++y) {
+			for(auto x = cellMin.x; x <= cellMax.x; ++x) {
+				ForEachPointInCell(Vector3i {x, y, z}, [&outIndices, &isInAabb](uint32_t idx, const Vector3 &p) {
+					if(isInAabb(p))
+						outIndices.push_back(idx);
+					return true;
+				});
+			}
+		}
+	}
+}
+
+void pragma::math::SpatialHashGrid::FindPointsInRadius(const Vector3 &origin, float radius, std::vector<uint32_t> &outIndices) const
+{
+	if(m_points.empty())
+		return;
+	Vector3 extents {radius, radius, radius};
+	auto cellMin = glm::max(GetCell(origin - extents), m_minCell);
+	auto cellMax = glm::min(GetCell(origin + extents), m_maxCell);
+	if(cellMin.x > cellMax.x || cellMin.y > cellMax.y || cellMin.z > cellMax.z)
+		return;
+	auto radiusSqr = radius * radius;
+	auto numCells = static_cast<uint64_t>(cellMax.x - cellMin.x + 1) * static_cast<uint64_t>(cellMax.y - cellMin.y + 1) * static_cast<uint64_t>(cellMax.z - cellMin.z + 1);
+	if(numCells >= m_points.size()) {
+		for(size_t i = 0; i < m_points.size(); ++i) {
+			if(uvec::length_sqr(m_points[i] - origin) <= radiusSqr)
+				outIndices.push_back(m_pointIndices[i]);
+		}
+		return;
+	}
+	for(auto z = cellMin.z; z <= cellMax.z; ++z) {
+		for(auto y = cellMin.y; y <= cellMax.y; ++y) {
+			for(auto x = cellMin.x; x <= cellMax.x; ++x) {
+				// Skip cells in the corners of the range which can't intersect the sphere
+				Vector3 cellMinPos {x * m_buildCellSize, y * m_buildCellSize, z * m_buildCellSize};
+				auto d = glm::max(glm::max(cellMinPos - origin, origin - (cellMinPos + Vector3 {m_buildCellSize})), Vector3 {});
+				if(uvec::length_sqr(d) > radiusSqr)
+					continue;
+				ForEachPointInCell(Vector3i {x, y, z}, [&outIndices, &origin, radiusSqr](uint32_t idx, const Vector3 &p) {
+					if(uvec::length_sqr(p - origin) <= radiusSqr)
+						outIndices.push_back(idx);
+					return true;
+				});
+			}
+		}
+	}
+}
+
+void pragma::math::SpatialHashGrid::FindKNearest(const Vector3 &origin, uint32_t k, std::vector<uint32_t> &outIndices, float maxDistance) const
+{
+	outIndices.clear();
+	if(k == 0 || m_points.empty())
+		return;
+	auto maxDistSqr = maxDistance * maxDistance;
+	// Max-heap of the k closest points found so far
+	std::vector<std::pair<float, uint32_t>> heap;
+	heap.reserve(k);
+	auto consider = [&heap, &origin, k, maxDistSqr](uint32_t idx, const Vector3 &p) {
+		auto candidate = std::pair<float, uint32_t> {uvec::length_sqr(p - origin), idx};
+		if(candidate.first > maxDistSqr)
+			return true;
+		if(heap.size() < k) {
+			heap.push_back(candidate);
+			std::push_heap(heap.begin(), heap.end());
+		}
+		else if(candidate < heap.front()) {
+			std::pop_heap(heap.begin(), heap.end());
+			heap.back() = candidate;
+			std::push_heap(heap.begin(), heap.end());
+		}
+		return true;
+	};
+
+	// Search shells of cells with increasing Chebyshev distance around the cell of the origin
+	auto center = GetCell(origin);
+	auto local = origin * m_invCellSize - Vector3 {center};
+	auto minFrac = std::min({local.x, local.y, local.z, 1.f - local.x, 1.f - local.y, 1.f - local.z});
+	int32_t rStart = 0;
+	for(uint32_t i = 0; i < 3; ++i)
+		rStart = std::max({rStart, m_minCell[i] - center[i], center[i] - m_maxCell[i]});
+	for(auto r = rStart;; ++r) {
+		auto lo = glm::max(center - Vector3i {r}, m_minCell);
+		auto hi = glm::min(center + Vector3i {r}, m_maxCell);
+		for(auto x = lo.x; x <= hi.x; ++x) {
+			for(auto y = lo.y; y <= hi.y; ++y) {
+				auto onShell = std::abs(x - center.x) == r || std::abs(y - center.y) == r;
+				if(onShell) {
+					for(auto z = lo.z; z <= hi.z; ++z)
+						ForEachPointInCell(Vector3i {x, y, z}, consider);
+					continue;
+				}
+				// Only the two outer cells of the column belong to the shell
+				if(center.z - r >= lo.z)
+					ForEachPointInCell(Vector3i {x, y, center.z - r}, consider);
+				if(r > 0 && center.z + r <= hi.z)
+					ForEachPointInCell(Vector3i {x, y, center.z + r}, consider);
+			}
+		}
+		// All cells outside of the searched cube are at least this far away from the origin
+		auto reach = (static_cast<float>(r) + minFrac) * m_buildCellSize;
+		if(heap.size() == k && heap.front().first <= reach * reach)
+			break;
+		if(reach * reach > maxDistSqr)
+			break;
+		auto coversAllCells = true;
+		for(uint32_t i = 0; i < 3; ++i)
+			coversAllCells = coversAllCells && center[i] - r <= m_minCell[i] && center[i] + r >= m_maxCell[i];
+		if(coversAllCells)
+			break;
+	}
+	std::sort_heap(heap.begin(), heap.end());
+	outIndices.reserve(heap.size());
+	for(auto &entry : heap)
+		outIndices.push_back(entry.second);
+}
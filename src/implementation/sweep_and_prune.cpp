@@ -0,0 +1,240 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+module pragma.math;
+
+import :sweep_and_prune;
+
+namespace {
+	bool overlaps(const bounding_volume::AABB &a, const bounding_volume::AABB &b)
+	{
+		return a.min.x <= b.max.x && a.min.y <= b.max.y && a.min.z <= b.max.z && b.min.x <= a.max.x && b.min.y <= a.max.y && b.min.z <= a.max.z;
+	}
+	// For boxes that are already known to overlap on the x-axis. Evaluated without branches, since most tests fail on a random axis.
+	bool overlaps_yz(const bounding_volume::AABB &a, const bounding_volume::AABB &b) { return (a.min.y <= b.max.y) & (b.min.y <= a.max.y) & (a.min.z <= b.max.z) & (b.min.z <= a.max.z); }
+};
+
+void pragma::math::SweepAndPrune::Reserve(uint32_t proxyCount)
+{
+	for(auto &endpoints : m_endpoints)
+		endpoints.reserve(proxyCount * 2);
+	m_boxes.reserve(proxyCount);
+	m_userData.reserve(proxyCount);
+	m_proxyStates.reserve(proxyCount);
+}
+
+void pragma::math::SweepAndPrune::Clear()
+{
+	for(auto &endpoints : m_endpoints)
+		endpoints.clear();
+	m_boxes.clear();
+	m_userData.clear();
+	m_proxyStates.clear();
+	m_freeIds.clear();
+	m_removedIds.clear();
+	m_addedIds.clear();
+	m_proxyCount = 0;
+	m_pairs.clear();
+	m_changedPairs.clear();
+	m_pairEvents.clear();
+	m_frameStats = {};
+}
+
+pragma::math::SweepAndPrune::ProxyId pragma::math::SweepAndPrune::Add(const bounding_volume::AABB &aabb, uint64_t userData)
+{
+	ProxyId proxyId;
+	if(!m_freeIds.empty()) {
+		proxyId = m_freeIds.back();
+		m_freeIds.pop_back();
+		m_boxes[proxyId] = aabb;
+		m_userData[proxyId] = userData;
+		m_proxyStates[proxyId] = ProxyState::Added;
+	}
+	else {
+		proxyId = static_cast<ProxyId>(m_boxes.size());
+		m_boxes.push_back(aabb);
+		m_userData.push_back(userData);
+		m_proxyStates.push_back(ProxyState::Added);
+	}
+	// The endpoints are inserted by the next update
+	m_addedIds.push_back(proxyId);
+	++m_proxyCount;
+	return proxyId;
+}
+
+void pragma::math::SweepAndPrune::Remove(ProxyId proxyId)
+{
+	m_proxyStates[proxyId] = ProxyState::Removed;
+	m_removedIds.push_back(proxyId);
+	--m_proxyCount;
+}
+
+void pragma::math::SweepAndPrune::AddPair(ProxyId a, ProxyId b)
+{
+	auto key = GetPairKey(a, b);
+	if(m_pairs.insert(key).second)
+		m_changedPairs.try_emplace(key, false);
+}
+
+void pragma::math::SweepAndPrune::RemovePair(ProxyId a, ProxyId b)
+{
+	auto key = GetPairKey(a, b);
+	if(m_pairs.erase(key) > 0)
+		m_changedPairs.try_emplace(key, true);
+}
+
+void pragma::math::SweepAndPrune::SortAxis(uint32_t axis)
+{
+	auto &endpoints = m_endpoints[axis];
+	uint64_t swapCount = 0;
+	for(size_t i = 1; i < endpoints.size(); ++i) {
+		auto ep = endpoints[i];
+		auto j = i;
+		for(; j > 0 && ep < endpoints[j - 1]; --j) {
+			auto &other = endpoints[j - 1];
+			auto a = ep.GetProxyId();
+			auto b = other.GetProxyId();
+			if(a != b) {
+				if(!ep.IsMax() && other.IsMax()) {
+					// The intervals start overlapping on this axis
+					if(overlaps(m_boxes[a], m_boxes[b]))
+						AddPair(a, b);
+				}
+				else if(ep.IsMax() && !other.IsMax()) {
+					// The intervals stop overlapping on this axis
+					RemovePair(a, b);
+				}
+			}
+			endpoints[j] = other;
+		}
+		swapCount += i - j;
+		endpoints[j] = ep;
+	}
+	m_frameStats.swapCount[axis] = swapCount;
+}
+
+void pragma::math::SweepAndPrune::InsertAddedProxies()
+{
+	// Proxies that have been removed again before the update never had their endpoints inserted
+	std::erase_if(m_addedIds, [this](ProxyId proxyId) { return m_proxyStates[proxyId] != ProxyState::Added; });
+	if(m_addedIds.empty())
+		return;
+	for(uint32_t axis = 0; axis < 3; ++axis) {
+		m_addedEndpoints.clear();
+		for(auto proxyId : m_addedIds) {
+			m_addedEndpoints.push_back({m_boxes[proxyId].min[axis], proxyId << 1});
+			m_addedEndpoints.push_back({m_boxes[proxyId].max[axis], (proxyId << 1) | 1});
+		}
+		std::sort(m_addedEndpoints.begin(), m_addedEndpoints.end());
+		// Merge from the back, so that no temporary buffer is required
+		auto &endpoints = m_endpoints[axis];
+		auto i = endpoints.size();
+		auto j = m_addedEndpoints.size();
+		endpoints.resize(i + j);
+		auto dst = endpoints.size();
+		while(j > 0) {
+			if(i > 0 && m_addedEndpoints[j - 1] < endpoints[i - 1])
+				endpoints[--dst] = endpoints[--i];
+			else
+				endpoints[--dst] = m_addedEndpoints[--j];
+		}
+	}
+
+	// Sweep along the x-axis and test every added proxy against all proxies whose x-interval is open when it starts, and vice versa,
+	// so that only the y- and z-intervals have to be compared. Pairs between two active proxies are already tracked, so the open
+	// active proxies are only tested against added ones.
+	m_openIndices.resize(m_boxes.size());
+	for(auto &ep : m_endpoints[0]) {
+		auto proxyId = ep.GetProxyId();
+		auto added = (m_proxyStates[proxyId] == ProxyState::Added) ? 1 : 0;
+		auto &open = m_openProxies[added];
+		if(ep.IsMax()) {
+			auto idx = m_openIndices[proxyId];
+			open[idx] = open.back();
+			m_openIndices[open[idx].proxyId] = idx;
+			open.pop_back();
+			continue;
+		}
+		auto &box = m_boxes[proxyId];
+		for(auto &other : m_openProxies[1]) {
+			if(overlaps_yz(box, other.aabb))
+				AddPair(proxyId, other.proxyId);
+		}
+		if(added) {
+			for(auto &other : m_openProxies[0]) {
+				if(overlaps_yz(box, other.aabb))
+					AddPair(proxyId, other.proxyId);
+			}
+		}
+		m_openIndices[proxyId] = static_cast<uint32_t>(open.size());
+		open.push_back({box, proxyId});
+	}
+	for(auto proxyId : m_addedIds)
+		m_proxyStates[proxyId] = ProxyState::Active;
+	m_addedIds.clear();
+}
+
+void pragma::math::SweepAndPrune::Update()
+{
+	m_frameStats = {};
+	m_pairEvents.clear();
+	if(!m_removedIds.empty()) {
+		// Erasing the endpoints of removed proxies keeps the remaining endpoints sorted
+		for(auto &endpoints : m_endpoints)
+			std::erase_if(endpoints, [this](const Endpoint &ep) { return m_proxyStates[ep.GetProxyId()] == ProxyState::Removed; });
+		for(auto it = m_pairs.begin(); it != m_pairs.end();) {
+			auto key = *it;
+			if(m_proxyStates[key >> 32] == ProxyState::Removed || m_proxyStates[key & std::numeric_limits<uint32_t>::max()] == ProxyState::Removed) {
+				it = m_pairs.erase(it);
+				m_changedPairs.try_emplace(key, true);
+				continue;
+			}
+			++it;
+		}
+		for(auto proxyId : m_removedIds) {
+			m_proxyStates[proxyId] = ProxyState::Free;
+			m_freeIds.push_back(proxyId);
+		}
+		m_removedIds.clear();
+	}
+
+	// The insertion sort only has to handle the movement of existing proxies, added proxies are merged in afterwards
+	for(uint32_t axis = 0; axis < 3; ++axis) {
+		for(auto &ep : m_endpoints[axis]) {
+			auto &box = m_boxes[ep.GetProxyId()];
+			ep.value = ep.IsMax() ? box.max[axis] : box.min[axis];
+		}
+		SortAxis(axis);
+	}
+	if(!m_addedIds.empty())
+		InsertAddedProxies();
+
+	// A pair may have been added and removed again during the same update, in which case no event is generated
+	for(auto &[key, wasOverlapping] : m_changedPairs) {
+		auto isOverlapping = m_pairs.contains(key);
+		if(isOverlapping == wasOverlapping)
+			continue;
+		PairEvent ev {};
+		ev.type = isOverlapping ? PairEventType::Added : PairEventType::Removed;
+		ev.a = static_cast<ProxyId>(key >> 32);
+		ev.b = static_cast<ProxyId>(key & std::numeric_limits<uint32_t>::max());
+		m_pairEvents.push_back(ev);
+		if(isOverlapping)
+			++m_frameStats.pairsAdded;
+		else
+			++m_frameStats.pairsRemoved;
+	}
+	m_changedPairs.clear();
+	std::sort(m_pairEvents.begin(), m_pairEvents.end(), [](const PairEvent &a, const PairEvent &b) { return (a.a != b.a) ? (a.a < b.a) : (a.b < b.b); });
+}
+
+void pragma::math::SweepAndPrune::GetPairs(std::vector<std::pair<ProxyId, ProxyId>> &outPairs) const
+{
+	outPairs.reserve(outPairs.size() + m_pairs.size());
+	auto offset = outPairs.size();
+	for(auto key : m_pairs)
+		outPairs.push_back({static_cast<ProxyId>(key >> 32), static_cast<ProxyId>(key & std::numeric_limits<uint32_t>::max())});
+	std::sort(outPairs.begin() + offset, outPairs.end());
+}
@@ -0,0 +1,402 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+#include "simd.hpp"
+
+module pragma.math;
+
+import :transform_buffer;
+
+namespace {
+	using vfloat = pragma::math::simd::vfloat;
+	using Vec3Lanes = std::array<vfloat, 3>;
+	// x, y, z, w
+	using QuatLanes = std::array<vfloat, 4>;
+	struct TransformLanes {
+		Vec3Lanes translation;
+		QuatLanes rotation;
+		Vec3Lanes scale;
+	};
+
+	template<typename TBuffer>
+	constexpr bool is_scaled() { return std::is_same_v<TBuffer, pragma::math::ScaledTransformBuffer>; }
+
+	Vec3Lanes cross(const Vec3Lanes &a, const Vec3Lanes &b) { return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]}; }
+	// Same as glm's quaternion product
+	QuatLanes multiply(const QuatLanes &p, const QuatLanes &q)
+	{
+		return {
+		  p[3] * q[0] + p[0] * q[3] + p[1] * q[2] - p[2] * q[1],
+		  p[3] * q[1] + p[1] * q[3] + p[2] * q[0] - p[0] * q[2],
+		  p[3] * q[2] + p[2] * q[3] + p[0] * q[1] - p[1] * q[0],
+		  p[3] * q[3] - p[0] * q[0] - p[1] * q[1] - p[2] * q[2],
+		};
+	}
+	// Same as uvec::rotate
+	Vec3Lanes rotate(const QuatLanes &q, const Vec3Lanes &v)
+	{
+		using namespace pragma::math::simd;
+		Vec3Lanes qv {q[0], q[1], q[2]};
+		auto uv = cross(qv, v);
+		auto uuv = cross(qv, uv);
+		auto two = set1(2.f);
+		return {v[0] + (uv[0] * q[3] + uuv[0]) * two, v[1] + (uv[1] * q[3] + uuv[1]) * two, v[2] + (uv[2] * q[3] + uuv[2]) * two};
+	}
+
+	// Unused lanes of partial batches are identity transforms
+	vfloat load_lane(const float *p, uint32_t n, float fill)
+	{
+		using namespace pragma::math::simd;
+		return (n == width) ? load(p) : load_partial(p, n, fill);
+	}
+	void store_lane(float *p, vfloat v, uint32_t n)
+	{
+		using namespace pragma::math::simd;
+		if(n == width)
+			store(p, v);
+		else
+			store_partial(p, v, n);
+	}
+
+	template<typename TBuffer>
+	TransformLanes load_transforms(const TBuffer &buffer, size_t offset, uint32_t n)
+	{
+		TransformLanes lanes;
+		for(uint8_t i = 0; i < 3; ++i)
+			lanes.translation[i] = load_lane(buffer.GetTranslation(i) + offset, n, 0.f);
+		for(uint8_t i = 0; i < 4; ++i)
+			lanes.rotation[i] = load_lane(buffer.GetRotation(i) + offset, n, (i == 3) ? 1.f : 0.f);
+		if constexpr(is_scaled<TBuffer>()) {
+			for(uint8_t i = 0; i < 3; ++i)
+				lanes.scale[i] = load_lane(buffer.GetScale(i) + offset, n, 1.f);
+		}
+		return lanes;
+	}
+	template<typename TBuffer>
+	void store_transforms(TBuffer &buffer, size_t offset, uint32_t n, const TransformLanes &lanes)
+	{
+		for(uint8_t i = 0; i < 3; ++i)
+			store_lane(buffer.GetTranslation(i) + offset, lanes.translation[i], n);
+		for(uint8_t i = 0; i < 4; ++i)
+			store_lane(buffer.GetRotation(i) + offset, lanes.rotation[i], n);
+		if constexpr(is_scaled<TBuffer>()) {
+			for(uint8_t i = 0; i < 3; ++i)
+				store_lane(buffer.GetScale(i) + offset, lanes.scale[i], n);
+		}
+	}
+	TransformLanes broadcast(const pragma::math::ScaledTransform &t)
+	{
+		using namespace pragma::math::simd;
+		auto &pos = t.GetOrigin();
+		auto &rot = t.GetRotation();
+		auto &scale = t.GetScale();
+		return {{set1(pos.x), set1(pos.y), set1(pos.z)}, {set1(rot.x), set1(rot.y), set1(rot.z), set1(rot.w)}, {set1(scale.x), set1(scale.y), set1(scale.z)}};
+	}
+
+	// Same as ScaledTransform::operator*=, the scale only applies to the scale of b
+	TransformLanes multiply(const TransformLanes &a, const TransformLanes &b, bool scaled)
+	{
+		TransformLanes result;
+		auto t = rotate(a.rotation, b.translation);
+		result.translation = {a.translation[0] + t[0], a.translation[1] + t[1], a.translation[2] + t[2]};
+		result.rotation = multiply(a.rotation, b.rotation);
+		if(scaled)
+			result.scale = {a.scale[0] * b.scale[0], a.scale[1] * b.scale[1], a.scale[2] * b.scale[2]};
+		return result;
+	}
+
+	template<typename TBuffer, typename TGetA>
+	void multiply_buffers(const TGetA &getA, const TBuffer &b, TBuffer &out)
+	{
+		using namespace pragma::math::simd;
+		auto count = b.Size();
+		out.Resize(count);
+		for(size_t i = 0; i < count; i += width) {
+			auto n = static_cast<uint32_t>(std::min<size_t>(width, count - i));
+			store_transforms(out, i, n, multiply(getA(i, n), load_transforms(b, i, n), is_scaled<TBuffer>()));
+		}
+	}
+
+	template<typename TBuffer>
+	void invert(const TBuffer &src, TBuffer &out)
+	{
+		using namespace pragma::math::simd;
+		auto count = src.Size();
+		out.Resize(count);
+		auto one = set1(1.f);
+		for(size_t i = 0; i < count; i += width) {
+			auto n = static_cast<uint32_t>(std::min<size_t>(width, count - i));
+			auto t = load_transforms(src, i, n);
+			// Same as glm::inverse: conjugate / dot(q, q)
+			auto &r = t.rotation;
+			auto invLenSqr = one / (r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+			t.rotation = {-r[0] * invLenSqr, -r[1] * invLenSqr, -r[2] * invLenSqr, r[3] * invLenSqr};
+			t.translation = rotate(t.rotation, {-t.translation[0], -t.translation[1], -t.translation[2]});
+			if constexpr(is_scaled<TBuffer>())
+				t.scale = {one / t.scale[0], one / t.scale[1], one / t.scale[2]};
+			store_transforms(out, i, n, t);
+		}
+	}
+
+	template<typename TBuffer>
+	void transform_points(const TBuffer &buffer, const Vector3 *points, Vector3 *outPoints)
+	{
+		using namespace pragma::math::simd;
+		alignas(64) std::array<std::array<float, pragma::math::simd::width>, 3> coords;
+		auto count = buffer.Size();
+		for(size_t i = 0; i < count; i += width) {
+			auto n = static_cast<uint32_t>(std::min<size_t>(width, count - i));
+			for(uint32_t j = 0; j < n; ++j) {
+				auto &p = points[i + j];
+				coords[0][j] = p.x;
+				coords[1][j] = p.y;
+				coords[2][j] = p.z;
+			}
+			auto t = load_transforms(buffer, i, n);
+			Vec3Lanes p {load_lane(coords[0].data(), n, 0.f), load_lane(coords[1].data(), n, 0.f), load_lane(coords[2].data(), n, 0.f)};
+			if constexpr(is_scaled<TBuffer>())
+				p = {p[0] * t.scale[0], p[1] * t.scale[1], p[2] * t.scale[2]};
+			p = rotate(t.rotation, p);
+			for(uint8_t k = 0; k < 3; ++k)
+				store(coords[k].data(), p[k] + t.translation[k]);
+			for(uint32_t j = 0; j < n; ++j)
+				outPoints[i + j] = {coords[0][j], coords[1][j], coords[2][j]};
+		}
+	}
+
+	// Basis vectors of rotation * scale, same as umat::create(const Quat&) * scale
+	template<typename TBuffer>
+	std::array<Vec3Lanes, 3> get_basis(const TransformLanes &t)
+	{
+		using namespace pragma::math::simd;
+		auto one = set1(1.f);
+		auto two = set1(2.f);
+		auto &q = t.rotation;
+		auto xx = q[0] * q[0];
+		auto yy = q[1] * q[1];
+		auto zz = q[2] * q[2];
+		auto xz = q[0] * q[2];
+		auto xy = q[0] * q[1];
+		auto yz = q[1] * q[2];
+		auto wx = q[3] * q[0];
+		auto wy = q[3] * q[1];
+		auto wz = q[3] * q[2];
+		std::array<Vec3Lanes, 3> columns {{
+		  {one - two * (yy + zz), two * (xy + wz), two * (xz - wy)},
+		  {two * (xy - wz), one - two * (xx + zz), two * (yz + wx)},
+		  {two * (xz + wy), two * (yz - wx), one - two * (xx + yy)},
+		}};
+		if constexpr(is_scaled<TBuffer>()) {
+			for(uint8_t c = 0; c < 3; ++c) {
+				for(uint8_t r = 0; r < 3; ++r)
+					columns[c][r] = columns[c][r] * t.scale[c];
+			}
+		}
+		return columns;
+	}
+
+	template<typename TBuffer>
+	void to_matrices(const TBuffer &buffer, Mat4 *outMatrices)
+	{
+		using namespace pragma::math::simd;
+		// Column-major elements of translation * rotation * scale
+		alignas(64) std::array<std::array<float, pragma::math::simd::width>, 16> elements;
+		auto count = buffer.Size();
+		auto zeroLanes = zero();
+		auto one = set1(1.f);
+		for(size_t i = 0; i < count; i += width) {
+			auto n = static_cast<uint32_t>(std::min<size_t>(width, count - i));
+			auto t = load_transforms(buffer, i, n);
+			auto columns = get_basis<TBuffer>(t);
+			for(uint8_t c = 0; c < 3; ++c) {
+				for(uint8_t r = 0; r < 3; ++r)
+					store(elements[c * 4 + r].data(), columns[c][r]);
+				store(elements[c * 4 + 3].data(), zeroLanes);
+			}
+			for(uint8_t r = 0; r < 3; ++r)
+				store(elements[12 + r].data(), t.translation[r]);
+			store(elements[15].data(), one);
+			for(uint32_t j = 0; j < n; ++j) {
+				auto &m = outMatrices[i + j];
+				for(uint8_t k = 0; k < 16; ++k)
+					m[k / 4][k % 4] = elements[k][j];
+			}
+		}
+	}
+
+	template<typename TBuffer>
+	void to_affine_matrices(const TBuffer &buffer, pragma::math::AffineMatrix *outMatrices)
+	{
+		using namespace pragma::math::simd;
+		// Row-major elements of the upper three rows of translation * rotation * scale
+		alignas(64) std::array<std::array<float, pragma::math::simd::width>, 12> elements;
+		auto count = buffer.Size();
+		for(size_t i = 0; i < count; i += width) {
+			auto n = static_cast<uint32_t>(std::min<size_t>(width, count - i));
+			auto t = load_transforms(buffer, i, n);
+			auto columns = get_basis<TBuffer>(t);
+			for(uint8_t r = 0; r < 3; ++r) {
+				for(uint8_t c = 0; c < 3; ++c)
+					store(elements[r * 4 + c].data(), columns[c][r]);
+				store(elements[r * 4 + 3].data(), t.translation[r]);
+			}
+			for(uint32_t j = 0; j < n; ++j) {
+				Mat3x4 rows;
+				for(uint8_t k = 0; k < 12; ++k)
+					rows[k / 4][k % 4] = elements[k][j];
+				outMatrices[i + j] = rows;
+			}
+		}
+	}
+};
+
+pragma::math::TransformBuffer::TransformBuffer(const std::vector<Transform> &transforms)
+{
+	Reserve(transforms.size());
+	for(auto &t : transforms)
+		Add(t);
+}
+void pragma::math::TransformBuffer::Reserve(size_t count)
+{
+	for(auto &v : m_translation)
+		v.reserve(count);
+	for(auto &v : m_rotation)
+		v.reserve(count);
+}
+void pragma::math::TransformBuffer::Resize(size_t count)
+{
+	for(auto &v : m_translation)
+		v.resize(count, 0.f);
+	for(uint8_t i = 0; i < 4; ++i)
+		m_rotation[i].resize(count, (i == 3) ? 1.f : 0.f);
+}
+void pragma::math::TransformBuffer::Clear()
+{
+	for(auto &v : m_translation)
+		v.clear();
+	for(auto &v : m_rotation)
+		v.clear();
+}
+void pragma::math::TransformBuffer::Add(const Transform &t)
+{
+	Resize(Size() + 1);
+	Set(Size() - 1, t);
+}
+void pragma::math::TransformBuffer::Set(size_t idx, const Transform &t)
+{
+	auto &pos = t.GetOrigin();
+	auto &rot = t.GetRotation();
+	for(uint8_t i = 0; i < 3; ++i)
+		m_translation[i][idx] = pos[i];
+	m_rotation[0][idx] = rot.x;
+	m_rotation[1][idx] = rot.y;
+	m_rotation[2][idx] = rot.z;
+	m_rotation[3][idx] = rot.w;
+}
+pragma::math::Transform pragma::math::TransformBuffer::Get(size_t idx) const
+{
+	return {Vector3 {m_translation[0][idx], m_translation[1][idx], m_translation[2][idx]}, Quat {m_rotation[3][idx], m_rotation[0][idx], m_rotation[1][idx], m_rotation[2][idx]}};
+}
+std::vector<pragma::math::Transform> pragma::math::TransformBuffer::ToVector() const
+{
+	std::vector<Transform> transforms;
+	transforms.reserve(Size());
+	for(size_t i = 0; i < Size(); ++i)
+		transforms.push_back(Get(i));
+	return transforms;
+}
+void pragma::math::TransformBuffer::Multiply(const TransformBuffer &a, const TransformBuffer &b, TransformBuffer &out)
+{
+	multiply_buffers([&a](size_t i, uint32_t n) { return load_transforms(a, i, n); }, b, out);
+}
+void pragma::math::TransformBuffer::Multiply(const Transform &parent, const TransformBuffer &b, TransformBuffer &out)
+{
+	auto lanes = broadcast(ScaledTransform {parent});
+	multiply_buffers([&lanes](size_t, uint32_t) -> const TransformLanes & { return lanes; }, b, out);
+}
+void pragma::math::TransformBuffer::Invert(const TransformBuffer &src, TransformBuffer &out) { invert(src, out); }
+void pragma::math::TransformBuffer::TransformPoints(const Vector3 *points, Vector3 *outPoints) const { transform_points(*this, points, outPoints); }
+void pragma::math::TransformBuffer::ToMatrices(Mat4 *outMatrices) const { to_matrices(*this, outMatrices); }
+void pragma::math::TransformBuffer::ToAffineMatrices(AffineMatrix *outMatrices) const { to_affine_matrices(*this, outMatrices); }
+
+/////////////
+
+pragma::math::ScaledTransformBuffer::ScaledTransformBuffer(const std::vector<ScaledTransform> &transforms)
+{
+	Reserve(transforms.size());
+	for(auto &t : transforms)
+		Add(t);
+}
+void pragma::math::ScaledTransformBuffer::Reserve(size_t count)
+{
+	for(auto &v : m_translation)
+		v.reserve(count);
+	for(auto &v : m_rotation)
+		v.reserve(count);
+	for(auto &v : m_scale)
+		v.reserve(count);
+}
+void pragma::math::ScaledTransformBuffer::Resize(size_t count)
+{
+	for(auto &v : m_translation)
+		v.resize(count, 0.f);
+	for(uint8_t i = 0; i < 4; ++i)
+		m_rotation[i].resize(count, (i == 3) ? 1.f : 0.f);
+	for(auto &v : m_scale)
+		v.resize(count, 1.f);
+}
+void pragma::math::ScaledTransformBuffer::Clear()
+{
+	for(auto &v : m_translation)
+		v.clear();
+	for(auto &v : m_rotation)
+		v.clear();
+	for(auto &v : m_scale)
+		v.clear();
+}
+void pragma::math::ScaledTransformBuffer::Add(const ScaledTransform &t)
+{
+	Resize(Size() + 1);
+	Set(Size() - 1, t);
+}
+void pragma::math::ScaledTransformBuffer::Set(size_t idx, const ScaledTransform &t)
+{
+	auto &pos = t.GetOrigin();
+	auto &rot = t.GetRotation();
+	auto &scale = t.GetScale();
+	for(uint8_t i = 0; i < 3; ++i) {
+		m_translation[i][idx] = pos[i];
+		m_scale[i][idx] = scale[i];
+	}
+	m_rotation[0][idx] = rot.x;
+	m_rotation[1][idx] = rot.y;
+	m_rotation[2][idx] = rot.z;
+	m_rotation[3][idx] = rot.w;
+}
+pragma::math::ScaledTransform pragma::math::ScaledTransformBuffer::Get(size_t idx) const
+{
+	return {Vector3 {m_translation[0][idx], m_translation[1][idx], m_translation[2][idx]}, Quat {m_rotation[3][idx], m_rotation[0][idx], m_rotation[1][idx], m_rotation[2][idx]}, Vector3 {m_scale[0][idx], m_scale[1][idx], m_scale[2][idx]}};
+}
+std::vector<pragma::math::ScaledTransform> pragma::math::ScaledTransformBuffer::ToVector() const
+{
+	std::vector<ScaledTransform> transforms;
+	transforms.reserve(Size());
+	for(size_t i = 0; i < Size(); ++i)
+		transforms.push_back(Get(i));
+	return transforms;
+}
+void pragma::math::ScaledTransformBuffer::Multiply(const ScaledTransformBuffer &a, const ScaledTransformBuffer &b, ScaledTransformBuffer &out)
+{
+	multiply_buffers([&a](size_t i, uint32_t n) { return load_transforms(a, i, n); }, b, out);
+}
+void pragma::math::ScaledTransformBuffer::Multiply(const ScaledTransform &parent, const ScaledTransformBuffer &b, ScaledTransformBuffer &out)
+{
+	auto lanes = broadcast(parent);
+	multiply_buffers([&lanes](size_t, uint32_t) -> const TransformLanes & { return lanes; }, b, out);
+}
+void pragma::math::ScaledTransformBuffer::Invert(const ScaledTransformBuffer &src, ScaledTransformBuffer &out) { invert(src, out); }
+void pragma::math::ScaledTransformBuffer::TransformPoints(const Vector3 *points, Vector3 *outPoints) const { transform_points(*this, points, outPoints); }
+void pragma::math::ScaledTransformBuffer::ToMatrices(Mat4 *outMatrices) const { to_matrices(*this, outMatrices); }
+void pragma::math::ScaledTransformBuffer::ToAffineMatrices(AffineMatrix *outMatrices) const { to_affine_matrices(*this, outMatrices); }
@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+module;
+
+module pragma.math;
+
+import :parallel;
+import :transform_hierarchy;
+
+bool pragma::math::TransformHierarchy::SetParents(const std::vector<uint32_t> &parents)
+{
+	Clear();
+	for(auto i = decltype(parents.size()) {0u}; i < parents.size(); ++i) {
+		if(parents[i] != INVALID_INDEX && parents[i] >= i) {
+			Clear();
+			return false;
+		}
+		AddNode(parents[i]);
+	}
+	return true;
+}
+
+uint32_t pragma::math::TransformHierarchy::AddNode(uint32_t parent, const ScaledTransform &localTransform)
+{
+	auto node = GetNodeCount();
+	if(parent != INVALID_INDEX && parent >= node)
+		return INVALID_INDEX;
+	uint32_t subtree;
+	if(parent == INVALID_INDEX) {
+		subtree = static_cast<uint32_t>(m_rootSubtrees.size());
+		m_rootSubtrees.push_back({});
+		m_subtreeDirty.push_back(true);
+	}
+	else
+		subtree = m_subtreeIndices[parent];
+	m_rootSubtrees[subtree].push_back(node);
+	m_subtreeIndices.push_back(subtree);
+	m_parents.push_back(parent);
+	m_localTransforms.push_back(localTransform);
+	m_worldTransforms.push_back(localTransform);
+	m_nodeDirty.push_back(true);
+	m_subtreeDirty[subtree] = true;
+	m_dirty = true;
+	return node;
+}
+
+void pragma::math::TransformHierarchy::Clear()
+{
+	m_parents.clear();
+	m_localTransforms.clear();
+	m_worldTransforms.clear();
+	m_nodeDirty.clear();
+	m_rootSubtrees.clear();
+	m_subtreeIndices.clear();
+	m_subtreeDirty.clear();
+	m_dirty = false;
+}
+
+void pragma::math::TransformHierarchy::SetLocalTransform(uint32_t node, const ScaledTransform &t)
+{
+	m_localTransforms[node] = t;
+	m_nodeDirty[node] = true;
+	m_subtreeDirty[m_subtreeIndices[node]] = true;
+	m_dirty = true;
+}
+
+void pragma::math::TransformHierarchy::SetLocalTransforms(const std::vector<ScaledTransform> &transforms)
+{
+	m_localTransforms = transforms;
+	std::fill(m_nodeDirty.begin(), m_nodeDirty.end(), true);
+	std::fill(m_subtreeDirty.begin(), m_subtreeDirty.end(), true);
+	m_dirty = true;
+}
+
+size_t pragma::math::TransformHierarchy::UpdateSubtree(const std::vector<uint32_t> &nodes)
+{
+	size_t numUpdated = 0;
+	for(auto node : nodes) {
+		auto parent = m_parents[node];
+		// Parents precede their children, so the flag of the parent already includes all of its ancestors
+		if(parent != INVALID_INDEX && m_nodeDirty[parent])
+			m_nodeDirty[node] = true;
+		if(!m_nodeDirty[node])
+			continue;
+		m_worldTransforms[node] = (parent != INVALID_INDEX) ? m_worldTransforms[parent] * m_localTransforms[node] : m_localTransforms[node];
+		++numUpdated;
+	}
+	// Flags can only be cleared once all children have been visited
+	for(auto node : nodes)
+		m_nodeDirty[node] = false;
+	return numUpdated;
+}
+
+size_t pragma::math::TransformHierarchy::Update()
+{
+	if(!m_dirty)
+		return 0;
+	size_t numUpdated = 0;
+	for(auto i = decltype(m_rootSubtrees.size()) {0u}; i < m_rootSubtrees.size(); ++i) {
+		if(!m_subtreeDirty[i])
+			continue;
+		numUpdated += UpdateSubtree(m_rootSubtrees[i]);
+		m_subtreeDirty[i] = false;
+	}
+	m_dirty = false;
+	return numUpdated;
+}
+
+size_t pragma::math::TransformHierarchy::UpdateParallel(uint32_t threadCount)
+{
+	if(!m_dirty)
+		return 0;
+	std::vector<uint32_t> dirtySubtrees;
+	for(auto i = decltype(m_subtreeDirty.size()) {0u}; i < m_subtreeDirty.size(); ++i) {
+		if(m_subtreeDirty[i])
+			dirtySubtrees.push_back(static_cast<uint32_t>(i));
+	}
+	// Subtrees are disjoint, so each task only writes to its own nodes
+	std::vector<size_t> numUpdated(dirtySubtrees.size(), 0);
+	parallel::parallel_for(
+	  dirtySubtrees.size(), [this, &dirtySubtrees, &numUpdated](size_t i) { numUpdated[i] = UpdateSubtree(m_rootSubtrees[dirtySubtrees[i]]); }, threadCount);
+	for(auto subtree : dirtySubtrees)
+		m_subtreeDirty[subtree] = false;
+	m_dirty = false;
+	return std::accumulate(numUpdated.begin(), numUpdated.end(), size_t {0});
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:affine_matrix;
+
+export import :transform;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Affine transform stored as the upper three rows of a 4x4 matrix (the last row is always (0, 0, 0, 1)).
+		// GetRows()[r] is row r, with the translation in the w component. This is the same layout as a transposed 4x3 matrix,
+		// which is commonly used for bone palettes on the GPU, and requires 48 instead of 64 bytes.
+		class DLLMUTIL AffineMatrix {
+		  public:
+			AffineMatrix() = default;
+			AffineMatrix(const Mat3x4 &rows) : m_rows {rows} {}
+			AffineMatrix(const Mat3 &basis, const Vector3 &translation);
+			// The last row of m is ignored
+			explicit AffineMatrix(const Mat4 &m);
+			// Same as Transform::ToMatrix / ScaledTransform::ToMatrix
+			AffineMatrix(const Transform &t);
+			AffineMatrix(const ScaledTransform &t);
+
+			const Mat3x4 &GetRows() const { return m_rows; }
+			Mat3 GetBasis() const;
+			Vector3 GetTranslation() const { return {m_rows[0].w, m_rows[1].w, m_rows[2].w}; }
+			void SetTranslation(const Vector3 &translation);
+			Mat4 ToMatrix() const;
+
+			// General inverse, the basis must be invertible
+			AffineMatrix GetInverse() const;
+			// Requires orthogonal basis vectors, i.e. a rotation combined with a (non-uniform) scale, as created from a ScaledTransform. Does not support shear.
+			AffineMatrix GetOrthogonalInverse() const;
+			// Requires an orthonormal basis, i.e. a pure rotation, as created from a Transform
+			AffineMatrix GetRigidInverse() const;
+
+			Vector3 TransformPoint(const Vector3 &p) const;
+			// Ignores the translation
+			Vector3 TransformDirection(const Vector3 &dir) const;
+			Vector3 operator*(const Vector3 &p) const { return TransformPoint(p); }
+
+			// Same order as Mat4 multiplication, i.e. (a * b) applies b first
+			AffineMatrix operator*(const AffineMatrix &other) const;
+			AffineMatrix &operator*=(const AffineMatrix &other);
+			bool operator==(const AffineMatrix &other) const { return m_rows == other.m_rows; }
+			bool operator!=(const AffineMatrix &other) const { return !operator==(other); }
+
+			// outPoints[i] = (*this) * points[i], the arrays may be the same
+			void TransformPoints(const Vector3 *points, Vector3 *outPoints, size_t count) const;
+			void TransformDirections(const Vector3 *dirs, Vector3 *outDirs, size_t count) const;
+			// out[i] = a[i] * b[i], out may be the same as a or b
+			static void Multiply(const AffineMatrix *a, const AffineMatrix *b, AffineMatrix *out, size_t count);
+			// out[i] = parent * b[i], e.g. to move all bone matrices of a skeleton into world space
+			static void Multiply(const AffineMatrix &parent, const AffineMatrix *b, AffineMatrix *out, size_t count);
+		  private:
+			Mat3x4 m_rows {1.f};
+		};
+	};
+#pragma warning(pop)
+}
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:bvh;
+
+export import :bounding_volume;
+export import :geometry;
+export import :intersection_batch;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		struct BvhNode {
+			Vector3 min;
+			// Index of the left child for inner nodes (the right child is always leftFirst +1),
+			// or index of the first primitive for leaf nodes
+			uint32_t leftFirst = 0;
+			Vector3 max;
+			// Number of primitives for leaf nodes, 0 for inner nodes
+			uint32_t count = 0;
+			bool IsLeaf() const { return count > 0; }
+		};
+		static_assert(sizeof(BvhNode) == 32);
+
+		struct BvhBuildInfo {
+			uint32_t maxLeafSize = 4;
+			uint32_t binCount = 16; // Number of bins for the binned SAH, clamped to [2, Bvh::MAX_BIN_COUNT]
+			// Number of threads used for the build, 0 uses all hardware threads. The resulting tree is identical for all thread counts.
+			uint32_t threadCount = 1;
+		};
+
+		// Bounding volume hierarchy over a triangle mesh
+		class DLLMUTIL Bvh {
+		  public:
+			static constexpr uint32_t MAX_DEPTH = 64;
+			static constexpr uint32_t MAX_BIN_COUNT = 64;
+			using BuildInfo = BvhBuildInfo;
+			struct RaycastHit {
+				uint32_t triangleIndex = 0;
+				float t = 0.f;
+				float u = 0.f;
+				float v = 0.f;
+			};
+			struct ClosestPoint {
+				uint32_t triangleIndex = 0;
+				Vector3 point {};
+				float distanceSqr = 0.f;
+			};
+
+			Bvh() = default;
+			Bvh(const std::vector<Vector3> &verts, const std::vector<uint16_t> &triangles, const BuildInfo &buildInfo = {});
+			Bvh(const std::vector<Vector3> &verts, const std::vector<uint32_t> &triangles, const BuildInfo &buildInfo = {});
+			void Build(const std::vector<Vector3> &verts, const std::vector<uint16_t> &triangles, const BuildInfo &buildInfo = {});
+			void Build(const std::vector<Vector3> &verts, const std::vector<uint32_t> &triangles, const BuildInfo &buildInfo = {});
+			void Clear();
+
+			// Triangle indices refer to the index of the triangle in the index buffer the bvh was built from (i.e. index /3).
+			// The ray is defined by its origin and direction, hits are only reported for t in [tMin, tMax]. The direction does not have to be normalized.
+			std::optional<RaycastHit> Raycast(const Vector3 &origin, const Vector3 &dir, float tMin = 0.f, float tMax = std::numeric_limits<float>::max(), bool bCull = false) const;
+			std::optional<ClosestPoint> FindClosestPoint(const Vector3 &p, float maxDistance = std::numeric_limits<float>::max()) const;
+			void FindTrianglesInAabb(const Vector3 &min, const Vector3 &max, std::vector<uint32_t> &outTriangles) const;
+			void FindTrianglesInSphere(const Vector3 &origin, float radius, std::vector<uint32_t> &outTriangles) const;
+
+			// Updates the node bounds for new vertex positions in O(n) without changing the tree topology, which is intended for
+			// deforming meshes (e.g. skinned or cloth meshes). The vertex count must match the one the bvh was built with, otherwise false is returned.
+			// The quality of the tree degrades the more the mesh deforms, use IsRebuildRecommended to determine when a full rebuild is worthwhile.
+			bool Refit(const std::vector<Vector3> &verts, uint32_t threadCount = 1);
+			// Surface area heuristic cost of the tree (with equal traversal and intersection costs), relative to the surface area of the root node
+			float CalcSahCost() const;
+			// SAH cost of the tree right after the last build
+			float GetBuildSahCost() const { return m_buildSahCost; }
+			// Returns true if the SAH cost has degraded by more than the specified factor compared to the last build
+			bool IsRebuildRecommended(float maxCostRatio = 1.5f) const;
+
+			bool IsEmpty() const { return m_nodes.empty(); }
+			bounding_volume::AABB GetBounds() const;
+			size_t GetTriangleCount() const { return m_primitives.size(); }
+			std::array<Vector3, 3> GetTriangle(uint32_t triangleIndex) const;
+			const std::vector<BvhNode> &GetNodes() const { return m_nodes; }
+			// Triangle indices in leaf order, i.e. leaf nodes reference the range [leftFirst, leftFirst +count) of this list
+			const std::vector<uint32_t> &GetPrimitives() const { return m_primitives; }
+		  private:
+			template<typename TIndex>
+			void Initialize(const std::vector<Vector3> &verts, const std::vector<TIndex> &triangles, const BuildInfo &buildInfo);
+			void BuildNodes(const BuildInfo &buildInfo);
+			void RefitNode(uint32_t nodeIndex);
+
+			std::vector<BvhNode> m_nodes;
+			std::vector<uint32_t> m_primitives;
+			std::vector<Vector3> m_vertices;
+			std::vector<uint32_t> m_indices;
+			float m_buildSahCost = 0.f;
+		};
+	};
+#pragma warning(pop)
+}
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:clustered_lighting;
+
+export import :bounding_volume;
+export import :frustum;
+export import :intersection_batch;
+export import :parallel;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Froxel grid for clustered shading. The view frustum is divided into numX * numY screen-space tiles and numZ depth slices,
+		// which are distributed exponentially between the near and far plane.
+		// Tiles are numbered in the uv space of frustum::get_plane_point, i.e. tile (0, 0) contains uv (0, 0).
+		// Cluster (x, y, z) has the index (z * numY + y) * numX + x, so the clusters of a slice are stored contiguously.
+		class DLLMUTIL LightClusterGrid {
+		  public:
+			struct SpotLight {
+				Vector3 origin {};
+				// Must be normalized
+				Vector3 direction {0.f, 0.f, 1.f};
+				// Half angle of the outer cone, in radians
+				float coneAngle = 0.f;
+				float range = 0.f;
+			};
+
+			LightClusterGrid() = default;
+			// The camera parameters are the same as for frustum::get_plane_point
+			void Build(const Vector3 &pos, const Vector3 &forward, const Vector3 &up, float fovRad, float aspectRatio, float nearZ, float farZ, uint32_t numX, uint32_t numY, uint32_t numZ);
+
+			uint32_t GetClusterCount() const { return m_numX * m_numY * m_numZ; }
+			uint32_t GetClusterIndex(uint32_t x, uint32_t y, uint32_t z) const { return (z * m_numY + y) * m_numX + x; }
+			// Depth of the near boundary of slice z along the view direction. GetSliceDepth(numZ) is the far plane.
+			float GetSliceDepth(uint32_t z) const { return m_sliceDepths[z]; }
+			// Returns false if the point lies outside of the frustum
+			bool FindCluster(const Vector3 &p, uint32_t &outClusterIndex) const;
+			// Sphere enclosing the corners of the cluster, as used for the spotlight tests. It is centered on the AABB of the corners,
+			// so it is not necessarily the smallest enclosing sphere.
+			bounding_volume::Sphere GetClusterSphere(uint32_t clusterIndex) const;
+
+			// Assigns the lights to all clusters they may affect. The bounding sphere of each light is tested against the column, row and slice
+			// boundaries separately, and the light is assigned to all clusters within the resulting ranges. This is a conservative box test,
+			// clusters in the corners of the ranges may not touch the sphere. Spotlights are additionally tested against the bounding sphere
+			// of each cluster with the same test as intersection::sphere_cone.
+			// The results are conservative and identical for all thread counts, 0 uses all hardware threads.
+			// Light indices refer to pointLights, spotlight i has the light index pointLights.count + i.
+			void AssignLights(const SphereSoaView &pointLights, const SpotLight *spotLights, size_t numSpotLights, uint32_t threadCount = 0);
+			// The lights of cluster i are m_lightIndices[offsets[i], offsets[i + 1]), in ascending order
+			const std::vector<uint32_t> &GetLightIndices() const { return m_lightIndices; }
+			const std::vector<uint32_t> &GetClusterOffsets() const { return m_clusterOffsets; }
+			std::pair<const uint32_t *, uint32_t> GetClusterLights(uint32_t clusterIndex) const;
+		  private:
+			// Inclusive cluster coordinate range of a light
+			struct LightRange {
+				std::array<uint32_t, 3> min;
+				std::array<uint32_t, 3> max;
+				bool valid;
+			};
+			bool GetLightRange(const Vector3 &origin, float radius, LightRange &outRange) const;
+			void AssignSlice(uint32_t z, const SphereSoaView &pointLights, const SpotLight *spotLights, size_t numSpotLights, std::vector<uint32_t> &outIndices);
+
+			uint32_t m_numX = 0;
+			uint32_t m_numY = 0;
+			uint32_t m_numZ = 0;
+			// Planes between the columns, rows and slices, including the outer ones. xyz is the plane normal, w the plane distance.
+			// The normals point towards increasing cluster coordinates.
+			std::array<std::vector<Vector4>, 3> m_boundaryPlanes;
+			std::vector<float> m_sliceDepths;
+			// Cluster bounding spheres
+			std::vector<float> m_clusterX;
+			std::vector<float> m_clusterY;
+			std::vector<float> m_clusterZ;
+			std::vector<float> m_clusterRadius;
+
+			std::vector<LightRange> m_lightRanges;
+			// Per slice (cluster, light) pairs, kept between assignments to avoid re-allocations
+			std::vector<std::vector<uint64_t>> m_sliceEntries;
+			std::vector<uint32_t> m_clusterCounts;
+			std::vector<uint32_t> m_clusterOffsets;
+			std::vector<uint32_t> m_lightIndices;
+		};
+	};
+#pragma warning(pop)
+}
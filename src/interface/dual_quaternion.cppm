@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:dual_quaternion;
+
+export import :transform;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Rigid transform as a unit dual quaternion real + e * dual, with dual = 0.5 * translation * real.
+		// The product corresponds to that of Transform, i.e. (a * b) applies b first. Scale is not supported.
+		class DLLMUTIL DualQuat {
+		  public:
+			DualQuat() = default;
+			DualQuat(const Quat &real, const Quat &dual) : real {real}, dual {dual} {}
+			DualQuat(const Vector3 &translation, const Quat &rotation);
+			// The scale of a ScaledTransform is ignored
+			DualQuat(const Transform &t);
+
+			Quat GetRotation() const { return real; }
+			Vector3 GetTranslation() const;
+			Transform ToTransform() const;
+			Mat4 ToMatrix() const;
+
+			// Normalizes the real part and removes the component of the dual part that is parallel to it
+			void Normalize();
+			DualQuat GetNormal() const;
+			// Same as the conjugate, requires a unit dual quaternion
+			DualQuat GetInverse() const;
+
+			Vector3 operator*(const Vector3 &p) const;
+			// Rotates the direction without translating it
+			Vector3 Rotate(const Vector3 &dir) const;
+
+			DualQuat operator*(const DualQuat &other) const;
+			DualQuat &operator*=(const DualQuat &other);
+			DualQuat operator*(float weight) const { return {real * weight, dual * weight}; }
+			DualQuat operator+(const DualQuat &other) const { return {real + other.real, dual + other.dual}; }
+			DualQuat &operator+=(const DualQuat &other);
+
+			// Dual quaternion linear blending (Kavan et al.): The weighted sum of the dual quaternions, normalized.
+			// Dual quaternions in the opposite hemisphere of the one with the largest weight are negated, so that the blend takes the shortest path.
+			// Returns the identity if the sum of the weights is zero.
+			static DualQuat Blend(const DualQuat *dqs, const float *weights, size_t count);
+
+			Quat real = uquat::identity();
+			Quat dual = {0.f, 0.f, 0.f, 0.f};
+		};
+	};
+#pragma warning(pop)
+}
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:dynamic_aabb_tree;
+
+export import :bounding_volume;
+export import :intersection_batch;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Dynamic bounding volume tree for broadphase collision detection, based on the tree used by Box2D.
+		// Proxies are stored with a fattened box, so that small movements don't require the tree to be updated, and the
+		// tree is kept balanced with rotations. All nodes are stored in a pool, which only grows if the number of proxies
+		// exceeds the reserved capacity.
+		class DLLMUTIL DynamicAabbTree {
+		  public:
+			using ProxyId = uint32_t;
+			static constexpr ProxyId INVALID_PROXY = std::numeric_limits<uint32_t>::max();
+			// The tree is height-balanced, so its height never comes close to this
+			static constexpr uint32_t MAX_QUERY_STACK_SIZE = 256;
+			struct Node {
+				bounding_volume::AABB aabb {};
+				uint64_t userData = 0;
+				// Parent node, or the next free node if this node is in the free list
+				uint32_t parent = INVALID_PROXY;
+				uint32_t child1 = INVALID_PROXY;
+				uint32_t child2 = INVALID_PROXY;
+				// 0 for leaves, -1 for free nodes
+				int32_t height = -1;
+				bool moved = false;
+				bool IsLeaf() const { return child1 == INVALID_PROXY; }
+			};
+
+			// The margin is added to all sides of a proxy box. On Move, the box is additionally extended by the displacement times the displacement multiplier.
+			DynamicAabbTree(float margin = 0.1f, float displacementMultiplier = 4.f);
+			void Reserve(uint32_t proxyCount);
+			void Clear();
+
+			ProxyId Insert(const bounding_volume::AABB &aabb, uint64_t userData = 0);
+			void Remove(ProxyId proxyId);
+			// Updates the box of the proxy. The proxy is only re-inserted if the new box is no longer contained in its fattened box (or the fattened box has become too large),
+			// in which case true is returned.
+			bool Move(ProxyId proxyId, const bounding_volume::AABB &aabb, const Vector3 &displacement = {});
+
+			const bounding_volume::AABB &GetFatAabb(ProxyId proxyId) const { return m_nodes[proxyId].aabb; }
+			uint64_t GetUserData(ProxyId proxyId) const { return m_nodes[proxyId].userData; }
+			uint32_t GetProxyCount() const { return m_proxyCount; }
+			uint32_t GetHeight() const;
+			const std::vector<Node> &GetNodes() const { return m_nodes; }
+			ProxyId GetRoot() const { return m_root; }
+
+			// Calls callback(ProxyId) for every proxy whose fattened box overlaps the box. Return false from the callback to stop the query.
+			template<typename TCallback>
+			void Query(const bounding_volume::AABB &aabb, TCallback &&callback) const;
+			// Calls callback(ProxyId, float tMax) for every proxy whose fattened box is hit by the ray within [0, tMax]. The callback returns the new maximum
+			// distance (e.g. the distance of the closest hit found so far, or tMax to continue unchanged), or a negative value to stop the query.
+			template<typename TCallback>
+			void Raycast(const Vector3 &origin, const Vector3 &dir, float tMax, TCallback &&callback) const;
+			// Calls callback(ProxyId, ProxyId) once for every overlapping pair of proxies where at least one of the proxies has been inserted or re-inserted
+			// since the last call, with the lower proxy id first. Pairs are reported in ascending order.
+			void UpdatePairs(const std::function<void(ProxyId, ProxyId)> &callback);
+			// Calls callback(ProxyId, ProxyId) once for every overlapping pair of proxies, with the lower proxy id first
+			template<typename TCallback>
+			void QueryAllPairs(TCallback &&callback) const;
+		  private:
+			static bool Overlaps(const bounding_volume::AABB &a, const bounding_volume::AABB &b)
+			{
+				return a.min.x <= b.max.x && a.min.y <= b.max.y && a.min.z <= b.max.z && b.min.x <= a.max.x && b.min.y <= a.max.y && b.min.z <= a.max.z;
+			}
+			uint32_t AllocateNode();
+			void FreeNode(uint32_t nodeIndex);
+			void InsertLeaf(uint32_t leaf);
+			void RemoveLeaf(uint32_t leaf);
+			uint32_t Balance(uint32_t nodeIndex);
+			// Refits the boxes and heights of all ancestors of the node, starting with the node itself, and re-balances them on the way
+			void UpdateAncestors(uint32_t nodeIndex);
+
+			std::vector<Node> m_nodes;
+			std::vector<ProxyId> m_moveBuffer;
+			std::vector<std::pair<ProxyId, ProxyId>> m_pairBuffer;
+			uint32_t m_root = INVALID_PROXY;
+			uint32_t m_freeList = INVALID_PROXY;
+			uint32_t m_proxyCount = 0;
+			float m_margin = 0.1f;
+			float m_displacementMultiplier = 4.f;
+		};
+	};
+
+	template<typename TCallback>
+	void pragma::math::DynamicAabbTree::Query(const bounding_volume::AABB &aabb, TCallback &&callback) const
+	{
+		if(m_root == INVALID_PROXY)
+			return;
+		std::array<uint32_t, MAX_QUERY_STACK_SIZE> stack;
+		uint32_t stackSize = 0;
+		stack[stackSize++] = m_root;
+		while(stackSize > 0) {
+			auto nodeIndex = stack[--stackSize];
+			auto &node = m_nodes[nodeIndex];
+			if(!Overlaps(node.aabb, aabb))
+				continue;
+			if(node.IsLeaf()) {
+				if(!callback(static_cast<ProxyId>(nodeIndex)))
+					return;
+				continue;
+			}
+			stack[stackSize++] = node.child2;
+			stack[stackSize++] = node.child1;
+		}
+	}
+
+	template<typename TCallback>
+	void pragma::math::DynamicAabbTree::Raycast(const Vector3 &origin, const Vector3 &dir, float tMax, TCallback &&callback) const
+	{
+		if(m_root == INVALID_PROXY)
+			return;
+		intersection::Ray ray {origin, dir};
+		std::array<uint32_t, MAX_QUERY_STACK_SIZE> stack;
+		uint32_t stackSize = 0;
+		stack[stackSize++] = m_root;
+		while(stackSize > 0) {
+			auto nodeIndex = stack[--stackSize];
+			auto &node = m_nodes[nodeIndex];
+			float tEntry, tExit;
+			if(intersection::line_aabb(ray, node.aabb.min, node.aabb.max, &tEntry, &tExit) != intersection::Result::Intersect || tExit < 0.f || tEntry > tMax)
+				continue;
+			if(node.IsLeaf()) {
+				tMax = callback(static_cast<ProxyId>(nodeIndex), tMax);
+				if(tMax < 0.f)
+					return;
+				continue;
+			}
+			stack[stackSize++] = node.child2;
+			stack[stackSize++] = node.child1;
+		}
+	}
+
+	template<typename TCallback>
+	void pragma::math::DynamicAabbTree::QueryAllPairs(TCallback &&callback) const
+	{
+		for(uint32_t i = 0; i < m_nodes.size(); ++i) {
+			auto &node = m_nodes[i];
+			if(node.height != 0)
+				continue;
+			Query(node.aabb, [i, &callback](ProxyId other) {
+				if(other > i)
+					callback(static_cast<ProxyId>(i), other);
+				return true;
+			});
+		}
+	}
+#pragma warning(pop)
+}
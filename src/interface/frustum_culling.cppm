@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:frustum_culling;
+
+export import :frustum;
+export import :intersection_batch;
+export import :parallel;
+export import :plane;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// View frustum for culling bounding volumes. Planes follow the same convention as the plane-mesh tests in the intersection namespace,
+		// i.e. normals point outwards and a positive distance is outside.
+		// Boxes are tested with their center and half-extents, which is equivalent to aabb_in_plane_mesh up to rounding.
+		class DLLMUTIL Frustum {
+		  public:
+			enum class PlaneIndex : uint8_t { Left = 0, Right, Bottom, Top, Near, Far, Count };
+			static constexpr uint32_t PLANE_COUNT = static_cast<uint32_t>(PlaneIndex::Count);
+			// Plane masks have one bit per plane, a cleared bit means that the plane does not need to be tested
+			static constexpr uint8_t PLANE_MASK_ALL = (1u << PLANE_COUNT) - 1u;
+			// Last-plane caches should be initialized to this value
+			static constexpr uint8_t INVALID_PLANE = std::numeric_limits<uint8_t>::max();
+
+			Frustum();
+			// Extracts the planes from a view-projection matrix with a depth range of [0,1] (Gribb/Hartmann). Works for perspective and orthographic projections.
+			// With reverse-Z, depth 1 is the near plane and 0 the far plane, which only affects which of the planes are labeled near and far.
+			// If the projection has an infinite far plane, the far plane never rejects anything (see HasFarPlane).
+			Frustum(const Mat4 &viewProjection, bool reverseZ = false);
+			// Corners are expected in the order bottom-left, top-left, top-right, bottom-right (see frustum::get_plane_boundaries).
+			// The near corners may coincide.
+			Frustum(const std::array<Vector3, 4> &nearCorners, const std::array<Vector3, 4> &farCorners);
+			// Planes with unit-length normals, e.g. from geometry::get_obb_planes for orthographic shadow cascades
+			Frustum(const std::array<Plane, PLANE_COUNT> &planes);
+			static Frustum CreatePerspective(const Vector3 &pos, const Vector3 &forward, const Vector3 &up, float fovRad, float aspectRatio, float nearZ, float farZ);
+
+			// xyz is the plane normal, w the plane distance
+			const std::array<Vector4, PLANE_COUNT> &GetPlaneVectors() const { return m_planes; }
+			const Vector4 &GetPlaneVector(PlaneIndex plane) const { return m_planes[static_cast<uint32_t>(plane)]; }
+			// For use with the plane-mesh tests in the intersection namespace, in the order of PlaneIndex.
+			// The far plane is left out if the frustum has no far plane, since its normal is zero.
+			std::vector<Plane> GetPlanes() const;
+			bool HasFarPlane() const;
+			// Intersection points of the planes, in the order bottom-left, top-left, top-right, bottom-right of the near plane, followed by the same for the far plane.
+			// The far corners are not finite if the frustum has no far plane.
+			std::array<Vector3, 8> GetCorners() const;
+
+			intersection::Intersect ClassifyAabb(const Vector3 &min, const Vector3 &max) const;
+			intersection::Intersect ClassifySphere(const Vector3 &origin, float radius) const;
+			// Variants for hierarchies and temporal coherence:
+			// Only planes set in inOutPlaneMask are tested. Unless the result is Outside, the bits of all planes the volume is entirely inside of
+			// are cleared, so the mask can be passed on to the children of the volume.
+			// inOutLastPlane is the plane that rejected the volume last time, which is tested first. It is updated if the volume is rejected by a different plane.
+			intersection::Intersect ClassifyAabb(const Vector3 &min, const Vector3 &max, uint8_t &inOutPlaneMask, uint8_t &inOutLastPlane) const;
+			intersection::Intersect ClassifySphere(const Vector3 &origin, float radius, uint8_t &inOutPlaneMask, uint8_t &inOutLastPlane) const;
+
+			// Tests all volumes of the view and returns the number of visible ones. Bit i of outVisibleMask (which must have
+			// intersection::get_hit_mask_size(count) elements) is set if volume i is not outside of the frustum.
+			// inOutLastPlanes is optional, it must have one element per volume and works as the last-plane cache of the single-volume variants.
+			size_t CullAabbs(const AabbSoaView &boxes, uint32_t *outVisibleMask, uint8_t *inOutLastPlanes = nullptr) const;
+			size_t CullSpheres(const SphereSoaView &spheres, uint32_t *outVisibleMask, uint8_t *inOutLastPlanes = nullptr) const;
+			// Culls the volumes in parallel (see parallel::parallel_compact) and writes the indices of all visible volumes to outVisibleIndices,
+			// in ascending order. 0 uses all hardware threads. Returns the number of visible volumes.
+			size_t CullAabbs(const AabbSoaView &boxes, std::vector<uint32_t> &outVisibleIndices, uint32_t threadCount = 0) const;
+			size_t CullSpheres(const SphereSoaView &spheres, std::vector<uint32_t> &outVisibleIndices, uint32_t threadCount = 0) const;
+
+			// Culls the volumes against multiple frusta (e.g. shadow cascades or cubemap faces) in a single pass, so that the bounds of each volume are only loaded once.
+			// outVisibleMasks must have numFrusta * intersection::get_hit_mask_size(count) elements, the mask of frustum i starts at element i * get_hit_mask_size(count).
+			// outVisibleCounts is optional and receives the number of visible volumes per frustum.
+			static void CullAabbs(const Frustum *frusta, uint32_t numFrusta, const AabbSoaView &boxes, uint32_t *outVisibleMasks, size_t *outVisibleCounts = nullptr);
+			static void CullSpheres(const Frustum *frusta, uint32_t numFrusta, const SphereSoaView &spheres, uint32_t *outVisibleMasks, size_t *outVisibleCounts = nullptr);
+		  private:
+			std::array<Vector4, PLANE_COUNT> m_planes;
+		};
+	};
+#pragma warning(pop)
+}
@@ -34,7 +34,22 @@ export {
 		DLLMUTIL bool obb_triangle(const Vector3 &min, const Vector3 &max, const Vector3 &origin, const Quat &rot, const Vector3 &a, const Vector3 &b, const Vector3 &c);
 		DLLMUTIL bool aabb_plane(const Vector3 &min, const Vector3 &max, const Vector3 &n, double d);
 		DLLMUTIL bool obb_plane(const Vector3 &min, const Vector3 &max, const Vector3 &origin, const Quat &rot, const Vector3 &n, double d);
+		// Each box is scaled by the scale of its own pose (see get_oriented_box), a non-uniform scale of one pose does not affect the other box
 		DLLMUTIL Intersect obb_obb(const ScaledTransform &obbPoseA, const Vector3 &obbMinA, const Vector3 &obbMaxA, const ScaledTransform &obbPoseB, const Vector3 &obbMinB, const Vector3 &obbMaxB);
+
+		// Oriented box in center / half-extents form. Column i of 'axes' is the direction of local axis i in world space.
+		struct OrientedBox {
+			Vector3 center {};
+			Vector3 halfExtents {};
+			Mat3 axes {1.f};
+		};
+		DLLMUTIL OrientedBox get_oriented_box(const Vector3 &origin, const Quat &rot, const Vector3 &min, const Vector3 &max);
+		// The scale of the pose is applied to the box along its local axes. A negative scale component mirrors the box,
+		// which leaves its extents unchanged, so only the absolute value of the scaled half-extents is used.
+		DLLMUTIL OrientedBox get_oriented_box(const ScaledTransform &pose, const Vector3 &min, const Vector3 &max);
+		// Separating axis test over the face axes of both boxes and the nine edge-edge axes. Outside if any axis separates the boxes,
+		// Inside if a is entirely contained in b, Overlap otherwise.
+		DLLMUTIL Intersect obb_obb(const OrientedBox &a, const OrientedBox &b);
 		DLLMUTIL bool sphere_plane(const Vector3 &sphereOrigin, float sphereRadius, const Vector3 &n, double d);
 		DLLMUTIL Result line_aabb(const Vector3 &o, const Vector3 &d, const Vector3 &min, const Vector3 &max, float *tMinRes, float *tMaxRes = nullptr);
 		DLLMUTIL Result line_plane(const Vector3 &o, const Vector3 &d, const Vector3 &nPlane, float distPlane, float *t = nullptr);
@@ -50,6 +65,8 @@ export {
 		Intersect sphere_in_plane_mesh(const Vector3 &vec, float radius, Iterator beginPlanes, Iterator endPlanes, bool skipInsideTest = false);
 		template<typename Iterator>
 		Intersect aabb_in_plane_mesh(const Vector3 &min, const Vector3 &max, Iterator beginPlanes, Iterator endPlanes);
+		// Outside if the triangle lies entirely in front of the plane mesh, Inside if all three vertices are behind all planes, Overlap otherwise.
+		// Triangles which straddle planes are clipped against them, so triangles which only cross the extension of a plane are Outside as well.
 		template<typename Iterator>
 		Intersect triangle_in_plane_mesh(const Vector3 &a, const Vector3 &b, const Vector3 &c, Iterator beginPlanes, Iterator endPlanes);
 
@@ -94,6 +111,11 @@ export {
 		DLLMUTIL WindingOrder get_triangle_winding_order(const Vector3 &v0, const Vector3 &v1, const Vector3 &v2, const Vector3 &n);
 		DLLMUTIL WindingOrder get_triangle_winding_order(const Vector2 &v0, const Vector2 &v1, const Vector2 &v2);
 
+		// Clips a convex polygon against all planes (Sutherland-Hodgman), keeping the part behind the planes.
+		// Returns false if nothing of the polygon remains, in which case inOutPolygon has less than three vertices.
+		template<typename Iterator>
+		bool clip_polygon_to_plane_mesh(std::vector<Vector3> &inOutPolygon, Iterator beginPlanes, Iterator endPlanes);
+
 		DLLMUTIL float calc_triangle_area(const Vector3 &p0, const Vector3 &p1, const Vector3 &p2);
 		DLLMUTIL float calc_triangle_area(const Vector2 &p0, const Vector2 &p1, const Vector2 &p2, bool keepSign = false);
 
@@ -125,32 +147,62 @@ export {
 	template<typename Iterator>
 	pragma::math::intersection::Intersect pragma::math::intersection::sphere_in_plane_mesh(const Vector3 &vec, float radius, Iterator beginPlanes, Iterator endPlanes, bool skipInsideTest)
 	{
-		if(point_in_plane_mesh(vec, beginPlanes, endPlanes) == false) {
-			for(auto it = beginPlanes; it != endPlanes; ++it) {
-				auto &plane = const_cast<Plane &>(*it);
-				if(plane.GetDistance(vec) > radius)
-					return Intersect::Outside;
-			}
-			return Intersect::Overlap;
-		}
-		if(skipInsideTest == true)
-			return Intersect::Overlap;
-		auto radiusSqr = pow(radius, 2.f);
+		// Single pass over the signed distances: The sphere is outside if it is entirely in front of any plane, and
+		// inside if it is entirely behind all planes. For planes with unit-length normals this is the same as testing
+		// the distance of the closest point on each plane against the radius.
+		auto r = Intersect::Inside;
 		for(auto it = beginPlanes; it != endPlanes; ++it) {
-			auto &plane = const_cast<Plane &>(*it);
-			Vector3 r;
-			geometry::closest_point_on_plane_to_point(plane.GetNormal(), static_cast<float>(plane.GetDistance()), vec, &r);
-			if(uvec::length_sqr(r - vec) < radiusSqr)
-				return Intersect::Overlap;
+			auto dist = it->GetDistance(vec);
+			if(dist > radius)
+				return Intersect::Outside;
+			if(dist > -radius)
+				r = Intersect::Overlap;
 		}
-		return Intersect::Inside;
+		return skipInsideTest ? Intersect::Overlap : r;
 	}
 
 	template<typename Iterator>
 	pragma::math::intersection::Intersect pragma::math::intersection::triangle_in_plane_mesh(const Vector3 &a, const Vector3 &b, const Vector3 &c, Iterator beginPlanes, Iterator endPlanes)
 	{
-		throw std::runtime_error {"Not yet implemented!"};
-		return Intersect::Outside;
+		// Most triangles are either completely behind all planes or completely in front of one of them, only the rest needs to be clipped
+		auto straddles = false;
+		for(auto it = beginPlanes; it != endPlanes; ++it) {
+			auto numOutside = static_cast<uint32_t>(it->GetDistance(a) > 0.f) + static_cast<uint32_t>(it->GetDistance(b) > 0.f) + static_cast<uint32_t>(it->GetDistance(c) > 0.f);
+			if(numOutside == 3)
+				return Intersect::Outside;
+			if(numOutside > 0)
+				straddles = true;
+		}
+		if(!straddles)
+			return Intersect::Inside;
+		std::vector<Vector3> polygon {a, b, c};
+		return geometry::clip_polygon_to_plane_mesh(polygon, beginPlanes, endPlanes) ? Intersect::Overlap : Intersect::Outside;
+	}
+
+	template<typename Iterator>
+	bool pragma::math::geometry::clip_polygon_to_plane_mesh(std::vector<Vector3> &inOutPolygon, Iterator beginPlanes, Iterator endPlanes)
+	{
+		std::vector<Vector3> clipped;
+		clipped.reserve(inOutPolygon.size() + 1);
+		for(auto it = beginPlanes; it != endPlanes; ++it) {
+			if(inOutPolygon.size() < 3)
+				return false;
+			clipped.clear();
+			auto &plane = *it;
+			auto *prev = &inOutPolygon.back();
+			auto distPrev = plane.GetDistance(*prev);
+			for(auto &v : inOutPolygon) {
+				auto dist = plane.GetDistance(v);
+				if((distPrev <= 0.f) != (dist <= 0.f))
+					clipped.push_back(*prev + (v - *prev) * static_cast<float>(distPrev / (distPrev - dist)));
+				if(dist <= 0.f)
+					clipped.push_back(v);
+				prev = &v;
+				distPrev = dist;
+			}
+			inOutPolygon.swap(clipped);
+		}
+		return inOutPolygon.size() >= 3;
 	}
 
 	template<typename Iterator>
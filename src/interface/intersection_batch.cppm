@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:intersection_batch;
+
+export import :bounding_volume;
+export import :geometry;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Non-owning structure-of-arrays view of axis-aligned bounding boxes
+		struct AabbSoaView {
+			const float *minX = nullptr;
+			const float *minY = nullptr;
+			const float *minZ = nullptr;
+			const float *maxX = nullptr;
+			const float *maxY = nullptr;
+			const float *maxZ = nullptr;
+			size_t count = 0;
+		};
+
+		class DLLMUTIL AabbSoaBuffer {
+		  public:
+			AabbSoaBuffer() = default;
+			AabbSoaBuffer(const std::vector<bounding_volume::AABB> &aabbs);
+			void Reserve(size_t count);
+			void Resize(size_t count);
+			void Clear();
+			size_t Size() const { return m_minX.size(); }
+			void Add(const Vector3 &min, const Vector3 &max);
+			void Set(size_t idx, const Vector3 &min, const Vector3 &max);
+			bounding_volume::AABB Get(size_t idx) const;
+			AabbSoaView GetView() const;
+			AabbSoaView GetView(size_t offset, size_t count) const;
+		  private:
+			std::vector<float> m_minX;
+			std::vector<float> m_minY;
+			std::vector<float> m_minZ;
+			std::vector<float> m_maxX;
+			std::vector<float> m_maxY;
+			std::vector<float> m_maxZ;
+		};
+
+		// Non-owning structure-of-arrays view of bounding spheres
+		struct SphereSoaView {
+			const float *x = nullptr;
+			const float *y = nullptr;
+			const float *z = nullptr;
+			const float *radius = nullptr;
+			size_t count = 0;
+		};
+
+		class DLLMUTIL SphereSoaBuffer {
+		  public:
+			SphereSoaBuffer() = default;
+			SphereSoaBuffer(const std::vector<bounding_volume::Sphere> &spheres);
+			void Reserve(size_t count);
+			void Resize(size_t count);
+			void Clear();
+			size_t Size() const { return m_x.size(); }
+			void Add(const Vector3 &origin, float radius);
+			void Set(size_t idx, const Vector3 &origin, float radius);
+			bounding_volume::Sphere Get(size_t idx) const;
+			SphereSoaView GetView() const;
+			SphereSoaView GetView(size_t offset, size_t count) const;
+		  private:
+			std::vector<float> m_x;
+			std::vector<float> m_y;
+			std::vector<float> m_z;
+			std::vector<float> m_radius;
+		};
+
+		// Non-owning structure-of-arrays view of triangles, stored as the first vertex and the two edges starting from it
+		struct TriangleSoaView {
+			const float *v0x = nullptr;
+			const float *v0y = nullptr;
+			const float *v0z = nullptr;
+			const float *e1x = nullptr;
+			const float *e1y = nullptr;
+			const float *e1z = nullptr;
+			const float *e2x = nullptr;
+			const float *e2y = nullptr;
+			const float *e2z = nullptr;
+			size_t count = 0;
+		};
+
+		class DLLMUTIL TriangleSoaBuffer {
+		  public:
+			TriangleSoaBuffer() = default;
+			TriangleSoaBuffer(const std::vector<Vector3> &verts, const std::vector<uint16_t> &triangles);
+			TriangleSoaBuffer(const std::vector<Vector3> &verts, const std::vector<uint32_t> &triangles);
+			void Reserve(size_t count);
+			void Clear();
+			size_t Size() const { return m_v0x.size(); }
+			void Add(const Vector3 &v0, const Vector3 &v1, const Vector3 &v2);
+			void Set(size_t idx, const Vector3 &v0, const Vector3 &v1, const Vector3 &v2);
+			std::array<Vector3, 3> Get(size_t idx) const;
+			TriangleSoaView GetView() const;
+		  private:
+			template<typename TIndex>
+			void Initialize(const std::vector<Vector3> &verts, const std::vector<TIndex> &triangles);
+			std::vector<float> m_v0x;
+			std::vector<float> m_v0y;
+			std::vector<float> m_v0z;
+			std::vector<float> m_e1x;
+			std::vector<float> m_e1y;
+			std::vector<float> m_e1z;
+			std::vector<float> m_e2x;
+			std::vector<float> m_e2y;
+			std::vector<float> m_e2z;
+		};
+
+		// Non-owning structure-of-arrays view of oriented boxes (see intersection::OrientedBox), axisN is column N of the rotation matrix.
+		struct ObbSoaView {
+			const float *centerX = nullptr;
+			const float *centerY = nullptr;
+			const float *centerZ = nullptr;
+			const float *halfExtentX = nullptr;
+			const float *halfExtentY = nullptr;
+			const float *halfExtentZ = nullptr;
+			const float *axis0X = nullptr;
+			const float *axis0Y = nullptr;
+			const float *axis0Z = nullptr;
+			const float *axis1X = nullptr;
+			const float *axis1Y = nullptr;
+			const float *axis1Z = nullptr;
+			const float *axis2X = nullptr;
+			const float *axis2Y = nullptr;
+			const float *axis2Z = nullptr;
+			size_t count = 0;
+		};
+
+		class DLLMUTIL ObbSoaBuffer {
+		  public:
+			ObbSoaBuffer() = default;
+			ObbSoaBuffer(const std::vector<intersection::OrientedBox> &boxes);
+			void Reserve(size_t count);
+			void Resize(size_t count);
+			void Clear();
+			size_t Size() const { return m_centerX.size(); }
+			void Add(const intersection::OrientedBox &box);
+			void Set(size_t idx, const intersection::OrientedBox &box);
+			intersection::OrientedBox Get(size_t idx) const;
+			ObbSoaView GetView() const;
+			ObbSoaView GetView(size_t offset, size_t count) const;
+		  private:
+			std::array<std::vector<float> *, 15> GetArrays();
+			std::vector<float> m_centerX;
+			std::vector<float> m_centerY;
+			std::vector<float> m_centerZ;
+			std::vector<float> m_halfExtentX;
+			std::vector<float> m_halfExtentY;
+			std::vector<float> m_halfExtentZ;
+			std::vector<float> m_axis0X;
+			std::vector<float> m_axis0Y;
+			std::vector<float> m_axis0Z;
+			std::vector<float> m_axis1X;
+			std::vector<float> m_axis1Y;
+			std::vector<float> m_axis1Z;
+			std::vector<float> m_axis2X;
+			std::vector<float> m_axis2Y;
+			std::vector<float> m_axis2Z;
+		};
+	};
+
+	namespace pragma::math::intersection {
+		// Ray with precomputed inverse direction and slab signs, for testing one ray against many boxes
+		struct DLLMUTIL Ray {
+			Ray(const Vector3 &origin, const Vector3 &dir);
+			Vector3 origin;
+			Vector3 dir;
+			Vector3 dirInv;
+			std::array<uint8_t, 3> sign;
+		};
+
+		// Same as line_aabb(o, d, min, max, tMinRes, tMaxRes) in geometry.cppm, but with the inverse direction taken from the ray
+		DLLMUTIL Result line_aabb(const Ray &ray, const Vector3 &min, const Vector3 &max, float *tMinRes, float *tMaxRes = nullptr);
+
+		// Returns the number of uint32_t words required for a hit mask of 'count' boxes
+		constexpr size_t get_hit_mask_size(size_t count) { return (count + 31) / 32; }
+
+		// Tests the ray against all boxes of the view and returns the number of boxes that were hit.
+		// Bit i of outHitMask (which must have get_hit_mask_size(boxes.count) elements) is set if box i was hit, which matches
+		// line_aabb returning Result::Intersect. outTMin and outTMax are optional, their values are only defined for boxes that were hit.
+		DLLMUTIL size_t line_aabb(const Ray &ray, const AabbSoaView &boxes, uint32_t *outHitMask, float *outTMin = nullptr, float *outTMax = nullptr);
+
+		// Same as obb_obb(boxes[i], obb) for each box of the view, evaluated with the native SIMD width (up to rounding). outResults must have boxes.count elements.
+		// Returns the number of boxes that are not outside of obb.
+		DLLMUTIL size_t obb_obb(const ObbSoaView &boxes, const OrientedBox &obb, Intersect *outResults);
+
+		// Same as sphere_in_plane_mesh for each sphere of the view, evaluated with the native SIMD width. outResults must have spheres.count elements.
+		// Returns the number of spheres that are not outside of the plane mesh.
+		DLLMUTIL size_t sphere_in_plane_mesh(const SphereSoaView &spheres, const Plane *planes, size_t numPlanes, Intersect *outResults, bool skipInsideTest = false);
+
+		struct RayPacketHit {
+			static constexpr uint32_t INVALID_TRIANGLE = std::numeric_limits<uint32_t>::max();
+			float t = 0.f;
+			float u = 0.f;
+			float v = 0.f;
+			uint32_t triangleIndex = INVALID_TRIANGLE;
+			bool IsHit() const { return triangleIndex != INVALID_TRIANGLE; }
+		};
+		// Finds the nearest triangle hit with t in [tMin, tMax) for each ray, using the same Moeller-Trumbore test as line_triangle.
+		// Rays are traced in packets of the native SIMD width (4, 8 or 16 rays), which is most efficient if the rays of a packet are coherent.
+		// outHits must have 'numRays' elements. Returns the number of rays that hit a triangle.
+		DLLMUTIL size_t line_triangle(const Vector3 *origins, const Vector3 *dirs, size_t numRays, const TriangleSoaView &triangles, RayPacketHit *outHits, bool bCull = false, float tMin = 0.f, float tMax = std::numeric_limits<float>::max());
+	};
+#pragma warning(pop)
+}
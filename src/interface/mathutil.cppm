@@ -4,25 +4,42 @@
 module;
 
 export module pragma.math;
+export import :affine_matrix;
 export import :bitmask_ops;
 export import :bounding_volume;
+export import :bvh;
 export import :camera;
+export import :clustered_lighting;
 export import :color;
 export import :core;
+export import :dual_quaternion;
+export import :dynamic_aabb_tree;
 export import :equation_solver;
 export import :euler_angles;
 export import :float_compressor;
 export import :float16_compressor;
 export import :frustum;
+export import :frustum_culling;
 export import :geometry;
+export import :ik;
+export import :intersection_batch;
 export import :lighting;
 export import :matrix;
 export import :mesh;
+export import :occlusion;
+export import :octree;
+export import :parallel;
 export import :perlin_noise;
 export import :plane;
+export import :plane_set;
 export import :quaternion;
 export import :random;
+export import :skinning;
+export import :spatial_grid;
+export import :sweep_and_prune;
 export import :transform;
+export import :transform_buffer;
+export import :transform_hierarchy;
 export import :types;
 export import :vector;
 export import :vertex;
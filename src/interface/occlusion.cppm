@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:occlusion;
+
+export import :intersection_batch;
+export import :matrix;
+export import :parallel;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Low-resolution software depth buffer for occlusion culling without GPU queries.
+		// Occluder triangles are binned into tiles of TILE_SIZE * TILE_SIZE pixels, which are then rasterized in parallel, with one SIMD batch of pixels of a row at a time.
+		// A triangle only covers the pixels that lie entirely inside of it, and stores its farthest depth within each of them. Pixels that are only
+		// covered by several triangles together, e.g. the pixels on the shared edge of the two triangles of a quad, are not covered.
+		// Each pixel stores the nearest of these depths, the mip chain stores the farthest depth of the pixels it covers.
+		// Depths are normalized device depths in [0, 1] with 0 at the near plane, also for reverse-Z projections.
+		// Pixel (x, y) is centered at the uv coordinates ((x + 0.5) / width, (y + 0.5) / height) of umat::to_screen_uv.
+		class DLLMUTIL OcclusionBuffer {
+		  public:
+			static constexpr uint32_t TILE_SIZE = 32;
+			OcclusionBuffer(uint32_t width, uint32_t height);
+
+			uint32_t GetWidth() const { return m_width; }
+			uint32_t GetHeight() const { return m_height; }
+
+			// Removes all occluders and clears the depth buffer to the far plane.
+			// The view-projection matrix must have a depth range of [0, 1], see Frustum::Frustum(const Mat4&, bool).
+			void Begin(const Mat4 &viewProjection, bool reverseZ = false);
+			// Bins the occluder triangles for the next call to Rasterize. The vertices are transformed by 'transform' and then by the view-projection matrix.
+			// Triangles are clipped against the near plane and rasterized without back-face culling.
+			void AddOccluder(const std::vector<Vector3> &verts, const std::vector<uint16_t> &triangles, const Mat4 &transform = umat::identity());
+			void AddOccluder(const std::vector<Vector3> &verts, const std::vector<uint32_t> &triangles, const Mat4 &transform = umat::identity());
+			// Rasterizes all binned triangles and builds the mip chain. 0 uses all hardware threads.
+			void Rasterize(uint32_t threadCount = 0);
+
+			// Returns false if the box is hidden behind the occluders, or if it lies outside of the screen or beyond the far plane.
+			// The test is conservative: Boxes are only hidden if every pixel they touch is entirely covered by occluders in front of them.
+			// Boxes which intersect the near plane are always visible.
+			bool IsAabbVisible(const Vector3 &min, const Vector3 &max) const;
+			// Tests all boxes of the view and returns the number of visible ones. Bit i of outVisibleMask (which must have
+			// intersection::get_hit_mask_size(boxes.count) elements) is set if box i is visible.
+			size_t CullAabbs(const AabbSoaView &boxes, uint32_t *outVisibleMask) const;
+			// Writes the indices of all visible boxes to outVisibleIndices in ascending order, see parallel::parallel_compact.
+			size_t CullAabbs(const AabbSoaView &boxes, std::vector<uint32_t> &outVisibleIndices, uint32_t threadCount = 0) const;
+
+			// Level 0 has the resolution of the depth buffer rounded up to whole tiles, every further level half the resolution of the previous one (rounded up), down to 1x1.
+			uint32_t GetMipCount() const { return static_cast<uint32_t>(m_mips.size()); }
+			uint32_t GetMipWidth(uint32_t level) const { return m_mips[level].width; }
+			uint32_t GetMipHeight(uint32_t level) const { return m_mips[level].height; }
+			// Row-major, with GetMipWidth(level) depths per row
+			const float *GetDepths(uint32_t level) const { return m_mips[level].depths.data(); }
+		  private:
+			// Screen-space triangle with edge functions and depth plane relative to the screen origin, in double precision
+			// to avoid cancellation for vertices close to the near plane
+			struct Triangle {
+				std::array<std::array<double, 3>, 3> edges; // a * x + b * y + c >= 0 inside
+				std::array<double, 3> depthPlane;          // depth = a * x + b * y + c
+				std::array<int32_t, 2> min;
+				std::array<int32_t, 2> max;
+			};
+			struct Mip {
+				uint32_t width = 0;
+				uint32_t height = 0;
+				std::vector<float> depths;
+			};
+			template<typename TIndex>
+			void AddTriangles(const std::vector<Vector3> &verts, const std::vector<TIndex> &triangles, const Mat4 &transform);
+			void AddTriangle(const std::array<Vector4, 3> &clipVerts);
+			void AddScreenTriangle(const std::array<Vector3, 3> &verts);
+			void RasterizeTile(uint32_t tileX, uint32_t tileY);
+			void BuildTileMips(uint32_t tileX, uint32_t tileY);
+			float ToDepth(float ndcDepth) const { return m_reverseZ ? 1.f - ndcDepth : ndcDepth; }
+
+			uint32_t m_width = 0;
+			uint32_t m_height = 0;
+			uint32_t m_tilesX = 0;
+			uint32_t m_tilesY = 0;
+			Mat4 m_viewProjection {1.f};
+			bool m_reverseZ = false;
+			std::vector<Triangle> m_triangles;
+			// Indices into m_triangles per tile, row-major
+			std::vector<std::vector<uint32_t>> m_tileBins;
+			std::vector<Mip> m_mips;
+		};
+	};
+#pragma warning(pop)
+}
@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:octree;
+
+export import :bounding_volume;
+export import :geometry;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Loose octree over items with axis-aligned bounding boxes. The bounds of each node are enlarged by the looseness factor,
+		// which allows every item to be stored in exactly one node, depending on its center and size.
+		// Nodes and items are stored in pools with free lists, empty nodes are returned to the pool automatically.
+		class DLLMUTIL LooseOctree {
+		  public:
+			using ItemId = uint32_t;
+			static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+			static constexpr uint32_t MAX_DEPTH = 16;
+			struct Node {
+				Vector3 center {};
+				// Half size of the (non-loose) cell
+				float halfSize = 0.f;
+				// Parent node, or the next free node if this node is in the free list
+				uint32_t parent = INVALID_INDEX;
+				std::array<uint32_t, 8> children {INVALID_INDEX, INVALID_INDEX, INVALID_INDEX, INVALID_INDEX, INVALID_INDEX, INVALID_INDEX, INVALID_INDEX, INVALID_INDEX};
+				uint32_t firstItem = INVALID_INDEX;
+				uint32_t itemCount = 0;
+				// Number of items in this node and all of its descendants
+				uint32_t subtreeItemCount = 0;
+				uint32_t depth = 0;
+			};
+			struct Item {
+				bounding_volume::AABB aabb {};
+				uint64_t userData = 0;
+				// INVALID_INDEX if the item lies outside of the octree bounds
+				uint32_t node = INVALID_INDEX;
+				uint32_t prev = INVALID_INDEX;
+				// Next item in the same node, or the next free item if this item is in the free list
+				uint32_t next = INVALID_INDEX;
+				bool valid = false;
+			};
+
+			// The octree covers the cube center +-halfSize. Items which don't fit into the root node are kept in a separate list and tested individually.
+			LooseOctree(const Vector3 &center, float halfSize, uint32_t maxDepth = 8, float looseness = 2.f);
+			void Reserve(uint32_t itemCount, uint32_t nodeCount);
+			void Clear();
+
+			ItemId Insert(const bounding_volume::AABB &aabb, uint64_t userData = 0);
+			void Remove(ItemId itemId);
+			// Items are only moved to a different node if their center or size changed enough to require it
+			void Update(ItemId itemId, const bounding_volume::AABB &aabb);
+
+			const bounding_volume::AABB &GetAabb(ItemId itemId) const { return m_items[itemId].aabb; }
+			uint64_t GetUserData(ItemId itemId) const { return m_items[itemId].userData; }
+			uint32_t GetItemCount() const { return m_itemCount; }
+			uint32_t GetNodeCount() const { return m_nodeCount; }
+			const std::vector<Node> &GetNodes() const { return m_nodes; }
+			const std::vector<Item> &GetItems() const { return m_items; }
+			std::pair<Vector3, Vector3> GetLooseBounds(const Node &node) const;
+
+			// Calls callback(ItemId) for all items which are not outside of the plane mesh (see aabb_in_plane_mesh).
+			// If a node is entirely inside the plane mesh, all items in its subtree are accepted without further tests.
+			template<typename Iterator, typename TCallback>
+			void QueryPlaneMesh(Iterator beginPlanes, Iterator endPlanes, TCallback &&callback) const;
+			// Calls callback(ItemId) for all items overlapping the box
+			template<typename TCallback>
+			void QueryAabb(const Vector3 &min, const Vector3 &max, TCallback &&callback) const;
+		  private:
+			template<typename TCallback>
+			void ForEachItemInSubtree(uint32_t nodeIndex, TCallback &callback) const;
+			uint32_t AllocateNode(uint32_t parent, const Vector3 &center, float halfSize, uint32_t depth);
+			void FreeNode(uint32_t nodeIndex);
+			bool ContainsCenter(const Node &node, const Vector3 &p) const;
+			bool FitsNode(const Node &node, float maxExtent) const { return maxExtent <= (m_looseness - 1.f) * node.halfSize; }
+			uint32_t GetChildIndex(const Node &node, const Vector3 &p) const;
+			void LinkItem(uint32_t nodeIndex, ItemId itemId);
+			void UnlinkItem(ItemId itemId);
+
+			std::vector<Node> m_nodes;
+			std::vector<Item> m_items;
+			uint32_t m_freeNodes = INVALID_INDEX;
+			uint32_t m_freeItems = INVALID_INDEX;
+			uint32_t m_outsideItems = INVALID_INDEX;
+			uint32_t m_itemCount = 0;
+			uint32_t m_nodeCount = 0;
+			Vector3 m_center {};
+			float m_halfSize = 1.f;
+			uint32_t m_maxDepth = 8;
+			float m_looseness = 2.f;
+		};
+	};
+
+	template<typename TCallback>
+	void pragma::math::LooseOctree::ForEachItemInSubtree(uint32_t nodeIndex, TCallback &callback) const
+	{
+		std::array<uint32_t, MAX_DEPTH * 7 + 1> stack;
+		uint32_t stackSize = 0;
+		stack[stackSize++] = nodeIndex;
+		while(stackSize > 0) {
+			auto &node = m_nodes[stack[--stackSize]];
+			for(auto itemId = node.firstItem; itemId != INVALID_INDEX; itemId = m_items[itemId].next)
+				callback(static_cast<ItemId>(itemId));
+			for(auto child : node.children) {
+				if(child != INVALID_INDEX)
+					stack[stackSize++] = child;
+			}
+		}
+	}
+
+	template<typename Iterator, typename TCallback>
+	void pragma::math::LooseOctree::QueryPlaneMesh(Iterator beginPlanes, Iterator endPlanes, TCallback &&callback) const
+	{
+		auto testItems = [this, &beginPlanes, &endPlanes, &callback](uint32_t firstItem) {
+			for(auto itemId = firstItem; itemId != INVALID_INDEX; itemId = m_items[itemId].next) {
+				auto &item = m_items[itemId];
+				if(intersection::aabb_in_plane_mesh(item.aabb.min, item.aabb.max, beginPlanes, endPlanes) != intersection::Intersect::Outside)
+					callback(static_cast<ItemId>(itemId));
+			}
+		};
+		testItems(m_outsideItems);
+		if(m_nodes.empty() || m_nodes.front().subtreeItemCount == 0)
+			return;
+		std::array<uint32_t, MAX_DEPTH * 7 + 1> stack;
+		uint32_t stackSize = 0;
+		stack[stackSize++] = 0;
+		while(stackSize > 0) {
+			auto nodeIndex = stack[--stackSize];
+			auto &node = m_nodes[nodeIndex];
+			auto [looseMin, looseMax] = GetLooseBounds(node);
+			auto result = intersection::aabb_in_plane_mesh(looseMin, looseMax, beginPlanes, endPlanes);
+			if(result == intersection::Intersect::Outside)
+				continue;
+			if(result == intersection::Intersect::Inside) {
+				ForEachItemInSubtree(nodeIndex, callback);
+				continue;
+			}
+			testItems(node.firstItem);
+			for(auto child : node.children) {
+				if(child != INVALID_INDEX)
+					stack[stackSize++] = child;
+			}
+		}
+	}
+
+	template<typename TCallback>
+	void pragma::math::LooseOctree::QueryAabb(const Vector3 &min, const Vector3 &max, TCallback &&callback) const
+	{
+		auto overlaps = [&min, &max](const Vector3 &otherMin, const Vector3 &otherMax) {
+			return otherMin.x <= max.x && otherMin.y <= max.y && otherMin.z <= max.z && min.x <= otherMax.x && min.y <= otherMax.y && min.z <= otherMax.z;
+		};
+		auto testItems = [this, &overlaps, &callback](uint32_t firstItem) {
+			for(auto itemId = firstItem; itemId != INVALID_INDEX; itemId = m_items[itemId].next) {
+				auto &item = m_items[itemId];
+				if(overlaps(item.aabb.min, item.aabb.max))
+					callback(static_cast<ItemId>(itemId));
+			}
+		};
+		testItems(m_outsideItems);
+		if(m_nodes.empty() || m_nodes.front().subtreeItemCount == 0)
+			return;
+		std::array<uint32_t, MAX_DEPTH * 7 + 1> stack;
+		uint32_t stackSize = 0;
+		stack[stackSize++] = 0;
+		while(stackSize > 0) {
+			auto &node = m_nodes[stack[--stackSize]];
+			auto [looseMin, looseMax] = GetLooseBounds(node);
+			if(!overlaps(looseMin, looseMax))
+				continue;
+			testItems(node.firstItem);
+			for(auto child : node.children) {
+				if(child != INVALID_INDEX)
+					stack[stackSize++] = child;
+			}
+		}
+	}
+#pragma warning(pop)
+}
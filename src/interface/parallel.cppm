@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:parallel;
+
+export import std.compat;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math::parallel {
+		// Returns the number of threads that will be used for the requested thread count, where 0 means one thread per hardware thread
+		DLLMUTIL uint32_t get_thread_count(uint32_t threadCount);
+
+		// Has to call task(i) for every i in [0, count) and return once all calls have completed. threadCount is the value passed to parallel_for.
+		using Executor = std::function<void(size_t count, const std::function<void(size_t)> &task, uint32_t threadCount)>;
+		// Replaces the built-in thread pool for all parallel algorithms of this library, e.g. to run them on the job system of an engine.
+		// An empty executor restores the default. Must not be called while parallel algorithms are running.
+		DLLMUTIL void set_executor(const Executor &executor);
+
+		// Thread pool where each participating thread processes its own index range of a job. Threads that run out of work
+		// steal half of the largest remaining range of another thread, so tasks of varying cost are balanced without a shared counter.
+		// The calling thread participates in its own jobs, so jobs may be nested.
+		class DLLMUTIL ThreadPool {
+		  public:
+			// Number of threads in addition to the calling thread, 0 means one per hardware thread minus one
+			ThreadPool(uint32_t workerCount = 0);
+			~ThreadPool();
+			ThreadPool(const ThreadPool &) = delete;
+			ThreadPool &operator=(const ThreadPool &) = delete;
+			uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+			// Same as parallel_for, but the number of threads is limited to GetWorkerCount() +1
+			void Run(size_t count, const std::function<void(size_t)> &task, uint32_t threadCount = 0);
+		  private:
+			struct Job;
+			void RunWorker();
+			std::vector<std::thread> m_workers;
+			std::mutex m_mutex;
+			std::condition_variable m_condition;
+			std::vector<std::shared_ptr<Job>> m_jobs;
+			bool m_stop = false;
+		};
+		// Pool used by parallel_for if no executor has been set, it is created on first use
+		DLLMUTIL ThreadPool &get_thread_pool();
+
+		// Calls f(i) for every i in [0, count), distributed across up to 'threadCount' threads, including the calling thread.
+		// Returns once all calls have completed. The order in which indices are processed is unspecified.
+		DLLMUTIL void parallel_for(size_t count, const std::function<void(size_t)> &f, uint32_t threadCount = 0);
+
+		// Splits [0, count) into chunks of chunkSize elements, which are processed with parallel_for. f(begin, end, outIndices) has to append the indices
+		// of the selected elements of its chunk to outIndices. The lists of all chunks are then concatenated into outIndices (which is overwritten)
+		// at offsets determined by a prefix sum over the list sizes, so no locks are required and the order does not depend on the thread count.
+		DLLMUTIL void parallel_compact(size_t count, size_t chunkSize, const std::function<void(size_t, size_t, std::vector<uint32_t> &)> &f, std::vector<uint32_t> &outIndices, uint32_t threadCount = 0);
+	};
+#pragma warning(pop)
+}
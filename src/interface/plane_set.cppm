@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:plane_set;
+
+export import :geometry;
+export import :plane;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Plane packed into 16 bytes. GetDistance(p) = dot(n, p) - d, positive distances are in front of the plane.
+		// Can be used with the plane-mesh templates in the intersection namespace in place of Plane. Normals must have unit length:
+		// Plane(n, d) measures distances from the point n * d, i.e. its GetDistance(p) is dot(n, p) - d * |n|^2, so the conversions
+		// between the two are only lossless for unit-length normals (and the sphere and box tests require them anyway).
+		struct alignas(16) PackedPlane {
+			PackedPlane() = default;
+			PackedPlane(const Vector3 &n, float d) : normal {n}, distance {d} {}
+			// Keeps the result of Plane::GetDistance(p), also for normals that don't have unit length
+			PackedPlane(const Plane &plane);
+			// xyz is the normal, w the distance (see Plane::ToVector4)
+			PackedPlane(const Vector4 &plane) : normal {plane.x, plane.y, plane.z}, distance {plane.w} {}
+			const Vector3 &GetNormal() const { return normal; }
+			float GetDistance() const { return distance; }
+			float GetDistance(const Vector3 &p) const { return uvec::dot(normal, p) - distance; }
+			Vector4 ToVector4() const { return {normal, distance}; }
+			// Only the inverse of PackedPlane(const Plane &) if the normal has unit length, see above
+			Plane ToPlane() const;
+
+			Vector3 normal {};
+			float distance = 0.f;
+		};
+
+		// Up to MAX_PLANES planes in structure-of-arrays form, for testing a volume against all planes at once.
+		// Unused slots contain planes which never reject anything, so the tests can always process full SIMD batches.
+		class DLLMUTIL PlaneSet {
+		  public:
+			static constexpr uint32_t MAX_PLANES = 32;
+			PlaneSet();
+			// Planes beyond MAX_PLANES are ignored
+			template<typename Iterator>
+			PlaneSet(Iterator beginPlanes, Iterator endPlanes);
+			// Returns false if the set is full
+			bool Add(const PackedPlane &plane);
+			void Clear();
+			uint32_t GetCount() const { return m_count; }
+			bool IsEmpty() const { return m_count == 0; }
+			PackedPlane Get(uint32_t idx) const;
+
+			// The arrays always have MAX_PLANES elements
+			const float *GetNormalsX() const { return m_normalX.data(); }
+			const float *GetNormalsY() const { return m_normalY.data(); }
+			const float *GetNormalsZ() const { return m_normalZ.data(); }
+			const float *GetDistances() const { return m_distance.data(); }
+		  private:
+			alignas(64) std::array<float, MAX_PLANES> m_normalX;
+			alignas(64) std::array<float, MAX_PLANES> m_normalY;
+			alignas(64) std::array<float, MAX_PLANES> m_normalZ;
+			alignas(64) std::array<float, MAX_PLANES> m_distance;
+			uint32_t m_count = 0;
+		};
+	};
+
+	namespace pragma::math::intersection {
+		// Same as the iterator overloads for a range of PackedPlane (up to rounding), with all planes of a SIMD batch tested at once
+		DLLMUTIL bool point_in_plane_mesh(const Vector3 &vec, const PlaneSet &planes);
+		DLLMUTIL Intersect sphere_in_plane_mesh(const Vector3 &vec, float radius, const PlaneSet &planes, bool skipInsideTest = false);
+		DLLMUTIL Intersect aabb_in_plane_mesh(const Vector3 &min, const Vector3 &max, const PlaneSet &planes);
+
+		// Parts of triangles which lie inside of a plane set. Triangle i consists of the vertices indices[i * 3] to indices[i * 3 + 2]
+		// and was cut from the source triangle sourceTriangles[i]. Clipped triangles are triangulated as a fan.
+		struct DLLMUTIL ClippedTriangleMesh {
+			void Clear();
+			std::vector<Vector3> vertices;
+			std::vector<uint32_t> indices;
+			std::vector<uint32_t> sourceTriangles;
+		};
+		// Same as triangle_in_plane_mesh for each triangle of the index buffer, with a SIMD batch of triangles tested against one plane at a time.
+		// outResults must have triangles.size() / 3 elements. If outClipped is specified, it is cleared and receives all inside triangles,
+		// as well as the clipped parts of all overlapping triangles.
+		// Returns the number of triangles that are not outside of the plane set.
+		DLLMUTIL size_t triangle_in_plane_mesh(const std::vector<Vector3> &verts, const std::vector<uint16_t> &triangles, const PlaneSet &planes, Intersect *outResults, ClippedTriangleMesh *outClipped = nullptr);
+		DLLMUTIL size_t triangle_in_plane_mesh(const std::vector<Vector3> &verts, const std::vector<uint32_t> &triangles, const PlaneSet &planes, Intersect *outResults, ClippedTriangleMesh *outClipped = nullptr);
+	};
+
+	template<typename Iterator>
+	pragma::math::PlaneSet::PlaneSet(Iterator beginPlanes, Iterator endPlanes) : PlaneSet {}
+	{
+		for(auto it = beginPlanes; it != endPlanes; ++it) {
+			if(!Add(*it))
+				break;
+		}
+	}
+#pragma warning(pop)
+}
@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:skinning;
+
+export import :affine_matrix;
+export import :dual_quaternion;
+export import :vertex;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math::skinning {
+		// Deforms the vertices with the blended bone transforms of up to four influences per vertex (VertexWeight::boneIds / VertexWeight::weights).
+		// Influences with a negative or out-of-range bone id, or a weight of 0, are ignored, vertices without any influence are left untransformed.
+		// The weights are expected to be non-negative, but do not have to be normalized.
+		// bones are the skinning transforms (bone world transform * inverse bind pose). outNormals and outTangents may be nullptr,
+		// the handedness of the tangents (w component) is copied from the source vertices.
+		// Vertex ranges are processed in parallel on up to threadCount threads, 0 uses all hardware threads.
+
+		// Dual quaternion linear blending, same result as DualQuat::Blend
+		DLLMUTIL void dual_quaternion(const DualQuat *bones, uint32_t numBones, const Vertex *verts, const VertexWeight *weights, size_t numVerts, Vector3 *outPositions, Vector3 *outNormals = nullptr, Vector4 *outTangents = nullptr,
+		  uint32_t threadCount = 1);
+
+		// Linear blend skinning with affine bone matrices. Normals and tangents are transformed by the blended 3x3 part and renormalized,
+		// which is exact for rotations and uniform scales.
+		DLLMUTIL void linear_blend(const Mat4 *bones, uint32_t numBones, const Vertex *verts, const VertexWeight *weights, size_t numVerts, Vector3 *outPositions, Vector3 *outNormals = nullptr, Vector4 *outTangents = nullptr,
+		  uint32_t threadCount = 1);
+		// Each matrix holds the three rows of the affine transform, with the translation in the last column (m[row][3]),
+		// i.e. the layout of a transposed 4x3 matrix commonly used for bone palettes on the GPU
+		DLLMUTIL void linear_blend(const Mat3x4 *bones, uint32_t numBones, const Vertex *verts, const VertexWeight *weights, size_t numVerts, Vector3 *outPositions, Vector3 *outNormals = nullptr, Vector4 *outTangents = nullptr,
+		  uint32_t threadCount = 1);
+		DLLMUTIL void linear_blend(const AffineMatrix *bones, uint32_t numBones, const Vertex *verts, const VertexWeight *weights, size_t numVerts, Vector3 *outPositions, Vector3 *outNormals = nullptr, Vector4 *outTangents = nullptr,
+		  uint32_t threadCount = 1);
+	};
+#pragma warning(pop)
+}
@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:spatial_grid;
+
+export import :bounding_volume;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Spatial hash grid over a point set, for radius, box and nearest-neighbor queries.
+		// The grid is rebuilt in bulk with a two-pass radix sort, which only allocates memory if the number of points grows.
+		// Points of the same cell are stored contiguously, in the order of their original indices.
+		class DLLMUTIL SpatialHashGrid {
+		  public:
+			// If tableSize is 0, the hash table size is chosen automatically on each build (the next power of two larger than the point count)
+			SpatialHashGrid(float cellSize = 1.f, uint32_t tableSize = 0);
+			// Takes effect on the next build
+			void SetCellSize(float cellSize);
+			float GetCellSize() const { return m_cellSize; }
+
+			// Rebuilds the grid from the points. The result is identical for all thread counts, 0 uses all hardware threads.
+			void Build(const std::vector<Vector3> &points, uint32_t threadCount = 1);
+			void Clear();
+			size_t GetPointCount() const { return m_points.size(); }
+			bool IsEmpty() const { return m_points.empty(); }
+
+			// Results are indices into the point list the grid was built from. They are appended to the output vector in no particular order.
+			void FindPointsInRadius(const Vector3 &origin, float radius, std::vector<uint32_t> &outIndices) const;
+			void FindPointsInAabb(const Vector3 &min, const Vector3 &max, std::vector<uint32_t> &outIndices) const;
+			// Finds up to k points closest to the origin within maxDistance. outIndices is cleared first and sorted by distance afterwards,
+			// with ties broken by the point index.
+			void FindKNearest(const Vector3 &origin, uint32_t k, std::vector<uint32_t> &outIndices, float maxDistance = std::numeric_limits<float>::max()) const;
+
+			Vector3i GetCell(const Vector3 &p) const;
+			uint32_t GetBucket(const Vector3i &cell) const;
+		  private:
+			// Calls f(pointIndex, point) for all points in the cell. Returns false if f returned false.
+			template<typename TFunc>
+			bool ForEachPointInCell(const Vector3i &cell, const TFunc &f) const;
+
+			float m_cellSize = 1.f;
+			float m_invCellSize = 1.f;
+			float m_buildCellSize = 1.f;
+			uint32_t m_requestedTableSize = 0;
+			uint32_t m_tableMask = 0;
+			// Points, sorted by bucket
+			std::vector<Vector3> m_points;
+			std::vector<uint32_t> m_pointIndices;
+			// Bucket i contains the sorted points [m_bucketStart[i], m_bucketStart[i +1])
+			std::vector<uint32_t> m_bucketStart;
+			std::vector<uint32_t> m_pointBuckets;
+			// (bucket, point index) pairs, grouped by the upper bits of the bucket
+			std::vector<std::pair<uint32_t, uint32_t>> m_partitionedPoints;
+			std::vector<uint32_t> m_partitionStart;
+			std::vector<uint32_t> m_chunkCounts;
+			std::vector<std::pair<Vector3i, Vector3i>> m_chunkCellBounds;
+			Vector3i m_minCell {};
+			Vector3i m_maxCell {};
+		};
+	};
+#pragma warning(pop)
+}
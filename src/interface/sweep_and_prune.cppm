@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:sweep_and_prune;
+
+export import :bounding_volume;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Sweep-and-prune broadphase, which keeps the box endpoints sorted along each axis and re-sorts them with an insertion sort on every update.
+		// With frame-to-frame coherence only few endpoints change their order, so an update is close to O(n).
+		// Proxies that have been added since the last update are sorted separately and merged into the endpoint arrays, and their pairs
+		// are found with a single sweep, so that inserting many proxies at once is O(n log n) instead of O(n^2).
+		// Overlapping pairs are tracked incrementally and changes are reported as pair events.
+		class DLLMUTIL SweepAndPrune {
+		  public:
+			using ProxyId = uint32_t;
+			static constexpr ProxyId INVALID_PROXY = std::numeric_limits<uint32_t>::max();
+			enum class PairEventType : uint8_t { Added = 0, Removed };
+			struct PairEvent {
+				PairEventType type = PairEventType::Added;
+				// a is always the lower proxy id
+				ProxyId a = INVALID_PROXY;
+				ProxyId b = INVALID_PROXY;
+			};
+			struct FrameStats {
+				// Number of endpoint swaps per axis during the last update, which is a measure of how coherent the motion is
+				std::array<uint64_t, 3> swapCount {};
+				uint32_t pairsAdded = 0;
+				uint32_t pairsRemoved = 0;
+			};
+
+			SweepAndPrune() = default;
+			void Reserve(uint32_t proxyCount);
+			void Clear();
+
+			// Changes to proxies only take effect on the next call to Update. Ids of removed proxies are re-used after the next update.
+			ProxyId Add(const bounding_volume::AABB &aabb, uint64_t userData = 0);
+			void Remove(ProxyId proxyId);
+			void SetAabb(ProxyId proxyId, const bounding_volume::AABB &aabb) { m_boxes[proxyId] = aabb; }
+			const bounding_volume::AABB &GetAabb(ProxyId proxyId) const { return m_boxes[proxyId]; }
+			uint64_t GetUserData(ProxyId proxyId) const { return m_userData[proxyId]; }
+			uint32_t GetProxyCount() const { return m_proxyCount; }
+
+			// Re-sorts the endpoints and updates the overlapping pairs. Pair events are sorted by proxy ids.
+			void Update();
+			const std::vector<PairEvent> &GetPairEvents() const { return m_pairEvents; }
+			const FrameStats &GetFrameStats() const { return m_frameStats; }
+			size_t GetPairCount() const { return m_pairs.size(); }
+			bool HasPair(ProxyId a, ProxyId b) const { return m_pairs.contains(GetPairKey(a, b)); }
+			// Returns all overlapping pairs, sorted by proxy ids
+			void GetPairs(std::vector<std::pair<ProxyId, ProxyId>> &outPairs) const;
+
+			static uint64_t GetPairKey(ProxyId a, ProxyId b)
+			{
+				if(a > b)
+					std::swap(a, b);
+				return (static_cast<uint64_t>(a) << 32) | b;
+			}
+		  private:
+			struct Endpoint {
+				float value = 0.f;
+				// Proxy id in the upper 31 bits, lowest bit is set for max endpoints
+				uint32_t data = 0;
+				ProxyId GetProxyId() const { return data >> 1; }
+				bool IsMax() const { return (data & 1) != 0; }
+				// Endpoints with the same value are ordered min before max, so that touching boxes are considered overlapping
+				bool operator<(const Endpoint &other) const { return value < other.value || (value == other.value && !IsMax() && other.IsMax()); }
+			};
+			// Added proxies become active once their endpoints have been inserted by the next update
+			enum class ProxyState : uint8_t { Free = 0, Added, Active, Removed };
+			void SortAxis(uint32_t axis);
+			void InsertAddedProxies();
+			void AddPair(ProxyId a, ProxyId b);
+			void RemovePair(ProxyId a, ProxyId b);
+
+			std::array<std::vector<Endpoint>, 3> m_endpoints;
+			std::vector<bounding_volume::AABB> m_boxes;
+			std::vector<uint64_t> m_userData;
+			std::vector<ProxyState> m_proxyStates;
+			std::vector<ProxyId> m_freeIds;
+			std::vector<ProxyId> m_removedIds;
+			std::vector<ProxyId> m_addedIds;
+			// Scratch buffers for InsertAddedProxies
+			std::vector<Endpoint> m_addedEndpoints;
+			// Proxies whose interval on the sweep axis contains the current sweep position, split into active [0] and added [1] proxies.
+			// The boxes are copied, so that the overlap tests access them sequentially.
+			struct OpenProxy {
+				bounding_volume::AABB aabb;
+				ProxyId proxyId;
+			};
+			std::array<std::vector<OpenProxy>, 2> m_openProxies;
+			std::vector<uint32_t> m_openIndices;
+			uint32_t m_proxyCount = 0;
+
+			std::unordered_set<uint64_t> m_pairs;
+			// Pairs that have been added or removed during the current update, with their state before the update
+			std::unordered_map<uint64_t, bool> m_changedPairs;
+			std::vector<PairEvent> m_pairEvents;
+			FrameStats m_frameStats {};
+		};
+	};
+#pragma warning(pop)
+}
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:transform_buffer;
+
+export import :affine_matrix;
+export import :transform;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Allocator for containers whose data is loaded with aligned SIMD loads
+		template<typename T, size_t ALIGNMENT>
+		struct AlignedAllocator {
+			using value_type = T;
+			template<typename U>
+			struct rebind {
+				using other = AlignedAllocator<U, ALIGNMENT>;
+			};
+			AlignedAllocator() noexcept = default;
+			template<typename U>
+			AlignedAllocator(const AlignedAllocator<U, ALIGNMENT> &) noexcept
+			{
+			}
+			T *allocate(size_t n) { return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t {ALIGNMENT})); }
+			void deallocate(T *p, size_t n) noexcept { ::operator delete(p, n * sizeof(T), std::align_val_t {ALIGNMENT}); }
+			template<typename U>
+			bool operator==(const AlignedAllocator<U, ALIGNMENT> &) const noexcept
+			{
+				return true;
+			}
+		};
+		// Arrays of the transform buffers start at a cache line, which covers the alignment of all SIMD instruction sets
+		using AlignedFloatVector = std::vector<float, AlignedAllocator<float, 64>>;
+
+		// Transforms in structure-of-arrays form, with one array per translation and rotation component.
+		// The batched operations are equivalent to the corresponding operations of Transform (up to rounding), evaluated with the native SIMD width.
+		class DLLMUTIL TransformBuffer {
+		  public:
+			TransformBuffer() = default;
+			TransformBuffer(const std::vector<Transform> &transforms);
+			void Reserve(size_t count);
+			// New elements are identity transforms
+			void Resize(size_t count);
+			void Clear();
+			size_t Size() const { return m_translation[0].size(); }
+			void Add(const Transform &t);
+			void Set(size_t idx, const Transform &t);
+			Transform Get(size_t idx) const;
+			std::vector<Transform> ToVector() const;
+
+			// axis 0-2 is x, y, z
+			const float *GetTranslation(uint8_t axis) const { return m_translation[axis].data(); }
+			float *GetTranslation(uint8_t axis) { return m_translation[axis].data(); }
+			// component 0-3 is x, y, z, w
+			const float *GetRotation(uint8_t component) const { return m_rotation[component].data(); }
+			float *GetRotation(uint8_t component) { return m_rotation[component].data(); }
+
+			// out[i] = a[i] * b[i]. a and b must have the same size, out is resized to it and may be the same buffer as a or b.
+			static void Multiply(const TransformBuffer &a, const TransformBuffer &b, TransformBuffer &out);
+			// out[i] = parent * b[i]
+			static void Multiply(const Transform &parent, const TransformBuffer &b, TransformBuffer &out);
+			// out[i] = src[i].GetInverse(), out may be the same buffer as src
+			static void Invert(const TransformBuffer &src, TransformBuffer &out);
+			// outPoints[i] = (*this)[i] * points[i], both arrays must have Size() elements and may be the same
+			void TransformPoints(const Vector3 *points, Vector3 *outPoints) const;
+			// outMatrices[i] = (*this)[i].ToMatrix(), outMatrices must have Size() elements
+			void ToMatrices(Mat4 *outMatrices) const;
+			// outMatrices[i] = AffineMatrix {(*this)[i]}, outMatrices must have Size() elements
+			void ToAffineMatrices(AffineMatrix *outMatrices) const;
+		  private:
+			std::array<AlignedFloatVector, 3> m_translation;
+			std::array<AlignedFloatVector, 4> m_rotation;
+		};
+
+		// Same as TransformBuffer for ScaledTransform, with an additional array per scale component
+		class DLLMUTIL ScaledTransformBuffer {
+		  public:
+			ScaledTransformBuffer() = default;
+			ScaledTransformBuffer(const std::vector<ScaledTransform> &transforms);
+			void Reserve(size_t count);
+			void Resize(size_t count);
+			void Clear();
+			size_t Size() const { return m_translation[0].size(); }
+			void Add(const ScaledTransform &t);
+			void Set(size_t idx, const ScaledTransform &t);
+			ScaledTransform Get(size_t idx) const;
+			std::vector<ScaledTransform> ToVector() const;
+
+			const float *GetTranslation(uint8_t axis) const { return m_translation[axis].data(); }
+			float *GetTranslation(uint8_t axis) { return m_translation[axis].data(); }
+			const float *GetRotation(uint8_t component) const { return m_rotation[component].data(); }
+			float *GetRotation(uint8_t component) { return m_rotation[component].data(); }
+			const float *GetScale(uint8_t axis) const { return m_scale[axis].data(); }
+			float *GetScale(uint8_t axis) { return m_scale[axis].data(); }
+
+			static void Multiply(const ScaledTransformBuffer &a, const ScaledTransformBuffer &b, ScaledTransformBuffer &out);
+			static void Multiply(const ScaledTransform &parent, const ScaledTransformBuffer &b, ScaledTransformBuffer &out);
+			static void Invert(const ScaledTransformBuffer &src, ScaledTransformBuffer &out);
+			void TransformPoints(const Vector3 *points, Vector3 *outPoints) const;
+			void ToMatrices(Mat4 *outMatrices) const;
+			void ToAffineMatrices(AffineMatrix *outMatrices) const;
+		  private:
+			std::array<AlignedFloatVector, 3> m_translation;
+			std::array<AlignedFloatVector, 4> m_rotation;
+			std::array<AlignedFloatVector, 3> m_scale;
+		};
+	};
+#pragma warning(pop)
+}
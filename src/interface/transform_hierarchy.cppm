@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+export module pragma.math:transform_hierarchy;
+
+export import :parallel;
+export import :transform;
+
+export {
+#pragma warning(push)
+#pragma warning(disable : 4251)
+	namespace pragma::math {
+		// Flat transform hierarchy, e.g. for skeletons or scene graphs. Nodes are sorted parents-first (the parent of node i has an index smaller than i),
+		// so the world transforms can be computed in a single linear pass: world[i] = world[parent[i]] * local[i], or local[i] for root nodes.
+		// Only nodes whose local transform has changed since the last update, and their descendants, are recomputed.
+		class DLLMUTIL TransformHierarchy {
+		  public:
+			static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+			TransformHierarchy() = default;
+			// Replaces all nodes, with identity local transforms. Root nodes have the parent INVALID_INDEX.
+			// Returns false (and leaves the hierarchy empty) if a parent index is not smaller than the index of its child.
+			bool SetParents(const std::vector<uint32_t> &parents);
+			// Appends a node and returns its index. Returns INVALID_INDEX if the parent does not exist.
+			uint32_t AddNode(uint32_t parent, const ScaledTransform &localTransform = {});
+			void Clear();
+
+			uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_parents.size()); }
+			uint32_t GetParent(uint32_t node) const { return m_parents[node]; }
+			const std::vector<uint32_t> &GetParents() const { return m_parents; }
+
+			const ScaledTransform &GetLocalTransform(uint32_t node) const { return m_localTransforms[node]; }
+			void SetLocalTransform(uint32_t node, const ScaledTransform &t);
+			// Must have GetNodeCount() elements, marks all nodes as changed
+			void SetLocalTransforms(const std::vector<ScaledTransform> &transforms);
+			const std::vector<ScaledTransform> &GetLocalTransforms() const { return m_localTransforms; }
+			bool IsDirty() const { return m_dirty; }
+
+			// Only valid after Update
+			const ScaledTransform &GetWorldTransform(uint32_t node) const { return m_worldTransforms[node]; }
+			const std::vector<ScaledTransform> &GetWorldTransforms() const { return m_worldTransforms; }
+
+			// Recomputes the world transforms of all changed nodes and returns the number of recomputed nodes
+			size_t Update();
+			// Same as Update, but the subtrees of different root nodes are processed in parallel. A hierarchy with a single root is processed by one thread.
+			// 0 uses all hardware threads.
+			size_t UpdateParallel(uint32_t threadCount = 0);
+		  private:
+			size_t UpdateSubtree(const std::vector<uint32_t> &nodes);
+
+			std::vector<uint32_t> m_parents;
+			std::vector<ScaledTransform> m_localTransforms;
+			std::vector<ScaledTransform> m_worldTransforms;
+			// Set if the local transform of the node has changed, or, during an update, that of one of its ancestors
+			std::vector<uint8_t> m_nodeDirty;
+			// Nodes of the subtree of each root node, in ascending order
+			std::vector<std::vector<uint32_t>> m_rootSubtrees;
+			// Index into m_rootSubtrees per node
+			std::vector<uint32_t> m_subtreeIndices;
+			std::vector<uint8_t> m_subtreeDirty;
+			bool m_dirty = false;
+		};
+	};
+#pragma warning(pop)
+}
@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	struct Mesh {
+		std::vector<Vector3> verts;
+		std::vector<uint32_t> indices;
+		uint32_t GetTriangleCount() const { return static_cast<uint32_t>(indices.size() / 3); }
+		const Vector3 &GetVertex(uint32_t tri, uint32_t i) const { return verts[indices[tri * 3 + i]]; }
+	};
+
+	// Small random triangles scattered in a cube, plus a few large ones spanning it
+	Mesh generate_mesh(uint32_t numTriangles)
+	{
+		test::reset_random_generator();
+		Mesh mesh;
+		for(uint32_t i = 0; i < numTriangles; ++i) {
+			auto center = test::random_vector(-50.f, 50.f);
+			auto size = (i % 97 == 0) ? 40.f : 2.f;
+			for(uint32_t j = 0; j < 3; ++j) {
+				mesh.indices.push_back(static_cast<uint32_t>(mesh.verts.size()));
+				mesh.verts.push_back(center + test::random_vector(-size, size));
+			}
+		}
+		return mesh;
+	}
+
+	std::optional<std::pair<uint32_t, double>> raycast_linear(const Mesh &mesh, const Vector3 &origin, const Vector3 &dir, float tMin, float tMax)
+	{
+		std::optional<std::pair<uint32_t, double>> result {};
+		for(uint32_t i = 0; i < mesh.GetTriangleCount(); ++i) {
+			double t, u, v;
+			if(!pragma::math::intersection::line_triangle(origin, dir, mesh.GetVertex(i, 0), mesh.GetVertex(i, 1), mesh.GetVertex(i, 2), t, u, v) || t < tMin || t > tMax)
+				continue;
+			if(!result || t < result->second)
+				result = std::pair<uint32_t, double> {i, t};
+		}
+		return result;
+	}
+
+	// Every triangle must be referenced by exactly one leaf, and the bounds of every node must contain its children or triangles
+	void validate_bvh(const pragma::math::Bvh &bvh, const Mesh &mesh)
+	{
+		auto &nodes = bvh.GetNodes();
+		auto &prims = bvh.GetPrimitives();
+		ASSERT_FALSE(nodes.empty());
+		ASSERT_EQ(prims.size(), mesh.GetTriangleCount());
+		std::vector<uint32_t> refCount(mesh.GetTriangleCount(), 0);
+		auto contains = [](const pragma::math::BvhNode &node, const Vector3 &p) { return p.x >= node.min.x && p.y >= node.min.y && p.z >= node.min.z && p.x <= node.max.x && p.y <= node.max.y && p.z <= node.max.z; };
+		std::vector<uint32_t> stack {0};
+		size_t numVisited = 0;
+		while(!stack.empty()) {
+			auto idx = stack.back();
+			stack.pop_back();
+			ASSERT_LT(idx, nodes.size());
+			++numVisited;
+			auto &node = nodes[idx];
+			if(node.IsLeaf()) {
+				ASSERT_LE(node.leftFirst + node.count, prims.size());
+				for(auto i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+					auto tri = prims[i];
+					ASSERT_LT(tri, refCount.size());
+					++refCount[tri];
+					for(uint32_t j = 0; j < 3; ++j)
+						EXPECT_TRUE(contains(node, mesh.GetVertex(tri, j)));
+				}
+				continue;
+			}
+			ASSERT_LT(node.leftFirst + 1, nodes.size());
+			for(auto child : {node.leftFirst, node.leftFirst + 1}) {
+				EXPECT_TRUE(contains(node, nodes[child].min));
+				EXPECT_TRUE(contains(node, nodes[child].max));
+				stack.push_back(child);
+			}
+		}
+		EXPECT_EQ(numVisited, nodes.size());
+		for(auto count : refCount)
+			EXPECT_EQ(count, 1u);
+	}
+
+	void compare_queries(const pragma::math::Bvh &bvh, const Mesh &mesh, uint32_t numQueries)
+	{
+		for(uint32_t q = 0; q < numQueries; ++q) {
+			auto origin = test::random_vector(-70.f, 70.f);
+			auto dir = test::random_vector(-1.f, 1.f);
+			auto tMax = (q % 2 == 0) ? std::numeric_limits<float>::max() : 60.f;
+			auto hit = bvh.Raycast(origin, dir, 0.f, tMax);
+			auto ref = raycast_linear(mesh, origin, dir, 0.f, tMax);
+			ASSERT_EQ(hit.has_value(), ref.has_value());
+			// Ties between triangles may be resolved differently, so only the distance is compared
+			if(hit)
+				EXPECT_NEAR(hit->t, ref->second, 1e-3);
+
+			auto [min, max] = test::random_aabb(50.f, 10.f);
+			std::vector<uint32_t> tris;
+			bvh.FindTrianglesInAabb(min, max, tris);
+			std::vector<uint32_t> refTris;
+			for(uint32_t i = 0; i < mesh.GetTriangleCount(); ++i) {
+				if(pragma::math::intersection::aabb_triangle(min, max, mesh.GetVertex(i, 0), mesh.GetVertex(i, 1), mesh.GetVertex(i, 2)))
+					refTris.push_back(i);
+			}
+			std::sort(tris.begin(), tris.end());
+			EXPECT_EQ(tris, refTris);
+
+			auto radius = test::random_float(0.5f, 15.f);
+			tris.clear();
+			refTris.clear();
+			bvh.FindTrianglesInSphere(origin, radius, tris);
+			auto closestDistSqr = std::numeric_limits<float>::max();
+			for(uint32_t i = 0; i < mesh.GetTriangleCount(); ++i) {
+				Vector3 p;
+				pragma::math::geometry::closest_point_on_triangle_to_point(mesh.GetVertex(i, 0), mesh.GetVertex(i, 1), mesh.GetVertex(i, 2), origin, &p);
+				auto distSqr = uvec::length_sqr(p - origin);
+				closestDistSqr = std::min(closestDistSqr, distSqr);
+				if(distSqr <= radius * radius)
+					refTris.push_back(i);
+			}
+			std::sort(tris.begin(), tris.end());
+			EXPECT_EQ(tris, refTris);
+
+			auto closest = bvh.FindClosestPoint(origin);
+			ASSERT_TRUE(closest.has_value());
+			EXPECT_NEAR(closest->distanceSqr, closestDistSqr, 1e-3f * std::max(1.f, closestDistSqr));
+		}
+	}
+
+	void expect_same_tree(const pragma::math::Bvh &a, const pragma::math::Bvh &b)
+	{
+		auto &nodesA = a.GetNodes();
+		auto &nodesB = b.GetNodes();
+		ASSERT_EQ(nodesA.size(), nodesB.size());
+		for(size_t i = 0; i < nodesA.size(); ++i) {
+			EXPECT_EQ(nodesA[i].leftFirst, nodesB[i].leftFirst);
+			EXPECT_EQ(nodesA[i].count, nodesB[i].count);
+			EXPECT_EQ(nodesA[i].min, nodesB[i].min);
+			EXPECT_EQ(nodesA[i].max, nodesB[i].max);
+		}
+		EXPECT_EQ(a.GetPrimitives(), b.GetPrimitives());
+	}
+};
+
+TEST(BvhTests, Empty)
+{
+	pragma::math::Bvh bvh {std::vector<Vector3> {}, std::vector<uint32_t> {}};
+	EXPECT_TRUE(bvh.IsEmpty());
+	EXPECT_FALSE(bvh.Raycast({}, {1.f, 0.f, 0.f}).has_value());
+	EXPECT_FALSE(bvh.FindClosestPoint({}).has_value());
+}
+
+TEST(BvhTests, SahBuildMatchesLinearScan)
+{
+	for(auto binCount : {2u, 16u, 64u}) {
+		auto mesh = generate_mesh(2'000);
+		pragma::math::Bvh::BuildInfo buildInfo {};
+		buildInfo.binCount = binCount;
+		pragma::math::Bvh bvh {mesh.verts, mesh.indices, buildInfo};
+		validate_bvh(bvh, mesh);
+		compare_queries(bvh, mesh, 200);
+	}
+}
+
+TEST(BvhTests, DegenerateCentroids)
+{
+	// All triangles share the same centroid, so no split can separate them
+	Mesh mesh;
+	for(uint32_t i = 0; i < 100; ++i) {
+		for(auto &v : {Vector3 {-1.f, 0.f, 0.f}, Vector3 {1.f, 0.f, 0.f}, Vector3 {0.f, 1.f, 0.f}}) {
+			mesh.indices.push_back(static_cast<uint32_t>(mesh.verts.size()));
+			mesh.verts.push_back(v);
+		}
+	}
+	pragma::math::Bvh bvh {mesh.verts, mesh.indices};
+	validate_bvh(bvh, mesh);
+	EXPECT_TRUE(bvh.Raycast({0.f, 0.3f, -5.f}, {0.f, 0.f, 1.f}).has_value());
+}
+
+TEST(BvhTests, Uint16Indices)
+{
+	auto mesh = generate_mesh(500);
+	std::vector<uint16_t> indices16(mesh.indices.begin(), mesh.indices.end());
+	pragma::math::Bvh bvh32 {mesh.verts, mesh.indices};
+	pragma::math::Bvh bvh16 {mesh.verts, indices16};
+	expect_same_tree(bvh32, bvh16);
+}
+
+TEST(BvhTests, ParallelBuildMatchesSerial)
+{
+	auto mesh = generate_mesh(20'000);
+	pragma::math::Bvh serial {mesh.verts, mesh.indices};
+	for(auto threadCount : {0u, 2u, 7u}) {
+		pragma::math::Bvh::BuildInfo buildInfo {};
+		buildInfo.threadCount = threadCount;
+		pragma::math::Bvh parallel {mesh.verts, mesh.indices, buildInfo};
+		expect_same_tree(serial, parallel);
+	}
+}
+
+TEST(BvhTests, RefitAfterMovingVertices)
+{
+	auto mesh = generate_mesh(3'000);
+	pragma::math::Bvh bvh {mesh.verts, mesh.indices};
+	auto buildCost = bvh.GetBuildSahCost();
+	EXPECT_FLOAT_EQ(bvh.CalcSahCost(), buildCost);
+
+	// Deform the mesh: a wave along x and a translation of half of the triangles
+	auto moved = mesh;
+	for(size_t i = 0; i < moved.verts.size(); ++i) {
+		auto &v = moved.verts[i];
+		v.y += std::sin(v.x * 0.1f) * 5.f;
+		if((i / 3) % 2 == 0)
+			v += Vector3 {20.f, 0.f, -10.f};
+	}
+	auto refitSerial = bvh;
+	ASSERT_TRUE(refitSerial.Refit(moved.verts));
+	validate_bvh(refitSerial, moved);
+	compare_queries(refitSerial, moved, 200);
+	// The topology must not change
+	EXPECT_EQ(refitSerial.GetPrimitives(), bvh.GetPrimitives());
+	EXPECT_GE(refitSerial.CalcSahCost(), 0.f);
+
+	auto refitParallel = bvh;
+	ASSERT_TRUE(refitParallel.Refit(moved.verts, 4));
+	expect_same_tree(refitSerial, refitParallel);
+
+	// Refitting back to the original positions restores the original bounds
+	ASSERT_TRUE(refitSerial.Refit(mesh.verts));
+	expect_same_tree(refitSerial, bvh);
+
+	auto wrongCount = moved.verts;
+	wrongCount.pop_back();
+	EXPECT_FALSE(refitSerial.Refit(wrongCount));
+}
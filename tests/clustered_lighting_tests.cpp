@@ -0,0 +1,240 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	using LightClusterGrid = pragma::math::LightClusterGrid;
+	constexpr float FOV = 1.2f;
+	constexpr float ASPECT_RATIO = 16.f / 9.f;
+	constexpr float NEAR_Z = 0.5f;
+	constexpr float FAR_Z = 100.f;
+	// Not multiples of the SIMD width, so that rows of clusters end in partial batches
+	constexpr uint32_t NUM_X = 11;
+	constexpr uint32_t NUM_Y = 6;
+	constexpr uint32_t NUM_Z = 9;
+	// Number of sample intervals per cluster dimension
+	constexpr uint32_t NUM_SAMPLE_STEPS = 4;
+	// Samples closer than this to the boundary of a light are ignored, since rounding can decide them either way
+	constexpr float MARGIN = 1e-3f;
+
+	struct Camera {
+		Vector3 pos;
+		Vector3 forward;
+		Vector3 right;
+		Vector3 up;
+	};
+	Camera get_camera()
+	{
+		Camera cam {};
+		cam.pos = {1.f, 2.f, 3.f};
+		cam.forward = uvec::get_normal(Vector3 {0.3f, -0.2f, 1.f});
+		// Same as LightClusterGrid::Build
+		cam.right = uvec::get_normal(uvec::cross(cam.forward, Vector3 {0.f, 1.f, 0.f}));
+		cam.up = uvec::cross(cam.right, cam.forward);
+		return cam;
+	}
+	LightClusterGrid build_grid(const Camera &cam)
+	{
+		LightClusterGrid grid {};
+		grid.Build(cam.pos, cam.forward, cam.up, FOV, ASPECT_RATIO, NEAR_Z, FAR_Z, NUM_X, NUM_Y, NUM_Z);
+		return grid;
+	}
+	// Regular grid of points within cluster (x, y, z), including its corners
+	std::vector<Vector3> get_cluster_samples(const Camera &cam, const LightClusterGrid &grid, uint32_t x, uint32_t y, uint32_t z)
+	{
+		std::vector<Vector3> samples;
+		auto step = 1.f / static_cast<float>(NUM_SAMPLE_STEPS);
+		for(uint32_t k = 0; k <= NUM_SAMPLE_STEPS; ++k) {
+			auto depth = grid.GetSliceDepth(z) + (grid.GetSliceDepth(z + 1) - grid.GetSliceDepth(z)) * (k * step);
+			for(uint32_t j = 0; j <= NUM_SAMPLE_STEPS; ++j) {
+				for(uint32_t i = 0; i <= NUM_SAMPLE_STEPS; ++i) {
+					Vector2 uv {(x + i * step) / static_cast<float>(NUM_X), (y + j * step) / static_cast<float>(NUM_Y)};
+					samples.push_back(pragma::math::frustum::get_plane_point(cam.pos, cam.forward, cam.right, cam.up, FOV, depth, ASPECT_RATIO, uv));
+				}
+			}
+		}
+		return samples;
+	}
+
+	struct Lights {
+		pragma::math::SphereSoaBuffer pointLights;
+		std::vector<LightClusterGrid::SpotLight> spotLights;
+		uint32_t GetSpotLightIndex(size_t i) const { return static_cast<uint32_t>(pointLights.Size() + i); }
+	};
+	// Random position around the view frustum, including positions behind the camera and beyond the far plane
+	Vector3 random_position(const Camera &cam)
+	{
+		auto depth = test::random_float(-5.f, FAR_Z + 10.f);
+		auto lateral = std::abs(depth) + 3.f;
+		return cam.pos + cam.forward * depth + cam.right * test::random_float(-lateral, lateral) + cam.up * test::random_float(-lateral, lateral) * 0.6f;
+	}
+	Lights generate_lights(const Camera &cam, size_t numPointLights, size_t numSpotLights)
+	{
+		Lights lights {};
+		for(size_t i = 0; i < numPointLights; ++i)
+			lights.pointLights.Add(random_position(cam), test::random_float(0.2f, 10.f));
+		for(size_t i = 0; i < numSpotLights; ++i) {
+			LightClusterGrid::SpotLight light {};
+			light.origin = random_position(cam);
+			light.direction = uvec::get_normal(test::random_vector(-1.f, 1.f));
+			// Every fourth cone is wider than a hemisphere
+			light.coneAngle = (i % 4 == 0) ? test::random_float(std::numbers::pi_v<float> * 0.5f, std::numbers::pi_v<float>) : test::random_float(0.05f, std::numbers::pi_v<float> * 0.5f);
+			light.range = test::random_float(1.f, 25.f);
+			lights.spotLights.push_back(light);
+		}
+		return lights;
+	}
+	bool is_point_in_spot_light(const LightClusterGrid::SpotLight &light, const Vector3 &p)
+	{
+		auto v = p - light.origin;
+		auto dist = uvec::length(v);
+		if(dist > light.range - MARGIN)
+			return false;
+		if(dist < MARGIN)
+			return true;
+		return uvec::dot(v / dist, light.direction) > std::cos(light.coneAngle) + MARGIN;
+	}
+	bool has_light(const LightClusterGrid &grid, uint32_t clusterIndex, uint32_t lightIndex)
+	{
+		auto [indices, count] = grid.GetClusterLights(clusterIndex);
+		return std::binary_search(indices, indices + count, lightIndex);
+	}
+};
+
+TEST(ClusteredLightingTests, ClusterSphereEnclosesCluster)
+{
+	auto cam = get_camera();
+	auto grid = build_grid(cam);
+	ASSERT_EQ(grid.GetClusterCount(), NUM_X * NUM_Y * NUM_Z);
+	for(uint32_t z = 0; z < NUM_Z; ++z) {
+		for(uint32_t y = 0; y < NUM_Y; ++y) {
+			for(uint32_t x = 0; x < NUM_X; ++x) {
+				auto idx = grid.GetClusterIndex(x, y, z);
+				auto sphere = grid.GetClusterSphere(idx);
+				for(auto &p : get_cluster_samples(cam, grid, x, y, z))
+					EXPECT_LE(uvec::distance(p, sphere.origin), sphere.radius * (1.f + 1e-5f)) << "Cluster " << idx;
+			}
+		}
+	}
+}
+
+TEST(ClusteredLightingTests, AssignLightsIsConservative)
+{
+	test::reset_random_generator();
+	auto cam = get_camera();
+	auto grid = build_grid(cam);
+	auto lights = generate_lights(cam, 150, 150);
+	grid.AssignLights(lights.pointLights.GetView(), lights.spotLights.data(), lights.spotLights.size());
+	auto &offsets = grid.GetClusterOffsets();
+	ASSERT_EQ(offsets.size(), grid.GetClusterCount() + 1u);
+	EXPECT_EQ(offsets.back(), grid.GetLightIndices().size());
+
+	size_t numRequired = 0;
+	for(uint32_t z = 0; z < NUM_Z; ++z) {
+		for(uint32_t y = 0; y < NUM_Y; ++y) {
+			for(uint32_t x = 0; x < NUM_X; ++x) {
+				auto idx = grid.GetClusterIndex(x, y, z);
+				auto [indices, count] = grid.GetClusterLights(idx);
+				EXPECT_TRUE(std::is_sorted(indices, indices + count)) << "Cluster " << idx;
+				EXPECT_EQ(std::adjacent_find(indices, indices + count), indices + count) << "Cluster " << idx;
+
+				// Any light that contains a point of the cluster has to be assigned to it
+				auto samples = get_cluster_samples(cam, grid, x, y, z);
+				for(uint32_t i = 0; i < lights.pointLights.Size(); ++i) {
+					auto light = lights.pointLights.Get(i);
+					auto touches = std::any_of(samples.begin(), samples.end(), [&light](const Vector3 &p) { return uvec::distance(p, light.origin) < light.radius - MARGIN; });
+					if(!touches)
+						continue;
+					++numRequired;
+					EXPECT_TRUE(has_light(grid, idx, i)) << "Cluster " << idx << ", point light " << i;
+				}
+				for(size_t i = 0; i < lights.spotLights.size(); ++i) {
+					auto &light = lights.spotLights[i];
+					auto touches = std::any_of(samples.begin(), samples.end(), [&light](const Vector3 &p) { return is_point_in_spot_light(light, p); });
+					if(!touches)
+						continue;
+					++numRequired;
+					EXPECT_TRUE(has_light(grid, idx, lights.GetSpotLightIndex(i))) << "Cluster " << idx << ", spotlight " << i;
+				}
+			}
+		}
+	}
+	EXPECT_GT(numRequired, 1'000u);
+}
+
+TEST(ClusteredLightingTests, SpotLightsMatchSphereCone)
+{
+	test::reset_random_generator();
+	auto cam = get_camera();
+	auto grid = build_grid(cam);
+	auto lights = generate_lights(cam, 0, 300);
+	grid.AssignLights(lights.pointLights.GetView(), lights.spotLights.data(), lights.spotLights.size());
+
+	// Spotlights are only assigned to clusters whose bounding sphere passes intersection::sphere_cone. sphere_cone also culls
+	// spheres behind the cone origin, which is only correct for cones that are narrower than a hemisphere.
+	size_t numAssigned = 0;
+	for(uint32_t idx = 0; idx < grid.GetClusterCount(); ++idx) {
+		auto sphere = grid.GetClusterSphere(idx);
+		auto [indices, count] = grid.GetClusterLights(idx);
+		for(auto *it = indices; it != indices + count; ++it) {
+			auto &light = lights.spotLights[*it - lights.pointLights.Size()];
+			++numAssigned;
+			if(light.coneAngle > std::numbers::pi_v<float> * 0.5f)
+				continue;
+			EXPECT_TRUE(pragma::math::intersection::sphere_cone(sphere.origin, sphere.radius + MARGIN, light.origin, light.direction, light.coneAngle, light.range)) << "Cluster " << idx << ", light " << *it;
+		}
+	}
+	EXPECT_GT(numAssigned, 0u);
+}
+
+TEST(ClusteredLightingTests, WideSpotLightCoversPointsBehindOrigin)
+{
+	auto cam = get_camera();
+	auto grid = build_grid(cam);
+	// The light points back towards the camera. The cone is wider than a hemisphere, so it also covers points that are
+	// far behind the light, at 150 degrees to the light direction. The bounding sphere of the cluster of such a point is entirely behind the light.
+	LightClusterGrid::SpotLight light {};
+	light.origin = cam.pos + cam.forward * 20.f;
+	light.direction = -cam.forward;
+	light.range = 30.f;
+	auto angle = 150.f / 180.f * std::numbers::pi_v<float>;
+	auto p = light.origin + (light.direction * std::cos(angle) + cam.right * std::sin(angle)) * 25.f;
+	ASSERT_LT(uvec::dot(p - light.origin, light.direction), 0.f);
+	uint32_t clusterIndex;
+	ASSERT_TRUE(grid.FindCluster(p, clusterIndex));
+	auto sphere = grid.GetClusterSphere(clusterIndex);
+	ASSERT_LT(uvec::dot(sphere.origin - light.origin, light.direction), -sphere.radius);
+
+	pragma::math::SphereSoaBuffer noPointLights {};
+	for(auto coneAngle : {2.7f, 3.f, std::numbers::pi_v<float>}) {
+		light.coneAngle = coneAngle;
+		ASSERT_TRUE(is_point_in_spot_light(light, p));
+		grid.AssignLights(noPointLights.GetView(), &light, 1);
+		EXPECT_TRUE(has_light(grid, clusterIndex, 0)) << "Cone angle " << coneAngle;
+	}
+}
+
+TEST(ClusteredLightingTests, AssignLightsIsIndependentOfThreadCount)
+{
+	test::reset_random_generator();
+	auto cam = get_camera();
+	auto lights = generate_lights(cam, 700, 300);
+	auto reference = build_grid(cam);
+	reference.AssignLights(lights.pointLights.GetView(), lights.spotLights.data(), lights.spotLights.size(), 1);
+	ASSERT_FALSE(reference.GetLightIndices().empty());
+	for(uint32_t threadCount : {2u, 3u, 8u, 0u}) {
+		auto grid = build_grid(cam);
+		// Assigning twice reuses the buffers of the first assignment
+		for(uint32_t i = 0; i < 2; ++i) {
+			grid.AssignLights(lights.pointLights.GetView(), lights.spotLights.data(), lights.spotLights.size(), threadCount);
+			EXPECT_EQ(grid.GetClusterOffsets(), reference.GetClusterOffsets()) << "Thread count " << threadCount;
+			EXPECT_EQ(grid.GetLightIndices(), reference.GetLightIndices()) << "Thread count " << threadCount;
+		}
+	}
+}
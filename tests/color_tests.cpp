@@ -2,7 +2,6 @@
 // SPDX-License-Identifier: MIT
 
 #include <memory>
-#include "mathutil/color.h"
 #include "gtest/gtest.h"
 #include "gtest_common.h"
 
@@ -0,0 +1,293 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	using ProxyId = pragma::math::DynamicAabbTree::ProxyId;
+	using ProxyPair = std::pair<ProxyId, ProxyId>;
+
+	struct Proxy {
+		bounding_volume::AABB aabb;
+		uint64_t userData = 0;
+	};
+
+	// Mirror of the tree contents, used as the brute-force reference
+	struct Scene {
+		pragma::math::DynamicAabbTree tree {0.1f, 4.f};
+		std::unordered_map<ProxyId, Proxy> proxies;
+		// Proxies that were inserted or re-inserted since the last UpdatePairs call
+		std::unordered_set<ProxyId> moved;
+		uint64_t nextUserData = 1;
+
+		bounding_volume::AABB RandomAabb() const
+		{
+			auto [min, max] = test::random_aabb(100.f, 4.f);
+			return {min, max};
+		}
+		void Insert()
+		{
+			auto aabb = RandomAabb();
+			auto userData = nextUserData++;
+			auto id = tree.Insert(aabb, userData);
+			ASSERT_EQ(proxies.find(id), proxies.end());
+			proxies[id] = {aabb, userData};
+			moved.insert(id);
+		}
+		void Remove(ProxyId id)
+		{
+			tree.Remove(id);
+			proxies.erase(id);
+			moved.erase(id);
+		}
+		void Move(ProxyId id)
+		{
+			auto &proxy = proxies[id];
+			// Mostly small movements which stay within the fattened box, and a few teleports
+			Vector3 displacement = (test::random_uint(0, 10) == 0) ? test::random_vector(-50.f, 50.f) : test::random_vector(-0.2f, 0.2f);
+			proxy.aabb = {proxy.aabb.min + displacement, proxy.aabb.max + displacement};
+			if(tree.Move(id, proxy.aabb, displacement))
+				moved.insert(id);
+		}
+		ProxyId RandomProxy() const
+		{
+			auto it = proxies.begin();
+			std::advance(it, test::random_uint(0, static_cast<uint32_t>(proxies.size())));
+			return it->first;
+		}
+		std::vector<ProxyPair> BruteForcePairs(bool movedOnly) const
+		{
+			std::vector<ProxyPair> pairs;
+			for(auto &[idA, a] : proxies) {
+				for(auto &[idB, b] : proxies) {
+					if(idA >= idB || (movedOnly && !moved.contains(idA) && !moved.contains(idB)))
+						continue;
+					if(tree.GetFatAabb(idA).Intersects(tree.GetFatAabb(idB)))
+						pairs.push_back({idA, idB});
+				}
+			}
+			std::sort(pairs.begin(), pairs.end());
+			return pairs;
+		}
+	};
+
+	bool aabb_contains(const bounding_volume::AABB &outer, const bounding_volume::AABB &inner)
+	{
+		return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+	}
+
+	// The rotations are single rotations, which can leave a local height difference larger than 1 between two siblings,
+	// but the height of the tree must stay close to that of an AVL tree with the same number of leaves
+	uint32_t get_max_height(uint32_t proxyCount) { return static_cast<uint32_t>(std::ceil(1.45f * std::log2(static_cast<float>(proxyCount) + 2.f))) + 1; }
+
+	// Checks the links, heights and bounds of all nodes, and that every proxy is reachable exactly once
+	void validate_tree(const Scene &scene)
+	{
+		auto &tree = scene.tree;
+		auto &nodes = tree.GetNodes();
+		ASSERT_EQ(tree.GetProxyCount(), scene.proxies.size());
+		if(scene.proxies.empty()) {
+			EXPECT_EQ(tree.GetRoot(), pragma::math::DynamicAabbTree::INVALID_PROXY);
+			return;
+		}
+		ASSERT_LT(tree.GetRoot(), nodes.size());
+		EXPECT_EQ(nodes[tree.GetRoot()].parent, pragma::math::DynamicAabbTree::INVALID_PROXY);
+		std::vector<uint32_t> stack {tree.GetRoot()};
+		size_t numLeaves = 0;
+		while(!stack.empty()) {
+			auto idx = stack.back();
+			stack.pop_back();
+			auto &node = nodes[idx];
+			if(node.IsLeaf()) {
+				ASSERT_EQ(node.height, 0);
+				auto it = scene.proxies.find(idx);
+				ASSERT_NE(it, scene.proxies.end());
+				EXPECT_EQ(node.userData, it->second.userData);
+				EXPECT_TRUE(aabb_contains(node.aabb, it->second.aabb));
+				++numLeaves;
+				continue;
+			}
+			auto &child1 = nodes[node.child1];
+			auto &child2 = nodes[node.child2];
+			EXPECT_EQ(child1.parent, idx);
+			EXPECT_EQ(child2.parent, idx);
+			EXPECT_EQ(node.height, 1 + std::max(child1.height, child2.height));
+			EXPECT_TRUE(aabb_contains(node.aabb, child1.aabb));
+			EXPECT_TRUE(aabb_contains(node.aabb, child2.aabb));
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+		EXPECT_EQ(numLeaves, scene.proxies.size());
+		EXPECT_LE(tree.GetHeight(), get_max_height(tree.GetProxyCount()));
+	}
+
+	void compare_queries(const Scene &scene, uint32_t numQueries)
+	{
+		for(uint32_t q = 0; q < numQueries; ++q) {
+			auto [min, max] = test::random_aabb(100.f, 20.f);
+			bounding_volume::AABB aabb {min, max};
+			std::vector<ProxyId> hits;
+			scene.tree.Query(aabb, [&hits](ProxyId id) {
+				hits.push_back(id);
+				return true;
+			});
+			std::vector<ProxyId> ref;
+			for(auto &[id, proxy] : scene.proxies) {
+				if(scene.tree.GetFatAabb(id).Intersects(aabb))
+					ref.push_back(id);
+			}
+			std::sort(hits.begin(), hits.end());
+			std::sort(ref.begin(), ref.end());
+			EXPECT_EQ(hits, ref);
+
+			auto origin = test::random_vector(-120.f, 120.f);
+			auto dir = test::random_vector(-1.f, 1.f);
+			auto tMax = 150.f;
+			hits.clear();
+			ref.clear();
+			scene.tree.Raycast(origin, dir, tMax, [&hits](ProxyId id, float tMax) {
+				hits.push_back(id);
+				return tMax;
+			});
+			pragma::math::intersection::Ray ray {origin, dir};
+			for(auto &[id, proxy] : scene.proxies) {
+				auto &fatAabb = scene.tree.GetFatAabb(id);
+				float tEntry, tExit;
+				if(pragma::math::intersection::line_aabb(ray, fatAabb.min, fatAabb.max, &tEntry, &tExit) == pragma::math::intersection::Result::Intersect && tExit >= 0.f && tEntry <= tMax)
+					ref.push_back(id);
+			}
+			std::sort(hits.begin(), hits.end());
+			std::sort(ref.begin(), ref.end());
+			EXPECT_EQ(hits, ref);
+		}
+	}
+
+	std::vector<ProxyPair> update_pairs(pragma::math::DynamicAabbTree &tree)
+	{
+		std::vector<ProxyPair> pairs;
+		tree.UpdatePairs([&pairs](ProxyId a, ProxyId b) { pairs.push_back({a, b}); });
+		return pairs;
+	}
+	std::vector<ProxyPair> query_all_pairs(const pragma::math::DynamicAabbTree &tree)
+	{
+		std::vector<ProxyPair> pairs;
+		tree.QueryAllPairs([&pairs](ProxyId a, ProxyId b) { pairs.push_back({a, b}); });
+		std::sort(pairs.begin(), pairs.end());
+		return pairs;
+	}
+};
+
+TEST(DynamicAabbTreeTests, Empty)
+{
+	pragma::math::DynamicAabbTree tree {};
+	EXPECT_EQ(tree.GetHeight(), 0u);
+	EXPECT_TRUE(update_pairs(tree).empty());
+	EXPECT_TRUE(query_all_pairs(tree).empty());
+	auto id = tree.Insert({Vector3 {-1.f, -1.f, -1.f}, Vector3 {1.f, 1.f, 1.f}}, 42);
+	EXPECT_EQ(tree.GetUserData(id), 42u);
+	tree.Remove(id);
+	EXPECT_EQ(tree.GetProxyCount(), 0u);
+	EXPECT_EQ(tree.GetRoot(), pragma::math::DynamicAabbTree::INVALID_PROXY);
+	// The removed proxy must not be reported
+	EXPECT_TRUE(update_pairs(tree).empty());
+}
+
+TEST(DynamicAabbTreeTests, InsertRemoveMoveMatchesBruteForce)
+{
+	test::reset_random_generator();
+	Scene scene;
+	scene.tree.Reserve(500);
+	for(uint32_t i = 0; i < 1'000; ++i)
+		scene.Insert();
+	validate_tree(scene);
+	compare_queries(scene, 100);
+	EXPECT_EQ(update_pairs(scene.tree), scene.BruteForcePairs(true));
+	scene.moved.clear();
+
+	for(uint32_t round = 0; round < 30; ++round) {
+		for(uint32_t op = 0; op < 200; ++op) {
+			auto r = test::random_uint(0, 10);
+			if(r < 2 || scene.proxies.empty())
+				scene.Insert();
+			else if(r < 4)
+				scene.Remove(scene.RandomProxy());
+			else
+				scene.Move(scene.RandomProxy());
+		}
+		validate_tree(scene);
+		compare_queries(scene, 20);
+		EXPECT_EQ(query_all_pairs(scene.tree), scene.BruteForcePairs(false));
+		EXPECT_EQ(update_pairs(scene.tree), scene.BruteForcePairs(true));
+		scene.moved.clear();
+		// Nothing has moved since the last call
+		EXPECT_TRUE(update_pairs(scene.tree).empty());
+	}
+
+	scene.tree.Clear();
+	scene.proxies.clear();
+	scene.moved.clear();
+	validate_tree(scene);
+	for(uint32_t i = 0; i < 100; ++i)
+		scene.Insert();
+	validate_tree(scene);
+	EXPECT_EQ(update_pairs(scene.tree), scene.BruteForcePairs(true));
+}
+
+TEST(DynamicAabbTreeTests, RemovedIdsAreReused)
+{
+	// Node ids of removed proxies are re-used, a proxy that is removed before UpdatePairs is called must not be reported,
+	// and a proxy that is inserted and then moved must only be reported once
+	pragma::math::DynamicAabbTree tree {0.f};
+	auto a = tree.Insert({Vector3 {0.f, 0.f, 0.f}, Vector3 {1.f, 1.f, 1.f}});
+	auto b = tree.Insert({Vector3 {10.f, 0.f, 0.f}, Vector3 {11.f, 1.f, 1.f}});
+	update_pairs(tree);
+	tree.Remove(b);
+	auto c = tree.Insert({Vector3 {0.5f, 0.f, 0.f}, Vector3 {1.5f, 1.f, 1.f}});
+	tree.Move(c, {Vector3 {0.25f, 0.f, 0.f}, Vector3 {1.25f, 1.f, 1.f}});
+	auto pairs = update_pairs(tree);
+	ASSERT_EQ(pairs.size(), 1u);
+	EXPECT_EQ(pairs.front(), (ProxyPair {std::min(a, c), std::max(a, c)}));
+}
+
+TEST(DynamicAabbTreeTests, HeightStaysBounded)
+{
+	// Query and Raycast use a fixed-size stack, which relies on the tree staying balanced
+	test::reset_random_generator();
+	Scene scene;
+	// Sorted insertion is the worst case for an unbalanced tree
+	for(uint32_t i = 0; i < 4'000; ++i) {
+		auto p = Vector3 {static_cast<float>(i), 0.f, 0.f};
+		auto id = scene.tree.Insert({p, p + Vector3 {0.5f, 0.5f, 0.5f}}, i);
+		scene.proxies[id] = {{p, p + Vector3 {0.5f, 0.5f, 0.5f}}, i};
+	}
+	// Boxes clustered along a line with exponentially varying density, which produces locally unbalanced insertions
+	auto insertClustered = [&scene](uint32_t i) {
+		auto p = Vector3 {test::random_float(-100.f, 100.f) * std::pow(10.f, test::random_float(-2.f, 2.f)), test::random_float(-1.f, 1.f), 0.f};
+		bounding_volume::AABB aabb {p, p + Vector3 {1.f, 1.f, 1.f}};
+		auto id = scene.tree.Insert(aabb, i);
+		scene.proxies[id] = {aabb, i};
+	};
+	for(uint32_t i = 0; i < 20'000; ++i) {
+		auto r = test::random_uint(0, 4);
+		if(r == 0)
+			scene.Insert();
+		else if(r == 1)
+			insertClustered(i);
+		else if(r == 2 && !scene.proxies.empty())
+			scene.Remove(scene.RandomProxy());
+		else if(!scene.proxies.empty())
+			scene.Move(scene.RandomProxy());
+		if(i % 1'000 == 0) {
+			EXPECT_LE(scene.tree.GetHeight(), get_max_height(scene.tree.GetProxyCount()));
+		}
+	}
+	validate_tree(scene);
+	EXPECT_LT(scene.tree.GetHeight() + 1, pragma::math::DynamicAabbTree::MAX_QUERY_STACK_SIZE / 4);
+	compare_queries(scene, 50);
+}
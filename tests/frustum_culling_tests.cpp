@@ -0,0 +1,496 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	using Frustum = pragma::math::Frustum;
+	using Intersect = pragma::math::intersection::Intersect;
+	constexpr float FOV = 1.2f;
+	constexpr float ASPECT_RATIO = 16.f / 9.f;
+	constexpr float NEAR_Z = 0.5f;
+	constexpr float FAR_Z = 300.f;
+
+	// Right-handed perspective projection with a depth range of [0, 1], farZ may be infinite
+	Mat4 create_perspective(float nearZ, float farZ, bool reverseZ, float fovRad = FOV, float aspectRatio = ASPECT_RATIO)
+	{
+		auto f = 1.f / std::tan(fovRad * 0.5f);
+		Mat4 m {0.f};
+		m[0][0] = f / aspectRatio;
+		m[1][1] = f;
+		m[2][3] = -1.f;
+		auto infinite = std::isinf(farZ);
+		if(reverseZ) {
+			m[2][2] = infinite ? 0.f : nearZ / (farZ - nearZ);
+			m[3][2] = infinite ? nearZ : (farZ * nearZ) / (farZ - nearZ);
+		}
+		else {
+			m[2][2] = infinite ? -1.f : farZ / (nearZ - farZ);
+			m[3][2] = infinite ? -nearZ : -(farZ * nearZ) / (farZ - nearZ);
+		}
+		return m;
+	}
+	Mat4 create_orthographic(float halfWidth, float halfHeight, float nearZ, float farZ)
+	{
+		Mat4 m {1.f};
+		m[0][0] = 1.f / halfWidth;
+		m[1][1] = 1.f / halfHeight;
+		m[2][2] = -1.f / (farZ - nearZ);
+		m[3][2] = -nearZ / (farZ - nearZ);
+		return m;
+	}
+
+	struct Projection {
+		Mat4 matrix;
+		bool reverseZ;
+		bool hasFarPlane;
+	};
+	std::vector<Projection> get_projections()
+	{
+		auto inf = std::numeric_limits<float>::infinity();
+		// Same as glm::tweakedInfinitePerspective, but with a depth range of [0, 1]
+		auto tweaked = create_perspective(NEAR_Z, inf, false);
+		constexpr auto eps = 2.4e-7f;
+		tweaked[2][2] = eps - 1.f;
+		tweaked[3][2] = (eps - 1.f) * NEAR_Z;
+		return {
+		  {create_perspective(NEAR_Z, FAR_Z, false), false, true},
+		  {create_perspective(NEAR_Z, FAR_Z, true), true, true},
+		  {create_perspective(NEAR_Z, inf, false), false, false},
+		  {create_perspective(NEAR_Z, inf, true), true, false},
+		  {tweaked, false, false},
+		  {create_orthographic(80.f, 45.f, NEAR_Z, FAR_Z), false, true},
+		};
+	}
+
+	struct Camera {
+		Vector3 pos;
+		Vector3 forward;
+		Vector3 up;
+		// The translation is applied after the rotation, so that the view direction does not lose precision if the camera is far from the origin
+		Mat4 GetView() const
+		{
+			auto view = umat::look_at(Vector3 {}, forward, up);
+			view[3] = view * Vector4 {-pos, 1.f};
+			return view;
+		}
+	};
+	Camera random_camera(float range)
+	{
+		auto forward = uvec::get_normal(test::random_vector(-1.f, 1.f));
+		auto up = uvec::get_normal(uvec::cross(forward, (std::abs(forward.y) < 0.9f) ? Vector3 {0.f, 1.f, 0.f} : Vector3 {1.f, 0.f, 0.f}));
+		return {test::random_vector(-range, range), forward, up};
+	}
+
+	// Returns 1 if the point is inside of the clip volume, 0 if it is outside and -1 if it is too close to one of the planes to tell
+	int32_t classify_clip_space(const Mat4 &viewProjection, const Projection &projection, const Vector3 &p)
+	{
+		auto c = viewProjection * Vector4 {p, 1.f};
+		std::array<float, 6> dists {c.w + c.x, c.w - c.x, c.w + c.y, c.w - c.y, c.z, c.w - c.z};
+		if(!projection.hasFarPlane)
+			dists[projection.reverseZ ? 4 : 5] = std::numeric_limits<float>::max();
+		auto margin = 1e-3f * (std::abs(c.w) + 1.f);
+		auto result = 1;
+		for(auto d : dists) {
+			if(d < -margin)
+				return 0;
+			if(d <= margin)
+				result = -1;
+		}
+		return result;
+	}
+
+	float get_plane_distance(const Vector4 &plane, const Vector3 &p) { return plane.x * p.x + plane.y * p.y + plane.z * p.z - plane.w; }
+	// Results that were computed in a different way may only differ for volumes that touch one of the planes
+	bool touches_plane(const Frustum &frustum, const Vector3 &center, const Vector3 &extents, float radius = 0.f, float minTolerance = 0.f)
+	{
+		for(auto &plane : frustum.GetPlaneVectors()) {
+			// Unbounded far plane of an infinite projection
+			if(plane.x == 0.f && plane.y == 0.f && plane.z == 0.f)
+				continue;
+			auto dist = get_plane_distance(plane, center);
+			auto r = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z + radius;
+			auto tolerance = std::max(1e-4f * (std::abs(plane.w) + std::abs(dist) + r + 1.f), minTolerance);
+			if(std::abs(dist - r) <= tolerance || std::abs(dist + r) <= tolerance)
+				return true;
+		}
+		return false;
+	}
+
+	struct Scene {
+		pragma::math::AabbSoaBuffer boxes;
+		pragma::math::SphereSoaBuffer spheres;
+		std::vector<bounding_volume::AABB> aabbs;
+		std::vector<bounding_volume::Sphere> sphereList;
+	};
+	Scene generate_scene(const Vector3 &center, size_t count, float range)
+	{
+		Scene scene;
+		for(size_t i = 0; i < count; ++i) {
+			auto [min, max] = test::random_aabb(range, 10.f);
+			min += center;
+			max += center;
+			scene.boxes.Add(min, max);
+			scene.aabbs.push_back({min, max});
+			auto origin = center + test::random_vector(-range, range);
+			auto radius = test::random_float(0.1f, 10.f);
+			scene.spheres.Add(origin, radius);
+			scene.sphereList.push_back({origin, radius});
+		}
+		return scene;
+	}
+	bool is_bit_set(const std::vector<uint32_t> &mask, size_t i) { return (mask[i / 32] & (1u << (i % 32))) != 0; }
+};
+
+TEST(FrustumCullingTests, PlaneExtraction)
+{
+	test::reset_random_generator();
+	for(auto &projection : get_projections()) {
+		for(uint32_t i = 0; i < 20; ++i) {
+			auto camera = random_camera(50.f);
+			auto viewProjection = projection.matrix * camera.GetView();
+			Frustum frustum {viewProjection, projection.reverseZ};
+			ASSERT_EQ(frustum.HasFarPlane(), projection.hasFarPlane);
+			for(uint32_t j = 0; j < Frustum::PLANE_COUNT; ++j) {
+				if(j == static_cast<uint32_t>(Frustum::PlaneIndex::Far) && !projection.hasFarPlane)
+					continue;
+				auto &plane = frustum.GetPlaneVectors()[j];
+				EXPECT_NEAR(uvec::length(Vector3 {plane.x, plane.y, plane.z}), 1.f, 1e-5f);
+			}
+
+			// The corners are projected onto the corners of the near and far plane in normalized device coordinates
+			auto corners = frustum.GetCorners();
+			constexpr std::array<std::pair<float, float>, 4> ndcCorners {std::pair {-1.f, -1.f}, std::pair {-1.f, 1.f}, std::pair {1.f, 1.f}, std::pair {1.f, -1.f}};
+			for(uint32_t j = 0; j < corners.size(); ++j) {
+				auto isFar = j >= 4;
+				if(isFar && !projection.hasFarPlane) {
+					EXPECT_FALSE(std::isfinite(corners[j].x) && std::isfinite(corners[j].y) && std::isfinite(corners[j].z));
+					continue;
+				}
+				auto c = viewProjection * Vector4 {corners[j], 1.f};
+				EXPECT_NEAR(c.x / c.w, ndcCorners[j % 4].first, 1e-3f);
+				EXPECT_NEAR(c.y / c.w, ndcCorners[j % 4].second, 1e-3f);
+				EXPECT_NEAR(c.z / c.w, (isFar != projection.reverseZ) ? 1.f : 0.f, 1e-3f);
+			}
+
+			for(uint32_t j = 0; j < 500; ++j) {
+				auto p = camera.pos + test::random_vector(-FAR_Z * 1.2f, FAR_Z * 1.2f);
+				auto ref = classify_clip_space(viewProjection, projection, p);
+				if(ref == -1)
+					continue;
+				EXPECT_EQ(frustum.ClassifySphere(p, 0.f) != Intersect::Outside, ref == 1);
+			}
+		}
+	}
+}
+
+TEST(FrustumCullingTests, InfiniteFarPlane)
+{
+	test::reset_random_generator();
+	for(auto &projection : get_projections()) {
+		auto camera = random_camera(50.f);
+		Frustum frustum {projection.matrix * camera.GetView(), projection.reverseZ};
+		// The infinite far plane does not reject anything in front of the camera, no matter how far away it is
+		auto farPoint = camera.pos + camera.forward * 1e6f;
+		EXPECT_EQ(frustum.ClassifySphere(farPoint, 1.f) != Intersect::Outside, !projection.hasFarPlane);
+		EXPECT_EQ(frustum.ClassifyAabb(farPoint - Vector3 {1.f}, farPoint + Vector3 {1.f}) != Intersect::Outside, !projection.hasFarPlane);
+		// but everything behind the camera is still rejected by the near plane
+		auto behind = camera.pos - camera.forward * 10.f;
+		EXPECT_EQ(frustum.ClassifySphere(behind, 1.f), Intersect::Outside);
+		auto inside = camera.pos + camera.forward * 10.f;
+		EXPECT_EQ(frustum.ClassifySphere(inside, 1.f), Intersect::Inside);
+	}
+}
+
+TEST(FrustumCullingTests, DistantFarPlane)
+{
+	// The far plane normal of a finite projection is shorter than the near plane normal by the factor near / far, which must not be mistaken for an infinite projection
+	constexpr float nearZ = 0.01f;
+	constexpr float farZ = 1'000.f;
+	for(auto reverseZ : {false, true}) {
+		Frustum frustum {create_perspective(nearZ, farZ, reverseZ), reverseZ};
+		ASSERT_TRUE(frustum.HasFarPlane()) << "Reverse-Z " << reverseZ;
+		EXPECT_EQ(frustum.GetPlanes().size(), Frustum::PLANE_COUNT) << "Reverse-Z " << reverseZ;
+		EXPECT_NEAR(frustum.GetPlaneVector(Frustum::PlaneIndex::Far).w, farZ, farZ * 0.05f) << "Reverse-Z " << reverseZ;
+		EXPECT_EQ(frustum.ClassifySphere({0.f, 0.f, -farZ * 0.9f}, 1.f), Intersect::Inside) << "Reverse-Z " << reverseZ;
+		EXPECT_EQ(frustum.ClassifySphere({0.f, 0.f, -farZ * 1.1f}, 1.f), Intersect::Outside) << "Reverse-Z " << reverseZ;
+	}
+}
+
+TEST(FrustumCullingTests, CameraFarFromOrigin)
+{
+	test::reset_random_generator();
+	// The plane distances grow with the distance of the camera from the origin, which must not affect the detection of the far plane
+	auto offset = Vector3 {1e5f, -3e4f, 2e5f};
+	for(auto &projection : get_projections()) {
+		for(uint32_t i = 0; i < 10; ++i) {
+			auto camera = random_camera(50.f);
+			camera.pos = {};
+			Frustum frustum {projection.matrix * camera.GetView(), projection.reverseZ};
+			auto farCamera = camera;
+			farCamera.pos = offset;
+			Frustum farFrustum {projection.matrix * farCamera.GetView(), projection.reverseZ};
+			ASSERT_EQ(farFrustum.HasFarPlane(), projection.hasFarPlane);
+			if(projection.hasFarPlane) {
+				EXPECT_EQ(farFrustum.ClassifySphere(farCamera.pos + camera.forward * (FAR_Z + 30.f), 1.f), Intersect::Outside);
+			}
+
+			// The far plane of a perspective projection is the difference of two almost equal rows of the matrix. The matrix elements
+			// have a precision of about 0.02 at this distance, which is amplified by far / near, so volumes are only compared if they
+			// are clearly inside or outside.
+			for(uint32_t j = 0; j < 500; ++j) {
+				auto p = test::random_vector(-FAR_Z * 1.2f, FAR_Z * 1.2f);
+				auto radius = test::random_float(0.f, 5.f);
+				if(touches_plane(frustum, p, {}, radius, 20.f))
+					continue;
+				EXPECT_EQ(farFrustum.ClassifySphere(offset + p, radius), frustum.ClassifySphere(p, radius));
+			}
+		}
+	}
+}
+
+TEST(FrustumCullingTests, MatchesPlaneMesh)
+{
+	test::reset_random_generator();
+	for(auto &projection : get_projections()) {
+		auto camera = random_camera(50.f);
+		Frustum frustum {projection.matrix * camera.GetView(), projection.reverseZ};
+		auto scene = generate_scene(camera.pos, 2'000, FAR_Z);
+		auto planes = frustum.GetPlanes();
+		// The unbounded far plane is left out
+		EXPECT_EQ(planes.size(), projection.hasFarPlane ? Frustum::PLANE_COUNT : (Frustum::PLANE_COUNT - 1));
+		for(auto &aabb : scene.aabbs) {
+			auto result = frustum.ClassifyAabb(aabb.min, aabb.max);
+			auto ref = pragma::math::intersection::aabb_in_plane_mesh(aabb.min, aabb.max, planes.begin(), planes.end());
+			EXPECT_TRUE(result == ref || touches_plane(frustum, (aabb.min + aabb.max) * 0.5f, (aabb.max - aabb.min) * 0.5f));
+		}
+		for(auto &sphere : scene.sphereList) {
+			auto result = frustum.ClassifySphere(sphere.origin, sphere.radius);
+			auto ref = pragma::math::intersection::sphere_in_plane_mesh(sphere.origin, sphere.radius, planes.begin(), planes.end());
+			EXPECT_TRUE(result == ref || touches_plane(frustum, sphere.origin, {}, sphere.radius));
+		}
+	}
+}
+
+TEST(FrustumCullingTests, PlaneMask)
+{
+	test::reset_random_generator();
+	auto camera = random_camera(50.f);
+	Frustum frustum {create_perspective(NEAR_Z, FAR_Z, false) * camera.GetView()};
+	uint8_t noPlanes = 0;
+	auto lastPlane = Frustum::INVALID_PLANE;
+	EXPECT_EQ(frustum.ClassifyAabb(camera.pos - Vector3 {1e4f}, camera.pos + Vector3 {1e4f}, noPlanes, lastPlane), Intersect::Inside);
+
+	auto scene = generate_scene(camera.pos, 2'000, FAR_Z);
+	for(auto &aabb : scene.aabbs) {
+		auto mask = Frustum::PLANE_MASK_ALL;
+		auto result = frustum.ClassifyAabb(aabb.min, aabb.max, mask, lastPlane);
+		if(result == Intersect::Outside) {
+			EXPECT_EQ(mask, Frustum::PLANE_MASK_ALL);
+			continue;
+		}
+		EXPECT_EQ(mask == 0, result == Intersect::Inside);
+		auto center = (aabb.min + aabb.max) * 0.5f;
+		auto extents = (aabb.max - aabb.min) * 0.5f;
+		for(uint32_t i = 0; i < Frustum::PLANE_COUNT; ++i) {
+			if(mask & (1u << i))
+				continue;
+			// The box is entirely inside of the cleared planes
+			auto &plane = frustum.GetPlaneVectors()[i];
+			EXPECT_LE(get_plane_distance(plane, center) + std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z, 0.f);
+		}
+
+		// The mask of the box is passed on to its octants, which must give the same results as the test against all planes
+		for(uint32_t i = 0; i < 8; ++i) {
+			auto childMin = Vector3 {(i & 1) ? center.x : aabb.min.x, (i & 2) ? center.y : aabb.min.y, (i & 4) ? center.z : aabb.min.z};
+			auto childMax = Vector3 {(i & 1) ? aabb.max.x : center.x, (i & 2) ? aabb.max.y : center.y, (i & 4) ? aabb.max.z : center.z};
+			auto childMask = mask;
+			auto childResult = frustum.ClassifyAabb(childMin, childMax, childMask, lastPlane);
+			EXPECT_TRUE(childResult == frustum.ClassifyAabb(childMin, childMax) || touches_plane(frustum, (childMin + childMax) * 0.5f, (childMax - childMin) * 0.5f));
+			EXPECT_EQ(childMask & ~mask, 0);
+		}
+	}
+}
+
+TEST(FrustumCullingTests, LastPlaneCache)
+{
+	test::reset_random_generator();
+	auto camera = random_camera(50.f);
+	Frustum frustum {create_perspective(NEAR_Z, FAR_Z, false) * camera.GetView()};
+	auto scene = generate_scene(camera.pos, 2'000, FAR_Z);
+	auto rejects = [&frustum](uint8_t plane, const Vector3 &origin, float radius) { return plane < Frustum::PLANE_COUNT && get_plane_distance(frustum.GetPlaneVectors()[plane], origin) - radius > 0.f; };
+	for(auto &sphere : scene.sphereList) {
+		auto mask = Frustum::PLANE_MASK_ALL;
+		auto lastPlane = Frustum::INVALID_PLANE;
+		auto result = frustum.ClassifySphere(sphere.origin, sphere.radius, mask, lastPlane);
+		EXPECT_EQ(result, frustum.ClassifySphere(sphere.origin, sphere.radius));
+		if(result != Intersect::Outside) {
+			EXPECT_EQ(lastPlane, Frustum::INVALID_PLANE);
+			// A cached plane that doesn't reject the volume has no effect
+			for(uint8_t plane = 0; plane < Frustum::PLANE_COUNT; ++plane) {
+				auto cachedPlane = plane;
+				mask = Frustum::PLANE_MASK_ALL;
+				EXPECT_EQ(frustum.ClassifySphere(sphere.origin, sphere.radius, mask, cachedPlane), result);
+				EXPECT_EQ(cachedPlane, plane);
+			}
+			continue;
+		}
+		ASSERT_TRUE(rejects(lastPlane, sphere.origin, sphere.radius));
+		// The cached plane is tested first and stays the same
+		auto cachedPlane = lastPlane;
+		mask = Frustum::PLANE_MASK_ALL;
+		EXPECT_EQ(frustum.ClassifySphere(sphere.origin, sphere.radius, mask, cachedPlane), Intersect::Outside);
+		EXPECT_EQ(cachedPlane, lastPlane);
+		// A stale cache is replaced by a plane that rejects the volume
+		for(uint8_t plane = 0; plane < Frustum::PLANE_COUNT; ++plane) {
+			if(rejects(plane, sphere.origin, sphere.radius))
+				continue;
+			cachedPlane = plane;
+			mask = Frustum::PLANE_MASK_ALL;
+			EXPECT_EQ(frustum.ClassifySphere(sphere.origin, sphere.radius, mask, cachedPlane), Intersect::Outside);
+			EXPECT_TRUE(rejects(cachedPlane, sphere.origin, sphere.radius));
+		}
+	}
+
+	// Batched culling with the cache gives the same results as without it, also if the cache is from a previous frame
+	auto view = scene.boxes.GetView();
+	std::vector<uint8_t> lastPlanes(view.count, Frustum::INVALID_PLANE);
+	std::vector<uint32_t> mask(pragma::math::intersection::get_hit_mask_size(view.count));
+	std::vector<uint32_t> refMask(mask.size());
+	for(uint32_t frame = 0; frame < 4; ++frame) {
+		if(frame > 0) {
+			camera.forward = uvec::get_normal(camera.forward + test::random_vector(-0.2f, 0.2f));
+			camera.up = uvec::get_normal(uvec::cross(camera.forward, uvec::cross(camera.up, camera.forward)));
+			frustum = Frustum {create_perspective(NEAR_Z, FAR_Z, false) * camera.GetView()};
+		}
+		auto numVisible = frustum.CullAabbs(view, mask.data(), lastPlanes.data());
+		EXPECT_EQ(numVisible, frustum.CullAabbs(view, refMask.data()));
+		EXPECT_EQ(mask, refMask);
+		for(size_t i = 0; i < view.count; ++i) {
+			if(is_bit_set(mask, i))
+				continue;
+			ASSERT_LT(lastPlanes[i], Frustum::PLANE_COUNT);
+			auto &plane = frustum.GetPlaneVectors()[lastPlanes[i]];
+			auto &aabb = scene.aabbs[i];
+			auto center = (aabb.min + aabb.max) * 0.5f;
+			auto extents = (aabb.max - aabb.min) * 0.5f;
+			auto dist = get_plane_distance(plane, center) - (std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z);
+			EXPECT_TRUE(dist > 0.f || touches_plane(frustum, center, extents));
+		}
+	}
+}
+
+TEST(FrustumCullingTests, CullMatchesClassify)
+{
+	test::reset_random_generator();
+	for(auto &projection : get_projections()) {
+		auto camera = random_camera(50.f);
+		Frustum frustum {projection.matrix * camera.GetView(), projection.reverseZ};
+		// Counts that are not multiples of the simd width, so that the last batch is partial
+		for(size_t count : {1, 7, 9, 31, 33, 1'003}) {
+			auto scene = generate_scene(camera.pos, count, FAR_Z * 0.5f);
+			std::vector<uint32_t> mask(pragma::math::intersection::get_hit_mask_size(count));
+			auto numVisible = frustum.CullAabbs(scene.boxes.GetView(), mask.data());
+			size_t refVisible = 0;
+			for(size_t i = 0; i < count; ++i) {
+				auto &aabb = scene.aabbs[i];
+				auto visible = frustum.ClassifyAabb(aabb.min, aabb.max) != Intersect::Outside;
+				EXPECT_TRUE(visible == is_bit_set(mask, i) || touches_plane(frustum, (aabb.min + aabb.max) * 0.5f, (aabb.max - aabb.min) * 0.5f));
+				refVisible += is_bit_set(mask, i) ? 1 : 0;
+			}
+			EXPECT_EQ(numVisible, refVisible);
+			// Bits past the end are cleared
+			if(count % 32 != 0) {
+				EXPECT_EQ(mask.back() >> (count % 32), 0u);
+			}
+
+			numVisible = frustum.CullSpheres(scene.spheres.GetView(), mask.data());
+			refVisible = 0;
+			for(size_t i = 0; i < count; ++i) {
+				auto &sphere = scene.sphereList[i];
+				auto visible = frustum.ClassifySphere(sphere.origin, sphere.radius) != Intersect::Outside;
+				EXPECT_TRUE(visible == is_bit_set(mask, i) || touches_plane(frustum, sphere.origin, {}, sphere.radius));
+				refVisible += is_bit_set(mask, i) ? 1 : 0;
+			}
+			EXPECT_EQ(numVisible, refVisible);
+		}
+	}
+}
+
+TEST(FrustumCullingTests, ParallelCullMatchesSerial)
+{
+	test::reset_random_generator();
+	auto camera = random_camera(50.f);
+	Frustum frustum {create_perspective(NEAR_Z, FAR_Z, false) * camera.GetView()};
+	// Several chunks of the parallel cull, the last one partial
+	auto scene = generate_scene(camera.pos, 20'011, FAR_Z);
+	auto boxes = scene.boxes.GetView();
+	auto spheres = scene.spheres.GetView();
+	std::vector<uint32_t> mask(pragma::math::intersection::get_hit_mask_size(boxes.count));
+	frustum.CullAabbs(boxes, mask.data());
+	std::vector<uint32_t> refAabbIndices;
+	for(uint32_t i = 0; i < boxes.count; ++i) {
+		if(is_bit_set(mask, i))
+			refAabbIndices.push_back(i);
+	}
+	frustum.CullSpheres(spheres, mask.data());
+	std::vector<uint32_t> refSphereIndices;
+	for(uint32_t i = 0; i < spheres.count; ++i) {
+		if(is_bit_set(mask, i))
+			refSphereIndices.push_back(i);
+	}
+	for(auto threadCount : {1u, 3u, 0u}) {
+		std::vector<uint32_t> indices;
+		EXPECT_EQ(frustum.CullAabbs(boxes, indices, threadCount), refAabbIndices.size());
+		EXPECT_EQ(indices, refAabbIndices);
+		EXPECT_EQ(frustum.CullSpheres(spheres, indices, threadCount), refSphereIndices.size());
+		EXPECT_EQ(indices, refSphereIndices);
+	}
+}
+
+TEST(FrustumCullingTests, MultiViewCull)
+{
+	test::reset_random_generator();
+	// Cubemap faces around a point, which overlap at the edges
+	auto pos = test::random_vector(-50.f, 50.f);
+	const std::array<std::pair<Vector3, Vector3>, 6> faces {std::pair {Vector3 {1.f, 0.f, 0.f}, Vector3 {0.f, -1.f, 0.f}}, std::pair {Vector3 {-1.f, 0.f, 0.f}, Vector3 {0.f, -1.f, 0.f}},
+	  std::pair {Vector3 {0.f, 1.f, 0.f}, Vector3 {0.f, 0.f, 1.f}}, std::pair {Vector3 {0.f, -1.f, 0.f}, Vector3 {0.f, 0.f, -1.f}}, std::pair {Vector3 {0.f, 0.f, 1.f}, Vector3 {0.f, -1.f, 0.f}},
+	  std::pair {Vector3 {0.f, 0.f, -1.f}, Vector3 {0.f, -1.f, 0.f}}};
+	std::vector<Frustum> frusta;
+	for(auto &[forward, up] : faces)
+		frusta.push_back(Frustum {create_perspective(NEAR_Z, FAR_Z, true, std::numbers::pi_v<float> * 0.5f, 1.f) * Camera {pos, forward, up}.GetView(), true});
+
+	auto scene = generate_scene(pos, 3'001, FAR_Z);
+	auto boxes = scene.boxes.GetView();
+	auto spheres = scene.spheres.GetView();
+	auto maskSize = pragma::math::intersection::get_hit_mask_size(boxes.count);
+	std::vector<uint32_t> masks(maskSize * frusta.size());
+	std::vector<size_t> counts(frusta.size());
+	std::vector<uint32_t> refMask(maskSize);
+	pragma::math::Frustum::CullAabbs(frusta.data(), static_cast<uint32_t>(frusta.size()), boxes, masks.data(), counts.data());
+	for(size_t i = 0; i < frusta.size(); ++i) {
+		EXPECT_EQ(counts[i], frusta[i].CullAabbs(boxes, refMask.data()));
+		EXPECT_TRUE(std::equal(refMask.begin(), refMask.end(), masks.begin() + i * maskSize));
+	}
+	pragma::math::Frustum::CullSpheres(frusta.data(), static_cast<uint32_t>(frusta.size()), spheres, masks.data(), counts.data());
+	for(size_t i = 0; i < frusta.size(); ++i) {
+		EXPECT_EQ(counts[i], frusta[i].CullSpheres(spheres, refMask.data()));
+		EXPECT_TRUE(std::equal(refMask.begin(), refMask.end(), masks.begin() + i * maskSize));
+	}
+	// The faces cover all directions, so every sphere within the far distance is visible in at least one of them
+	for(size_t i = 0; i < spheres.count; ++i) {
+		if(uvec::length(scene.sphereList[i].origin - pos) > FAR_Z - 20.f)
+			continue;
+		auto visible = false;
+		for(size_t j = 0; j < frusta.size(); ++j)
+			visible = visible || ((masks[j * maskSize + i / 32] & (1u << (i % 32))) != 0);
+		EXPECT_TRUE(visible);
+	}
+}
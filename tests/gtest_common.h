@@ -5,6 +5,12 @@
 #ifndef __GTEST_COMMON_H__
 #define __GTEST_COMMON_H__
 
+#include <cstdint>
+#include <random>
+#include <utility>
+
+import pragma.math;
+
 #define ANSI_TXT_GRN "\033[0;32m"
 #define ANSI_TXT_MGT "\033[0;35m" //Magenta
 #define ANSI_TXT_DFT "\033[0;0m" //Console default
@@ -12,5 +18,31 @@
 #define COUT_GTEST ANSI_TXT_GRN << GTEST_BOX //You could add the Default
 #define COUT_GTEST_MGT COUT_GTEST << ANSI_TXT_MGT
 
+namespace test {
+	// Random inputs are generated from a fixed seed, so that failures are reproducible
+	constexpr uint32_t SEED = 0x74657374;
+
+	inline std::mt19937 &get_random_generator()
+	{
+		static std::mt19937 gen {SEED};
+		return gen;
+	}
+	inline void reset_random_generator() { get_random_generator().seed(SEED); }
+	inline float random_float(float min, float max) { return std::uniform_real_distribution<float> {min, max}(get_random_generator()); }
+	// Returns a value in [min, max)
+	inline uint32_t random_uint(uint32_t min, uint32_t max) { return std::uniform_int_distribution<uint32_t> {min, max - 1}(get_random_generator()); }
+	inline Vector3 random_vector(float min, float max) { return {random_float(min, max), random_float(min, max), random_float(min, max)}; }
+	inline std::pair<Vector3, Vector3> random_aabb(float range, float maxExtent)
+	{
+		auto center = random_vector(-range, range);
+		auto extents = random_vector(0.1f, maxExtent);
+		return {center - extents, center + extents};
+	}
+	// Same as AABB::Intersects, boxes that touch are overlapping
+	inline bool aabb_overlap(const Vector3 &minA, const Vector3 &maxA, const Vector3 &minB, const Vector3 &maxB)
+	{
+		return minA.x <= maxB.x && maxA.x >= minB.x && minA.y <= maxB.y && maxA.y >= minB.y && minA.z <= maxB.z && maxA.z >= minB.z;
+	}
+};
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,468 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	using Result = pragma::math::intersection::Result;
+	using Ray = pragma::math::intersection::Ray;
+	using Intersect = pragma::math::intersection::Intersect;
+	using Sphere = bounding_volume::Sphere;
+	// Counts which are not a multiple of the SIMD width, so that the last batch is partial, and which end in the middle of a mask word
+	constexpr std::array<size_t, 15> BATCH_COUNTS {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 100, 197};
+	// Marks values that must not be written to
+	constexpr uint32_t SENTINEL_MASK = 0xDEADBEEF;
+	constexpr float SENTINEL_T = -12345.f;
+
+	// Rays which start on a face of a box they are parallel to produce NaN distances, which have to match as well
+	bool is_same_float(float a, float b) { return a == b || (std::isnan(a) && std::isnan(b)); }
+	bool is_bit_set(const std::vector<uint32_t> &mask, size_t i) { return (mask[i / 32] & (1u << (i % 32))) != 0; }
+	// Directions with components that are zero (of either sign), so that the ray is parallel to some of the slabs
+	Vector3 random_direction()
+	{
+		auto dir = test::random_vector(-1.f, 1.f);
+		for(uint8_t i = 0; i < 3; ++i) {
+			auto r = test::random_uint(0, 6);
+			if(r == 0)
+				dir[i] = 0.f;
+			else if(r == 1)
+				dir[i] = -0.f;
+		}
+		if(dir == Vector3 {})
+			dir.x = 1.f;
+		return dir;
+	}
+	// Boxes around the ray origin, some of which share a face with the origin
+	std::pair<Vector3, Vector3> random_box(const Vector3 &origin)
+	{
+		auto [min, max] = test::random_aabb(10.f, 5.f);
+		min += origin;
+		max += origin;
+		for(uint8_t i = 0; i < 3; ++i) {
+			auto r = test::random_uint(0, 10);
+			if(r == 0)
+				min[i] = origin[i];
+			else if(r == 1)
+				max[i] = origin[i];
+		}
+		return {min, max};
+	}
+
+	// Precision of the triangle tests, results which are closer than this to a decision boundary can differ between the scalar and the packet test
+	constexpr double TRIANGLE_MARGIN = 1e-4;
+	bool is_near(double a, double b) { return std::abs(a - b) < TRIANGLE_MARGIN * std::max(1.0, std::abs(a)); }
+	// Checks in double precision whether the ray passes close to an edge of the triangle, grazes it, or hits it close to tMin or tMax
+	bool is_ambiguous(const Vector3 &origin, const Vector3 &dir, const std::array<Vector3, 3> &tri, bool bCull, float tMin, float tMax)
+	{
+		auto cross = [](const std::array<double, 3> &a, const std::array<double, 3> &b) -> std::array<double, 3> { return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]}; };
+		auto dot = [](const std::array<double, 3> &a, const std::array<double, 3> &b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; };
+		auto sub = [](const Vector3 &a, const Vector3 &b) -> std::array<double, 3> { return {static_cast<double>(a.x) - b.x, static_cast<double>(a.y) - b.y, static_cast<double>(a.z) - b.z}; };
+		std::array<double, 3> d {dir.x, dir.y, dir.z};
+		auto e1 = sub(tri[1], tri[0]);
+		auto e2 = sub(tri[2], tri[0]);
+		auto p = cross(d, e2);
+		auto det = dot(e1, p);
+		if(std::abs(det) < 1e-3)
+			return true;
+		if(bCull && det < 0.0)
+			return false;
+		auto tv = sub(origin, tri[0]);
+		auto q = cross(tv, e1);
+		auto u = dot(tv, p) / det;
+		auto v = dot(d, q) / det;
+		auto t = dot(e2, q) / det;
+		auto m = TRIANGLE_MARGIN;
+		if(u < -m || v < -m || u + v > 1.0 + m)
+			return false;
+		if(u < m || v < m || u + v > 1.0 - m)
+			return true;
+		return is_near(t, tMin) || is_near(t, tMax);
+	}
+
+	// Planes around the origin facing outwards, with the plane centers moved along the plane so that they aren't on the normal
+	std::vector<pragma::math::Plane> random_plane_mesh(uint32_t count)
+	{
+		std::vector<pragma::math::Plane> planes;
+		for(uint32_t i = 0; i < count; ++i) {
+			Vector3 n;
+			do
+				n = test::random_vector(-1.f, 1.f);
+			while(uvec::length_sqr(n) < 0.01f);
+			n = uvec::get_normal(n);
+			auto center = n * test::random_float(1.f, 6.f) + uvec::cross(n, test::random_vector(-3.f, 3.f));
+			planes.push_back({n, center});
+		}
+		return planes;
+	}
+	// The batched test evaluates the distance in a different order, so spheres which touch a plane from either side may be classified differently
+	bool touches_plane(const Vector3 &origin, float radius, const std::vector<pragma::math::Plane> &planes)
+	{
+		for(auto &plane : planes) {
+			auto dist = plane.GetDistance(origin);
+			auto margin = 1e-4f * std::max(1.f, std::abs(dist));
+			if(std::abs(dist - radius) < margin || std::abs(dist + radius) < margin)
+				return true;
+		}
+		return false;
+	}
+};
+
+TEST(IntersectionBatchTests, LineAabbMatchesScalar)
+{
+	test::reset_random_generator();
+	for(uint32_t r = 0; r < 50; ++r) {
+		auto origin = test::random_vector(-10.f, 10.f);
+		Ray ray {origin, random_direction()};
+		std::vector<std::pair<Vector3, Vector3>> boxes;
+		pragma::math::AabbSoaBuffer buffer;
+		for(uint32_t i = 0; i < 200; ++i) {
+			auto [min, max] = random_box(origin);
+			boxes.push_back({min, max});
+			buffer.Add(min, max);
+		}
+		// Views which start in the middle of a batch
+		for(size_t offset : {0u, 1u, 3u}) {
+			for(auto count : BATCH_COUNTS) {
+				auto info = ::testing::Message() << "Ray " << r << ", offset " << offset << ", count " << count;
+				auto maskSize = pragma::math::intersection::get_hit_mask_size(count);
+				// One extra element to catch writes past the end, the mask words have to be cleared by line_aabb
+				std::vector<uint32_t> mask(maskSize + 1, SENTINEL_MASK);
+				std::vector<float> tMins(count + 1, SENTINEL_T);
+				std::vector<float> tMaxs(count + 1, SENTINEL_T);
+				auto numHits = pragma::math::intersection::line_aabb(ray, buffer.GetView(offset, count), mask.data(), tMins.data(), tMaxs.data());
+				EXPECT_EQ(mask.back(), SENTINEL_MASK) << info;
+				EXPECT_EQ(tMins.back(), SENTINEL_T) << info;
+				EXPECT_EQ(tMaxs.back(), SENTINEL_T) << info;
+				mask.pop_back();
+
+				size_t expectedHits = 0;
+				for(size_t i = 0; i < count; ++i) {
+					auto &[min, max] = boxes[offset + i];
+					float tMin, tMax;
+					auto hit = pragma::math::intersection::line_aabb(ray, min, max, &tMin, &tMax) == Result::Intersect;
+					// Same as the variant without a precomputed ray
+					float tMinRef, tMaxRef;
+					EXPECT_EQ(pragma::math::intersection::line_aabb(ray.origin, ray.dir, min, max, &tMinRef, &tMaxRef) == Result::Intersect, hit) << info << ", box " << i;
+					EXPECT_EQ(is_bit_set(mask, i), hit) << info << ", box " << i;
+					if(!hit)
+						continue;
+					++expectedHits;
+					EXPECT_TRUE(is_same_float(tMins[i], tMin)) << info << ", box " << i;
+					EXPECT_TRUE(is_same_float(tMaxs[i], tMax)) << info << ", box " << i;
+					EXPECT_TRUE(is_same_float(tMinRef, tMin)) << info << ", box " << i;
+					EXPECT_TRUE(is_same_float(tMaxRef, tMax)) << info << ", box " << i;
+				}
+				EXPECT_EQ(numHits, expectedHits) << info;
+				// Bits past the end of the view are cleared
+				for(size_t i = count; i < maskSize * 32; ++i)
+					EXPECT_FALSE(is_bit_set(mask, i)) << info << ", bit " << i;
+			}
+		}
+	}
+}
+
+TEST(IntersectionBatchTests, LineAabbParallelRay)
+{
+	// The ray is parallel to the x and z slabs, so it only hits boxes whose x and z ranges contain the origin
+	Ray ray {{1.f, 2.f, 3.f}, {0.f, 1.f, -0.f}};
+	std::vector<std::pair<std::pair<Vector3, Vector3>, bool>> cases {
+	  {{{0.f, 5.f, 2.f}, {2.f, 6.f, 4.f}}, true},    // In front of the origin
+	  {{{0.f, -6.f, 2.f}, {2.f, -5.f, 4.f}}, true},  // Behind the origin, the line is infinite
+	  {{{1.5f, 5.f, 2.f}, {2.f, 6.f, 4.f}}, false},  // Next to the ray in x
+	  {{{0.f, 5.f, 3.5f}, {2.f, 6.f, 4.f}}, false},  // Next to the ray in z
+	  {{{-2.f, 5.f, -4.f}, {0.5f, 6.f, 2.5f}}, false}, // Next to the ray in x and z
+	};
+	pragma::math::AabbSoaBuffer buffer;
+	for(auto &[box, hit] : cases)
+		buffer.Add(box.first, box.second);
+	std::vector<uint32_t> mask(1);
+	std::vector<float> tMins(cases.size());
+	EXPECT_EQ(pragma::math::intersection::line_aabb(ray, buffer.GetView(), mask.data(), tMins.data()), 2u);
+	for(size_t i = 0; i < cases.size(); ++i) {
+		auto &[box, hit] = cases[i];
+		EXPECT_EQ(is_bit_set(mask, i), hit) << "Box " << i;
+		EXPECT_EQ(pragma::math::intersection::line_aabb(ray, box.first, box.second, nullptr) == Result::Intersect, hit) << "Box " << i;
+	}
+	EXPECT_EQ(tMins[0], 3.f);
+	EXPECT_EQ(tMins[1], -8.f);
+}
+
+TEST(IntersectionBatchTests, LineAabbHitMaskLayout)
+{
+	// Box i is hit if i is a multiple of 3 or 7, bit i % 32 of word i / 32 has to be set for exactly these boxes
+	Ray ray {{0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}};
+	constexpr size_t count = 100;
+	pragma::math::AabbSoaBuffer buffer;
+	for(size_t i = 0; i < count; ++i) {
+		auto hit = (i % 3 == 0) || (i % 7 == 0);
+		auto y = hit ? 0.f : 10.f;
+		buffer.Add({static_cast<float>(i), y - 1.f, -1.f}, {static_cast<float>(i) + 0.5f, y + 1.f, 1.f});
+	}
+	std::vector<uint32_t> mask(pragma::math::intersection::get_hit_mask_size(count), SENTINEL_MASK);
+	ASSERT_EQ(mask.size(), 4u);
+	std::vector<float> tMins(count);
+	auto numHits = pragma::math::intersection::line_aabb(ray, buffer.GetView(), mask.data(), tMins.data());
+	std::array<uint32_t, 4> expectedMask {};
+	size_t expectedHits = 0;
+	for(size_t i = 0; i < count; ++i) {
+		if((i % 3 != 0) && (i % 7 != 0))
+			continue;
+		expectedMask[i / 32] |= 1u << (i % 32);
+		++expectedHits;
+		EXPECT_EQ(tMins[i], static_cast<float>(i));
+	}
+	EXPECT_EQ(numHits, expectedHits);
+	for(size_t i = 0; i < mask.size(); ++i)
+		EXPECT_EQ(mask[i], expectedMask[i]) << "Word " << i;
+	size_t numBits = 0;
+	for(auto word : mask)
+		numBits += std::popcount(word);
+	EXPECT_EQ(numBits, numHits);
+}
+
+TEST(IntersectionBatchTests, LineTriangleMatchesScalar)
+{
+	test::reset_random_generator();
+	std::vector<Vector3> verts;
+	std::vector<uint16_t> indices16;
+	std::vector<uint32_t> indices32;
+	for(uint32_t i = 0; i < 100; ++i) {
+		auto center = test::random_vector(-5.f, 5.f);
+		for(uint8_t j = 0; j < 3; ++j) {
+			indices16.push_back(static_cast<uint16_t>(verts.size()));
+			indices32.push_back(static_cast<uint32_t>(verts.size()));
+			verts.push_back(center + test::random_vector(-2.f, 2.f));
+		}
+	}
+	pragma::math::TriangleSoaBuffer buffer16 {verts, indices16};
+	pragma::math::TriangleSoaBuffer buffer32 {verts, indices32};
+	ASSERT_EQ(buffer16.Size(), 100u);
+	ASSERT_EQ(buffer32.Size(), 100u);
+	for(size_t i = 0; i < buffer16.Size(); ++i) {
+		auto tri16 = buffer16.Get(i);
+		auto tri32 = buffer32.Get(i);
+		for(uint8_t j = 0; j < 3; ++j) {
+			EXPECT_LT(uvec::distance(tri16[j], verts[i * 3 + j]), 1e-5f) << "Triangle " << i;
+			EXPECT_EQ(tri16[j], tri32[j]) << "Triangle " << i;
+		}
+	}
+
+	// The rays are aimed at the triangles, the aim point is at t = 1
+	std::vector<Vector3> origins;
+	std::vector<Vector3> dirs;
+	for(uint32_t i = 0; i < 197; ++i) {
+		origins.push_back(test::random_vector(-10.f, 10.f));
+		dirs.push_back(test::random_vector(-6.f, 6.f) - origins.back());
+	}
+
+	constexpr auto maxT = std::numeric_limits<float>::max();
+	std::vector<std::pair<float, float>> ranges {{0.f, maxT}, {0.5f, maxT}, {0.f, 0.8f}, {0.3f, 0.7f}, {-0.5f, 0.6f}, {std::numeric_limits<float>::lowest(), maxT}};
+	size_t numChecked = 0;
+	size_t numHitsChecked = 0;
+	size_t numTotal = 0;
+	for(auto bCull : {false, true}) {
+		for(auto &[tMin, tMax] : ranges) {
+			for(size_t numTris : {0u, 1u, 3u, 17u, 100u}) {
+				// Only the first numTris triangles of the buffer
+				auto view = (numTris % 2 == 0) ? buffer16.GetView() : buffer32.GetView();
+				view.count = numTris;
+				for(auto numRays : BATCH_COUNTS) {
+					auto info = ::testing::Message() << "Cull " << bCull << ", range [" << tMin << ", " << tMax << "), " << numTris << " triangles, " << numRays << " rays";
+					// One extra element to catch writes past the end
+					std::vector<pragma::math::intersection::RayPacketHit> hits(numRays + 1, {SENTINEL_T, SENTINEL_T, SENTINEL_T, 12345});
+					auto numHits = pragma::math::intersection::line_triangle(origins.data(), dirs.data(), numRays, view, hits.data(), bCull, tMin, tMax);
+					EXPECT_EQ(hits.back().t, SENTINEL_T) << info;
+					EXPECT_EQ(hits.back().triangleIndex, 12345u) << info;
+					hits.pop_back();
+					EXPECT_EQ(numHits, static_cast<size_t>(std::count_if(hits.begin(), hits.end(), [](auto &hit) { return hit.IsHit(); }))) << info;
+
+					for(size_t i = 0; i < numRays; ++i) {
+						++numTotal;
+						auto &hit = hits[i];
+						EXPECT_TRUE(hit.IsHit() || hit.triangleIndex == pragma::math::intersection::RayPacketHit::INVALID_TRIANGLE) << info << ", ray " << i;
+						// Nearest scalar hit in [tMin, tMax), the first one wins ties, same as in the packet test
+						auto refIndex = pragma::math::intersection::RayPacketHit::INVALID_TRIANGLE;
+						double refT = 0.0, refU = 0.0, refV = 0.0;
+						std::vector<double> hitTs;
+						auto ambiguous = false;
+						for(size_t j = 0; j < numTris; ++j) {
+							auto tri = buffer32.Get(j);
+							ambiguous = ambiguous || is_ambiguous(origins[i], dirs[i], tri, bCull, tMin, tMax);
+							double t, u, v;
+							if(!pragma::math::intersection::line_triangle(origins[i], dirs[i], tri[0], tri[1], tri[2], t, u, v, bCull) || t < tMin || t >= tMax)
+								continue;
+							hitTs.push_back(t);
+							if(refIndex != pragma::math::intersection::RayPacketHit::INVALID_TRIANGLE && t >= refT)
+								continue;
+							refIndex = static_cast<uint32_t>(j);
+							refT = t;
+							refU = u;
+							refV = v;
+						}
+						// Two triangles at nearly the same distance
+						std::sort(hitTs.begin(), hitTs.end());
+						if(hitTs.size() > 1 && is_near(hitTs[0], hitTs[1]))
+							ambiguous = true;
+						if(ambiguous)
+							continue;
+						++numChecked;
+						EXPECT_EQ(hit.triangleIndex, refIndex) << info << ", ray " << i;
+						if(!hit.IsHit() || hit.triangleIndex != refIndex)
+							continue;
+						++numHitsChecked;
+						EXPECT_NEAR(hit.t, refT, TRIANGLE_MARGIN * std::max(1.0, std::abs(refT))) << info << ", ray " << i;
+						EXPECT_NEAR(hit.u, refU, TRIANGLE_MARGIN) << info << ", ray " << i;
+						EXPECT_NEAR(hit.v, refV, TRIANGLE_MARGIN) << info << ", ray " << i;
+					}
+				}
+			}
+		}
+	}
+	// Make sure that the margins don't skip most of the rays, and that enough of the compared rays hit a triangle
+	EXPECT_GT(numChecked, numTotal * 3 / 4);
+	EXPECT_GT(numHitsChecked, numChecked / 20);
+}
+
+TEST(IntersectionBatchTests, LineTriangleRange)
+{
+	// Triangles in the plane x = c facing the -x direction, except for the one at x = 1, which faces +x and is culled for rays along +x
+	std::vector<float> planes {3.f, -2.f, 5.f, 1.f};
+	pragma::math::TriangleSoaBuffer buffer;
+	for(auto c : planes) {
+		if(c == 1.f)
+			buffer.Add({c, -1.f, -1.f}, {c, 2.f, -1.f}, {c, -1.f, 2.f});
+		else
+			buffer.Add({c, -1.f, -1.f}, {c, -1.f, 2.f}, {c, 2.f, -1.f});
+	}
+	// Five rays, so that the packet is partial for all SIMD widths. The last one misses all triangles.
+	std::vector<Vector3> origins {{0.f, 0.f, 0.f}, {-10.f, 0.f, 0.f}, {4.f, 0.f, 0.f}, {10.f, 0.f, 0.f}, {0.f, 5.f, 0.f}};
+	std::vector<Vector3> dirs(origins.size(), {1.f, 0.f, 0.f});
+	constexpr auto none = pragma::math::intersection::RayPacketHit::INVALID_TRIANGLE;
+	struct Case {
+		bool bCull;
+		float tMin;
+		float tMax;
+		std::array<uint32_t, 5> expected;
+	};
+	std::vector<Case> cases {
+	  {false, 0.f, std::numeric_limits<float>::max(), {3, 1, 2, none, none}},
+	  {true, 0.f, std::numeric_limits<float>::max(), {0, 1, 2, none, none}},
+	  {false, 1.5f, 3.f, {none, none, none, none, none}}, // tMax is exclusive
+	  {false, 3.f, 9.f, {0, 1, none, none, none}},        // tMin is inclusive
+	  {false, std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max(), {1, 1, 1, 1, none}},
+	  {true, -8.f, 0.f, {1, none, 1, 0, none}},
+	};
+	for(size_t c = 0; c < cases.size(); ++c) {
+		auto &testCase = cases[c];
+		std::vector<pragma::math::intersection::RayPacketHit> hits(origins.size());
+		auto numHits = pragma::math::intersection::line_triangle(origins.data(), dirs.data(), origins.size(), buffer.GetView(), hits.data(), testCase.bCull, testCase.tMin, testCase.tMax);
+		EXPECT_EQ(numHits, static_cast<size_t>(std::count_if(testCase.expected.begin(), testCase.expected.end(), [](uint32_t idx) { return idx != none; }))) << "Case " << c;
+		for(size_t i = 0; i < origins.size(); ++i) {
+			auto &hit = hits[i];
+			EXPECT_EQ(hit.triangleIndex, testCase.expected[i]) << "Case " << c << ", ray " << i;
+			if(!hit.IsHit() || hit.triangleIndex != testCase.expected[i])
+				continue;
+			EXPECT_NEAR(hit.t, planes[hit.triangleIndex] - origins[i].x, 1e-5f) << "Case " << c << ", ray " << i;
+			EXPECT_NEAR(hit.u, 1.f / 3.f, 1e-5f) << "Case " << c << ", ray " << i;
+			EXPECT_NEAR(hit.v, 1.f / 3.f, 1e-5f) << "Case " << c << ", ray " << i;
+		}
+	}
+}
+
+TEST(IntersectionBatchTests, SphereInPlaneMeshMatchesScalar)
+{
+	test::reset_random_generator();
+	// Half of the spheres are added one by one, the other half through the constructor
+	std::vector<Sphere> spheres;
+	for(uint32_t i = 0; i < 200; ++i)
+		spheres.push_back({test::random_vector(-8.f, 8.f), (i % 17 == 0) ? 0.f : test::random_float(0.1f, 3.f)});
+	pragma::math::SphereSoaBuffer buffer {std::vector<Sphere> {spheres.begin(), spheres.begin() + 100}};
+	for(size_t i = 100; i < spheres.size(); ++i)
+		buffer.Add(spheres[i].origin, spheres[i].radius);
+	ASSERT_EQ(buffer.Size(), spheres.size());
+	for(size_t i = 0; i < spheres.size(); ++i) {
+		auto sphere = buffer.Get(i);
+		EXPECT_EQ(sphere.origin, spheres[i].origin) << "Sphere " << i;
+		EXPECT_EQ(sphere.radius, spheres[i].radius) << "Sphere " << i;
+	}
+
+	size_t numChecked = 0;
+	size_t numTotal = 0;
+	std::array<size_t, 3> numPerResult {};
+	for(uint32_t numPlanes : {0u, 1u, 4u, 6u, 20u}) {
+		for(uint32_t p = 0; p < 5; ++p) {
+			auto planes = random_plane_mesh(numPlanes);
+			for(auto skipInsideTest : {false, true}) {
+				// Views which start in the middle of a batch
+				for(size_t offset : {0u, 1u, 3u}) {
+					for(auto count : BATCH_COUNTS) {
+						auto info = ::testing::Message() << numPlanes << " planes (" << p << "), skip inside test " << skipInsideTest << ", offset " << offset << ", count " << count;
+						// One extra element to catch writes past the end
+						std::vector<Intersect> results(count + 1, static_cast<Intersect>(0xAB));
+						auto numNotOutside = pragma::math::intersection::sphere_in_plane_mesh(buffer.GetView(offset, count), planes.data(), planes.size(), results.data(), skipInsideTest);
+						EXPECT_EQ(static_cast<uint8_t>(results.back()), 0xAB) << info;
+						results.pop_back();
+						EXPECT_EQ(numNotOutside, static_cast<size_t>(std::count_if(results.begin(), results.end(), [](Intersect r) { return r != Intersect::Outside; }))) << info;
+						for(size_t i = 0; i < count; ++i) {
+							++numTotal;
+							auto &sphere = spheres[offset + i];
+							EXPECT_TRUE(results[i] == Intersect::Outside || results[i] == Intersect::Inside || results[i] == Intersect::Overlap) << info << ", sphere " << i;
+							if(touches_plane(sphere.origin, sphere.radius, planes))
+								continue;
+							++numChecked;
+							auto expected = pragma::math::intersection::sphere_in_plane_mesh(sphere.origin, sphere.radius, planes.begin(), planes.end(), skipInsideTest);
+							EXPECT_EQ(results[i], expected) << info << ", sphere " << i;
+							++numPerResult[static_cast<uint8_t>(expected)];
+						}
+					}
+				}
+			}
+		}
+	}
+	EXPECT_GT(numChecked, numTotal * 9 / 10);
+	// All three results have to be covered
+	for(auto n : numPerResult)
+		EXPECT_GT(n, numChecked / 20);
+}
+
+TEST(IntersectionBatchTests, SphereInPlaneMeshCube)
+{
+	// Planes of the box [-1, 1]^3
+	std::vector<pragma::math::Plane> planes {
+	  {{1.f, 0.f, 0.f}, Vector3 {1.f, 0.f, 0.f}},
+	  {{-1.f, 0.f, 0.f}, Vector3 {-1.f, 0.f, 0.f}},
+	  {{0.f, 1.f, 0.f}, Vector3 {0.f, 1.f, 0.f}},
+	  {{0.f, -1.f, 0.f}, Vector3 {0.f, -1.f, 0.f}},
+	  {{0.f, 0.f, 1.f}, Vector3 {0.f, 0.f, 1.f}},
+	  {{0.f, 0.f, -1.f}, Vector3 {0.f, 0.f, -1.f}},
+	};
+	// Five spheres, so that the batch is partial for all SIMD widths
+	std::vector<std::pair<Sphere, Intersect>> cases {
+	  {{{0.f, 0.f, 0.f}, 0.5f}, Intersect::Inside},
+	  {{{1.f, 0.f, 0.f}, 0.5f}, Intersect::Overlap},
+	  {{{3.f, 0.f, -3.f}, 0.5f}, Intersect::Outside},
+	  {{{1.5f, 0.f, 0.f}, 0.5f}, Intersect::Overlap}, // Touches the box from the outside
+	  {{{0.f, 0.f, 0.f}, 5.f}, Intersect::Overlap},   // Contains the box
+	};
+	pragma::math::SphereSoaBuffer buffer;
+	for(auto &[sphere, expected] : cases)
+		buffer.Add(sphere.origin, sphere.radius);
+	for(auto skipInsideTest : {false, true}) {
+		std::vector<Intersect> results(cases.size());
+		EXPECT_EQ(pragma::math::intersection::sphere_in_plane_mesh(buffer.GetView(), planes.data(), planes.size(), results.data(), skipInsideTest), 4u);
+		for(size_t i = 0; i < cases.size(); ++i) {
+			auto &[sphere, expected] = cases[i];
+			// With skipInsideTest spheres which are inside are reported as overlapping
+			auto expectedResult = (skipInsideTest && expected == Intersect::Inside) ? Intersect::Overlap : expected;
+			EXPECT_EQ(results[i], expectedResult) << "Sphere " << i << ", skip inside test " << skipInsideTest;
+			EXPECT_EQ(pragma::math::intersection::sphere_in_plane_mesh(sphere.origin, sphere.radius, planes.begin(), planes.end(), skipInsideTest), expectedResult) << "Sphere " << i << ", skip inside test " << skipInsideTest;
+		}
+	}
+}
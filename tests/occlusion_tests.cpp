@@ -0,0 +1,296 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	using OcclusionBuffer = pragma::math::OcclusionBuffer;
+	constexpr float FOV = 1.2f;
+	// Not a multiple of the tile size, so that the last column and row of tiles is only partially on screen
+	constexpr uint32_t WIDTH = 200;
+	constexpr uint32_t HEIGHT = 120;
+	constexpr float ASPECT_RATIO = static_cast<float>(WIDTH) / static_cast<float>(HEIGHT);
+	constexpr float NEAR_Z = 0.5f;
+	constexpr float FAR_Z = 300.f;
+	// Depth and half size of the quad occluder, which covers x and y in [-QUAD_SIZE, QUAD_SIZE]
+	constexpr float QUAD_DEPTH = 10.f;
+	constexpr float QUAD_SIZE = 4.f;
+
+	// Right-handed perspective projection with a depth range of [0, 1]. The view matrix is the identity, so the camera looks down the negative z-axis.
+	Mat4 create_perspective(bool reverseZ)
+	{
+		auto f = 1.f / std::tan(FOV * 0.5f);
+		Mat4 m {0.f};
+		m[0][0] = f / ASPECT_RATIO;
+		m[1][1] = f;
+		m[2][3] = -1.f;
+		if(reverseZ) {
+			m[2][2] = NEAR_Z / (FAR_Z - NEAR_Z);
+			m[3][2] = (FAR_Z * NEAR_Z) / (FAR_Z - NEAR_Z);
+		}
+		else {
+			m[2][2] = FAR_Z / (NEAR_Z - FAR_Z);
+			m[3][2] = -(FAR_Z * NEAR_Z) / (FAR_Z - NEAR_Z);
+		}
+		return m;
+	}
+	// View-space x of the point at 'depth' in front of the camera which projects onto the horizontal screen coordinate px
+	float get_view_x(float px, float depth)
+	{
+		auto ndcX = px / static_cast<float>(WIDTH) * 2.f - 1.f;
+		return ndcX * depth / create_perspective(false)[0][0];
+	}
+
+	// Quad parallel to the screen, made of two triangles that share the diagonal from (-QUAD_SIZE, -QUAD_SIZE) to (QUAD_SIZE, QUAD_SIZE)
+	void add_quad(OcclusionBuffer &buffer, float rightEdge = QUAD_SIZE)
+	{
+		std::vector<Vector3> verts {{-QUAD_SIZE, -QUAD_SIZE, -QUAD_DEPTH}, {rightEdge, -QUAD_SIZE, -QUAD_DEPTH}, {rightEdge, QUAD_SIZE, -QUAD_DEPTH}, {-QUAD_SIZE, QUAD_SIZE, -QUAD_DEPTH}};
+		buffer.AddOccluder(verts, std::vector<uint16_t> {0, 1, 2, 0, 2, 3});
+	}
+	// Ground plane at y = -1.1, which starts behind the camera and crosses the near plane
+	void add_ground(OcclusionBuffer &buffer)
+	{
+		std::vector<Vector3> verts {{-9.7f, -1.1f, 2.f}, {9.7f, -1.1f, 2.f}, {9.7f, -1.1f, -50.f}, {-9.7f, -1.1f, -50.f}};
+		buffer.AddOccluder(verts, std::vector<uint32_t> {0, 1, 2, 0, 2, 3});
+	}
+	void rasterize(OcclusionBuffer &buffer, bool reverseZ, bool quad, bool ground)
+	{
+		buffer.Begin(create_perspective(reverseZ), reverseZ);
+		if(quad)
+			add_quad(buffer);
+		if(ground)
+			add_ground(buffer);
+		buffer.Rasterize();
+	}
+	std::pair<Vector3, Vector3> random_box()
+	{
+		auto center = Vector3 {test::random_float(-8.f, 8.f), test::random_float(-5.f, 5.f), test::random_float(-30.f, -2.f)};
+		auto extents = test::random_vector(0.05f, 1.5f);
+		return {center - extents, center + extents};
+	}
+	// Returns true if p is outside of the view frustum, or if the segment from the camera to p passes through the quad of add_quad before reaching p
+	bool is_hidden_by_quad(const Vector3 &p)
+	{
+		auto clipPos = create_perspective(false) * Vector4 {p, 1.f};
+		if(std::abs(clipPos.x) > clipPos.w || std::abs(clipPos.y) > clipPos.w || clipPos.z < 0.f || clipPos.z > clipPos.w)
+			return true;
+		if(p.z >= -QUAD_DEPTH)
+			return false;
+		auto t = QUAD_DEPTH / -p.z;
+		return std::abs(p.x * t) <= QUAD_SIZE && std::abs(p.y * t) <= QUAD_SIZE;
+	}
+};
+
+TEST(OcclusionTests, QuadOccluder)
+{
+	for(auto reverseZ : {false, true}) {
+		OcclusionBuffer buffer {WIDTH, HEIGHT};
+		rasterize(buffer, reverseZ, true, false);
+		// Behind the quad, away from the diagonal
+		EXPECT_FALSE(buffer.IsAabbVisible({1.f, -2.f, -20.f}, {2.f, -1.f, -18.f})) << "Reverse-Z " << reverseZ;
+		EXPECT_FALSE(buffer.IsAabbVisible({-3.f, 0.5f, -40.f}, {-1.f, 2.5f, -30.f})) << "Reverse-Z " << reverseZ;
+		// In front of the quad
+		EXPECT_TRUE(buffer.IsAabbVisible({1.f, -2.f, -6.f}, {2.f, -1.f, -5.f})) << "Reverse-Z " << reverseZ;
+		// Intersecting the quad
+		EXPECT_TRUE(buffer.IsAabbVisible({1.f, -2.f, -11.f}, {2.f, -1.f, -9.f})) << "Reverse-Z " << reverseZ;
+		// Beside the quad
+		EXPECT_TRUE(buffer.IsAabbVisible({10.f, -1.f, -20.f}, {11.f, 0.f, -18.f})) << "Reverse-Z " << reverseZ;
+		// Partially behind the quad
+		EXPECT_TRUE(buffer.IsAabbVisible({6.f, -1.f, -20.f}, {12.f, 0.f, -18.f})) << "Reverse-Z " << reverseZ;
+		// Outside of the screen and beyond the far plane
+		EXPECT_FALSE(buffer.IsAabbVisible({100.f, -1.f, -20.f}, {101.f, 0.f, -18.f})) << "Reverse-Z " << reverseZ;
+		EXPECT_FALSE(buffer.IsAabbVisible({-1.f, -1.f, -FAR_Z - 20.f}, {1.f, 1.f, -FAR_Z - 10.f})) << "Reverse-Z " << reverseZ;
+		// Entirely behind the camera, and intersecting the near plane
+		EXPECT_FALSE(buffer.IsAabbVisible({-1.f, -1.f, 1.f}, {1.f, 1.f, 2.f})) << "Reverse-Z " << reverseZ;
+		EXPECT_TRUE(buffer.IsAabbVisible({-1.f, -1.f, -20.f}, {1.f, 1.f, 1.f})) << "Reverse-Z " << reverseZ;
+	}
+}
+
+TEST(OcclusionTests, PartiallyCoveredPixelsDontOcclude)
+{
+	// The right edge of the quad lies at x = 133.8 on screen, which covers the center of pixel 133 but not all of it
+	OcclusionBuffer buffer {WIDTH, HEIGHT};
+	buffer.Begin(create_perspective(false));
+	add_quad(buffer, get_view_x(133.8f, QUAD_DEPTH));
+	buffer.Rasterize();
+	// The box covers x in [133.85, 133.95] on screen, which is within pixel 133, but not behind the quad
+	constexpr float nearDepth = 19.f;
+	constexpr float farDepth = 19.05f;
+	EXPECT_TRUE(buffer.IsAabbVisible({get_view_x(133.85f, farDepth), -0.5f, -farDepth}, {get_view_x(133.95f, nearDepth), 0.5f, -nearDepth}));
+	// Within pixel 130, which is entirely covered by the quad
+	EXPECT_FALSE(buffer.IsAabbVisible({get_view_x(130.2f, farDepth), -0.5f, -farDepth}, {get_view_x(130.8f, nearDepth), 0.5f, -nearDepth}));
+}
+
+TEST(OcclusionTests, HiddenBoxesAreBehindOccluder)
+{
+	test::reset_random_generator();
+	OcclusionBuffer buffer {WIDTH, HEIGHT};
+	rasterize(buffer, false, true, false);
+	uint32_t numHidden = 0;
+	for(uint32_t i = 0; i < 5'000; ++i) {
+		auto [min, max] = random_box();
+		if(buffer.IsAabbVisible(min, max))
+			continue;
+		++numHidden;
+		// Every point of a hidden box has to be behind the quad or off screen
+		constexpr uint32_t numSteps = 4;
+		for(uint32_t s = 0; s < (numSteps + 1) * (numSteps + 1) * (numSteps + 1); ++s) {
+			auto f = Vector3 {static_cast<float>(s % (numSteps + 1)), static_cast<float>((s / (numSteps + 1)) % (numSteps + 1)), static_cast<float>(s / ((numSteps + 1) * (numSteps + 1)))} / static_cast<float>(numSteps);
+			auto p = min + (max - min) * f;
+			if(!is_hidden_by_quad(p)) {
+				ADD_FAILURE() << "Box " << i << " is hidden, but point (" << p.x << ", " << p.y << ", " << p.z << ") is not behind the quad";
+				break;
+			}
+		}
+	}
+	EXPECT_GT(numHidden, 100u);
+}
+
+TEST(OcclusionTests, OccluderCrossingNearPlane)
+{
+	for(auto reverseZ : {false, true}) {
+		OcclusionBuffer buffer {WIDTH, HEIGHT};
+		rasterize(buffer, reverseZ, false, true);
+		// Below the ground
+		EXPECT_FALSE(buffer.IsAabbVisible({-1.f, -3.f, -12.f}, {1.f, -2.f, -10.f})) << "Reverse-Z " << reverseZ;
+		EXPECT_FALSE(buffer.IsAabbVisible({-0.5f, -2.f, -2.f}, {0.5f, -1.5f, -1.f})) << "Reverse-Z " << reverseZ;
+		// Above the ground
+		EXPECT_TRUE(buffer.IsAabbVisible({-1.f, -0.5f, -12.f}, {1.f, 0.5f, -10.f})) << "Reverse-Z " << reverseZ;
+		// Standing on the ground
+		EXPECT_TRUE(buffer.IsAabbVisible({-1.f, -2.f, -12.f}, {1.f, 0.f, -10.f})) << "Reverse-Z " << reverseZ;
+	}
+}
+
+TEST(OcclusionTests, DepthIsFarthestWithinPixel)
+{
+	for(auto reverseZ : {false, true}) {
+		OcclusionBuffer buffer {WIDTH, HEIGHT};
+		rasterize(buffer, reverseZ, false, true);
+		auto proj = create_perspective(false);
+		// Normalized depth of the ground at the pixel corner (x, y), or 1 if the ray through it doesn't hit the ground
+		auto get_ground_depth = [&proj](uint32_t x, uint32_t y) {
+			auto ndcX = static_cast<float>(x) / static_cast<float>(WIDTH) * 2.f - 1.f;
+			auto ndcY = static_cast<float>(y) / static_cast<float>(HEIGHT) * 2.f - 1.f;
+			if(ndcY >= 0.f)
+				return 1.f;
+			auto dir = Vector3 {ndcX / proj[0][0], ndcY / proj[1][1], -1.f};
+			auto p = dir * (-1.1f / dir.y);
+			auto clipPos = proj * Vector4 {p, 1.f};
+			return std::min(clipPos.z / clipPos.w, 1.f);
+		};
+		uint32_t numCovered = 0;
+		auto *depths = buffer.GetDepths(0);
+		for(uint32_t y = 0; y < HEIGHT; ++y) {
+			for(uint32_t x = 0; x < WIDTH; ++x) {
+				auto depth = depths[y * buffer.GetMipWidth(0) + x];
+				if(depth >= 1.f)
+					continue;
+				++numCovered;
+				auto farthest = std::max({get_ground_depth(x, y), get_ground_depth(x + 1, y), get_ground_depth(x, y + 1), get_ground_depth(x + 1, y + 1)});
+				EXPECT_GE(depth, farthest - 1e-5f) << "Pixel (" << x << ", " << y << "), reverse-Z " << reverseZ;
+			}
+		}
+		EXPECT_GT(numCovered, WIDTH * HEIGHT / 4) << "Reverse-Z " << reverseZ;
+	}
+}
+
+TEST(OcclusionTests, ReverseZMatchesForwardZ)
+{
+	test::reset_random_generator();
+	OcclusionBuffer forward {WIDTH, HEIGHT};
+	OcclusionBuffer reverse {WIDTH, HEIGHT};
+	rasterize(forward, false, true, true);
+	rasterize(reverse, true, true, true);
+	ASSERT_EQ(forward.GetMipCount(), reverse.GetMipCount());
+	for(uint32_t level = 0; level < forward.GetMipCount(); ++level) {
+		auto numTexels = forward.GetMipWidth(level) * forward.GetMipHeight(level);
+		for(uint32_t i = 0; i < numTexels; ++i)
+			ASSERT_NEAR(forward.GetDepths(level)[i], reverse.GetDepths(level)[i], 1e-4f) << "Level " << level << ", texel " << i;
+	}
+
+	uint32_t numCompared = 0;
+	for(uint32_t i = 0; i < 2'000; ++i) {
+		auto [min, max] = random_box();
+		// Boxes whose visibility changes if they are shrunk or grown slightly may be decided differently due to rounding
+		auto center = (min + max) * 0.5f;
+		auto extents = (max - min) * 0.5f;
+		auto visible = forward.IsAabbVisible(min, max);
+		if(forward.IsAabbVisible(center - extents * 0.99f, center + extents * 0.99f) != visible || forward.IsAabbVisible(center - extents * 1.01f, center + extents * 1.01f) != visible)
+			continue;
+		++numCompared;
+		EXPECT_EQ(reverse.IsAabbVisible(min, max), visible) << "Box " << i;
+	}
+	EXPECT_GT(numCompared, 1'900u);
+}
+
+TEST(OcclusionTests, MipLevelsAreMaxOfLevelBelow)
+{
+	OcclusionBuffer buffer {WIDTH, HEIGHT};
+	rasterize(buffer, false, true, true);
+	ASSERT_EQ(buffer.GetMipWidth(0), ((WIDTH + OcclusionBuffer::TILE_SIZE - 1) / OcclusionBuffer::TILE_SIZE) * OcclusionBuffer::TILE_SIZE);
+	ASSERT_EQ(buffer.GetMipHeight(0), ((HEIGHT + OcclusionBuffer::TILE_SIZE - 1) / OcclusionBuffer::TILE_SIZE) * OcclusionBuffer::TILE_SIZE);
+	auto last = buffer.GetMipCount() - 1;
+	EXPECT_EQ(buffer.GetMipWidth(last), 1u);
+	EXPECT_EQ(buffer.GetMipHeight(last), 1u);
+
+	// The occluders have to cover some pixels for the comparison to be meaningful
+	auto *depths0 = buffer.GetDepths(0);
+	EXPECT_LT(*std::min_element(depths0, depths0 + buffer.GetMipWidth(0) * buffer.GetMipHeight(0)), 1.f);
+	for(uint32_t level = 1; level < buffer.GetMipCount(); ++level) {
+		auto srcWidth = buffer.GetMipWidth(level - 1);
+		auto srcHeight = buffer.GetMipHeight(level - 1);
+		auto *src = buffer.GetDepths(level - 1);
+		auto *dst = buffer.GetDepths(level);
+		ASSERT_EQ(buffer.GetMipWidth(level), (srcWidth + 1) / 2);
+		ASSERT_EQ(buffer.GetMipHeight(level), (srcHeight + 1) / 2);
+		for(uint32_t y = 0; y < buffer.GetMipHeight(level); ++y) {
+			for(uint32_t x = 0; x < buffer.GetMipWidth(level); ++x) {
+				auto x1 = std::min(x * 2 + 1, srcWidth - 1);
+				auto y1 = std::min(y * 2 + 1, srcHeight - 1);
+				auto expected = std::max({src[y * 2 * srcWidth + x * 2], src[y * 2 * srcWidth + x1], src[y1 * srcWidth + x * 2], src[y1 * srcWidth + x1]});
+				EXPECT_EQ(dst[y * buffer.GetMipWidth(level) + x], expected) << "Level " << level << ", texel (" << x << ", " << y << ")";
+			}
+		}
+	}
+}
+
+TEST(OcclusionTests, CullAabbsMatchesIsAabbVisible)
+{
+	test::reset_random_generator();
+	OcclusionBuffer buffer {WIDTH, HEIGHT};
+	rasterize(buffer, false, true, true);
+	// Not a multiple of 32, so that the last word of the mask is only partially used
+	std::vector<bounding_volume::AABB> aabbs;
+	for(uint32_t i = 0; i < 2'500; ++i) {
+		auto [min, max] = random_box();
+		aabbs.push_back({min, max});
+	}
+	pragma::math::AabbSoaBuffer boxes {aabbs};
+	std::vector<uint32_t> expectedIndices;
+	for(uint32_t i = 0; i < aabbs.size(); ++i) {
+		if(buffer.IsAabbVisible(aabbs[i].min, aabbs[i].max))
+			expectedIndices.push_back(i);
+	}
+	ASSERT_GT(expectedIndices.size(), 0u);
+	ASSERT_LT(expectedIndices.size(), aabbs.size());
+
+	std::vector<uint32_t> mask(pragma::math::intersection::get_hit_mask_size(aabbs.size()), 0xFFFFFFFFu);
+	EXPECT_EQ(buffer.CullAabbs(boxes.GetView(), mask.data()), expectedIndices.size());
+	std::vector<uint32_t> maskIndices;
+	for(uint32_t i = 0; i < mask.size() * 32; ++i) {
+		if(mask[i / 32] & (1u << (i % 32)))
+			maskIndices.push_back(i);
+	}
+	EXPECT_EQ(maskIndices, expectedIndices);
+
+	for(uint32_t threadCount : {1u, 3u, 0u}) {
+		std::vector<uint32_t> indices {12345u};
+		EXPECT_EQ(buffer.CullAabbs(boxes.GetView(), indices, threadCount), expectedIndices.size()) << "Thread count " << threadCount;
+		EXPECT_EQ(indices, expectedIndices) << "Thread count " << threadCount;
+	}
+}
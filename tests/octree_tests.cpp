@@ -0,0 +1,363 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	using LooseOctree = pragma::math::LooseOctree;
+	using ItemId = LooseOctree::ItemId;
+	using Intersect = pragma::math::intersection::Intersect;
+	using Plane = pragma::math::Plane;
+	constexpr float HALF_SIZE = 100.f;
+	constexpr uint32_t MAX_DEPTH = 6;
+	constexpr float LOOSENESS = 2.f;
+
+	struct Item {
+		bounding_volume::AABB aabb;
+		uint64_t userData = 0;
+	};
+	float get_max_extent(const bounding_volume::AABB &aabb)
+	{
+		auto e = (aabb.max - aabb.min) * 0.5f;
+		return std::max({e.x, e.y, e.z});
+	}
+	bool aabb_contains(const Vector3 &outerMin, const Vector3 &outerMax, const bounding_volume::AABB &inner)
+	{
+		return outerMin.x <= inner.min.x && outerMin.y <= inner.min.y && outerMin.z <= inner.min.z && inner.max.x <= outerMax.x && inner.max.y <= outerMax.y && inner.max.z <= outerMax.z;
+	}
+
+	// Mirror of the octree contents, used as the brute-force reference
+	struct Scene {
+		LooseOctree tree {Vector3 {}, HALF_SIZE, MAX_DEPTH, LOOSENESS};
+		std::unordered_map<ItemId, Item> items;
+		uint64_t nextUserData = 1;
+
+		// Mostly small boxes, but also boxes that are larger than the nodes they are centered in, boxes that don't fit into
+		// the root node and boxes that are centered outside of it
+		bounding_volume::AABB RandomAabb() const
+		{
+			auto type = test::random_uint(0, 20);
+			auto range = (type == 0) ? HALF_SIZE * 1.5f : HALF_SIZE;
+			auto maxExtent = (type == 1) ? HALF_SIZE * 1.5f : ((type < 5) ? 30.f : 3.f);
+			auto [min, max] = test::random_aabb(range, maxExtent);
+			return {min, max};
+		}
+		void Insert()
+		{
+			auto aabb = RandomAabb();
+			auto userData = nextUserData++;
+			auto id = tree.Insert(aabb, userData);
+			ASSERT_EQ(items.find(id), items.end());
+			items[id] = {aabb, userData};
+		}
+		void Remove(ItemId id)
+		{
+			tree.Remove(id);
+			items.erase(id);
+		}
+		void Update(ItemId id)
+		{
+			auto &item = items[id];
+			switch(test::random_uint(0, 3)) {
+			case 0:
+				{
+					// Small movements, which mostly keep the item in its node
+					auto displacement = test::random_vector(-0.5f, 0.5f);
+					item.aabb = {item.aabb.min + displacement, item.aabb.max + displacement};
+					break;
+				}
+			case 1:
+				item.aabb = RandomAabb();
+				break;
+			default:
+				{
+					auto center = (item.aabb.min + item.aabb.max) * 0.5f;
+					auto extents = (item.aabb.max - item.aabb.min) * (0.5f * test::random_float(0.5f, 2.f));
+					item.aabb = {center - extents, center + extents};
+					break;
+				}
+			}
+			tree.Update(id, item.aabb);
+		}
+		ItemId RandomItem() const
+		{
+			auto it = items.begin();
+			std::advance(it, test::random_uint(0, static_cast<uint32_t>(items.size())));
+			return it->first;
+		}
+	};
+
+	// Checks the links and counts of all nodes, and that every item is stored in exactly one node whose cell contains its center
+	// and whose loose bounds contain the item, or in the list of items outside of the octree if it doesn't fit into the root node
+	void validate_tree(const Scene &scene)
+	{
+		auto &tree = scene.tree;
+		auto &nodes = tree.GetNodes();
+		auto &items = tree.GetItems();
+		ASSERT_EQ(tree.GetItemCount(), scene.items.size());
+		ASSERT_FALSE(nodes.empty());
+		EXPECT_EQ(nodes.front().parent, LooseOctree::INVALID_INDEX);
+		EXPECT_EQ(nodes.front().halfSize, HALF_SIZE);
+
+		size_t numLinkedItems = 0;
+		uint32_t numNodes = 0;
+		std::vector<uint32_t> stack {0};
+		while(!stack.empty()) {
+			auto nodeIndex = stack.back();
+			stack.pop_back();
+			auto &node = nodes[nodeIndex];
+			++numNodes;
+			EXPECT_LE(node.depth, MAX_DEPTH);
+			if(nodeIndex != 0)
+				EXPECT_GT(node.subtreeItemCount, 0u) << "Empty nodes have to be freed";
+
+			auto [looseMin, looseMax] = tree.GetLooseBounds(node);
+			uint32_t numItems = 0;
+			auto prev = LooseOctree::INVALID_INDEX;
+			for(auto itemId = node.firstItem; itemId != LooseOctree::INVALID_INDEX; itemId = items[itemId].next) {
+				auto &item = items[itemId];
+				EXPECT_TRUE(item.valid);
+				EXPECT_EQ(item.node, nodeIndex);
+				EXPECT_EQ(item.prev, prev);
+				prev = itemId;
+				++numItems;
+				auto it = scene.items.find(itemId);
+				ASSERT_NE(it, scene.items.end());
+				EXPECT_EQ(item.userData, it->second.userData);
+				EXPECT_EQ(item.aabb.min, it->second.aabb.min);
+				EXPECT_EQ(item.aabb.max, it->second.aabb.max);
+				auto d = (item.aabb.min + item.aabb.max) * 0.5f - node.center;
+				EXPECT_TRUE(std::abs(d.x) <= node.halfSize && std::abs(d.y) <= node.halfSize && std::abs(d.z) <= node.halfSize);
+				EXPECT_TRUE(aabb_contains(looseMin, looseMax, item.aabb));
+			}
+			EXPECT_EQ(node.itemCount, numItems);
+			numLinkedItems += numItems;
+
+			auto subtreeItemCount = node.itemCount;
+			for(uint32_t i = 0; i < node.children.size(); ++i) {
+				auto childIndex = node.children[i];
+				if(childIndex == LooseOctree::INVALID_INDEX)
+					continue;
+				auto &child = nodes[childIndex];
+				EXPECT_EQ(child.parent, nodeIndex);
+				EXPECT_EQ(child.depth, node.depth + 1);
+				EXPECT_EQ(child.halfSize, node.halfSize * 0.5f);
+				auto offset = node.halfSize * 0.5f;
+				auto expectedCenter = node.center + Vector3 {(i & 1) ? offset : -offset, (i & 2) ? offset : -offset, (i & 4) ? offset : -offset};
+				EXPECT_EQ(child.center, expectedCenter);
+				subtreeItemCount += child.subtreeItemCount;
+				stack.push_back(childIndex);
+			}
+			EXPECT_EQ(node.subtreeItemCount, subtreeItemCount);
+		}
+		EXPECT_EQ(tree.GetNodeCount(), numNodes);
+
+		// The remaining items don't fit into the root node
+		size_t numOutsideItems = 0;
+		for(auto &[id, item] : scene.items) {
+			if(items[id].node != LooseOctree::INVALID_INDEX)
+				continue;
+			++numOutsideItems;
+			auto d = (item.aabb.min + item.aabb.max) * 0.5f;
+			auto fitsRoot = std::abs(d.x) <= HALF_SIZE && std::abs(d.y) <= HALF_SIZE && std::abs(d.z) <= HALF_SIZE && get_max_extent(item.aabb) <= (LOOSENESS - 1.f) * HALF_SIZE;
+			EXPECT_FALSE(fitsRoot);
+		}
+		EXPECT_EQ(numLinkedItems + numOutsideItems, scene.items.size());
+	}
+
+	// Returns the sorted user data of all items reported by the query
+	template<typename TQuery>
+	std::vector<uint64_t> run_query(const Scene &scene, const TQuery &query)
+	{
+		std::vector<uint64_t> result;
+		query([&result, &scene](ItemId id) { result.push_back(scene.tree.GetUserData(id)); });
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+	template<typename TFilter>
+	std::vector<uint64_t> brute_force_query(const Scene &scene, const TFilter &filter)
+	{
+		std::vector<uint64_t> result;
+		for(auto &[id, item] : scene.items) {
+			if(filter(item.aabb))
+				result.push_back(item.userData);
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+	// Planes of the box min, max
+	std::vector<Plane> get_box_planes(const Vector3 &min, const Vector3 &max)
+	{
+		return {Plane {{1.f, 0.f, 0.f}, max.x}, Plane {{-1.f, 0.f, 0.f}, -min.x}, Plane {{0.f, 1.f, 0.f}, max.y}, Plane {{0.f, -1.f, 0.f}, -min.y}, Plane {{0.f, 0.f, 1.f}, max.z}, Plane {{0.f, 0.f, -1.f}, -min.z}};
+	}
+	pragma::math::Frustum random_frustum()
+	{
+		auto pos = test::random_vector(-HALF_SIZE * 1.2f, HALF_SIZE * 1.2f);
+		auto forward = uvec::get_normal(test::random_vector(-1.f, 1.f));
+		auto up = uvec::get_normal(uvec::cross(forward, (std::abs(forward.y) < 0.9f) ? Vector3 {0.f, 1.f, 0.f} : Vector3 {1.f, 0.f, 0.f}));
+		return pragma::math::Frustum::CreatePerspective(pos, forward, up, test::random_float(0.5f, 2.f), 16.f / 9.f, 0.1f, test::random_float(20.f, 300.f));
+	}
+
+	// Returns the number of plane queries in which the loose bounds of at least one node with items were entirely inside of the planes,
+	// i.e. in which the subtree of that node was accepted without testing its items
+	uint32_t compare_queries(const Scene &scene, uint32_t numQueries)
+	{
+		uint32_t numEarlyAccepts = 0;
+		auto comparePlaneQuery = [&scene, &numEarlyAccepts](const std::vector<Plane> &planes) {
+			auto result = run_query(scene, [&scene, &planes](const auto &callback) { scene.tree.QueryPlaneMesh(planes.begin(), planes.end(), callback); });
+			auto ref = brute_force_query(scene, [&planes](const bounding_volume::AABB &aabb) { return pragma::math::intersection::aabb_in_plane_mesh(aabb.min, aabb.max, planes.begin(), planes.end()) != Intersect::Outside; });
+			EXPECT_EQ(result, ref);
+			for(auto &node : scene.tree.GetNodes()) {
+				auto [looseMin, looseMax] = scene.tree.GetLooseBounds(node);
+				if(node.subtreeItemCount > 0 && pragma::math::intersection::aabb_in_plane_mesh(looseMin, looseMax, planes.begin(), planes.end()) == Intersect::Inside) {
+					++numEarlyAccepts;
+					break;
+				}
+			}
+		};
+		for(uint32_t q = 0; q < numQueries; ++q) {
+			auto [min, max] = test::random_aabb(HALF_SIZE * 1.2f, 40.f);
+			auto result = run_query(scene, [&scene, &min, &max](const auto &callback) { scene.tree.QueryAabb(min, max, callback); });
+			auto ref = brute_force_query(scene, [&min, &max](const bounding_volume::AABB &aabb) { return test::aabb_overlap(aabb.min, aabb.max, min, max); });
+			EXPECT_EQ(result, ref);
+
+			comparePlaneQuery(random_frustum().GetPlanes());
+			// Boxes that contain large parts of the octree
+			auto [boxMin, boxMax] = test::random_aabb(HALF_SIZE * 0.5f, HALF_SIZE * 1.2f);
+			comparePlaneQuery(get_box_planes(boxMin, boxMax));
+		}
+		return numEarlyAccepts;
+	}
+};
+
+TEST(OctreeTests, InsertAndQuery)
+{
+	test::reset_random_generator();
+	Scene scene;
+	for(uint32_t i = 0; i < 2'000; ++i)
+		scene.Insert();
+	validate_tree(scene);
+	EXPECT_GT(compare_queries(scene, 100), 50u);
+}
+
+TEST(OctreeTests, Churn)
+{
+	test::reset_random_generator();
+	Scene scene;
+	for(uint32_t i = 0; i < 500; ++i)
+		scene.Insert();
+	for(uint32_t round = 0; round < 30; ++round) {
+		for(uint32_t i = 0; i < 200; ++i) {
+			auto op = test::random_uint(0, 4);
+			if(op == 0 || scene.items.empty())
+				scene.Insert();
+			else if(op == 1)
+				scene.Remove(scene.RandomItem());
+			else
+				scene.Update(scene.RandomItem());
+		}
+		validate_tree(scene);
+		compare_queries(scene, 5);
+	}
+
+	// Removing everything frees all nodes apart from the root
+	while(!scene.items.empty())
+		scene.Remove(scene.RandomItem());
+	validate_tree(scene);
+	EXPECT_EQ(scene.tree.GetNodeCount(), 1u);
+	EXPECT_EQ(scene.tree.GetNodes().front().subtreeItemCount, 0u);
+	EXPECT_EQ(compare_queries(scene, 5), 0u);
+	// and the freed items and nodes are reused
+	auto numItems = scene.tree.GetItems().size();
+	auto numNodes = scene.tree.GetNodes().size();
+	for(uint32_t i = 0; i < 100; ++i)
+		scene.Insert();
+	validate_tree(scene);
+	EXPECT_EQ(scene.tree.GetItems().size(), numItems);
+	EXPECT_EQ(scene.tree.GetNodes().size(), numNodes);
+	compare_queries(scene, 5);
+}
+
+TEST(OctreeTests, ItemsLargerThanNodes)
+{
+	Scene scene;
+	auto insert = [&scene](const Vector3 &center, float extent) {
+		bounding_volume::AABB aabb {center - Vector3 {extent}, center + Vector3 {extent}};
+		auto id = scene.tree.Insert(aabb, scene.nextUserData);
+		scene.items[id] = {aabb, scene.nextUserData++};
+		return id;
+	};
+	auto getNode = [&scene](ItemId id) { return scene.tree.GetItems()[id].node; };
+	auto getDepth = [&scene, &getNode](ItemId id) { return scene.tree.GetNodes()[getNode(id)].depth; };
+	// Too large for the children of the root, but fits into the loose bounds of the root
+	auto rootItem = insert({10.f, -20.f, 30.f}, HALF_SIZE * 0.8f);
+	EXPECT_EQ(getNode(rootItem), 0u);
+	// Too large for the root
+	auto largeItem = insert({}, HALF_SIZE * 1.5f);
+	EXPECT_EQ(getNode(largeItem), LooseOctree::INVALID_INDEX);
+	// Centered outside of the root
+	auto outsideItem = insert({HALF_SIZE * 1.2f, 0.f, 0.f}, 1.f);
+	EXPECT_EQ(getNode(outsideItem), LooseOctree::INVALID_INDEX);
+	// Small items are stored at the maximum depth, medium ones in between
+	auto smallItem = insert({-50.f, 50.f, -50.f}, 0.1f);
+	EXPECT_EQ(getDepth(smallItem), MAX_DEPTH);
+	auto mediumItem = insert({-50.f, 50.f, -50.f}, HALF_SIZE * 0.2f);
+	EXPECT_EQ(getDepth(mediumItem), 2u);
+	validate_tree(scene);
+
+	// All of them are found by queries that only touch their corners
+	for(auto id : {rootItem, largeItem, outsideItem, smallItem, mediumItem}) {
+		auto &aabb = scene.items[id].aabb;
+		auto touched = run_query(scene, [&scene, &aabb](const auto &callback) { scene.tree.QueryAabb(aabb.max, aabb.max + Vector3 {1.f}, callback); });
+		EXPECT_TRUE(std::find(touched.begin(), touched.end(), scene.items[id].userData) != touched.end());
+		auto planes = get_box_planes(aabb.min - Vector3 {1.f}, aabb.min);
+		touched = run_query(scene, [&scene, &planes](const auto &callback) { scene.tree.QueryPlaneMesh(planes.begin(), planes.end(), callback); });
+		EXPECT_TRUE(std::find(touched.begin(), touched.end(), scene.items[id].userData) != touched.end());
+	}
+	test::reset_random_generator();
+	compare_queries(scene, 20);
+
+	// Growing an item moves it up the tree, shrinking it moves it back down, and items can move in and out of the octree
+	auto update = [&scene](ItemId id, const Vector3 &center, float extent) {
+		scene.items[id].aabb = {center - Vector3 {extent}, center + Vector3 {extent}};
+		scene.tree.Update(id, scene.items[id].aabb);
+	};
+	update(smallItem, {-50.f, 50.f, -50.f}, HALF_SIZE * 0.8f);
+	EXPECT_EQ(getNode(smallItem), 0u);
+	update(smallItem, {-50.f, 50.f, -50.f}, 0.1f);
+	EXPECT_EQ(getDepth(smallItem), MAX_DEPTH);
+	update(smallItem, {-HALF_SIZE * 1.2f, 0.f, 0.f}, 0.1f);
+	EXPECT_EQ(getNode(smallItem), LooseOctree::INVALID_INDEX);
+	update(largeItem, {}, 0.1f);
+	EXPECT_EQ(getDepth(largeItem), MAX_DEPTH);
+	validate_tree(scene);
+	compare_queries(scene, 20);
+}
+
+TEST(OctreeTests, SmallUpdatesKeepNode)
+{
+	test::reset_random_generator();
+	Scene scene;
+	for(uint32_t i = 0; i < 200; ++i)
+		scene.Insert();
+	auto &treeItems = scene.tree.GetItems();
+	for(auto &[id, item] : scene.items) {
+		auto node = treeItems[id].node;
+		if(node == LooseOctree::INVALID_INDEX)
+			continue;
+		// Moving the item within the cell of its node, without changing its size, keeps the node
+		auto &cell = scene.tree.GetNodes()[node];
+		auto center = (item.aabb.min + item.aabb.max) * 0.5f;
+		auto target = cell.center + (center - cell.center) * 0.5f;
+		item.aabb = {item.aabb.min + (target - center), item.aabb.max + (target - center)};
+		scene.tree.Update(id, item.aabb);
+		EXPECT_EQ(treeItems[id].node, node);
+	}
+	validate_tree(scene);
+	compare_queries(scene, 10);
+}
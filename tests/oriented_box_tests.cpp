@@ -0,0 +1,368 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <type_traits>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	using Intersect = pragma::math::intersection::Intersect;
+	using OrientedBox = pragma::math::intersection::OrientedBox;
+	using ScaledTransform = pragma::math::ScaledTransform;
+	// Cases which are closer than this to touching or to containment are skipped by the brute-force comparisons, since rounding can decide them either way
+	constexpr float MARGIN = 1e-3f;
+
+	Quat random_rotation()
+	{
+		Quat q {test::random_float(-1.f, 1.f), test::random_float(-1.f, 1.f), test::random_float(-1.f, 1.f), test::random_float(-1.f, 1.f)};
+		if(uquat::length(q) < 0.0001f)
+			return uquat::identity();
+		uquat::normalize(q);
+		return q;
+	}
+	Vector3 random_extents()
+	{
+		// Long, thin boxes are the most likely to be separated only along an edge-edge axis
+		if(test::random_uint(0, 3) != 0)
+			return test::random_vector(0.1f, 1.5f);
+		auto extents = test::random_vector(0.05f, 0.2f);
+		extents[test::random_uint(0, 3)] = test::random_float(1.5f, 4.f);
+		return extents;
+	}
+	OrientedBox random_box(float range)
+	{
+		auto extents = random_extents();
+		return pragma::math::intersection::get_oriented_box(test::random_vector(-range, range), random_rotation(), -extents, extents);
+	}
+	// Returns a box which is entirely contained in b
+	OrientedBox random_box_inside(const OrientedBox &b)
+	{
+		auto center = b.center;
+		for(uint8_t i = 0; i < 3; ++i)
+			center += b.axes[i] * (b.halfExtents[i] * test::random_float(-0.5f, 0.5f));
+		auto maxExtent = std::min({b.halfExtents.x, b.halfExtents.y, b.halfExtents.z}) * 0.25f;
+		auto extents = test::random_vector(0.1f * maxExtent, maxExtent);
+		return pragma::math::intersection::get_oriented_box(center, random_rotation(), -extents, extents);
+	}
+
+	std::array<Vector3, 8> get_corners(const OrientedBox &box)
+	{
+		std::array<Vector3, 8> corners;
+		for(uint32_t i = 0; i < corners.size(); ++i) {
+			auto p = box.center;
+			for(uint8_t j = 0; j < 3; ++j)
+				p += box.axes[j] * (((i >> j) & 1) ? box.halfExtents[j] : -box.halfExtents[j]);
+			corners[i] = p;
+		}
+		return corners;
+	}
+	// Gap between the projections of both corner sets onto the axis, positive if the axis separates them
+	float get_gap(const std::array<Vector3, 8> &a, const std::array<Vector3, 8> &b, const Vector3 &axis)
+	{
+		auto n = axis / uvec::length(axis);
+		auto project = [&n](const std::array<Vector3, 8> &corners) {
+			std::pair<float, float> range {std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+			for(auto &p : corners) {
+				auto d = uvec::dot(n, p);
+				range = {std::min(range.first, d), std::max(range.second, d)};
+			}
+			return range;
+		};
+		auto [minA, maxA] = project(a);
+		auto [minB, maxB] = project(b);
+		return std::max(minB - maxA, minA - maxB);
+	}
+	struct Separation {
+		// Largest gap over the face axes of both boxes
+		float faceGap = std::numeric_limits<float>::lowest();
+		// Largest gap over the cross products of the edges of both boxes
+		float edgeGap = std::numeric_limits<float>::lowest();
+	};
+	Separation get_separation(const OrientedBox &a, const OrientedBox &b)
+	{
+		auto cornersA = get_corners(a);
+		auto cornersB = get_corners(b);
+		Separation sep {};
+		for(uint8_t i = 0; i < 3; ++i) {
+			sep.faceGap = std::max({sep.faceGap, get_gap(cornersA, cornersB, a.axes[i]), get_gap(cornersA, cornersB, b.axes[i])});
+			for(uint8_t j = 0; j < 3; ++j) {
+				auto axis = uvec::cross(a.axes[i], b.axes[j]);
+				// Parallel edges don't define an axis, the face axes already cover that case
+				if(uvec::length(axis) > 1e-4f)
+					sep.edgeGap = std::max(sep.edgeGap, get_gap(cornersA, cornersB, axis));
+			}
+		}
+		return sep;
+	}
+	// Largest distance of a corner of a outside of b, positive if a is not contained in b
+	float get_containment_gap(const OrientedBox &a, const OrientedBox &b)
+	{
+		auto gap = std::numeric_limits<float>::lowest();
+		for(auto &p : get_corners(a)) {
+			for(uint8_t j = 0; j < 3; ++j)
+				gap = std::max(gap, std::abs(uvec::dot(p - b.center, b.axes[j])) - b.halfExtents[j]);
+		}
+		return gap;
+	}
+	// Brute-force reference for obb_obb(a, b): Outside if any of the 15 axes separates the boxes, Inside if all corners of a are within b.
+	// Returns std::nullopt if the boxes are too close to touching or to containment to be decided reliably.
+	std::optional<Intersect> classify(const OrientedBox &a, const OrientedBox &b, bool *outEdgeOnly = nullptr)
+	{
+		auto sep = get_separation(a, b);
+		auto gap = std::max(sep.faceGap, sep.edgeGap);
+		if(std::abs(gap) < MARGIN)
+			return {};
+		if(gap > 0.f) {
+			if(outEdgeOnly)
+				*outEdgeOnly = sep.faceGap < 0.f;
+			return Intersect::Outside;
+		}
+		auto containmentGap = get_containment_gap(a, b);
+		if(std::abs(containmentGap) < MARGIN)
+			return {};
+		return (containmentGap > 0.f) ? Intersect::Overlap : Intersect::Inside;
+	}
+
+	// The ScaledTransform overload of obb_obb before it was based on the separating axis test: box b is moved into the space of a, and its six planes are tested against a.
+	Intersect obb_obb_planes(const ScaledTransform &poseA, const Vector3 &minA, const Vector3 &maxA, const ScaledTransform &poseB, const Vector3 &minB, const Vector3 &maxB)
+	{
+		auto poseBRelToA = poseA.GetInverse() * poseB;
+		auto planes = pragma::math::geometry::get_obb_planes(poseBRelToA.GetOrigin(), poseBRelToA.GetRotation(), minB, maxB);
+		return pragma::math::intersection::aabb_in_plane_mesh(minA, maxA, planes.begin(), planes.end());
+	}
+	std::pair<Vector3, Vector3> random_bounds()
+	{
+		auto min = test::random_vector(-1.5f, 0.f);
+		return {min, min + random_extents() * 2.f};
+	}
+};
+
+TEST(OrientedBoxTests, SeparatingAxisMatchesBruteForce)
+{
+	test::reset_random_generator();
+	constexpr uint32_t numPairs = 20'000;
+	uint32_t numSkipped = 0;
+	uint32_t numEdgeOnly = 0;
+	std::array<uint32_t, 3> numResults {};
+	for(uint32_t i = 0; i < numPairs; ++i) {
+		auto b = random_box(2.f);
+		auto a = (i % 8 == 0) ? random_box_inside(b) : random_box(2.f);
+		auto edgeOnly = false;
+		auto expected = classify(a, b, &edgeOnly);
+		if(!expected) {
+			++numSkipped;
+			continue;
+		}
+		auto result = pragma::math::intersection::obb_obb(a, b);
+		EXPECT_EQ(result, *expected) << "Pair " << i;
+		++numResults[static_cast<uint32_t>(*expected)];
+		if(edgeOnly)
+			++numEdgeOnly;
+	}
+	// Every class has to be covered, including boxes that only an edge-edge axis separates
+	EXPECT_GT(numResults[static_cast<uint32_t>(Intersect::Outside)], 0u);
+	EXPECT_GT(numResults[static_cast<uint32_t>(Intersect::Inside)], 0u);
+	EXPECT_GT(numResults[static_cast<uint32_t>(Intersect::Overlap)], 0u);
+	EXPECT_GT(numEdgeOnly, 0u);
+	EXPECT_LT(numSkipped, numPairs / 100);
+}
+
+TEST(OrientedBoxTests, EdgeEdgeSeparation)
+{
+	// Two unit cubes, a rotated by 45 degrees around z and b by 45 degrees around y. The edge of a along z and the edge of b along y
+	// face each other across the x-axis, which is the cross product of the two edges. None of the face axes separate the cubes for offsets between 2*sqrt(2) and 2*sqrt(2)+1.
+	auto angle = std::numbers::pi_v<float> * 0.25f;
+	Quat rotZ {std::cos(angle * 0.5f), 0.f, 0.f, std::sin(angle * 0.5f)};
+	Quat rotY {std::cos(angle * 0.5f), 0.f, std::sin(angle * 0.5f), 0.f};
+	Vector3 extents {1.f, 1.f, 1.f};
+	auto a = pragma::math::intersection::get_oriented_box({}, rotZ, -extents, extents);
+	for(auto offset : {3.f, 3.2f, 3.6f}) {
+		auto b = pragma::math::intersection::get_oriented_box({offset, 0.f, 0.f}, rotY, -extents, extents);
+		auto edgeOnly = false;
+		ASSERT_EQ(classify(a, b, &edgeOnly), Intersect::Outside);
+		EXPECT_TRUE(edgeOnly);
+		EXPECT_EQ(pragma::math::intersection::obb_obb(a, b), Intersect::Outside) << "Offset " << offset;
+		EXPECT_EQ(pragma::math::intersection::obb_obb(b, a), Intersect::Outside) << "Offset " << offset;
+	}
+	// Closer than 2*sqrt(2) the edges cross
+	auto b = pragma::math::intersection::get_oriented_box({2.6f, 0.f, 0.f}, rotY, -extents, extents);
+	EXPECT_EQ(pragma::math::intersection::obb_obb(a, b), Intersect::Overlap);
+}
+
+TEST(OrientedBoxTests, InsideMeansFirstWithinSecond)
+{
+	test::reset_random_generator();
+	for(uint32_t i = 0; i < 1'000; ++i) {
+		auto b = random_box(5.f);
+		auto a = random_box_inside(b);
+		EXPECT_EQ(pragma::math::intersection::obb_obb(a, b), Intersect::Inside) << "Pair " << i;
+		EXPECT_EQ(pragma::math::intersection::obb_obb(b, a), Intersect::Overlap) << "Pair " << i;
+		// Equal boxes are inside of each other
+		EXPECT_EQ(pragma::math::intersection::obb_obb(b, b), Intersect::Inside) << "Pair " << i;
+	}
+}
+
+TEST(OrientedBoxTests, BatchMatchesScalar)
+{
+	test::reset_random_generator();
+	auto obb = random_box(1.f);
+	std::vector<OrientedBox> boxes;
+	for(uint32_t i = 0; i < 200; ++i)
+		boxes.push_back((i % 5 == 0) ? random_box_inside(obb) : random_box(3.f));
+	pragma::math::ObbSoaBuffer buffer {boxes};
+	ASSERT_EQ(buffer.Size(), boxes.size());
+
+	// Equal boxes are inside of each other
+	pragma::math::ObbSoaBuffer equalBoxes {std::vector<OrientedBox>(5, obb)};
+	std::vector<Intersect> equalResults(equalBoxes.Size());
+	EXPECT_EQ(pragma::math::intersection::obb_obb(equalBoxes.GetView(), obb, equalResults.data()), equalResults.size());
+	for(auto result : equalResults)
+		EXPECT_EQ(result, Intersect::Inside);
+
+	constexpr auto unset = static_cast<Intersect>(std::numeric_limits<std::underlying_type_t<Intersect>>::max());
+	// Counts which are not a multiple of the SIMD width, with offsets that start in the middle of a batch
+	for(size_t offset : {0u, 1u, 3u}) {
+		for(size_t count : {0u, 1u, 3u, 4u, 5u, 7u, 8u, 9u, 15u, 16u, 17u, 31u, 33u, 100u, 197u}) {
+			// One extra element to catch writes past the end
+			std::vector<Intersect> results(count + 1, unset);
+			auto numNotOutside = pragma::math::intersection::obb_obb(buffer.GetView(offset, count), obb, results.data());
+			EXPECT_EQ(results.back(), unset) << "Offset " << offset << ", count " << count;
+			size_t expectedNotOutside = 0;
+			for(size_t i = 0; i < count; ++i) {
+				auto &box = boxes[offset + i];
+				EXPECT_NE(results[i], unset);
+				if(results[i] != Intersect::Outside)
+					++expectedNotOutside;
+				if(!classify(box, obb))
+					continue;
+				EXPECT_EQ(results[i], pragma::math::intersection::obb_obb(box, obb)) << "Offset " << offset << ", count " << count << ", box " << i;
+			}
+			EXPECT_EQ(numNotOutside, expectedNotOutside) << "Offset " << offset << ", count " << count;
+		}
+	}
+}
+
+TEST(OrientedBoxTests, ScaledTransformUnitScaleMatchesPlaneTest)
+{
+	// With unit scale, the only difference to the previous implementation is that it could not detect every separation:
+	// It only tested the planes of b, so boxes that only a face axis of a or an edge-edge axis separates were Overlap.
+	test::reset_random_generator();
+	uint32_t numChanged = 0;
+	uint32_t numCompared = 0;
+	for(uint32_t i = 0; i < 10'000; ++i) {
+		ScaledTransform poseA {test::random_vector(-2.f, 2.f), random_rotation(), Vector3 {1.f, 1.f, 1.f}};
+		ScaledTransform poseB {test::random_vector(-2.f, 2.f), random_rotation(), Vector3 {1.f, 1.f, 1.f}};
+		auto [minA, maxA] = random_bounds();
+		auto [minB, maxB] = random_bounds();
+		auto expected = classify(pragma::math::intersection::get_oriented_box(poseA, minA, maxA), pragma::math::intersection::get_oriented_box(poseB, minB, maxB));
+		if(!expected)
+			continue;
+		++numCompared;
+		auto result = pragma::math::intersection::obb_obb(poseA, minA, maxA, poseB, minB, maxB);
+		EXPECT_EQ(result, *expected) << "Pair " << i;
+		// Same as testing a in its own space against b in the space of a
+		auto poseBRelToA = poseA.GetInverse() * poseB;
+		EXPECT_EQ(result, pragma::math::intersection::aabb_obb(minA, maxA, poseBRelToA.GetOrigin(), poseBRelToA.GetRotation(), minB, maxB)) << "Pair " << i;
+
+		auto previous = obb_obb_planes(poseA, minA, maxA, poseB, minB, maxB);
+		if(*expected != Intersect::Outside)
+			EXPECT_EQ(result, previous) << "Pair " << i;
+		else if(previous != Intersect::Outside) {
+			EXPECT_EQ(previous, Intersect::Overlap) << "Pair " << i;
+			++numChanged;
+		}
+	}
+	EXPECT_GT(numCompared, 9'900u);
+	EXPECT_GT(numChanged, 0u);
+}
+
+TEST(OrientedBoxTests, ScaledTransformAppliesScale)
+{
+	test::reset_random_generator();
+	for(uint32_t i = 0; i < 10'000; ++i) {
+		std::array<ScaledTransform, 2> poses;
+		std::array<std::pair<Vector3, Vector3>, 2> bounds;
+		std::array<OrientedBox, 2> boxes;
+		for(uint8_t j = 0; j < 2; ++j) {
+			auto scale = test::random_vector(0.25f, 3.f);
+			for(uint8_t k = 0; k < 3; ++k) {
+				if(test::random_uint(0, 4) == 0)
+					scale[k] = -scale[k];
+			}
+			poses[j] = {test::random_vector(-3.f, 3.f), random_rotation(), scale};
+			bounds[j] = random_bounds();
+			boxes[j] = pragma::math::intersection::get_oriented_box(poses[j], bounds[j].first, bounds[j].second);
+
+			// Every corner of the bounds, transformed by the pose including its scale, is a corner of the box
+			auto corners = get_corners(boxes[j]);
+			for(uint32_t c = 0; c < 8; ++c) {
+				auto &[min, max] = bounds[j];
+				auto p = poses[j] * Vector3 {(c & 1) ? max.x : min.x, (c & 2) ? max.y : min.y, (c & 4) ? max.z : min.z};
+				auto closest = std::min_element(corners.begin(), corners.end(), [&p](const Vector3 &a, const Vector3 &b) { return uvec::distance(a, p) < uvec::distance(b, p); });
+				EXPECT_LT(uvec::distance(*closest, p), 1e-4f) << "Pose " << i << ", corner " << c;
+			}
+		}
+		auto expected = classify(boxes[0], boxes[1]);
+		if(!expected)
+			continue;
+		EXPECT_EQ(pragma::math::intersection::obb_obb(poses[0], bounds[0].first, bounds[0].second, poses[1], bounds[1].first, bounds[1].second), *expected) << "Pair " << i;
+	}
+}
+
+TEST(OrientedBoxTests, ScaledTransformScaleChangesResult)
+{
+	// The previous implementation tested both boxes at their unscaled size, see obb_obb_planes
+	Vector3 min {-1.f, -1.f, -1.f};
+	Vector3 max {1.f, 1.f, 1.f};
+	ScaledTransform poseB {Vector3 {2.5f, 0.f, 0.f}, uquat::identity(), Vector3 {1.f, 1.f, 1.f}};
+
+	// a covers [-2, 2] on x, b covers [1.5, 3.5]
+	ScaledTransform scaledUp {Vector3 {}, uquat::identity(), Vector3 {2.f, 2.f, 2.f}};
+	EXPECT_EQ(pragma::math::intersection::obb_obb(scaledUp, min, max, poseB, min, max), Intersect::Overlap);
+	EXPECT_EQ(obb_obb_planes(scaledUp, min, max, poseB, min, max), Intersect::Outside);
+
+	// a covers [-0.25, 0.25] on x, b covers [0.5, 2.5]
+	ScaledTransform scaledDown {Vector3 {}, uquat::identity(), Vector3 {0.25f, 0.25f, 0.25f}};
+	poseB.SetOrigin({1.5f, 0.f, 0.f});
+	EXPECT_EQ(pragma::math::intersection::obb_obb(scaledDown, min, max, poseB, min, max), Intersect::Outside);
+	EXPECT_EQ(obb_obb_planes(scaledDown, min, max, poseB, min, max), Intersect::Overlap);
+
+	// A box scaled down within b is inside of it
+	poseB.SetOrigin({});
+	EXPECT_EQ(pragma::math::intersection::obb_obb(scaledDown, min, max, poseB, min, max), Intersect::Inside);
+	EXPECT_EQ(pragma::math::intersection::obb_obb(poseB, min, max, scaledDown, min, max), Intersect::Overlap);
+}
+
+TEST(OrientedBoxTests, ScaledTransformNegativeScaleMirrors)
+{
+	// The bounds [0, 2] on x are mirrored to [-2, 0], the extents of the box stay the same
+	Vector3 minA {0.f, -1.f, -1.f};
+	Vector3 maxA {2.f, 1.f, 1.f};
+	ScaledTransform mirrored {Vector3 {}, uquat::identity(), Vector3 {-1.f, 1.f, 1.f}};
+	auto box = pragma::math::intersection::get_oriented_box(mirrored, minA, maxA);
+	EXPECT_NEAR(box.center.x, -1.f, 1e-6f);
+	EXPECT_NEAR(box.halfExtents.x, 1.f, 1e-6f);
+	EXPECT_NEAR(box.halfExtents.y, 1.f, 1e-6f);
+	EXPECT_NEAR(box.halfExtents.z, 1.f, 1e-6f);
+
+	Vector3 minB {-0.5f, -0.5f, -0.5f};
+	Vector3 maxB {0.5f, 0.5f, 0.5f};
+	ScaledTransform poseB {Vector3 {1.5f, 0.f, 0.f}, uquat::identity(), Vector3 {1.f, 1.f, 1.f}};
+	EXPECT_EQ(pragma::math::intersection::obb_obb(mirrored, minA, maxA, poseB, minB, maxB), Intersect::Outside);
+	// The previous implementation ignored the mirroring
+	EXPECT_EQ(obb_obb_planes(mirrored, minA, maxA, poseB, minB, maxB), Intersect::Overlap);
+
+	poseB.SetOrigin({-1.5f, 0.f, 0.f});
+	EXPECT_EQ(pragma::math::intersection::obb_obb(mirrored, minA, maxA, poseB, minB, maxB), Intersect::Overlap);
+	EXPECT_EQ(pragma::math::intersection::obb_obb(poseB, minB, maxB, mirrored, minA, maxA), Intersect::Inside);
+	// Mirroring y and z as well doesn't change anything, since the bounds are symmetric on those axes
+	ScaledTransform mirroredAll {Vector3 {}, uquat::identity(), Vector3 {-1.f, -1.f, -1.f}};
+	EXPECT_EQ(pragma::math::intersection::obb_obb(poseB, minB, maxB, mirroredAll, minA, maxA), Intersect::Inside);
+}
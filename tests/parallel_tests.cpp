@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	// Some indices are much more expensive than others, so that ranges are stolen
+	void run_uneven_task(size_t i)
+	{
+		if(i % 97 == 0) {
+			volatile uint32_t sum = 0;
+			for(uint32_t j = 0; j < 20'000; ++j)
+				sum = sum + j;
+		}
+	}
+
+	// Runs the task with 'run' and checks that every index was processed exactly once
+	void expect_each_index_once(size_t count, const std::function<void(size_t, const std::function<void(size_t)> &)> &run)
+	{
+		std::vector<std::atomic<uint32_t>> hits(count);
+		run(count, [&hits](size_t i) {
+			run_uneven_task(i);
+			hits[i].fetch_add(1, std::memory_order_relaxed);
+		});
+		for(size_t i = 0; i < count; ++i)
+			ASSERT_EQ(hits[i].load(), 1u) << "index " << i;
+	}
+
+	// Selects every third element and, in a different pattern, some more
+	void select_elements(size_t begin, size_t end, std::vector<uint32_t> &outIndices)
+	{
+		for(auto i = begin; i < end; ++i) {
+			if(i % 3 == 0 || (i * 7919) % 11 == 0)
+				outIndices.push_back(static_cast<uint32_t>(i));
+		}
+	}
+};
+
+TEST(ParallelTests, ParallelForRunsEachIndexOnce)
+{
+	for(auto threadCount : {0u, 1u, 2u, 3u, 8u, 33u}) {
+		// Includes counts smaller than the thread count
+		for(size_t count : {0, 1, 2, 5, 31, 1'000, 10'007}) {
+			expect_each_index_once(count, [threadCount](size_t n, const std::function<void(size_t)> &task) { pragma::math::parallel::parallel_for(n, task, threadCount); });
+		}
+	}
+}
+
+TEST(ParallelTests, ThreadPoolRunsEachIndexOnce)
+{
+	for(auto workerCount : {1u, 3u, 7u}) {
+		pragma::math::parallel::ThreadPool pool {workerCount};
+		EXPECT_EQ(pool.GetWorkerCount(), workerCount);
+		for(auto threadCount : {0u, 2u, workerCount + 1, workerCount + 5}) {
+			for(size_t count : {1, 3, 8, 4'099}) {
+				expect_each_index_once(count, [&pool, threadCount](size_t n, const std::function<void(size_t)> &task) { pool.Run(n, task, threadCount); });
+			}
+		}
+	}
+}
+
+TEST(ParallelTests, RepeatedAndNestedJobs)
+{
+	pragma::math::parallel::ThreadPool pool {3};
+	// Many short jobs in a row on the same pool
+	for(uint32_t i = 0; i < 500; ++i)
+		expect_each_index_once(1 + i % 17, [&pool](size_t n, const std::function<void(size_t)> &task) { pool.Run(n, task, 4); });
+
+	// Every outer index runs an inner job on the same pool, while the outer job is still running
+	constexpr size_t outerCount = 16;
+	constexpr size_t innerCount = 257;
+	std::vector<std::atomic<uint32_t>> hits(outerCount * innerCount);
+	pool.Run(
+	  outerCount,
+	  [&pool, &hits](size_t i) {
+		  pool.Run(
+		    innerCount,
+		    [&hits, i](size_t j) {
+			    run_uneven_task(j);
+			    hits[i * innerCount + j].fetch_add(1, std::memory_order_relaxed);
+		    },
+		    3);
+	  },
+	  4);
+	for(auto &h : hits)
+		ASSERT_EQ(h.load(), 1u);
+
+	// Same with the default pool, through parallel_for
+	std::atomic<size_t> sum {0};
+	pragma::math::parallel::parallel_for(
+	  outerCount, [&sum](size_t) { pragma::math::parallel::parallel_for(innerCount, [&sum](size_t j) { sum.fetch_add(j, std::memory_order_relaxed); }, 3); }, 4);
+	EXPECT_EQ(sum.load(), outerCount * (innerCount * (innerCount - 1) / 2));
+}
+
+TEST(ParallelTests, ParallelCompactMatchesSerial)
+{
+	for(size_t count : {0, 1, 100, 4'096, 100'003}) {
+		std::vector<uint32_t> ref;
+		select_elements(0, count, ref);
+		for(size_t chunkSize : {0, 1, 7, 1'000, 200'000}) {
+			// Chunk sizes of 0 are treated as 1, which is slow for large counts
+			if(chunkSize < 7 && count > 4'096)
+				continue;
+			for(auto threadCount : {0u, 1u, 3u, 16u}) {
+				std::vector<uint32_t> result {1, 2, 3};
+				pragma::math::parallel::parallel_compact(count, chunkSize, select_elements, result, threadCount);
+				EXPECT_EQ(result, ref);
+			}
+		}
+	}
+}
+
+TEST(ParallelTests, Executor)
+{
+	// The executor replaces the thread pool for all parallel algorithms
+	uint32_t numCalls = 0;
+	pragma::math::parallel::set_executor([&numCalls](size_t count, const std::function<void(size_t)> &task, uint32_t) {
+		++numCalls;
+		for(size_t i = count; i > 0; --i)
+			task(i - 1);
+	});
+	expect_each_index_once(100, [](size_t n, const std::function<void(size_t)> &task) { pragma::math::parallel::parallel_for(n, task, 4); });
+	EXPECT_EQ(numCalls, 1u);
+	std::vector<uint32_t> ref;
+	select_elements(0, 10'000, ref);
+	std::vector<uint32_t> result;
+	pragma::math::parallel::parallel_compact(10'000, 100, select_elements, result, 4);
+	EXPECT_EQ(result, ref);
+	// Single-threaded calls don't go through the executor
+	pragma::math::parallel::parallel_for(100, [](size_t) {}, 1);
+	EXPECT_EQ(numCalls, 3u);
+
+	pragma::math::parallel::set_executor({});
+	expect_each_index_once(100, [](size_t n, const std::function<void(size_t)> &task) { pragma::math::parallel::parallel_for(n, task, 4); });
+	EXPECT_EQ(numCalls, 3u);
+}
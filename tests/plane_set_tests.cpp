@@ -0,0 +1,329 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	using PackedPlane = pragma::math::PackedPlane;
+	using PlaneSet = pragma::math::PlaneSet;
+	using Intersect = pragma::math::intersection::Intersect;
+	// Points closer to a plane than this are not used for deciding the expected result, since rounding may put them on either side
+	constexpr float MARGIN = 1e-4f;
+
+	// Planes of a convex volume around the origin
+	std::vector<PackedPlane> random_planes(uint32_t count)
+	{
+		std::vector<PackedPlane> planes;
+		for(uint32_t i = 0; i < count; ++i) {
+			Vector3 n;
+			do
+				n = test::random_vector(-1.f, 1.f);
+			while(uvec::length_sqr(n) < 0.01f);
+			planes.push_back({uvec::get_normal(n), test::random_float(2.f, 6.f)});
+		}
+		return planes;
+	}
+	// Planes of the box [-1, 1]^3
+	std::vector<PackedPlane> get_cube_planes()
+	{
+		return {{{1.f, 0.f, 0.f}, 1.f}, {{-1.f, 0.f, 0.f}, 1.f}, {{0.f, 1.f, 0.f}, 1.f}, {{0.f, -1.f, 0.f}, 1.f}, {{0.f, 0.f, 1.f}, 1.f}, {{0.f, 0.f, -1.f}, 1.f}};
+	}
+	// Largest distance of p to any of the planes, i.e. p is inside if the result is <= 0
+	float get_max_distance(const Vector3 &p, const std::vector<PackedPlane> &planes)
+	{
+		auto maxDist = -std::numeric_limits<float>::max();
+		for(auto &plane : planes)
+			maxDist = std::max(maxDist, plane.GetDistance(p));
+		return maxDist;
+	}
+	bool is_near_any_plane(const std::vector<Vector3> &points, const std::vector<PackedPlane> &planes)
+	{
+		for(auto &p : points) {
+			for(auto &plane : planes) {
+				if(std::abs(plane.GetDistance(p)) < MARGIN)
+					return true;
+			}
+		}
+		return false;
+	}
+	float get_triangle_area(const Vector3 &a, const Vector3 &b, const Vector3 &c) { return uvec::length(uvec::cross(b - a, c - a)) * 0.5f; }
+	float get_polygon_area(const std::vector<Vector3> &polygon)
+	{
+		auto area = 0.f;
+		for(size_t i = 1; i + 1 < polygon.size(); ++i)
+			area += get_triangle_area(polygon[0], polygon[i], polygon[i + 1]);
+		return area;
+	}
+	// Uniformly distributed points on a grid in barycentric coordinates
+	template<typename TFunc>
+	void for_each_triangle_sample(const Vector3 &a, const Vector3 &b, const Vector3 &c, uint32_t numSteps, const TFunc &func)
+	{
+		for(uint32_t i = 0; i <= numSteps; ++i) {
+			for(uint32_t j = 0; i + j <= numSteps; ++j) {
+				auto u = static_cast<float>(i) / static_cast<float>(numSteps);
+				auto v = static_cast<float>(j) / static_cast<float>(numSteps);
+				func(a + (b - a) * u + (c - a) * v);
+			}
+		}
+	}
+	// Returns true if a volume with the given distance to the plane and radius (projected half-extents for boxes) touches it within the margin,
+	// or if its center lies on the plane
+	bool touches_plane(float dist, float radius)
+	{
+		auto margin = MARGIN * (std::abs(dist) + radius + 1.f);
+		return std::abs(dist - radius) < margin || std::abs(dist + radius) < margin || std::abs(dist) < margin;
+	}
+	bool touches_any_plane(const Vector3 &center, const Vector3 &extents, float radius, const std::vector<PackedPlane> &planes)
+	{
+		for(auto &plane : planes) {
+			auto &n = plane.GetNormal();
+			auto r = radius + std::abs(n.x) * extents.x + std::abs(n.y) * extents.y + std::abs(n.z) * extents.z;
+			if(touches_plane(plane.GetDistance(center), r))
+				return true;
+		}
+		return false;
+	}
+	// Counts which are not a multiple of any SIMD width, as well as a full set
+	constexpr std::array<uint32_t, 12> PLANE_COUNTS {0, 1, 3, 4, 5, 7, 8, 9, 15, 17, 31, PlaneSet::MAX_PLANES};
+
+	struct TriangleMesh {
+		std::vector<Vector3> verts;
+		std::vector<uint32_t> triangles;
+	};
+	// Triangles of different sizes around the origin, many of which intersect a plane set of random_planes
+	TriangleMesh random_mesh(uint32_t numTriangles)
+	{
+		TriangleMesh mesh;
+		for(uint32_t i = 0; i < numTriangles; ++i) {
+			auto center = test::random_vector(-7.f, 7.f);
+			auto size = test::random_float(0.5f, 8.f);
+			for(uint8_t j = 0; j < 3; ++j) {
+				mesh.triangles.push_back(static_cast<uint32_t>(mesh.verts.size()));
+				mesh.verts.push_back(center + test::random_vector(-size, size));
+			}
+		}
+		// Share some vertices between triangles
+		for(size_t i = 3; i < mesh.triangles.size(); i += 7)
+			mesh.triangles[i] = mesh.triangles[i - 2];
+		return mesh;
+	}
+};
+
+TEST(PlaneSetTests, TriangleInPlaneMeshCube)
+{
+	using pragma::math::intersection::triangle_in_plane_mesh;
+	auto planes = get_cube_planes();
+	EXPECT_EQ(triangle_in_plane_mesh({-0.5f, -0.5f, 0.f}, {0.5f, -0.5f, 0.f}, {0.f, 0.5f, 0.f}, planes.begin(), planes.end()), Intersect::Inside);
+	EXPECT_EQ(triangle_in_plane_mesh({2.f, -0.5f, 0.f}, {3.f, -0.5f, 0.f}, {2.5f, 0.5f, 0.f}, planes.begin(), planes.end()), Intersect::Outside);
+	// Crosses the extensions of the planes x = 1 and y = 1 next to the corner of the cube, but not the cube itself
+	EXPECT_EQ(triangle_in_plane_mesh({1.5f, 0.8f, 0.f}, {0.8f, 1.5f, 0.f}, {1.5f, 1.5f, 0.f}, planes.begin(), planes.end()), Intersect::Outside);
+	// Crosses the plane x = 1, the part inside of the cube is the trapezoid (0, -0.5), (1, -0.5), (1, 0), (0, 0.5)
+	std::vector<Vector3> polygon {{0.f, -0.5f, 0.f}, {2.f, -0.5f, 0.f}, {0.f, 0.5f, 0.f}};
+	EXPECT_EQ(triangle_in_plane_mesh(polygon[0], polygon[1], polygon[2], planes.begin(), planes.end()), Intersect::Overlap);
+	ASSERT_TRUE(pragma::math::geometry::clip_polygon_to_plane_mesh(polygon, planes.begin(), planes.end()));
+	EXPECT_EQ(polygon.size(), 4u);
+	EXPECT_NEAR(get_polygon_area(polygon), 0.75f, 1e-5f);
+	for(auto &p : polygon)
+		EXPECT_LE(get_max_distance(p, planes), 1e-5f);
+}
+
+TEST(PlaneSetTests, TriangleInPlaneMeshMatchesSamples)
+{
+	using pragma::math::intersection::triangle_in_plane_mesh;
+	test::reset_random_generator();
+	constexpr uint32_t numSteps = 40;
+	std::array<uint32_t, 3> numResults {};
+	for(uint32_t i = 0; i < 400; ++i) {
+		auto planes = random_planes(test::random_uint(1, 20));
+		auto mesh = random_mesh(1);
+		auto &a = mesh.verts[0];
+		auto &b = mesh.verts[1];
+		auto &c = mesh.verts[2];
+		auto result = triangle_in_plane_mesh(a, b, c, planes.begin(), planes.end());
+		++numResults[static_cast<uint32_t>(result)];
+
+		// Fraction of the samples inside of the plane set, which approximates the fraction of the area inside
+		uint32_t numSamples = 0;
+		uint32_t numInside = 0;
+		for_each_triangle_sample(a, b, c, numSteps, [&](const Vector3 &p) {
+			++numSamples;
+			auto dist = get_max_distance(p, planes);
+			if(dist <= -MARGIN)
+				++numInside;
+			if(result == Intersect::Inside)
+				EXPECT_LE(dist, MARGIN) << "Triangle " << i;
+			else if(result == Intersect::Outside)
+				EXPECT_GE(dist, -MARGIN) << "Triangle " << i;
+		});
+		if(result != Intersect::Overlap)
+			continue;
+
+		std::vector<Vector3> polygon {a, b, c};
+		ASSERT_TRUE(pragma::math::geometry::clip_polygon_to_plane_mesh(polygon, planes.begin(), planes.end())) << "Triangle " << i;
+		ASSERT_GE(polygon.size(), 3u) << "Triangle " << i;
+		// The clipped polygon has to lie inside of the plane set and cover the same part of the triangle as the samples
+		for(size_t j = 1; j + 1 < polygon.size(); ++j) {
+			for_each_triangle_sample(polygon[0], polygon[j], polygon[j + 1], 5, [&](const Vector3 &p) { EXPECT_LE(get_max_distance(p, planes), MARGIN) << "Triangle " << i; });
+		}
+		auto areaFraction = get_polygon_area(polygon) / get_triangle_area(a, b, c);
+		EXPECT_LE(areaFraction, 1.f + 1e-4f) << "Triangle " << i;
+		EXPECT_NEAR(areaFraction, static_cast<float>(numInside) / static_cast<float>(numSamples), 0.06f) << "Triangle " << i;
+	}
+	// All results have to be covered
+	for(auto n : numResults)
+		EXPECT_GT(n, 20u);
+}
+
+TEST(PlaneSetTests, BatchedTriangleInPlaneMeshMatchesTemplate)
+{
+	test::reset_random_generator();
+	uint32_t numCompared = 0;
+	// Triangle counts which don't fill the last SIMD batch, as well as no triangles at all
+	for(auto numTriangles : {0u, 1u, 3u, 7u, 16u, 17u, 33u, 100u}) {
+		for(auto numPlanes : {0u, 1u, 5u, 6u, 20u, PlaneSet::MAX_PLANES}) {
+			auto planes = random_planes(numPlanes);
+			PlaneSet planeSet {planes.begin(), planes.end()};
+			auto mesh = random_mesh(numTriangles);
+			std::vector<uint16_t> triangles16 {mesh.triangles.begin(), mesh.triangles.end()};
+
+			// Expected results and clipped polygons
+			std::vector<Intersect> expectedResults;
+			std::vector<std::vector<Vector3>> expectedPolygons;
+			std::vector<bool> ambiguous;
+			size_t expectedNotOutside = 0;
+			for(uint32_t i = 0; i < numTriangles; ++i) {
+				std::vector<Vector3> polygon {mesh.verts[mesh.triangles[i * 3]], mesh.verts[mesh.triangles[i * 3 + 1]], mesh.verts[mesh.triangles[i * 3 + 2]]};
+				ambiguous.push_back(is_near_any_plane(polygon, planes));
+				auto result = pragma::math::intersection::triangle_in_plane_mesh(polygon[0], polygon[1], polygon[2], planes.begin(), planes.end());
+				if(result == Intersect::Overlap)
+					pragma::math::geometry::clip_polygon_to_plane_mesh(polygon, planes.begin(), planes.end());
+				if(result != Intersect::Outside)
+					++expectedNotOutside;
+				expectedResults.push_back(result);
+				expectedPolygons.push_back(result == Intersect::Outside ? std::vector<Vector3> {} : polygon);
+			}
+			if(std::find(ambiguous.begin(), ambiguous.end(), true) != ambiguous.end())
+				continue;
+			++numCompared;
+
+			for(auto use16 : {false, true}) {
+				std::vector<Intersect> results(numTriangles + 1, Intersect::Overlap);
+				// Sentinel past the end, which must not be written to
+				results.back() = static_cast<Intersect>(0xFF);
+				pragma::math::intersection::ClippedTriangleMesh clipped;
+				// Contents from a previous call, which have to be cleared
+				clipped.vertices.push_back({});
+				clipped.sourceTriangles.push_back(12345);
+				auto numNotOutside = use16 ? pragma::math::intersection::triangle_in_plane_mesh(mesh.verts, triangles16, planeSet, results.data(), &clipped)
+				                           : pragma::math::intersection::triangle_in_plane_mesh(mesh.verts, mesh.triangles, planeSet, results.data(), &clipped);
+				auto info = ::testing::Message() << numTriangles << " triangles, " << numPlanes << " planes, 16-bit indices " << use16;
+				EXPECT_EQ(numNotOutside, expectedNotOutside) << info;
+				EXPECT_EQ(results.back(), static_cast<Intersect>(0xFF)) << info;
+				results.pop_back();
+				EXPECT_EQ(results, expectedResults) << info;
+
+				// The clipped mesh contains the fan triangulation of each polygon, in order of the source triangles
+				ASSERT_EQ(clipped.indices.size(), clipped.sourceTriangles.size() * 3) << info;
+				size_t triIdx = 0;
+				for(uint32_t i = 0; i < numTriangles; ++i) {
+					auto &polygon = expectedPolygons[i];
+					for(size_t j = 1; j + 1 < polygon.size(); ++j) {
+						ASSERT_LT(triIdx, clipped.sourceTriangles.size()) << info;
+						EXPECT_EQ(clipped.sourceTriangles[triIdx], i) << info;
+						std::array<Vector3, 3> expectedVerts {polygon[0], polygon[j], polygon[j + 1]};
+						for(uint8_t k = 0; k < 3; ++k) {
+							auto idx = clipped.indices[triIdx * 3 + k];
+							ASSERT_LT(idx, clipped.vertices.size()) << info;
+							EXPECT_LT(uvec::distance(clipped.vertices[idx], expectedVerts[k]), 1e-4f) << info << ", triangle " << i;
+						}
+						++triIdx;
+					}
+				}
+				EXPECT_EQ(triIdx, clipped.sourceTriangles.size()) << info;
+			}
+		}
+	}
+	EXPECT_GT(numCompared, 40u);
+}
+
+TEST(PlaneSetTests, PlaneSetMatchesIteratorOverloads)
+{
+	using namespace pragma::math::intersection;
+	test::reset_random_generator();
+	for(auto numPlanes : PLANE_COUNTS) {
+		auto planes = random_planes(numPlanes);
+		PlaneSet planeSet {planes.begin(), planes.end()};
+		ASSERT_EQ(planeSet.GetCount(), numPlanes);
+		uint32_t numCompared = 0;
+		std::array<uint32_t, 3> numResults {};
+		for(uint32_t i = 0; i < 2'000; ++i) {
+			// Some volumes are far outside of the planes, or large enough to contain all of them
+			auto center = test::random_vector(-8.f, 8.f);
+			auto radius = (i % 10 == 0) ? test::random_float(5.f, 20.f) : test::random_float(0.f, 3.f);
+			auto extents = (i % 10 == 0) ? test::random_vector(5.f, 20.f) : test::random_vector(0.f, 3.f);
+			if(touches_any_plane(center, {}, radius, planes) || touches_any_plane(center, extents, 0.f, planes))
+				continue;
+			++numCompared;
+			auto info = ::testing::Message() << numPlanes << " planes, volume " << i;
+			EXPECT_EQ(point_in_plane_mesh(center, planeSet), point_in_plane_mesh(center, planes.begin(), planes.end())) << info;
+			for(auto skipInsideTest : {false, true})
+				EXPECT_EQ(sphere_in_plane_mesh(center, radius, planeSet, skipInsideTest), sphere_in_plane_mesh(center, radius, planes.begin(), planes.end(), skipInsideTest)) << info << ", skip inside test " << skipInsideTest;
+			auto result = aabb_in_plane_mesh(center - extents, center + extents, planeSet);
+			EXPECT_EQ(result, aabb_in_plane_mesh(center - extents, center + extents, planes.begin(), planes.end())) << info;
+			++numResults[static_cast<uint32_t>(result)];
+		}
+		EXPECT_GT(numCompared, 1'000u) << numPlanes << " planes";
+		// Without planes, everything is inside
+		if(numPlanes > 0) {
+			for(auto n : numResults)
+				EXPECT_GT(n, 0u) << numPlanes << " planes";
+		}
+	}
+}
+
+TEST(PlaneSetTests, UnusedSlotsDontReject)
+{
+	using namespace pragma::math::intersection;
+	test::reset_random_generator();
+	for(auto numPlanes : PLANE_COUNTS) {
+		// Large distances, so that the planes are far away from the origin and don't intersect the test volumes
+		std::vector<PackedPlane> planes;
+		for(auto &plane : random_planes(numPlanes))
+			planes.push_back({plane.GetNormal(), plane.GetDistance() + 1e6f});
+		PlaneSet planeSet {planes.begin(), planes.end()};
+		for(uint32_t i = numPlanes; i < PlaneSet::MAX_PLANES; ++i) {
+			EXPECT_EQ(planeSet.GetNormalsX()[i], 0.f);
+			EXPECT_EQ(planeSet.GetNormalsY()[i], 0.f);
+			EXPECT_EQ(planeSet.GetNormalsZ()[i], 0.f);
+			EXPECT_EQ(planeSet.GetDistances()[i], std::numeric_limits<float>::max());
+		}
+		// The unused slots are neither in front of nor touching any volume
+		for(auto center : {Vector3 {}, Vector3 {1e5f, -1e5f, 1e5f}}) {
+			EXPECT_TRUE(point_in_plane_mesh(center, planeSet)) << numPlanes << " planes";
+			EXPECT_EQ(sphere_in_plane_mesh(center, 1e4f, planeSet), Intersect::Inside) << numPlanes << " planes";
+			EXPECT_EQ(sphere_in_plane_mesh(center, 1e4f, planeSet, true), Intersect::Overlap) << numPlanes << " planes";
+			EXPECT_EQ(aabb_in_plane_mesh(center - Vector3 {1e4f}, center + Vector3 {1e4f}, planeSet), Intersect::Inside) << numPlanes << " planes";
+		}
+	}
+
+	// Planes beyond MAX_PLANES are ignored, and clearing a full set restores the unused slots
+	auto planes = random_planes(PlaneSet::MAX_PLANES + 3);
+	PlaneSet planeSet {planes.begin(), planes.end()};
+	EXPECT_EQ(planeSet.GetCount(), PlaneSet::MAX_PLANES);
+	EXPECT_FALSE(planeSet.Add(planes.back()));
+	for(uint32_t i = 0; i < PlaneSet::MAX_PLANES; ++i) {
+		EXPECT_EQ(planeSet.Get(i).GetNormal(), planes[i].GetNormal());
+		EXPECT_EQ(planeSet.Get(i).GetDistance(), planes[i].GetDistance());
+	}
+	planeSet.Clear();
+	EXPECT_TRUE(planeSet.IsEmpty());
+	EXPECT_EQ(aabb_in_plane_mesh(Vector3 {-1e4f}, Vector3 {1e4f}, planeSet), Intersect::Inside);
+	EXPECT_TRUE(planeSet.Add(planes.front()));
+	EXPECT_EQ(planeSet.GetCount(), 1u);
+}
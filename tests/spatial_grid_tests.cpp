@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	// Mostly uniform points, plus a dense cluster so that some buckets contain many points
+	std::vector<Vector3> generate_points(uint32_t count)
+	{
+		test::reset_random_generator();
+		std::vector<Vector3> points;
+		points.reserve(count);
+		for(uint32_t i = 0; i < count; ++i)
+			points.push_back((i % 8 == 0) ? test::random_vector(-0.5f, 0.5f) : test::random_vector(-40.f, 40.f));
+		return points;
+	}
+
+	std::vector<uint32_t> find_in_radius_linear(const std::vector<Vector3> &points, const Vector3 &origin, float radius)
+	{
+		std::vector<uint32_t> result;
+		for(uint32_t i = 0; i < points.size(); ++i) {
+			if(uvec::length_sqr(points[i] - origin) <= radius * radius)
+				result.push_back(i);
+		}
+		return result;
+	}
+
+	void compare_queries(const pragma::math::SpatialHashGrid &grid, const std::vector<Vector3> &points, uint32_t numQueries)
+	{
+		for(uint32_t q = 0; q < numQueries; ++q) {
+			auto origin = test::random_vector(-45.f, 45.f);
+			auto radius = test::random_float(0.1f, 6.f);
+			std::vector<uint32_t> result;
+			grid.FindPointsInRadius(origin, radius, result);
+			std::sort(result.begin(), result.end());
+			EXPECT_EQ(result, find_in_radius_linear(points, origin, radius));
+
+			auto [min, max] = test::random_aabb(40.f, 5.f);
+			result.clear();
+			grid.FindPointsInAabb(min, max, result);
+			std::sort(result.begin(), result.end());
+			std::vector<uint32_t> ref;
+			for(uint32_t i = 0; i < points.size(); ++i) {
+				auto &p = points[i];
+				if(p.x >= min.x && p.y >= min.y && p.z >= min.z && p.x <= max.x && p.y <= max.y && p.z <= max.z)
+					ref.push_back(i);
+			}
+			EXPECT_EQ(result, ref);
+
+			auto k = test::random_uint(1, 20);
+			grid.FindKNearest(origin, k, result);
+			std::vector<std::pair<float, uint32_t>> sorted;
+			for(uint32_t i = 0; i < points.size(); ++i)
+				sorted.push_back({uvec::length_sqr(points[i] - origin), i});
+			std::sort(sorted.begin(), sorted.end());
+			ASSERT_EQ(result.size(), std::min<size_t>(k, points.size()));
+			for(size_t i = 0; i < result.size(); ++i)
+				EXPECT_EQ(result[i], sorted[i].second);
+		}
+	}
+
+	// A box query that covers more cells than there are points iterates over all points in the order in which they are stored
+	std::vector<uint32_t> get_storage_order(const pragma::math::SpatialHashGrid &grid)
+	{
+		std::vector<uint32_t> result;
+		grid.FindPointsInAabb(Vector3 {-1'000.f, -1'000.f, -1'000.f}, Vector3 {1'000.f, 1'000.f, 1'000.f}, result);
+		return result;
+	}
+};
+
+TEST(SpatialGridTests, QueriesMatchLinearScan)
+{
+	for(auto cellSize : {0.5f, 2.f, 10.f}) {
+		auto points = generate_points(5'000);
+		pragma::math::SpatialHashGrid grid {cellSize};
+		grid.Build(points);
+		EXPECT_EQ(grid.GetPointCount(), points.size());
+		compare_queries(grid, points, 100);
+	}
+}
+
+TEST(SpatialGridTests, ParallelBuildMatchesSerial)
+{
+	auto points = generate_points(200'000);
+	pragma::math::SpatialHashGrid serial {1.f};
+	serial.Build(points, 1);
+	auto serialOrder = get_storage_order(serial);
+	// Points of the same bucket are stored in the order of their indices
+	ASSERT_EQ(serialOrder.size(), points.size());
+	for(auto threadCount : {0u, 2u, 7u}) {
+		pragma::math::SpatialHashGrid parallel {1.f};
+		parallel.Build(points, threadCount);
+		EXPECT_EQ(get_storage_order(parallel), serialOrder);
+		compare_queries(parallel, points, 20);
+	}
+}
+
+TEST(SpatialGridTests, Rebuild)
+{
+	pragma::math::SpatialHashGrid grid {1.f, 64};
+	grid.Build({});
+	EXPECT_TRUE(grid.IsEmpty());
+	std::vector<uint32_t> result;
+	grid.FindPointsInRadius({}, 10.f, result);
+	EXPECT_TRUE(result.empty());
+
+	// A fixed table size that is smaller than the point count, and rebuilds with fewer points
+	for(auto count : {50'000u, 1'000u, 70'000u}) {
+		auto points = generate_points(count);
+		grid.Build(points, 4);
+		compare_queries(grid, points, 20);
+	}
+}
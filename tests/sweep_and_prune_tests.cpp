@@ -0,0 +1,169 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	using ProxyId = pragma::math::SweepAndPrune::ProxyId;
+	using ProxyPair = std::pair<ProxyId, ProxyId>;
+
+	// Mirror of the proxies, used as the brute-force reference
+	struct Scene {
+		pragma::math::SweepAndPrune sap {};
+		std::unordered_map<ProxyId, bounding_volume::AABB> proxies;
+		// Pairs of the last update, to validate the pair events
+		std::set<ProxyPair> pairs;
+
+		void Add(const bounding_volume::AABB &aabb)
+		{
+			auto id = sap.Add(aabb);
+			ASSERT_EQ(proxies.find(id), proxies.end());
+			proxies[id] = aabb;
+		}
+		void Add()
+		{
+			auto [min, max] = test::random_aabb(50.f, 3.f);
+			Add({min, max});
+		}
+		void Remove(ProxyId id)
+		{
+			sap.Remove(id);
+			proxies.erase(id);
+		}
+		void Move(ProxyId id, float maxDisplacement)
+		{
+			auto d = test::random_vector(-maxDisplacement, maxDisplacement);
+			auto &aabb = proxies[id];
+			aabb = {aabb.min + d, aabb.max + d};
+			sap.SetAabb(id, aabb);
+		}
+		ProxyId RandomProxy() const
+		{
+			auto it = proxies.begin();
+			std::advance(it, test::random_uint(0, static_cast<uint32_t>(proxies.size())));
+			return it->first;
+		}
+		std::vector<ProxyPair> BruteForcePairs() const
+		{
+			std::vector<ProxyPair> result;
+			for(auto &[idA, a] : proxies) {
+				for(auto &[idB, b] : proxies) {
+					if(idA < idB && a.Intersects(b))
+						result.push_back({idA, idB});
+				}
+			}
+			std::sort(result.begin(), result.end());
+			return result;
+		}
+		// Runs the update and compares the pairs and pair events with the brute-force result
+		void UpdateAndValidate()
+		{
+			sap.Update();
+			auto ref = BruteForcePairs();
+			std::vector<ProxyPair> result;
+			sap.GetPairs(result);
+			EXPECT_EQ(result, ref);
+			EXPECT_EQ(sap.GetPairCount(), ref.size());
+			EXPECT_EQ(sap.GetProxyCount(), proxies.size());
+
+			auto &events = sap.GetPairEvents();
+			for(size_t i = 1; i < events.size(); ++i)
+				EXPECT_LT((ProxyPair {events[i - 1].a, events[i - 1].b}), (ProxyPair {events[i].a, events[i].b}));
+			for(auto &ev : events) {
+				ProxyPair pair {ev.a, ev.b};
+				if(ev.type == pragma::math::SweepAndPrune::PairEventType::Added)
+					EXPECT_TRUE(pairs.insert(pair).second);
+				else
+					EXPECT_EQ(pairs.erase(pair), 1u);
+			}
+			EXPECT_EQ(std::vector<ProxyPair>(pairs.begin(), pairs.end()), ref);
+		}
+	};
+};
+
+TEST(SweepAndPruneTests, BulkInsert)
+{
+	test::reset_random_generator();
+	Scene scene;
+	for(uint32_t i = 0; i < 3'000; ++i)
+		scene.Add();
+	scene.UpdateAndValidate();
+	EXPECT_EQ(scene.sap.GetFrameStats().pairsAdded, scene.pairs.size());
+	// Nothing has changed
+	scene.sap.Update();
+	EXPECT_TRUE(scene.sap.GetPairEvents().empty());
+}
+
+TEST(SweepAndPruneTests, TouchingBoxesOverlap)
+{
+	Scene scene;
+	scene.Add({Vector3 {0.f, 0.f, 0.f}, Vector3 {1.f, 1.f, 1.f}});
+	scene.Add({Vector3 {1.f, 0.f, 0.f}, Vector3 {2.f, 1.f, 1.f}});
+	scene.Add({Vector3 {0.f, 1.f, 0.f}, Vector3 {1.f, 2.f, 1.f}});
+	// Degenerate boxes with the same endpoints on every axis
+	scene.Add({Vector3 {5.f, 5.f, 5.f}, Vector3 {5.f, 5.f, 5.f}});
+	scene.Add({Vector3 {5.f, 5.f, 5.f}, Vector3 {5.f, 5.f, 5.f}});
+	scene.UpdateAndValidate();
+	EXPECT_EQ(scene.pairs.size(), 4u);
+}
+
+TEST(SweepAndPruneTests, ChurnMatchesBruteForce)
+{
+	test::reset_random_generator();
+	Scene scene;
+	for(uint32_t i = 0; i < 1'000; ++i)
+		scene.Add();
+	scene.UpdateAndValidate();
+	for(uint32_t frame = 0; frame < 60; ++frame) {
+		// Coherent movement of all proxies, plus random additions and removals, some of which happen in bulk
+		for(auto &[id, aabb] : scene.proxies)
+			scene.Move(id, 0.3f);
+		auto numChanges = (frame % 10 == 0) ? 300u : 20u;
+		for(uint32_t i = 0; i < numChanges; ++i) {
+			auto r = test::random_uint(0, 3);
+			if(r == 0 || scene.proxies.empty())
+				scene.Add();
+			else if(r == 1)
+				scene.Remove(scene.RandomProxy());
+			else
+				scene.Move(scene.RandomProxy(), 20.f);
+		}
+		scene.UpdateAndValidate();
+	}
+}
+
+TEST(SweepAndPruneTests, RemoveBeforeUpdate)
+{
+	test::reset_random_generator();
+	Scene scene;
+	for(uint32_t i = 0; i < 200; ++i)
+		scene.Add();
+	scene.UpdateAndValidate();
+	// Proxies that are added and removed again before the next update must not generate any pairs
+	std::vector<ProxyId> added;
+	for(uint32_t i = 0; i < 50; ++i) {
+		auto [min, max] = test::random_aabb(50.f, 3.f);
+		added.push_back(scene.sap.Add({min, max}));
+	}
+	for(auto id : added)
+		scene.sap.Remove(id);
+	for(uint32_t i = 0; i < 50; ++i)
+		scene.Remove(scene.RandomProxy());
+	scene.UpdateAndValidate();
+	// The ids are re-used after the update
+	for(uint32_t i = 0; i < 100; ++i)
+		scene.Add();
+	scene.UpdateAndValidate();
+
+	scene.sap.Clear();
+	scene.proxies.clear();
+	scene.pairs.clear();
+	for(uint32_t i = 0; i < 100; ++i)
+		scene.Add();
+	scene.UpdateAndValidate();
+}
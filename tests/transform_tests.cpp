@@ -0,0 +1,501 @@
+// SPDX-FileCopyrightText: (c) 2025 Silverlan <opensource@pragma-engine.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gtest_common.h"
+
+namespace {
+	constexpr float EPSILON = 0.0001f;
+	// Covers empty buffers, partial batches only, and full batches followed by a partial one for all SIMD widths up to 16
+	constexpr std::array<size_t, 9> BATCH_COUNTS {0, 1, 3, 4, 7, 9, 16, 17, 35};
+
+	Quat random_rotation()
+	{
+		Quat q {test::random_float(-1.f, 1.f), test::random_float(-1.f, 1.f), test::random_float(-1.f, 1.f), test::random_float(-1.f, 1.f)};
+		if(uquat::length(q) < 0.0001f)
+			return uquat::identity();
+		uquat::normalize(q);
+		return q;
+	}
+	template<typename TTransform>
+	TTransform random_transform()
+	{
+		if constexpr(std::is_same_v<TTransform, pragma::math::ScaledTransform>)
+			return {test::random_vector(-10.f, 10.f), random_rotation(), test::random_vector(0.5f, 2.f)};
+		else
+			return {test::random_vector(-10.f, 10.f), random_rotation()};
+	}
+	template<typename TTransform>
+	std::vector<TTransform> random_transforms(size_t count)
+	{
+		std::vector<TTransform> transforms;
+		transforms.reserve(count);
+		for(size_t i = 0; i < count; ++i)
+			transforms.push_back(random_transform<TTransform>());
+		return transforms;
+	}
+	std::vector<Vector3> random_points(size_t count)
+	{
+		std::vector<Vector3> points;
+		points.reserve(count);
+		for(size_t i = 0; i < count; ++i)
+			points.push_back(test::random_vector(-10.f, 10.f));
+		return points;
+	}
+
+	// The tolerance is relative to the magnitude of the expected value
+	void expect_near(const Vector3 &v, const Vector3 &expected)
+	{
+		auto tolerance = EPSILON * std::max(1.f, uvec::length(expected));
+		EXPECT_NEAR(v.x, expected.x, tolerance);
+		EXPECT_NEAR(v.y, expected.y, tolerance);
+		EXPECT_NEAR(v.z, expected.z, tolerance);
+	}
+	// q and -q are the same rotation
+	void expect_near(const Quat &q, const Quat &expected) { EXPECT_NEAR(std::abs(uquat::dot_product(q, expected)), 1.f, EPSILON); }
+	void expect_near(const pragma::math::Transform &t, const pragma::math::Transform &expected)
+	{
+		expect_near(t.GetOrigin(), expected.GetOrigin());
+		expect_near(t.GetRotation(), expected.GetRotation());
+	}
+	void expect_near(const pragma::math::ScaledTransform &t, const pragma::math::ScaledTransform &expected)
+	{
+		expect_near(static_cast<const pragma::math::Transform &>(t), static_cast<const pragma::math::Transform &>(expected));
+		expect_near(t.GetScale(), expected.GetScale());
+	}
+	void expect_near(const Mat4 &m, const Mat4 &expected)
+	{
+		auto maxElement = 1.f;
+		for(uint8_t c = 0; c < 4; ++c) {
+			for(uint8_t r = 0; r < 4; ++r)
+				maxElement = std::max(maxElement, std::abs(expected[c][r]));
+		}
+		for(uint8_t c = 0; c < 4; ++c) {
+			for(uint8_t r = 0; r < 4; ++r)
+				EXPECT_NEAR(m[c][r], expected[c][r], EPSILON * maxElement) << "column " << static_cast<uint32_t>(c) << ", row " << static_cast<uint32_t>(r);
+		}
+	}
+	void expect_near(const pragma::math::AffineMatrix &m, const Mat4 &expected) { expect_near(m.ToMatrix(), expected); }
+
+	template<typename TBuffer, typename TTransform>
+	void expect_buffer_near(const TBuffer &buffer, const std::vector<TTransform> &expected)
+	{
+		ASSERT_EQ(buffer.Size(), expected.size());
+		for(size_t i = 0; i < expected.size(); ++i) {
+			SCOPED_TRACE(i);
+			expect_near(buffer.Get(i), expected[i]);
+		}
+	}
+
+	// Compares every batched operation of the buffer with the scalar operation of the transform type, including outputs that alias an input
+	template<typename TBuffer, typename TTransform>
+	void compare_batched_kernels()
+	{
+		test::reset_random_generator();
+		for(auto count : BATCH_COUNTS) {
+			SCOPED_TRACE(count);
+			auto a = random_transforms<TTransform>(count);
+			auto b = random_transforms<TTransform>(count);
+			auto parent = random_transform<TTransform>();
+			TBuffer bufA {a};
+			TBuffer bufB {b};
+			expect_buffer_near(bufA, a);
+
+			std::vector<TTransform> products;
+			std::vector<TTransform> parentProducts;
+			std::vector<TTransform> inverses;
+			for(size_t i = 0; i < count; ++i) {
+				products.push_back(a[i] * b[i]);
+				parentProducts.push_back(parent * b[i]);
+				inverses.push_back(a[i].GetInverse());
+			}
+
+			// The output buffer still has the size of a previous iteration
+			TBuffer out {random_transforms<TTransform>(5)};
+			TBuffer::Multiply(bufA, bufB, out);
+			expect_buffer_near(out, products);
+			TBuffer::Multiply(parent, bufB, out);
+			expect_buffer_near(out, parentProducts);
+			TBuffer::Invert(bufA, out);
+			expect_buffer_near(out, inverses);
+
+			auto aliased = bufA;
+			TBuffer::Multiply(aliased, bufB, aliased);
+			expect_buffer_near(aliased, products);
+			aliased = bufB;
+			TBuffer::Multiply(bufA, aliased, aliased);
+			expect_buffer_near(aliased, products);
+			aliased = bufA;
+			TBuffer::Multiply(aliased, aliased, aliased);
+			for(size_t i = 0; i < count; ++i) {
+				SCOPED_TRACE(i);
+				expect_near(aliased.Get(i), a[i] * a[i]);
+			}
+			aliased = bufB;
+			TBuffer::Multiply(parent, aliased, aliased);
+			expect_buffer_near(aliased, parentProducts);
+			aliased = bufA;
+			TBuffer::Invert(aliased, aliased);
+			expect_buffer_near(aliased, inverses);
+
+			auto points = random_points(count);
+			std::vector<Vector3> outPoints(count);
+			bufA.TransformPoints(points.data(), outPoints.data());
+			std::vector<Mat4> matrices(count);
+			bufA.ToMatrices(matrices.data());
+			std::vector<pragma::math::AffineMatrix> affineMatrices(count);
+			bufA.ToAffineMatrices(affineMatrices.data());
+			for(size_t i = 0; i < count; ++i) {
+				SCOPED_TRACE(i);
+				expect_near(outPoints[i], a[i] * points[i]);
+				expect_near(matrices[i], a[i].ToMatrix());
+				expect_near(affineMatrices[i], a[i].ToMatrix());
+			}
+			bufA.TransformPoints(points.data(), points.data());
+			EXPECT_EQ(points, outPoints);
+		}
+	}
+
+	// Parents-first forest, most roots are at the beginning so that the subtrees are interleaved
+	std::vector<uint32_t> random_parents(uint32_t count, uint32_t numRoots)
+	{
+		std::vector<uint32_t> parents;
+		parents.reserve(count);
+		for(uint32_t i = 0; i < count; ++i)
+			parents.push_back((i < numRoots || test::random_uint(0, 100) == 0) ? pragma::math::TransformHierarchy::INVALID_INDEX : test::random_uint(0, i));
+		return parents;
+	}
+	std::vector<pragma::math::ScaledTransform> compute_world_transforms(const pragma::math::TransformHierarchy &hierarchy)
+	{
+		std::vector<pragma::math::ScaledTransform> world;
+		world.reserve(hierarchy.GetNodeCount());
+		for(uint32_t i = 0; i < hierarchy.GetNodeCount(); ++i) {
+			auto parent = hierarchy.GetParent(i);
+			world.push_back((parent != pragma::math::TransformHierarchy::INVALID_INDEX) ? world[parent] * hierarchy.GetLocalTransform(i) : hierarchy.GetLocalTransform(i));
+		}
+		return world;
+	}
+	// Number of nodes that have changed or have a changed ancestor
+	size_t count_dirty_nodes(const pragma::math::TransformHierarchy &hierarchy, const std::vector<uint8_t> &changed)
+	{
+		std::vector<uint8_t> dirty = changed;
+		for(uint32_t i = 0; i < hierarchy.GetNodeCount(); ++i) {
+			auto parent = hierarchy.GetParent(i);
+			if(parent != pragma::math::TransformHierarchy::INVALID_INDEX && dirty[parent])
+				dirty[i] = true;
+		}
+		return static_cast<size_t>(std::count(dirty.begin(), dirty.end(), true));
+	}
+	void expect_world_transforms(const pragma::math::TransformHierarchy &hierarchy)
+	{
+		EXPECT_FALSE(hierarchy.IsDirty());
+		auto expected = compute_world_transforms(hierarchy);
+		for(uint32_t i = 0; i < hierarchy.GetNodeCount(); ++i) {
+			SCOPED_TRACE(i);
+			expect_near(hierarchy.GetWorldTransform(i), expected[i]);
+		}
+	}
+
+	struct SkinningInput {
+		std::vector<pragma::math::Vertex> verts;
+		std::vector<pragma::math::VertexWeight> weights;
+	};
+	// Includes out-of-range bone ids, zero weights and vertices without any influence
+	SkinningInput random_skinning_input(size_t numVerts, uint32_t numBones)
+	{
+		SkinningInput input;
+		input.verts.reserve(numVerts);
+		input.weights.reserve(numVerts);
+		for(size_t i = 0; i < numVerts; ++i) {
+			auto normal = uvec::get_normal(test::random_vector(-1.f, 1.f));
+			auto tangent = uvec::get_normal(test::random_vector(-1.f, 1.f));
+			input.verts.push_back({test::random_vector(-10.f, 10.f), Vector2 {}, normal, Vector4 {tangent, (i % 2 == 0) ? 1.f : -1.f}});
+			Vector4i boneIds;
+			Vector4 weights;
+			for(uint8_t k = 0; k < 4; ++k) {
+				boneIds[k] = static_cast<int32_t>(test::random_uint(0, numBones + 2)) - 1;
+				weights[k] = (i % 13 == 0 || test::random_uint(0, 4) == 0) ? 0.f : test::random_float(0.1f, 1.f);
+			}
+			input.weights.push_back({boneIds, weights});
+		}
+		return input;
+	}
+	bool is_valid_influence(const pragma::math::VertexWeight &vw, uint8_t k, uint32_t numBones) { return vw.boneIds[k] >= 0 && static_cast<uint32_t>(vw.boneIds[k]) < numBones && vw.weights[k] != 0.f; }
+
+	pragma::math::DualQuat blend_bones(const std::vector<pragma::math::DualQuat> &bones, const pragma::math::VertexWeight &vw)
+	{
+		std::vector<pragma::math::DualQuat> dqs;
+		std::vector<float> weights;
+		for(uint8_t k = 0; k < 4; ++k) {
+			if(!is_valid_influence(vw, k, static_cast<uint32_t>(bones.size())))
+				continue;
+			dqs.push_back(bones[vw.boneIds[k]]);
+			weights.push_back(vw.weights[k]);
+		}
+		return pragma::math::DualQuat::Blend(dqs.data(), weights.data(), dqs.size());
+	}
+
+	// Weighted average of the bone matrices
+	Mat4 blend_bones(const std::vector<Mat4> &bones, const pragma::math::VertexWeight &vw)
+	{
+		Mat4 m {0.f};
+		auto weightSum = 0.f;
+		for(uint8_t k = 0; k < 4; ++k) {
+			if(!is_valid_influence(vw, k, static_cast<uint32_t>(bones.size())))
+				continue;
+			m += bones[vw.boneIds[k]] * vw.weights[k];
+			weightSum += vw.weights[k];
+		}
+		return (weightSum != 0.f) ? m * (1.f / weightSum) : Mat4 {1.f};
+	}
+
+	struct SkinningOutput {
+		SkinningOutput(size_t numVerts) : positions(numVerts), normals(numVerts), tangents(numVerts) {}
+		std::vector<Vector3> positions;
+		std::vector<Vector3> normals;
+		std::vector<Vector4> tangents;
+	};
+	void expect_skinning_output(const SkinningOutput &output, const SkinningOutput &expected)
+	{
+		for(size_t i = 0; i < expected.positions.size(); ++i) {
+			SCOPED_TRACE(i);
+			expect_near(output.positions[i], expected.positions[i]);
+			expect_near(output.normals[i], expected.normals[i]);
+			expect_near(Vector3 {output.tangents[i]}, Vector3 {expected.tangents[i]});
+			EXPECT_EQ(output.tangents[i].w, expected.tangents[i].w);
+		}
+	}
+};
+
+TEST(TransformTests, TransformBufferMatchesTransform) { compare_batched_kernels<pragma::math::TransformBuffer, pragma::math::Transform>(); }
+
+TEST(TransformTests, ScaledTransformBufferMatchesScaledTransform) { compare_batched_kernels<pragma::math::ScaledTransformBuffer, pragma::math::ScaledTransform>(); }
+
+TEST(TransformTests, HierarchyUpdate)
+{
+	test::reset_random_generator();
+	constexpr uint32_t numNodes = 2'000;
+	auto parents = random_parents(numNodes, 8);
+	pragma::math::TransformHierarchy serial;
+	ASSERT_TRUE(serial.SetParents(parents));
+	ASSERT_EQ(serial.GetNodeCount(), numNodes);
+	// Scales close to 1, so that the world transforms of deep nodes stay in a reasonable range
+	std::vector<pragma::math::ScaledTransform> localTransforms;
+	for(uint32_t i = 0; i < numNodes; ++i)
+		localTransforms.push_back({test::random_vector(-10.f, 10.f), random_rotation(), test::random_vector(0.8f, 1.25f)});
+	serial.SetLocalTransforms(localTransforms);
+	auto parallel = serial;
+
+	EXPECT_EQ(serial.Update(), numNodes);
+	EXPECT_EQ(parallel.UpdateParallel(4), numNodes);
+	expect_world_transforms(serial);
+	expect_world_transforms(parallel);
+
+	// Changes of single nodes only recompute their subtrees. Rounds without changes don't recompute anything.
+	constexpr std::array<uint32_t, 3> threadCounts {0, 1, 3};
+	for(uint32_t round = 0; round < 30; ++round) {
+		SCOPED_TRACE(round);
+		std::vector<uint8_t> changed(numNodes, false);
+		auto numChanges = (round % 5 == 4) ? 0 : test::random_uint(1, 6);
+		for(uint32_t i = 0; i < numChanges; ++i) {
+			auto node = test::random_uint(0, numNodes);
+			pragma::math::ScaledTransform t {test::random_vector(-10.f, 10.f), random_rotation(), test::random_vector(0.8f, 1.25f)};
+			serial.SetLocalTransform(node, t);
+			parallel.SetLocalTransform(node, t);
+			changed[node] = true;
+		}
+		EXPECT_EQ(serial.IsDirty(), numChanges > 0);
+		auto numDirty = count_dirty_nodes(serial, changed);
+		EXPECT_EQ(serial.Update(), numDirty);
+		EXPECT_EQ(parallel.UpdateParallel(threadCounts[round % threadCounts.size()]), numDirty);
+		expect_world_transforms(serial);
+		expect_world_transforms(parallel);
+		EXPECT_EQ(serial.Update(), 0u);
+		EXPECT_EQ(parallel.UpdateParallel(), 0u);
+	}
+
+	// Only the new node is computed, with the current world transform of its parent
+	auto node = serial.AddNode(numNodes / 2, localTransforms.front());
+	EXPECT_EQ(parallel.AddNode(numNodes / 2, localTransforms.front()), node);
+	EXPECT_EQ(serial.Update(), 1u);
+	EXPECT_EQ(parallel.UpdateParallel(), 1u);
+	expect_world_transforms(serial);
+	expect_world_transforms(parallel);
+
+	EXPECT_EQ(serial.AddNode(numNodes + 1), pragma::math::TransformHierarchy::INVALID_INDEX);
+	EXPECT_FALSE(serial.SetParents({pragma::math::TransformHierarchy::INVALID_INDEX, 2, 0}));
+	EXPECT_EQ(serial.GetNodeCount(), 0u);
+}
+
+TEST(TransformTests, DualQuatMatchesTransform)
+{
+	test::reset_random_generator();
+	for(uint32_t i = 0; i < 100; ++i) {
+		SCOPED_TRACE(i);
+		auto a = random_transform<pragma::math::Transform>();
+		auto b = random_transform<pragma::math::Transform>();
+		auto p = test::random_vector(-10.f, 10.f);
+		pragma::math::DualQuat dqA {a};
+		pragma::math::DualQuat dqB {b};
+		expect_near(dqA.GetTranslation(), a.GetOrigin());
+		expect_near(dqA.ToTransform(), a);
+		expect_near(dqA.ToMatrix(), a.ToMatrix());
+		expect_near(dqA * p, a * p);
+		expect_near(dqA.Rotate(p), a * p - a.GetOrigin());
+		expect_near((dqA * dqB) * p, (a * b) * p);
+		expect_near(dqA.GetInverse() * p, a.GetInverse() * p);
+
+		// Blending two copies of the same transform, one of them in the opposite hemisphere, yields the transform itself
+		std::array<pragma::math::DualQuat, 2> dqs {dqA, dqA * -1.f};
+		std::array<float, 2> weights {test::random_float(0.1f, 1.f), test::random_float(0.1f, 1.f)};
+		expect_near(pragma::math::DualQuat::Blend(dqs.data(), weights.data(), dqs.size()) * p, a * p);
+	}
+}
+
+TEST(TransformTests, DualQuaternionSkinningMatchesBlend)
+{
+	test::reset_random_generator();
+	constexpr uint32_t numBones = 20;
+	std::vector<pragma::math::DualQuat> bones;
+	for(uint32_t i = 0; i < numBones; ++i) {
+		pragma::math::DualQuat dq {random_transform<pragma::math::Transform>()};
+		// Same transform in the opposite hemisphere
+		bones.push_back((i % 3 == 0) ? dq * -1.f : dq);
+	}
+	// The largest count is processed in multiple chunks if multithreaded
+	for(size_t numVerts : {0, 1, 5, 17, 100, 10'003}) {
+		SCOPED_TRACE(numVerts);
+		auto input = random_skinning_input(numVerts, numBones);
+		SkinningOutput expected {numVerts};
+		for(size_t i = 0; i < numVerts; ++i) {
+			auto dq = blend_bones(bones, input.weights[i]);
+			auto &v = input.verts[i];
+			expected.positions[i] = dq * v.position;
+			expected.normals[i] = dq.Rotate(v.normal);
+			expected.tangents[i] = {dq.Rotate(Vector3 {v.tangent}), v.tangent.w};
+		}
+		for(auto threadCount : {1u, 4u}) {
+			SkinningOutput output {numVerts};
+			pragma::math::skinning::dual_quaternion(bones.data(), numBones, input.verts.data(), input.weights.data(), numVerts, output.positions.data(), output.normals.data(), output.tangents.data(), threadCount);
+			expect_skinning_output(output, expected);
+
+			std::vector<Vector3> positions(numVerts);
+			pragma::math::skinning::dual_quaternion(bones.data(), numBones, input.verts.data(), input.weights.data(), numVerts, positions.data(), nullptr, nullptr, threadCount);
+			EXPECT_EQ(positions, output.positions);
+		}
+	}
+}
+
+TEST(TransformTests, LinearBlendSkinningMatchesMatrixBlend)
+{
+	test::reset_random_generator();
+	constexpr uint32_t numBones = 20;
+	// Uniform scales, for which the blended normals are exact
+	std::vector<Mat4> bones;
+	std::vector<Mat3x4> rowBones;
+	std::vector<pragma::math::AffineMatrix> affineBones;
+	for(uint32_t i = 0; i < numBones; ++i) {
+		auto scale = test::random_float(0.5f, 2.f);
+		pragma::math::ScaledTransform t {test::random_vector(-10.f, 10.f), random_rotation(), Vector3 {scale, scale, scale}};
+		bones.push_back(t.ToMatrix());
+		affineBones.push_back(pragma::math::AffineMatrix {t});
+		rowBones.push_back(affineBones.back().GetRows());
+	}
+	for(size_t numVerts : {0, 1, 5, 17, 100, 10'003}) {
+		SCOPED_TRACE(numVerts);
+		auto input = random_skinning_input(numVerts, numBones);
+		SkinningOutput expected {numVerts};
+		for(size_t i = 0; i < numVerts; ++i) {
+			auto m = blend_bones(bones, input.weights[i]);
+			auto &v = input.verts[i];
+			expected.positions[i] = Vector3 {m * Vector4 {v.position, 1.f}};
+			expected.normals[i] = uvec::get_normal(Vector3 {m * Vector4 {v.normal, 0.f}});
+			expected.tangents[i] = {uvec::get_normal(Vector3 {m * Vector4 {Vector3 {v.tangent}, 0.f}}), v.tangent.w};
+		}
+		for(auto threadCount : {1u, 4u}) {
+			SkinningOutput output {numVerts};
+			pragma::math::skinning::linear_blend(bones.data(), numBones, input.verts.data(), input.weights.data(), numVerts, output.positions.data(), output.normals.data(), output.tangents.data(), threadCount);
+			expect_skinning_output(output, expected);
+
+			SkinningOutput rowOutput {numVerts};
+			pragma::math::skinning::linear_blend(rowBones.data(), numBones, input.verts.data(), input.weights.data(), numVerts, rowOutput.positions.data(), rowOutput.normals.data(), rowOutput.tangents.data(), threadCount);
+			expect_skinning_output(rowOutput, expected);
+
+			SkinningOutput affineOutput {numVerts};
+			pragma::math::skinning::linear_blend(affineBones.data(), numBones, input.verts.data(), input.weights.data(), numVerts, affineOutput.positions.data(), affineOutput.normals.data(), affineOutput.tangents.data(), threadCount);
+			expect_skinning_output(affineOutput, expected);
+		}
+	}
+}
+
+TEST(TransformTests, AffineMatrixMatchesMatrix)
+{
+	test::reset_random_generator();
+	for(auto count : BATCH_COUNTS) {
+		SCOPED_TRACE(count);
+		auto a = random_transforms<pragma::math::ScaledTransform>(count);
+		auto b = random_transforms<pragma::math::ScaledTransform>(count);
+		auto parent = random_transform<pragma::math::ScaledTransform>();
+		std::vector<pragma::math::AffineMatrix> matA;
+		std::vector<pragma::math::AffineMatrix> matB;
+		for(size_t i = 0; i < count; ++i) {
+			matA.push_back(pragma::math::AffineMatrix {a[i]});
+			matB.push_back(pragma::math::AffineMatrix {b[i]});
+		}
+		pragma::math::AffineMatrix matParent {parent};
+		auto points = random_points(count);
+		auto dirs = random_points(count);
+
+		for(size_t i = 0; i < count; ++i) {
+			SCOPED_TRACE(i);
+			auto m = a[i].ToMatrix();
+			expect_near(matA[i], m);
+			expect_near(pragma::math::AffineMatrix {m}, m);
+			expect_near(matA[i].TransformPoint(points[i]), a[i] * points[i]);
+			expect_near(matA[i].TransformDirection(dirs[i]), Vector3 {m * Vector4 {dirs[i], 0.f}});
+			// Non-uniform scales don't commute with rotations, so the product is compared with the matrix product rather than with the ScaledTransform product
+			expect_near(matA[i] * matB[i], m * b[i].ToMatrix());
+			auto inverse = glm::inverse(m);
+			expect_near(matA[i].GetInverse(), inverse);
+			expect_near(matA[i].GetOrthogonalInverse(), inverse);
+
+			auto rigid = random_transform<pragma::math::Transform>();
+			expect_near(pragma::math::AffineMatrix {rigid}.GetRigidInverse(), rigid.GetInverse().ToMatrix());
+		}
+
+		std::vector<pragma::math::AffineMatrix> out(count);
+		pragma::math::AffineMatrix::Multiply(matA.data(), matB.data(), out.data(), count);
+		for(size_t i = 0; i < count; ++i)
+			expect_near(out[i], (matA[i] * matB[i]).ToMatrix());
+		auto aliased = matA;
+		pragma::math::AffineMatrix::Multiply(aliased.data(), matB.data(), aliased.data(), count);
+		EXPECT_EQ(aliased, out);
+		aliased = matB;
+		pragma::math::AffineMatrix::Multiply(matA.data(), aliased.data(), aliased.data(), count);
+		EXPECT_EQ(aliased, out);
+
+		pragma::math::AffineMatrix::Multiply(matParent, matB.data(), out.data(), count);
+		for(size_t i = 0; i < count; ++i)
+			expect_near(out[i], (matParent * matB[i]).ToMatrix());
+		aliased = matB;
+		pragma::math::AffineMatrix::Multiply(matParent, aliased.data(), aliased.data(), count);
+		EXPECT_EQ(aliased, out);
+
+		std::vector<Vector3> outPoints(count);
+		matParent.TransformPoints(points.data(), outPoints.data(), count);
+		for(size_t i = 0; i < count; ++i)
+			expect_near(outPoints[i], matParent.TransformPoint(points[i]));
+		matParent.TransformPoints(points.data(), points.data(), count);
+		EXPECT_EQ(points, outPoints);
+		matParent.TransformDirections(dirs.data(), outPoints.data(), count);
+		for(size_t i = 0; i < count; ++i)
+			expect_near(outPoints[i], matParent.TransformDirection(dirs[i]));
+		matParent.TransformDirections(dirs.data(), dirs.data(), count);
+		EXPECT_EQ(dirs, outPoints);
+	}
+}